@@ -0,0 +1,142 @@
+#ifndef AI_SERVER_APP_AI_SERVER_CONFIG_H
+#define AI_SERVER_APP_AI_SERVER_CONFIG_H
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/hana/define_struct.hpp>
+#include <fmt/format.h>
+#include <yamlizer/yamlizer.h>
+
+// ai-server の設定ファイル (YAML) の内容
+// 全ての項目を省略せずに書くこと (ai-server.yaml を参照)
+// --------------------------------
+
+// チームの最大のロボット数 (ID 0 ~ ID max_robots - 1 の機体を使う)
+inline constexpr std::size_t max_robots = 16;
+
+// 受信するアドレスとポート
+struct endpoint_config {
+  BOOST_HANA_DEFINE_STRUCT(endpoint_config,
+                           (std::string, address), // マルチキャストアドレス
+                           (int, port));
+};
+
+// Gameの設定
+struct game_config {
+  BOOST_HANA_DEFINE_STRUCT(game_config,
+                           (std::string, team_color), // "yellow" or "blue"
+                           (std::vector<unsigned int>, active_robots), // ID (max_robots 未満)
+                           (std::string, nnp_dir),           // 設定ファイルからの相対パス
+                           (double, planning_budget),        // 1 周期に経路探索に使う時間 [ms]
+                           // (rrt_star 以外の planner は期限を使わないので, human_like では効果がない)
+                           (std::size_t, planning_threads),  // 経路探索に使うスレッドの数
+                           (double, plan_cache_horizon)); // 経路探索の結果を使い回す期間 [ms]
+};
+
+// Radioの設定
+struct radio_config {
+  BOOST_HANA_DEFINE_STRUCT(radio_config,
+                           (std::string, type),      // "grsim", "kiks" or "humanoid"
+                           (std::string, transport), // "udp" or "serial" (grsim は udp のみ)
+                           (std::string, address),
+                           (int, port),
+                           (std::string, device),
+                           (unsigned int, baud_rate),
+                           (std::string, protocol)); // kiks のフレームの版 ("v1" or "v2")
+};
+
+// WorldModelの設定
+struct world_config {
+  BOOST_HANA_DEFINE_STRUCT(world_config,
+                           (bool, va_filter),      // ロボットの速度/加速度を計算する
+                           (bool, ball_observer),  // ボールの状態オブザーバを有効にする
+                           (bool, robot_observer), // 自チームのロボットで状態オブザーバを使う
+                           (int, lost_duration));  // ロスト判定するまでの時間 [ms]
+};
+
+// Driverの設定
+struct driver_config {
+  BOOST_HANA_DEFINE_STRUCT(driver_config,
+                           (double, frequency), // 制御周期 [Hz]
+                           (std::size_t, threads), // Controller の計算に使うスレッドの数
+                           (bool, triggered_by_vision),
+                           (int, trigger_offset),   // vision 受信から周期開始までの時間 [us]
+                           (std::string, controller), // "state_feedback" or "trajectory"
+                           (double, velocity_limit_at_stopgame));
+};
+
+// スレッドの設定
+struct thread_config {
+  BOOST_HANA_DEFINE_STRUCT(thread_config,
+                           (std::vector<unsigned int>, cpus), // 実行する CPU (空なら制限しない)
+                           (int, priority)); // 正なら SCHED_FIFO の優先度, 0 なら通常
+};
+
+struct threads_config {
+  BOOST_HANA_DEFINE_STRUCT(threads_config,
+                           (thread_config, receiver),
+                           (thread_config, driver),
+                           (thread_config, game));
+};
+
+// 処理時間の記録の設定
+struct trace_config {
+  BOOST_HANA_DEFINE_STRUCT(trace_config,
+                           (bool, enabled),
+                           (std::string, output)); // 終了時に書き出すファイル (Chrome trace 形式)
+};
+
+struct config {
+  BOOST_HANA_DEFINE_STRUCT(config,
+                           (game_config, game),
+                           (endpoint_config, vision),
+                           (endpoint_config, refbox),
+                           (endpoint_config, robot),
+                           (radio_config, radio),
+                           (world_config, world),
+                           (driver_config, driver),
+                           (threads_config, threads),
+                           (trace_config, trace));
+};
+
+// 設定ファイルを読み込み, 値を検査する
+inline config load_config(const std::filesystem::path& path) {
+  std::ifstream ifs{path};
+  if (!ifs) throw std::runtime_error{fmt::format("failed to open '{}'", path.c_str())};
+  std::stringstream ss{};
+  ss << ifs.rdbuf();
+
+  const auto c = yamlizer::from_yaml<config>(ss.str());
+
+  const auto check = [](bool ok, const char* key, const std::string& value) {
+    if (!ok) throw std::runtime_error{fmt::format("invalid value for {}: '{}'", key, value)};
+  };
+  const auto& g = c.game;
+  check(g.team_color == "yellow" || g.team_color == "blue", "game.team_color", g.team_color);
+  for (const auto id : g.active_robots) {
+    check(id < max_robots, "game.active_robots",
+          fmt::format("{} (ID must be less than {})", id, max_robots));
+  }
+  check(g.planning_budget >= 0, "game.planning_budget", std::to_string(g.planning_budget));
+  check(g.plan_cache_horizon >= 0, "game.plan_cache_horizon",
+        std::to_string(g.plan_cache_horizon));
+  const auto& r = c.radio;
+  check(r.type == "grsim" || r.type == "kiks" || r.type == "humanoid", "radio.type", r.type);
+  check(r.transport == "udp" || (r.transport == "serial" && r.type != "grsim"),
+        "radio.transport", r.transport);
+  check(r.protocol == "v1" || r.protocol == "v2", "radio.protocol", r.protocol);
+  const auto& d = c.driver;
+  check(d.frequency > 0, "driver.frequency", std::to_string(d.frequency));
+  check(d.controller == "state_feedback" || d.controller == "trajectory", "driver.controller",
+        d.controller);
+
+  return c;
+}
+
+#endif // AI_SERVER_APP_AI_SERVER_CONFIG_H
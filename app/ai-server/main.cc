@@ -1 +1,644 @@
-auto main() -> int {}
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#ifdef AI_SERVER_HAS_NNABLA_EXT_CUDA
+#include <nbla/cuda/cudnn/init.hpp>
+#include <nbla/cuda/init.hpp>
+#endif
+
+#include "ai_server/controller/state_feedback.h"
+#include "ai_server/controller/trajectory.h"
+#include "ai_server/driver.h"
+#include "ai_server/filter/state_observer/ball.h"
+#include "ai_server/filter/state_observer/robot.h"
+#include "ai_server/filter/va_calculator.h"
+#include "ai_server/game/action/with_planner.h"
+#include "ai_server/game/captain/first.h"
+#include "ai_server/game/context.h"
+#include "ai_server/game/nnabla.h"
+#include "ai_server/game/planning_budget.h"
+#include "ai_server/logger/logger.h"
+#include "ai_server/logger/sink/ostream.h"
+#include "ai_server/model/team_color.h"
+#include "ai_server/model/updater/refbox.h"
+#include "ai_server/model/updater/world.h"
+#include "ai_server/planner/plan_cache.h"
+#include "ai_server/planner/service.h"
+#include "ai_server/radio/connection/serial.h"
+#include "ai_server/radio/connection/udp.h"
+#include "ai_server/radio/grsim.h"
+#include "ai_server/radio/humanoid.h"
+#include "ai_server/radio/kiks.h"
+#include "ai_server/receiver/refbox.h"
+#include "ai_server/receiver/robot.h"
+#include "ai_server/receiver/vision.h"
+#include "ai_server/util/thread.h"
+#include "ai_server/util/trace.h"
+
+#include "config.h"
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+
+namespace controller = ai_server::controller;
+namespace filter     = ai_server::filter;
+namespace game       = ai_server::game;
+namespace logger     = ai_server::logger;
+namespace model      = ai_server::model;
+namespace planner    = ai_server::planner;
+namespace radio      = ai_server::radio;
+namespace receiver   = ai_server::receiver;
+namespace util       = ai_server::util;
+
+// Vision を受信してから Game を開始するまでの時間 (状態オブザーバなどの値が収束するのを待つ)
+static constexpr auto ready_delay = 5s;
+
+// nnabla の設定
+std::vector<std::string> nnabla_backend() {
+#ifdef AI_SERVER_HAS_NNABLA_EXT_CUDA
+  return {"cudnn", "cuda", "cpu"};
+#else
+  return {"cpu"};
+#endif
+}
+
+std::string nnabla_device_id() {
+  return "0";
+}
+
+// .nnp ファイルの設定
+auto nnp_files(const std::filesystem::path& nnp_dir)
+    -> std::unordered_map<std::string, game::nnabla::nnp_file_type> {
+  return {
+      // { key, { path, 常に CPU で計算するか } }
+      {"probability", {nnp_dir / "game/detail/mcts/probability.nnp", true}},
+  };
+}
+
+// thread に config のアフィニティと優先度を設定する
+void apply_thread_config(std::thread& thread, const char* name, const thread_config& c,
+                         logger::logger& l) {
+  util::set_thread_name(thread, name);
+  if (!util::set_thread_affinity(thread, c.cpus)) {
+    l.warn(fmt::format("{}: failed to set cpu affinity {}", name, c.cpus));
+  }
+  if (c.priority != 0 && !util::set_thread_priority(thread, c.priority)) {
+    l.warn(fmt::format("{}: failed to set priority {}", name, c.priority));
+  }
+  l.info(fmt::format("{}: cpus = {}, priority = {}", name, c.cpus, c.priority));
+}
+
+// スコープを抜けるときに io_context と thread を stop(), join() する helper
+class stop_and_join_at_exit {
+  boost::asio::io_context& ctx_;
+  std::thread thread_;
+
+public:
+  stop_and_join_at_exit(const stop_and_join_at_exit&) = delete;
+  stop_and_join_at_exit(stop_and_join_at_exit&&)      = delete;
+
+  stop_and_join_at_exit(boost::asio::io_context& ctx, std::thread thread)
+      : ctx_{ctx}, thread_{std::move(thread)} {}
+
+  ~stop_and_join_at_exit() {
+    ctx_.stop();
+    thread_.join();
+  }
+};
+
+// Gameを行うクラス
+// --------------------------------
+class game_runner {
+public:
+  game_runner(const config& c, const std::filesystem::path& nnp_dir,
+              model::updater::world& world, model::updater::refbox& refbox,
+              ai_server::driver& driver, std::shared_ptr<radio::base::command> radio)
+      : running_{false},
+        config_{c},
+        cycle_{std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>{1.0 / c.driver.frequency})},
+        nnp_dir_{nnp_dir},
+        team_color_{c.game.team_color == "yellow" ? model::team_color::yellow
+                                                  : model::team_color::blue},
+        updater_world_{world},
+        updater_refbox_{refbox},
+        active_robots_{c.game.active_robots},
+        driver_{driver},
+        radio_{radio},
+        planning_budget_time_{std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>{c.game.planning_budget})},
+        planning_budget_{planning_budget_time_},
+        planning_service_{c.game.planning_threads},
+        plan_cache_{c.game.plan_cache_horizon > 0
+                        ? std::make_shared<planner::plan_cache>(
+                              std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                  std::chrono::duration<double, std::milli>{
+                                      c.game.plan_cache_horizon}))
+                        : nullptr},
+        l_{"game_runner"} {
+    auto lock = driver_.lock();
+    driver_.set_team_color(team_color_);
+
+    for (auto id : active_robots_) {
+      driver_.register_robot(id, make_controller(), radio_);
+    }
+
+    if (config_.world.robot_observer) {
+      for (auto id : active_robots_) set_state_observer(id);
+      on_command_updated_connection_ = driver_.on_command_updated([this](auto&&... args) {
+        handle_command_updated(std::forward<decltype(args)>(args)...);
+      });
+    }
+  }
+
+  ~game_runner() {
+    stop();
+  }
+
+  void start() {
+    std::unique_lock lock{mutex_};
+    if (!game_thread_.joinable()) {
+      running_     = true;
+      game_thread_ = std::thread([this] { main_loop(); });
+      apply_thread_config(game_thread_, "game_thread", config_.threads.game, l_);
+    }
+  }
+
+  void stop() {
+    running_ = false;
+    cv_.notify_all();
+    if (game_thread_.joinable()) game_thread_.join();
+  }
+
+private:
+  std::unique_ptr<controller::base> make_controller() const {
+    const auto cycle_count = std::chrono::duration<double>(cycle_).count();
+    if (config_.driver.controller == "trajectory") {
+      return std::make_unique<controller::trajectory>(cycle_count);
+    } else {
+      return std::make_unique<controller::state_feedback>(cycle_count);
+    }
+  }
+
+  void main_loop() {
+    l_.info("game started!");
+
+    game::context ctx{};
+    ctx.nnabla = std::make_unique<game::nnabla>(nnabla_backend(), nnabla_device_id(),
+                                                nnp_files(nnp_dir_));
+    ctx.plan_cache = plan_cache_;
+
+    model::refbox refbox{};
+    std::unique_ptr<game::captain::base> captain{};
+
+    std::chrono::steady_clock::time_point prev_time{};
+
+    for (;;) {
+      try {
+        std::unique_lock lock{mutex_};
+        // 前回の処理開始から cycle 待つ
+        if (cv_.wait_until(lock, prev_time + cycle_, [this] { return !running_; })) {
+          break; // その間に stop() されたらループを抜ける
+        }
+
+        AI_SERVER_TRACE_SCOPE("game_runner::main_loop");
+
+        const auto current_time = std::chrono::steady_clock::now();
+
+        const auto prev_cmd = refbox.command();
+
+        ctx.team_color = team_color_;
+        ctx.world      = updater_world_.value();
+        refbox         = updater_refbox_.value();
+
+        const auto current_cmd = refbox.command();
+
+        if (current_cmd != prev_cmd || !captain) {
+          if (current_cmd == model::refbox::game_command::stop) {
+            driver_.set_velocity_limit(config_.driver.velocity_limit_at_stopgame);
+          } else {
+            driver_.set_velocity_limit(std::numeric_limits<double>::max());
+          }
+        }
+
+        if (!captain) {
+          captain = std::make_unique<game::captain::first>(
+              ctx, refbox, std::set(active_robots_.cbegin(), active_robots_.cend()));
+        }
+
+        const auto formation = [&captain] {
+          AI_SERVER_TRACE_SCOPE("game::captain::execute");
+          return captain->execute();
+        }();
+        const auto actions = [&formation] {
+          AI_SERVER_TRACE_SCOPE("game::formation::execute");
+          return formation->execute();
+        }();
+
+        if (planning_service_.threads() > 0) {
+          execute_in_parallel(actions);
+        } else {
+          execute_in_order(actions, *captain);
+        }
+
+        prev_time = current_time;
+      } catch (const std::exception& e) {
+        l_.error(fmt::format("exception at game_thread\n\t{}", e.what()));
+      } catch (...) {
+        l_.error("unknown exception at game_thread");
+      }
+    }
+
+    // ロボットを全て停止させる
+    {
+      std::unique_lock lock{mutex_};
+      for (const auto& id : active_robots_) {
+        driver_.update_command(id, {});
+      }
+    }
+
+    for (const auto& [id, t] : plan_times_) {
+      l_.info(fmt::format("plan time of robot {}: mean {:.1f} us, max {:.1f} us", id,
+                          t.total / std::max<std::size_t>(t.count, 1), t.max));
+    }
+    if (plan_cache_) {
+      for (const auto& [id, s] : plan_cache_->robot_stats()) {
+        l_.info(fmt::format(
+            "plan cache of robot {}: hit rate {:.1f} % ({} / {}), {} invalidated", id,
+            100.0 * s.hit_rate(), s.hits, s.hits + s.misses, s.invalidations));
+      }
+    }
+
+    l_.info("game stopped!");
+  }
+
+  // action を順に実行する
+  // 経路探索の時間が決められていれば, captain の優先度に応じて割り振る
+  void execute_in_order(const std::vector<std::shared_ptr<game::action::base>>& actions,
+                        const game::captain::base& captain) {
+    const auto with_budget = planning_budget_time_.count() > 0;
+    if (with_budget) {
+      std::unordered_map<unsigned int, double> priorities{};
+      for (const auto& action : actions) {
+        if (std::dynamic_pointer_cast<game::action::with_planner>(action)) {
+          priorities.emplace(action->id(), captain.planning_priority(action->id()));
+        }
+      }
+      planning_budget_.start(std::move(priorities));
+    }
+
+    for (auto action : actions) {
+      AI_SERVER_TRACE_SCOPE("game::action::execute");
+      if (with_budget) {
+        if (auto p = std::dynamic_pointer_cast<game::action::with_planner>(action)) {
+          p->set_planning_deadline(planning_budget_.deadline(action->id()));
+        }
+      }
+      auto command = action->execute();
+      driver_.update_command(action->id(), command);
+    }
+  }
+
+  // action を順に実行し, 経路探索はまとめて planning_service_ で並列に行う
+  // 経路探索の時間が決められていれば, 全てのロボットが同じ期限まで探索する
+  void execute_in_parallel(const std::vector<std::shared_ptr<game::action::base>>& actions) {
+    std::vector<std::shared_ptr<game::action::with_planner>> planned{};
+    std::vector<planner::service::request> requests{};
+    {
+      AI_SERVER_TRACE_SCOPE("game::action::prepare");
+      for (auto action : actions) {
+        if (auto p = std::dynamic_pointer_cast<game::action::with_planner>(action)) {
+          if (auto r = p->prepare()) {
+            planned.push_back(p);
+            requests.push_back(*r);
+          } else {
+            driver_.update_command(p->id(), p->complete({}));
+          }
+        } else {
+          driver_.update_command(action->id(), action->execute());
+        }
+      }
+    }
+
+    if (planning_budget_time_.count() > 0) {
+      const auto deadline = std::chrono::steady_clock::now() + planning_budget_time_;
+      for (auto& r : requests) r.deadline = deadline;
+    }
+
+    const auto results = planning_service_.solve(requests);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      const auto& r = results[i];
+      driver_.update_command(r.id, planned[i]->complete(r.value));
+
+      const auto t = std::chrono::duration<double, std::micro>(r.time).count();
+      auto& s      = plan_times_[r.id];
+      s.total += t;
+      s.max = std::max(s.max, t);
+      ++s.count;
+    }
+  }
+
+  // id の state_observer を初期化する
+  void set_state_observer(unsigned int id) {
+    const auto lost_duration = std::chrono::milliseconds{config_.world.lost_duration};
+    auto f                   = [this, id, lost_duration](auto& updater) {
+      auto p = updater.template set_filter<filter::state_observer::robot>(id, lost_duration);
+      // 観測時刻に有効だった指令を Driver の履歴から取り出して使う
+      if (auto sp = p.lock()) sp->set_command_history(driver_.command_history(id));
+      state_observers_.at(id) = p;
+    };
+    if (team_color_ == model::team_color::yellow) {
+      f(updater_world_.robots_yellow_updater());
+    } else {
+      f(updater_world_.robots_blue_updater());
+    }
+  }
+
+  // contrtoller が新しい値を出力したときの処理
+  void handle_command_updated(model::team_color, unsigned int id,
+                              const model::command::kick_flag_t&, int, double, double,
+                              double) {
+    if (auto p = state_observers_.at(id).lock()) {
+      p->observe();
+    } else {
+      l_.warn(fmt::format("state_observer for id {} is not initialized / already dead", id));
+    }
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<bool> running_;
+
+  const config& config_;
+  std::chrono::steady_clock::duration cycle_;
+  std::filesystem::path nnp_dir_;
+
+  model::team_color team_color_;
+  model::updater::world& updater_world_;
+  model::updater::refbox& updater_refbox_;
+  std::vector<unsigned int> active_robots_;
+
+  ai_server::driver& driver_;
+
+  std::shared_ptr<radio::base::command> radio_;
+
+  // 1 周期に経路探索に使う時間 (0 なら planner ごとの設定で探索する)
+  std::chrono::steady_clock::duration planning_budget_time_;
+  game::planning_budget planning_budget_;
+  planner::service planning_service_;
+
+  // ロボットごとの経路探索にかかった時間 [us] (planning_service_ を使うときだけ記録する)
+  struct plan_time {
+    double total      = 0.0;
+    double max        = 0.0;
+    std::size_t count = 0;
+  };
+  std::unordered_map<unsigned int, plan_time> plan_times_;
+
+  // 経路探索の結果を使い回すためのもの (使わなければ nullptr)
+  std::shared_ptr<planner::plan_cache> plan_cache_;
+
+  std::thread game_thread_;
+
+  boost::signals2::scoped_connection on_command_updated_connection_;
+  std::array<std::weak_ptr<filter::state_observer::robot>, max_robots> state_observers_;
+
+  logger::logger l_;
+};
+
+// Radio を作る
+template <class Connection>
+std::shared_ptr<radio::base::command> make_radio(const radio_config& c,
+                                                 std::unique_ptr<Connection> con) {
+  if (c.type == "grsim") {
+    return std::make_shared<radio::grsim<Connection>>(std::move(con));
+  } else if (c.type == "kiks") {
+    auto r = std::make_shared<radio::kiks<Connection>>(std::move(con));
+    r->set_protocol(c.protocol == "v2" ? radio::kiks_protocol::v2 : radio::kiks_protocol::v1);
+    return r;
+  } else {
+    return std::make_shared<radio::humanoid<Connection>>(std::move(con));
+  }
+}
+
+auto main(int argc, char** argv) -> int {
+  logger::sink::ostream sink(std::cout, "{elapsed} {level:<5} {zone}: {message}");
+
+  logger::logger l{"main()"};
+
+  if (argc != 2) {
+    l.error(fmt::format("usage: {} <config.yaml>", argv[0]));
+    return -1;
+  }
+
+#ifdef AI_SERVER_HAS_NNABLA_EXT_CUDA
+  nbla::init_cudnn();
+#endif
+  l.info(fmt::format("nnabla: backend = {}, device_id = {}", nnabla_backend(),
+                     nnabla_device_id()));
+
+  try {
+    const auto config_path = std::filesystem::path{argv[1]};
+    l.info(fmt::format("configuration: {}", config_path.c_str()));
+    const auto c       = load_config(config_path);
+    const auto nnp_dir = weakly_canonical(config_path.parent_path() / c.game.nnp_dir);
+
+    // 各スレッドの処理時間を記録する
+    util::trace::set_enabled(c.trace.enabled);
+    l.info("trace: "s + (c.trace.enabled ? c.trace.output : "disabled"s));
+
+    // WorldModelの設定
+    model::updater::world updater_world{};
+    {
+      // ロボットの速度と加速度を計算するか
+      if (c.world.va_filter) {
+        updater_world.robots_blue_updater()
+            .set_default_filter<filter::va_calculator<model::robot>>();
+        updater_world.robots_yellow_updater()
+            .set_default_filter<filter::va_calculator<model::robot>>();
+      }
+      l.info("va filter (robot): "s + (c.world.va_filter ? "enabled"s : "disabled"s));
+      // ボールの状態オブザーバを使うか
+      if (c.world.ball_observer) {
+        updater_world.ball_updater().set_filter<filter::state_observer::ball>(
+            model::ball{}, std::chrono::system_clock::now());
+      }
+      l.info("state observer (ball): "s + (c.world.ball_observer ? "enabled"s : "disabled"s));
+      l.info("state observer (robot): "s +
+             (c.world.robot_observer ? "enabled"s : "disabled"s));
+    }
+
+    boost::asio::io_context receiver_io{1};
+
+    // Vision receiverの設定
+    std::atomic<bool> vision_received{false};
+    receiver::vision vision{receiver_io, "0.0.0.0", c.vision.address,
+                            static_cast<unsigned short>(c.vision.port)};
+    vision.on_receive([&updater_world, &vision_received, &l](auto&& p) {
+      if (!vision_received) {
+        // 最初に受信したときにメッセージを表示する
+        l.info("vision packet received!");
+        vision_received = true;
+      }
+      updater_world.update(std::forward<decltype(p)>(p));
+    });
+    l.info(fmt::format("vision: {}:{}", c.vision.address, c.vision.port));
+
+    // Refbox receiverの設定
+    std::atomic<bool> refbox_received{false};
+    model::updater::refbox updater_refbox{};
+    receiver::refbox refbox{receiver_io, "0.0.0.0", c.refbox.address,
+                            static_cast<unsigned short>(c.refbox.port)};
+    refbox.on_receive([&updater_refbox, &refbox_received, &l](auto&& p) {
+      if (!refbox_received) {
+        // 最初に受信したときにメッセージを表示する
+        l.info("refbox packet received!");
+        refbox_received = true;
+      }
+      updater_refbox.update(std::forward<decltype(p)>(p));
+    });
+    l.info(fmt::format("refbox: {}:{}", c.refbox.address, c.refbox.port));
+
+    // Robot receiverの設定
+    std::atomic<bool> robot_received{false};
+    receiver::robot robot{receiver_io, "0.0.0.0", c.robot.address,
+                          static_cast<unsigned short>(c.robot.port)};
+    robot.on_receive([&robot_received, &l](auto&&) {
+      if (!robot_received) {
+        // 最初に受信したときにメッセージを表示する
+        l.info("robot packet received!");
+        robot_received = true;
+      }
+    });
+    l.info(fmt::format("robot: {}:{}", c.robot.address, c.robot.port));
+
+    // receiver_ioに登録されたタスクを別スレッドで開始
+    std::thread receiver_thread{[&receiver_io, &l] {
+      try {
+        receiver_io.run();
+      } catch (std::exception& e) {
+        l.error(fmt::format("exception at receiver_thread: {}", e.what()));
+      }
+    }};
+    apply_thread_config(receiver_thread, "receiver_thread", c.threads.receiver, l);
+    stop_and_join_at_exit receiver_io_and_thread{receiver_io, std::move(receiver_thread)};
+
+    boost::asio::io_context driver_io{1};
+
+    // Radioの設定
+    auto radio = [&]() -> std::shared_ptr<radio::base::command> {
+      const auto& r = c.radio;
+      if (r.transport == "udp") {
+        auto con = std::make_unique<radio::connection::udp>(
+            driver_io, boost::asio::ip::udp::endpoint{boost::asio::ip::make_address(r.address),
+                                                      static_cast<unsigned short>(r.port)});
+        l.info(fmt::format("radio: {} ({}:{})", r.type, r.address, r.port));
+        return make_radio(r, std::move(con));
+      } else {
+        auto con = std::make_unique<radio::connection::serial>(
+            driver_io, r.device, radio::connection::serial::baud_rate(r.baud_rate));
+        l.info(fmt::format("radio: {} ({}, {} baud)", r.type, r.device, r.baud_rate));
+        return make_radio(r, std::move(con));
+      }
+    }();
+
+    // driver による命令の送信を別スレッドで開始
+    const auto cycle = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>{1.0 / c.driver.frequency});
+    ai_server::driver driver{driver_io, cycle, updater_world, model::team_color::yellow,
+                             c.driver.threads};
+    std::thread driver_thread{[&driver_io, &l] {
+      try {
+        driver_io.run();
+      } catch (std::exception& e) {
+        l.error(fmt::format("exception at driver_thread: {}", e.what()));
+      }
+    }};
+    apply_thread_config(driver_thread, "driver_thread", c.threads.driver, l);
+    stop_and_join_at_exit driver_io_and_thread{driver_io, std::move(driver_thread)};
+
+    // vision の受信を契機に driver の制御周期を開始する
+    boost::signals2::scoped_connection driver_trigger_connection{};
+    if (c.driver.triggered_by_vision) {
+      driver.set_trigger_offset(std::chrono::microseconds{c.driver.trigger_offset});
+      driver_trigger_connection =
+          updater_world.on_updated([&driver] { driver.notify_world_updated(); });
+    }
+    l.info("driver trigger: "s + (c.driver.triggered_by_vision ? "vision"s : "timer"s));
+
+    game_runner runner{c, nnp_dir, updater_world, updater_refbox, driver, radio};
+
+    // main_io では終了シグナルの待機と Game の開始を行う
+    boost::asio::io_context main_io{1};
+
+    boost::asio::signal_set signals{main_io, SIGINT, SIGTERM};
+    signals.async_wait([&main_io, &l](auto&& ec, int signal) {
+      if (!ec) l.info(fmt::format("signal {} received, shutting down", signal));
+      main_io.stop();
+    });
+
+    // Vision から値が取れたら, 状態オブザーバなどの値が収束するまでもう少し待って開始する
+    boost::asio::steady_timer ready_timer{main_io};
+    std::function<void(const boost::system::error_code&)> wait_for_vision =
+        [&](const boost::system::error_code& ec) {
+          if (ec) return;
+          if (!vision_received) {
+            ready_timer.expires_after(500ms);
+            ready_timer.async_wait(wait_for_vision);
+            return;
+          }
+          ready_timer.expires_after(ready_delay);
+          ready_timer.async_wait([&runner, &l](const boost::system::error_code& ec) {
+            if (ec) return;
+            l.info("ready!");
+            runner.start();
+          });
+        };
+    wait_for_vision({});
+
+    main_io.run();
+    runner.stop();
+
+    // runner.stop() で設定した停止命令が送信されるまで driver のサイクルを待ってから終了する
+    // (実行中のサイクルは停止前の命令を送信しうるので, 2 サイクル進むのを待つ)
+    {
+      const auto cycles   = driver.stats().cycles;
+      const auto deadline = std::chrono::steady_clock::now() + 10 * cycle;
+      while (driver.stats().cycles < cycles + 2 &&
+             std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(cycle / 4);
+      }
+    }
+
+    if (c.trace.enabled) {
+      std::ofstream ofs{config_path.parent_path() / c.trace.output};
+      util::trace::write_chrome_trace(ofs);
+      l.info(fmt::format("trace written to {}", c.trace.output));
+    }
+  } catch (std::exception& e) {
+    l.error(e.what());
+    return -1;
+  } catch (...) {
+    l.error("unknown error occurred");
+    return -1;
+  }
+}
@@ -0,0 +1,602 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <boost/geometry/geometries/segment.hpp>
+#include <boost/random.hpp>
+#include <Eigen/Core>
+#include <fmt/format.h>
+
+#include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/human_like.h"
+#include "ai_server/planner/obstacle_list.h"
+#include "ai_server/planner/plan_cache.h"
+#include "ai_server/planner/rrt_star.h"
+#include "ai_server/planner/service.h"
+#include "ai_server/planner/space_time.h"
+
+namespace planner = ai_server::planner;
+namespace model   = ai_server::model;
+
+static void usage(const char* name) {
+  std::cerr << "usage: " << name << " [options]\n"
+            << "  --trials=N              scenarios for each setting (default 20)\n"
+            << "  --cycles=N              planning cycles in each scenario (default 400)\n"
+            << "  --seed=N                random seed (default 0)\n"
+            << "  --threads=N             planning service threads (default: all cores)\n";
+}
+
+// 移動可能領域
+static const Eigen::Vector2d min_pos{-6000.0, -4500.0};
+static const Eigen::Vector2d max_pos{6000.0, 4500.0};
+
+// 1 周期に進む距離 (60Hz で 3m/s)
+static constexpr double step = 50.0;
+
+struct scenario {
+  Eigen::Vector2d start;
+  Eigen::Vector2d goal;
+  planner::obstacle_list obstacles;
+};
+
+// start と goal の間に片側に寄せた壁を置き, 残りのロボットを散らばらせる
+static scenario make_scenario(std::uint32_t seed) {
+  boost::random::mt19937 mt{seed};
+  boost::random::uniform_real_distribution<> x{-5000.0, 5000.0};
+  boost::random::uniform_real_distribution<> y{-4000.0, 4000.0};
+  boost::random::uniform_real_distribution<> offset{800.0, 1200.0};
+
+  scenario s{{-4000.0, y(mt) / 4}, {4000.0, y(mt) / 4}, {}};
+  const auto center = (mt() % 2 ? 1.0 : -1.0) * offset(mt);
+  for (int i = -5; i <= 5; ++i) {
+    s.obstacles.add(model::obstacle::point{{0.0, center + 400.0 * i}, 250.0});
+  }
+  while (s.obstacles.buffer().size() < 11 + 10) {
+    const Eigen::Vector2d p{x(mt), y(mt)};
+    if ((p - s.start).norm() < 600.0 || (p - s.goal).norm() < 600.0) continue;
+    s.obstacles.add(model::obstacle::point{p, 250.0});
+  }
+  return s;
+}
+
+struct result {
+  double time         = 0.0; // 計画にかかった時間の合計 [us]
+  double travelled    = 0.0; // 目的地に着くまでに移動した距離の合計 [mm]
+  std::size_t calls   = 0;
+  std::size_t reached = 0;
+};
+
+static void run(const scenario& s, int node_count, bool reuse, std::uint32_t seed,
+                int cycles, result& r) {
+  planner::rrt_star rrt{};
+  rrt.set_max_pos(max_pos);
+  rrt.set_min_pos(min_pos);
+  rrt.set_node_count(node_count);
+  rrt.set_reuse(reuse);
+  rrt.set_seed(seed);
+  const auto plan = rrt.planner();
+
+  Eigen::Vector2d pos = s.start;
+  double travelled    = 0.0;
+  for (int c = 0; c < cycles; ++c) {
+    const auto t0     = std::chrono::steady_clock::now();
+    const auto target = std::get<0>(plan(pos, s.goal, s.obstacles));
+    const auto t1     = std::chrono::steady_clock::now();
+
+    r.time += std::chrono::duration<double, std::micro>(t1 - t0).count();
+    ++r.calls;
+
+    if ((s.goal - pos).norm() < step) {
+      r.travelled += travelled + (s.goal - pos).norm();
+      ++r.reached;
+      return;
+    }
+    const Eigen::Vector2d d = target - pos;
+    const auto l            = std::min(step, d.norm());
+    if (l > 0.0) pos += l * d.normalized();
+    travelled += l;
+  }
+}
+
+// 11 台分の経路探索を planner::service でまとめて解き, 1 周期あたりの時間を返す [us]
+static double run_service(const std::vector<scenario>& scenarios, std::size_t threads,
+                          std::uint32_t seed, int cycles) {
+  constexpr std::size_t robots = 11;
+
+  std::vector<std::unique_ptr<planner::rrt_star>> planners{};
+  for (std::size_t i = 0; i < robots; ++i) {
+    auto p = std::make_unique<planner::rrt_star>();
+    p->set_max_pos(max_pos);
+    p->set_min_pos(min_pos);
+    p->set_node_count(100);
+    p->set_seed(seed + i);
+    planners.push_back(std::move(p));
+  }
+
+  std::vector<planner::service::request> requests{};
+  for (std::size_t i = 0; i < robots; ++i) {
+    const auto& s = scenarios[i % scenarios.size()];
+    requests.push_back({static_cast<unsigned int>(i), planners[i].get(), s.start, s.goal,
+                        &s.obstacles, std::nullopt});
+  }
+
+  planner::service service{threads};
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int c = 0; c < cycles; ++c) service.solve(requests);
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(t1 - t0).count() / cycles;
+}
+
+// 両陣のペナルティエリア
+static std::vector<planner::detail::distance_field::obstacle_type> penalty_areas() {
+  return {model::obstacle::box{{{-106000.0, -1000.0}, {-4800.0, 1000.0}}, 150.0},
+          model::obstacle::box{{{4800.0, -1000.0}, {106000.0, 1000.0}}, 150.0}};
+}
+
+// 障害物が n 個あるフィールド (ほとんどがロボットで, 軌跡とペナルティエリアを含む)
+// field を渡すと, ペナルティエリアを box として追加する代わりに field を設定する
+static planner::obstacle_list make_field(
+    std::size_t n, std::uint32_t seed,
+    std::shared_ptr<const planner::detail::distance_field> field = nullptr) {
+  boost::random::mt19937 mt{seed};
+  boost::random::uniform_real_distribution<> x{-5000.0, 5000.0};
+  boost::random::uniform_real_distribution<> y{-4000.0, 4000.0};
+  boost::random::uniform_real_distribution<> v{-500.0, 500.0};
+
+  planner::obstacle_list obs{};
+  if (field) {
+    obs.set_field(std::move(field));
+  } else {
+    for (const auto& o : penalty_areas()) obs.add(o);
+  }
+  for (std::size_t i = 2; i < n; ++i) {
+    const Eigen::Vector2d p{x(mt), y(mt)};
+    if (i % 5 == 0) {
+      obs.add(model::obstacle::segment{{p, p + Eigen::Vector2d{v(mt), v(mt)}}, 250.0});
+    } else {
+      obs.add(model::obstacle::point{p, 250.0});
+    }
+  }
+  return obs;
+}
+
+// 当たり判定 1 回あたりの時間を返す [ns]
+template <class F>
+static double measure(std::size_t queries, F&& f) {
+  std::size_t hits = 0;
+  const auto t0    = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < queries; ++i) hits += f(i);
+  const auto t1 = std::chrono::steady_clock::now();
+  // 最適化で消されないように結果を使う
+  if (hits == queries + 1) std::cerr << hits;
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / queries;
+}
+
+// RTree と, 種類ごとの配列 (scalar / simd) で当たり判定にかかる時間を比べる
+static void run_collision(std::uint32_t seed) {
+  namespace detail = planner::detail;
+  using segment_t  = boost::geometry::model::segment<Eigen::Vector2d>;
+  using kernel     = detail::obstacle_batch::kernel;
+  constexpr std::size_t queries = 100000;
+
+  // RRT* の枝くらいの長さの線分
+  boost::random::mt19937 mt{seed};
+  boost::random::uniform_real_distribution<> x{-6000.0, 6000.0};
+  boost::random::uniform_real_distribution<> y{-4500.0, 4500.0};
+  boost::random::uniform_real_distribution<> d{-1000.0, 1000.0};
+  std::vector<Eigen::Vector2d> starts{}, ends{}, dirs{};
+  for (std::size_t i = 0; i < 1024; ++i) {
+    starts.emplace_back(x(mt), y(mt));
+    ends.push_back(starts.back() + Eigen::Vector2d{d(mt), d(mt)});
+    dirs.push_back((ends.back() - starts.back()).normalized());
+  }
+  std::vector<double> lengths{};
+  for (int i = 1; i <= 20; ++i) lengths.push_back(100.0 * i);
+
+  fmt::print("\ncollision: ns/query ({})\n", detail::obstacle_batch::simd_available
+                                                     ? "simd is AVX2"
+                                                     : "simd is not available");
+  fmt::print("{:>9} {:>10} {:>10} {:>10} {:>12} {:>12} {:>12}\n", "obstacles", "rtree",
+             "scalar", "simd", "len rtree", "len scalar", "len simd");
+  for (const std::size_t n : {20, 30, 40}) {
+    const auto obs  = make_field(n, seed);
+    const auto tree = obs.to_tree();
+    auto batch      = obs.to_batch();
+
+    const auto segment = [&](const auto& o) {
+      return [&](std::size_t i) {
+        return detail::is_collided(segment_t{starts[i % 1024], ends[i % 1024]}, o);
+      };
+    };
+    const auto length = [&](const auto& o) {
+      return [&](std::size_t i) {
+        const auto it = detail::find_collided_length(lengths.begin(), lengths.end(),
+                                                     starts[i % 1024], dirs[i % 1024], o);
+        return it != lengths.end();
+      };
+    };
+
+    const auto rtree     = measure(queries, segment(tree));
+    const auto rtree_len = measure(queries, length(tree));
+    batch.set_kernel(kernel::scalar);
+    const auto scalar     = measure(queries, segment(batch));
+    const auto scalar_len = measure(queries, length(batch));
+    batch.set_kernel(kernel::simd);
+    const auto simd     = measure(queries, segment(batch));
+    const auto simd_len = measure(queries, length(batch));
+
+    fmt::print("{:>9} {:>10.1f} {:>10.1f} {:>10.1f} {:>12.1f} {:>12.1f} {:>12.1f}\n", n, rtree,
+               scalar, simd, rtree_len, scalar_len, simd_len);
+  }
+}
+
+// ペナルティエリアを box として追加するときと, distance_field で設定するときの時間を比べる
+static void run_static_field(std::uint32_t seed, int cycles) {
+  namespace detail = planner::detail;
+  using segment_t  = boost::geometry::model::segment<Eigen::Vector2d>;
+  constexpr std::size_t queries = 100000;
+
+  boost::random::mt19937 mt{seed};
+  boost::random::uniform_real_distribution<> x{-6000.0, 6000.0};
+  boost::random::uniform_real_distribution<> y{-4500.0, 4500.0};
+  boost::random::uniform_real_distribution<> d{-1000.0, 1000.0};
+  std::vector<Eigen::Vector2d> starts{}, ends{}, dirs{};
+  for (std::size_t i = 0; i < 1024; ++i) {
+    starts.emplace_back(x(mt), y(mt));
+    ends.push_back(starts.back() + Eigen::Vector2d{d(mt), d(mt)});
+    dirs.push_back((ends.back() - starts.back()).normalized());
+  }
+  std::vector<double> lengths{};
+  for (int i = 1; i <= 20; ++i) lengths.push_back(100.0 * i);
+
+  planner::human_like hl{};
+  hl.set_min_pos(min_pos);
+  hl.set_max_pos(max_pos);
+  const auto plan = hl.planner();
+
+  fmt::print("\nstatic field: 30 obstacles, penalty areas as boxes or distance_field\n");
+  fmt::print("{:>10} {:>8} {:>10} {:>10} {:>10} {:>10} {:>12}\n", "penalty", "build ms",
+             "seg rtree", "len rtree", "seg simd", "len simd", "human_like us");
+  for (const double resolution : {0.0, 10.0, 20.0, 50.0}) {
+    std::shared_ptr<const detail::distance_field> field{};
+    const auto t0 = std::chrono::steady_clock::now();
+    if (resolution > 0.0) {
+      field = std::make_shared<const detail::distance_field>(
+          penalty_areas(), min_pos - Eigen::Vector2d{500.0, 500.0},
+          max_pos + Eigen::Vector2d{500.0, 500.0}, resolution);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    const auto obs   = make_field(30, seed, field);
+    const auto tree  = obs.to_tree();
+    const auto batch = obs.to_batch();
+
+    const auto segment = [&](const auto& o) {
+      return [&](std::size_t i) {
+        return detail::is_collided(segment_t{starts[i % 1024], ends[i % 1024]}, o);
+      };
+    };
+    const auto length = [&](const auto& o) {
+      return [&](std::size_t i) {
+        const auto it = detail::find_collided_length(lengths.begin(), lengths.end(),
+                                                     starts[i % 1024], dirs[i % 1024], o);
+        return it != lengths.end();
+      };
+    };
+    const auto planning = [&](std::size_t i) {
+      return plan(starts[i % 1024], ends[(i + 1) % 1024], obs).first.x() > 0.0;
+    };
+
+    const auto name = resolution > 0.0 ? fmt::format("{:.0f} mm", resolution) : "boxes";
+    fmt::print("{:>10} {:>8.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>12.2f}\n", name,
+               std::chrono::duration<double, std::milli>(t1 - t0).count(),
+               measure(queries, segment(tree)), measure(queries, length(tree)),
+               measure(queries, segment(batch)), measure(queries, length(batch)),
+               measure(cycles, planning) / 1000.0);
+  }
+}
+
+// planner::human_like を 1ms あたりに呼び出せる回数を返す
+static void run_human_like(std::uint32_t seed, int cycles) {
+  boost::random::mt19937 mt{seed};
+  boost::random::uniform_real_distribution<> x{-6000.0, 6000.0};
+  boost::random::uniform_real_distribution<> y{-4500.0, 4500.0};
+  std::vector<Eigen::Vector2d> points{};
+  for (std::size_t i = 0; i < 1024; ++i) points.emplace_back(x(mt), y(mt));
+
+  planner::human_like hl{};
+  hl.set_min_pos(min_pos);
+  hl.set_max_pos(max_pos);
+  const auto plan = hl.planner();
+
+  fmt::print("\nhuman_like: calls/ms\n");
+  fmt::print("{:>9} {:>10}\n", "obstacles", "calls/ms");
+  for (const std::size_t n : {10, 20, 30, 40}) {
+    const auto obs   = make_field(n, seed);
+    const auto calls = [&](std::size_t i) {
+      return plan(points[i % 1024], points[(i * 7 + 1) % 1024], obs).first.x() > 0.0;
+    };
+    fmt::print("{:>9} {:>10.1f}\n", n, 1e6 / measure(cycles, calls));
+  }
+}
+
+// 止まっている 11 台のロボットが毎周期経路探索をする場面 (試合の中断中など) で,
+// planner::plan_cache で結果を使い回したときの時間と割合を比べる
+// 敵ロボットも止まっていて, 観測した位置には noise [mm] 以内の誤差がある
+static void run_plan_cache(std::uint32_t seed, int cycles) {
+  using namespace std::chrono_literals;
+
+  boost::random::mt19937 mt{seed};
+  boost::random::uniform_real_distribution<> x{-5000.0, 5000.0};
+  boost::random::uniform_real_distribution<> y{-4000.0, 4000.0};
+  std::vector<Eigen::Vector2d> ours{}, enemies{};
+  for (std::size_t i = 0; i < 11; ++i) ours.emplace_back(x(mt), y(mt));
+  for (std::size_t i = 0; i < 11; ++i) enemies.emplace_back(x(mt), y(mt));
+
+  planner::human_like hl{};
+  hl.set_min_pos(min_pos);
+  hl.set_max_pos(max_pos);
+  const auto plan = hl.planner();
+
+  fmt::print("\nplan_cache: 11 robots holding position, horizon 100 ms, resolution 20 mm\n");
+  fmt::print("{:>10} {:>12} {:>12} {:>10}\n", "noise [mm]", "off us/cyc", "on us/cyc",
+             "hit rate");
+  for (const double noise : {1.0, 3.0, 10.0, 30.0}) {
+    boost::random::uniform_real_distribution<> n{-noise, noise};
+    const auto observe = [&n, &mt](const Eigen::Vector2d& p) {
+      return Eigen::Vector2d{p.x() + n(mt), p.y() + n(mt)};
+    };
+
+    const auto run = [&](planner::plan_cache* cache) {
+      planner::plan_cache::clock_type::time_point now{};
+      double sum = 0.0;
+      const auto t0 = std::chrono::steady_clock::now();
+      for (int c = 0; c < cycles; ++c) {
+        now += 16ms;
+        planner::obstacle_list common{};
+        for (const auto& o : penalty_areas()) common.add(o);
+        for (const auto& e : enemies) common.add(model::obstacle::point{observe(e), 300.0});
+        common.share();
+
+        for (std::size_t i = 0; i < ours.size(); ++i) {
+          auto obs = common;
+          for (std::size_t j = 0; j < ours.size(); ++j) {
+            if (j != i) obs.add(model::obstacle::point{observe(ours[j]), 200.0});
+          }
+          const auto start = observe(ours[i]);
+          if (cache) {
+            const auto key = cache->make_key(start, ours[i], obs, hl);
+            if (const auto r = cache->find(i, key, start, obs, now)) {
+              sum += r->first.x();
+              continue;
+            }
+            const auto r = plan(start, ours[i], obs);
+            cache->store(i, key, r, now);
+            sum += r.first.x();
+          } else {
+            sum += plan(start, ours[i], obs).first.x();
+          }
+        }
+      }
+      const auto t1 = std::chrono::steady_clock::now();
+      // 最適化で消されないように結果を使う
+      if (std::isnan(sum)) std::cerr << sum;
+      return std::chrono::duration<double, std::micro>(t1 - t0).count() / cycles;
+    };
+
+    const auto off = run(nullptr);
+    planner::plan_cache cache{100ms};
+    const auto on = run(&cache);
+    fmt::print("{:>10.0f} {:>12.1f} {:>12.1f} {:>9.1f}%\n", noise, off, on,
+               100.0 * cache.stats().hit_rate());
+  }
+}
+
+// 動くロボットの間を通り抜ける場面 (ロボットは等速で動き, フィールドの端で跳ね返る)
+struct crowd {
+  Eigen::Vector2d start;
+  Eigen::Vector2d goal;
+  std::vector<std::pair<Eigen::Vector2d, Eigen::Vector2d>> robots; // 位置と速度
+};
+
+static crowd make_crowd(std::uint32_t seed) {
+  boost::random::mt19937 mt{seed};
+  boost::random::uniform_real_distribution<> x{-3000.0, 3000.0};
+  boost::random::uniform_real_distribution<> y{-4000.0, 4000.0};
+  boost::random::uniform_real_distribution<> speed{500.0, 2500.0};
+  boost::random::uniform_real_distribution<> angle{-3.14159265, 3.14159265};
+
+  crowd c{{-4500.0, y(mt) / 4}, {4500.0, y(mt) / 4}, {}};
+  while (c.robots.size() < 11) {
+    const Eigen::Vector2d p{x(mt), y(mt)};
+    if ((p - c.start).norm() < 800.0 || (p - c.goal).norm() < 800.0) continue;
+    const auto a = angle(mt);
+    c.robots.emplace_back(p, speed(mt) * Eigen::Vector2d{std::cos(a), std::sin(a)});
+  }
+  return c;
+}
+
+struct crowd_result {
+  double time         = 0.0; // 計画にかかった時間の合計 [us]
+  double elapsed      = 0.0; // 目的地に着くまでにかかった時間の合計 [s]
+  std::size_t calls   = 0;
+  std::size_t reached = 0;
+  std::size_t contact = 0; // 他のロボットに接触した周期の数
+};
+
+enum class crowd_planner { paths, points, space_time };
+
+// 60Hz で planner の目標位置へ向かって加速/減速しながら進む
+static void run_crowd(crowd c, crowd_planner kind, int cycles, crowd_result& r) {
+  constexpr double dt = 1.0 / 60, v_max = 3000.0, a_max = 3000.0;
+  constexpr double radius = 90.0, margin = 300.0;
+
+  planner::human_like hl{};
+  planner::space_time st{};
+  st.set_max_velocity(v_max);
+  st.set_max_acceleration(a_max);
+  for (planner::base* p : std::initializer_list<planner::base*>{&hl, &st}) {
+    p->set_max_pos(max_pos);
+    p->set_min_pos(min_pos);
+  }
+
+  Eigen::Vector2d pos = c.start;
+  Eigen::Vector2d vel = Eigen::Vector2d::Zero();
+  for (int i = 0; i < cycles; ++i) {
+    planner::obstacle_list obs{};
+    for (const auto& [p, v] : c.robots) {
+      switch (kind) {
+        case crowd_planner::paths: // model::obstacle::add_robot_paths と同じく 1s 分の軌跡
+          obs.add(model::obstacle::segment{{p, p + v}, margin});
+          break;
+        case crowd_planner::points:
+          obs.add(model::obstacle::point{p, margin});
+          break;
+        case crowd_planner::space_time:
+          obs.add(model::obstacle::moving_point{p, v, margin});
+          break;
+      }
+    }
+    st.set_velocity(vel);
+    auto& planner = kind == crowd_planner::space_time ? static_cast<planner::base&>(st) : hl;
+
+    const auto t0     = std::chrono::steady_clock::now();
+    const auto target = planner.planner()(pos, c.goal, obs).first;
+    const auto t1     = std::chrono::steady_clock::now();
+    r.time += std::chrono::duration<double, std::micro>(t1 - t0).count();
+    ++r.calls;
+
+    // 目標位置で止まれる速さで向かう
+    const Eigen::Vector2d d = target - pos;
+    const Eigen::Vector2d desired =
+        std::min(v_max, std::sqrt(2 * a_max * d.norm())) * d.stableNormalized();
+    Eigen::Vector2d dv = desired - vel;
+    if (dv.norm() > a_max * dt) dv = a_max * dt * dv.normalized();
+    vel += dv;
+    pos += vel * dt;
+
+    for (auto& [p, v] : c.robots) {
+      p += v * dt;
+      if (p.x() < min_pos.x() || max_pos.x() < p.x()) v.x() = -v.x();
+      if (p.y() < min_pos.y() || max_pos.y() < p.y()) v.y() = -v.y();
+      if ((p - pos).norm() < 2 * radius) ++r.contact;
+    }
+
+    if ((c.goal - pos).norm() < 50.0) {
+      r.elapsed += (i + 1) * dt;
+      ++r.reached;
+      return;
+    }
+  }
+}
+
+auto main(int argc, char** argv) -> int {
+  int trials         = 20;
+  int cycles         = 400;
+  std::uint32_t seed = 0;
+  std::size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view arg{argv[i]};
+      const auto eq = arg.find('=');
+      if (arg.substr(0, 2) != "--" || eq == std::string_view::npos) {
+        usage(argv[0]);
+        return arg == "--help" ? 0 : -1;
+      }
+      const auto key   = arg.substr(2, eq - 2);
+      const auto value = std::string{arg.substr(eq + 1)};
+
+      if (key == "trials") {
+        trials = std::stoi(value);
+      } else if (key == "cycles") {
+        cycles = std::stoi(value);
+      } else if (key == "seed") {
+        seed = std::stoul(value);
+      } else if (key == "threads") {
+        threads = std::stoul(value);
+      } else {
+        usage(argv[0]);
+        return -1;
+      }
+    }
+  } catch (std::exception& e) {
+    std::cerr << "invalid argument: " << e.what() << std::endl;
+    usage(argv[0]);
+    return -1;
+  }
+
+  std::vector<scenario> scenarios{};
+  for (int t = 0; t < trials; ++t) scenarios.push_back(make_scenario(seed + t));
+
+  // 移動した距離は start から goal までの直線距離との比で表す
+  double straight = 0.0;
+  for (const auto& s : scenarios) straight += (s.goal - s.start).norm();
+  straight /= trials;
+
+  fmt::print("rrt_star: {} scenarios, {} cycles, straight distance {:.0f} mm\n", trials, cycles,
+             straight);
+  fmt::print("{:>6} {:>6} {:>10} {:>10} {:>8}\n", "nodes", "reuse", "us/call", "travelled",
+             "reached");
+
+  for (const int node_count : {5, 10, 20, 50, 100}) {
+    for (const bool reuse : {false, true}) {
+      result r{};
+      for (int t = 0; t < trials; ++t) {
+        run(scenarios[t], node_count, reuse, seed + t, cycles, r);
+      }
+      fmt::print("{:>6} {:>6} {:>10.1f} {:>10.3f} {:>5}/{}\n", node_count, reuse ? "on" : "off",
+                 r.time / r.calls, r.reached ? r.travelled / r.reached / straight : 0.0,
+                 r.reached, trials);
+    }
+  }
+
+  // 全ロボットの経路探索をまとめて解くときのスレッド数による違い
+  fmt::print("\nservice: 11 robots, 100 nodes each\n");
+  fmt::print("{:>8} {:>10}\n", "threads", "us/cycle");
+  std::vector<std::size_t> counts{0};
+  for (std::size_t t = 1; t < threads; t *= 2) counts.push_back(t);
+  counts.push_back(threads);
+  for (const auto t : counts) {
+    fmt::print("{:>8} {:>10.1f}\n", t, run_service(scenarios, t, seed, cycles));
+  }
+
+
+  // 障害物の当たり判定の実装による違い
+  run_collision(seed);
+
+  // 動かない障害物の扱い方による違い
+  run_static_field(seed, cycles * 10);
+
+  // human_like の呼び出し回数
+  run_human_like(seed, cycles * 50);
+
+  // 止まっているロボットの経路探索の結果を使い回したときの違い
+  run_plan_cache(seed, cycles * 10);
+
+  // 動くロボットの扱い方による違い
+  fmt::print("\ncrowd: 11 moving robots, {} scenes\n", trials);
+  fmt::print("{:>11} {:>10} {:>10} {:>8} {:>8}\n", "planner", "us/call", "time [s]", "reached",
+             "contact");
+  for (const auto kind :
+       {crowd_planner::paths, crowd_planner::points, crowd_planner::space_time}) {
+    crowd_result r{};
+    for (int t = 0; t < trials; ++t) run_crowd(make_crowd(seed + t), kind, 600, r);
+    const auto name = kind == crowd_planner::paths    ? "paths"
+                      : kind == crowd_planner::points ? "points"
+                                                      : "space_time";
+    fmt::print("{:>11} {:>10.1f} {:>10.2f} {:>5}/{} {:>8}\n", name, r.time / r.calls,
+               r.reached ? r.elapsed / r.reached : 0.0, r.reached, trials, r.contact);
+  }
+}
@@ -0,0 +1,191 @@
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <boost/asio.hpp>
+
+#include <fmt/format.h>
+
+#include "ai_server/logger/logger.h"
+#include "ai_server/logger/sink/ostream.h"
+#include "ai_server/simulator/simulator.h"
+#include "ai_server/util/net/multicast/sender.h"
+
+using namespace std::chrono_literals;
+
+namespace logger    = ai_server::logger;
+namespace simulator = ai_server::simulator;
+namespace util      = ai_server::util;
+
+// 命令を受け付けるポート (grSim と同じ)
+static constexpr unsigned short default_command_port = 20011;
+// 検出データの送信先 (standalone-gui の設定に合わせる)
+static constexpr char default_vision_address[] = "224.5.23.2";
+static constexpr unsigned short default_vision_port = 10021;
+
+static void usage(const char* name) {
+  std::cerr
+      << "usage: " << name << " [options]\n"
+      << "  --command-port=PORT     grSim packet port (default 20011)\n"
+      << "  --vision-address=ADDR   vision multicast address (default 224.5.23.2)\n"
+      << "  --vision-port=PORT      vision multicast port (default 10021)\n"
+      << "  --speed=X               simulation speed relative to real time,\n"
+      << "                          0 runs as fast as possible (default 1)\n"
+      << "  --robots=N              robots placed for each team at startup (default 8)\n"
+      << "  --cameras=XxY           camera grid (default 2x2)\n"
+      << "  --noise=MM              stddev of position noise [mm] (default 0)\n"
+      << "  --latency=MS            vision latency [ms] (default 0)\n"
+      << "  --seed=N                random seed (default 0)\n";
+}
+
+// grSim 形式の命令を受け付け, 一定の周期でシミュレータを進めて検出データを送る
+class server {
+public:
+  server(boost::asio::io_context& io, std::shared_ptr<simulator::simulator> sim,
+         const simulator::config& config, unsigned short command_port,
+         const std::string& vision_address, unsigned short vision_port, double speed)
+      : io_{io},
+        sim_{std::move(sim)},
+        period_{config.frame_period},
+        speed_{speed},
+        socket_{io, {boost::asio::ip::udp::v4(), command_port}},
+        sender_{io, vision_address, static_cast<short>(vision_port)},
+        timer_{io},
+        l_{"simulator"} {}
+
+  void start() {
+    receive();
+    start_ = std::chrono::steady_clock::now();
+    tick(0);
+  }
+
+private:
+  void receive() {
+    socket_.async_receive_from(
+        boost::asio::buffer(buffer_), endpoint_, [this](const auto& ec, std::size_t size) {
+          if (ec == boost::asio::error::operation_aborted) return;
+          if (ec) {
+            l_.error(ec.message());
+          } else if (!sim_->apply(buffer_.data(), size)) {
+            l_.warn("failed to parse a grSim packet");
+          }
+          receive();
+        });
+  }
+
+  void tick(std::uint64_t n) {
+    sim_->advance(period_);
+    for (const auto& p : sim_->take_vision()) sender_.send(p.SerializeAsString());
+
+    if (speed_ <= 0) {
+      boost::asio::post(io_, [this, n] { tick(n + 1); });
+      return;
+    }
+
+    // 遅れが蓄積しないよう, 開始時刻を基準に次の時刻を決める
+    const auto next = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>{period_} * ((n + 1) / speed_));
+    timer_.expires_at(start_ + next);
+    timer_.async_wait([this, n](const auto& ec) {
+      if (!ec) tick(n + 1);
+    });
+  }
+
+  boost::asio::io_context& io_;
+  std::shared_ptr<simulator::simulator> sim_;
+  std::chrono::nanoseconds period_;
+  double speed_;
+
+  boost::asio::ip::udp::socket socket_;
+  boost::asio::ip::udp::endpoint endpoint_;
+  std::array<char, 65536> buffer_;
+  util::net::multicast::sender sender_;
+
+  boost::asio::steady_timer timer_;
+  std::chrono::steady_clock::time_point start_;
+
+  logger::logger l_;
+};
+
+auto main(int argc, char** argv) -> int {
+  logger::sink::ostream sink(std::cout, "{elapsed} {level:<5} {zone}: {message}");
+  logger::logger l{"main()"};
+
+  simulator::config config{};
+  config.robots_per_team      = 8;
+  unsigned short command_port = default_command_port;
+  std::string vision_address  = default_vision_address;
+  unsigned short vision_port  = default_vision_port;
+  double speed                = 1.0;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view arg{argv[i]};
+      const auto eq = arg.find('=');
+      if (arg.substr(0, 2) != "--" || eq == std::string_view::npos) {
+        usage(argv[0]);
+        return arg == "--help" ? 0 : -1;
+      }
+      const auto key   = arg.substr(2, eq - 2);
+      const auto value = std::string{arg.substr(eq + 1)};
+
+      if (key == "command-port") {
+        command_port = static_cast<unsigned short>(std::stoul(value));
+      } else if (key == "vision-address") {
+        vision_address = value;
+      } else if (key == "vision-port") {
+        vision_port = static_cast<unsigned short>(std::stoul(value));
+      } else if (key == "speed") {
+        speed = std::stod(value);
+      } else if (key == "robots") {
+        config.robots_per_team = std::stoul(value);
+      } else if (key == "cameras") {
+        std::size_t pos{};
+        config.cameras_x = std::stoul(value, &pos);
+        if (pos >= value.size() || value[pos] != 'x') throw std::invalid_argument{value};
+        config.cameras_y = std::stoul(value.substr(pos + 1));
+      } else if (key == "noise") {
+        config.position_noise = std::stod(value);
+      } else if (key == "latency") {
+        config.latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double, std::milli>{std::stod(value)});
+      } else if (key == "seed") {
+        config.seed = std::stoul(value);
+      } else {
+        usage(argv[0]);
+        return -1;
+      }
+    }
+  } catch (std::exception& e) {
+    l.error(fmt::format("invalid argument: {}", e.what()));
+    usage(argv[0]);
+    return -1;
+  }
+
+  try {
+    boost::asio::io_context io{1};
+    auto sim = std::make_shared<simulator::simulator>(config);
+    server s{io, sim, config, command_port, vision_address, vision_port, speed};
+
+    boost::asio::signal_set signals{io, SIGINT, SIGTERM};
+    signals.async_wait([&io](auto&&...) { io.stop(); });
+
+    l.info(fmt::format("command: 0.0.0.0:{}", command_port));
+    l.info(fmt::format("vision: {}:{}", vision_address, vision_port));
+    l.info(fmt::format("speed: {}, cameras: {}x{}, robots: {}", speed, config.cameras_x,
+                       config.cameras_y, config.robots_per_team));
+
+    s.start();
+    io.run();
+  } catch (std::exception& e) {
+    l.error(e.what());
+    return -1;
+  }
+
+  return 0;
+}
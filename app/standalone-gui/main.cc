@@ -29,6 +29,7 @@
 #endif
 
 #include "ai_server/controller/state_feedback.h"
+#include "ai_server/controller/trajectory.h"
 #include "ai_server/driver.h"
 #include "ai_server/filter/state_observer/ball.h"
 #include "ai_server/filter/state_observer/robot.h"
@@ -115,10 +116,28 @@ static constexpr short grsim_command_port = 20011;
 // 制御周期の設定
 static constexpr auto cycle =
     std::chrono::duration_cast<std::chrono::steady_clock::duration>(fps60_type{1});
+// Controller の計算に使うスレッドの数 (0 なら driver_thread で行う)
+static constexpr std::size_t driver_threads = 4;
+// vision の受信を契機に制御周期を開始するか
+static constexpr bool driver_triggered_by_vision = false;
+// vision を受信してから制御周期を開始するまでの時間
+static constexpr auto driver_trigger_offset = std::chrono::milliseconds{1};
 
 // stopgame時の速度制限
 static constexpr double velocity_limit_at_stopgame = 1400.0;
 
+// Controller の設定 (true なら trajectory, false なら state_feedback を使う)
+static constexpr bool use_trajectory_controller = false;
+
+std::unique_ptr<controller::base> make_controller() {
+  constexpr auto cycle_count = std::chrono::duration<double>(cycle).count();
+  if constexpr (use_trajectory_controller) {
+    return std::make_unique<controller::trajectory>(cycle_count);
+  } else {
+    return std::make_unique<controller::state_feedback>(cycle_count);
+  }
+}
+
 // nnabla の設定
 std::vector<std::string> nnabla_backend() {
 #ifdef AI_SERVER_HAS_NNABLA_EXT_CUDA
@@ -182,9 +201,7 @@ public:
     driver_.set_team_color(team_color_);
 
     for (auto id : active_robots_) {
-      constexpr auto cycle_count = std::chrono::duration<double>(cycle).count();
-      auto controller            = std::make_unique<controller::state_feedback>(cycle_count);
-      driver_.register_robot(id, std::move(controller), radio_);
+      driver_.register_robot(id, make_controller(), radio_);
     }
 
     if constexpr (use_robot_observer) {
@@ -230,9 +247,7 @@ public:
     // register new robots
     for (auto id : ids) {
       if (!driver_.registered(id)) {
-        constexpr auto cycle_count = std::chrono::duration<double>(cycle).count();
-        auto controller            = std::make_unique<controller::state_feedback>(cycle_count);
-        driver_.register_robot(id, std::move(controller), radio_);
+        driver_.register_robot(id, make_controller(), radio_);
         if constexpr (use_robot_observer) set_state_observer(id);
         changed = true;
       }
@@ -366,8 +381,10 @@ private:
   // id の state_observer を初期化する
   void set_state_observer(unsigned int id) {
     auto f = [this, id](auto& updater) {
-      state_observers_[id] =
-          updater.template set_filter<filter::state_observer::robot>(id, lost_duration);
+      auto p = updater.template set_filter<filter::state_observer::robot>(id, lost_duration);
+      // 観測時刻に有効だった指令を Driver の履歴から取り出して使う
+      if (auto sp = p.lock()) sp->set_command_history(driver_.command_history(id));
+      state_observers_[id] = p;
     };
     if (team_color_ == model::team_color::yellow) {
       f(updater_world_.robots_yellow_updater());
@@ -399,10 +416,10 @@ private:
 
   // contrtoller が新しい値を出力したときの処理
   void handle_command_updated(model::team_color, unsigned int id,
-                              const model::command::kick_flag_t&, int, double vx, double vy,
+                              const model::command::kick_flag_t&, int, double, double,
                               double) {
     if (auto p = state_observers_.at(id).lock()) {
-      p->observe(vx, vy);
+      p->observe();
     } else {
       l_.warn(fmt::format("state_observer for id {} is not initialized / already dead", id));
       return;
@@ -1421,7 +1438,8 @@ auto main(int argc, char** argv) -> int {
     }();
 
     // driver による命令の送信を別スレッドで開始
-    ai_server::driver driver{driver_io, cycle, updater_world, model::team_color::yellow};
+    ai_server::driver driver{driver_io, cycle, updater_world, model::team_color::yellow,
+                             driver_threads};
     std::thread driver_thread{[&driver_io, &l] {
       try {
         driver_io.run();
@@ -1432,6 +1450,15 @@ auto main(int argc, char** argv) -> int {
     util::set_thread_name(driver_thread, "driver_thread");
     stop_and_join_at_exit driver_io_and_thread{driver_io, std::move(driver_thread)};
 
+    // vision の受信を契機に driver の制御周期を開始する
+    boost::signals2::scoped_connection driver_trigger_connection{};
+    if constexpr (driver_triggered_by_vision) {
+      driver.set_trigger_offset(driver_trigger_offset);
+      driver_trigger_connection =
+          updater_world.on_updated([&driver] { driver.notify_world_updated(); });
+    }
+    l.info("driver trigger: "s + (driver_triggered_by_vision ? "vision"s : "timer"s));
+
     refbox_panel rp{updater_refbox};
 
     game_runner runner{config_dir, updater_world, rp.updater(), driver, radio};
@@ -20,5 +20,13 @@ void base::set_stable(const bool stable) {
   stable_flag_ = stable;
 }
 
+void base::set_command_history(std::shared_ptr<const model::command_history>) {
+  // 指令の履歴を使わない Controller では何もしない
+}
+
+void base::set_delay(double) {
+  // 遅延時間を補償しない Controller では何もしない
+}
+
 } // namespace controller
 } // namespace ai_server
@@ -1,6 +1,9 @@
 #ifndef AI_SERVER_CONTROLLER_BASE_H
 #define AI_SERVER_CONTROLLER_BASE_H
 
+#include <memory>
+
+#include "ai_server/model/command_history.h"
 #include "ai_server/model/field.h"
 #include "ai_server/model/robot.h"
 #include "ai_server/model/setpoint/types.h"
@@ -24,6 +27,14 @@ public:
   /// @param stable           true->安定,false->通常
   virtual void set_stable(const bool stable);
 
+  /// @brief                  送信した指令の履歴を設定する
+  /// @param history          Driver が書き込む指令の履歴
+  virtual void set_command_history(std::shared_ptr<const model::command_history> history);
+
+  /// @brief                  指令を送信してから観測されるまでの遅延時間を設定する
+  /// @param delay            遅延時間 [s]
+  virtual void set_delay(double delay);
+
   using result_type = std::tuple<double, double, double>;
 
   virtual result_type update(const model::robot& robot, const model::field& field,
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cmath>
+#include <boost/math/constants/constants.hpp>
+
+#include "bang_bang.h"
+
+namespace ai_server {
+namespace controller {
+namespace detail {
+
+bang_bang_1d::bang_bang_1d() : parts_{}, size_(0), p1_(0.0) {}
+
+void bang_bang_1d::generate(double p0, double v0, double p1, double v_max, double a_max) {
+  size_ = 0;
+  p1_   = p1;
+
+  double t = 0.0;
+  double p = p0;
+  double v = v0;
+  // 加速度 a で dt だけ進む区間を追加する
+  const auto add = [this, &t, &p, &v](double dt, double a) {
+    if (dt <= 0.0) return;
+    parts_[size_++] = {t, t + dt, p, v, a};
+    p += v * dt + 0.5 * a * dt * dt;
+    v += a * dt;
+    t += dt;
+  };
+
+  // 目標位置から遠ざかっているか, 減速しても目標位置を行き過ぎる場合はまず停止する
+  {
+    const auto d      = p1 - p;
+    const auto s_stop = v * std::abs(v) / (2.0 * a_max);
+    if (v != 0.0 && (std::signbit(v) != std::signbit(d) || std::abs(s_stop) > std::abs(d))) {
+      add(std::abs(v) / a_max, std::signbit(v) ? a_max : -a_max);
+      v = 0.0;
+    }
+  }
+
+  // 以降は目標位置の向きを正として考える
+  const auto dir = std::signbit(p1 - p) ? -1.0 : 1.0;
+  auto u         = dir * v;
+
+  // 最大速度を超えていれば最大速度まで減速する
+  if (u > v_max) {
+    add((u - v_max) / a_max, -dir * a_max);
+    u = v_max;
+  }
+
+  const auto distance = dir * (p1 - p);
+  const auto s_acc    = (v_max * v_max - u * u) / (2.0 * a_max);
+  const auto s_dec    = v_max * v_max / (2.0 * a_max);
+  if (s_acc + s_dec <= distance) {
+    // 台形: 最大速度まで加速し, 等速で進んでから減速する
+    add((v_max - u) / a_max, dir * a_max);
+    add((distance - s_acc - s_dec) / v_max, 0.0);
+    add(v_max / a_max, -dir * a_max);
+  } else {
+    // 三角形: 最大速度に達する前に減速を始める
+    const auto v_peak = std::sqrt(std::max(a_max * distance + 0.5 * u * u, u * u));
+    add((v_peak - u) / a_max, dir * a_max);
+    add(v_peak / a_max, -dir * a_max);
+  }
+}
+
+double bang_bang_1d::total_time() const {
+  return size_ > 0 ? parts_[size_ - 1].end : 0.0;
+}
+
+const bang_bang_1d::part* bang_bang_1d::find(double t) const {
+  for (std::size_t i = 0; i < size_; ++i) {
+    if (t < parts_[i].end) return &parts_[i];
+  }
+  return nullptr;
+}
+
+double bang_bang_1d::position(double t) const {
+  const auto q = find(t);
+  if (!q) return p1_;
+  const auto dt = std::max(t - q->begin, 0.0);
+  return q->p + q->v * dt + 0.5 * q->a * dt * dt;
+}
+
+double bang_bang_1d::velocity(double t) const {
+  const auto q = find(t);
+  if (!q) return 0.0;
+  const auto dt = std::max(t - q->begin, 0.0);
+  return q->v + q->a * dt;
+}
+
+double bang_bang_1d::acceleration(double t) const {
+  const auto q = find(t);
+  return q ? q->a : 0.0;
+}
+
+void bang_bang_2d::generate(const Eigen::Vector2d& p0, const Eigen::Vector2d& v0,
+                            const Eigen::Vector2d& p1, double v_max, double a_max) {
+  using boost::math::double_constants::half_pi;
+
+  // alpha を大きくするほど x 軸への配分が減り, x 軸の到達時刻は遅くなる
+  constexpr int max_iterations = 30;
+  constexpr double tolerance   = 1e-4;
+  double lo = 0.0, hi = half_pi;
+  for (int i = 0; i < max_iterations; ++i) {
+    const auto alpha = 0.5 * (lo + hi);
+    const auto c     = std::cos(alpha);
+    const auto s     = std::sin(alpha);
+    x_.generate(p0.x(), v0.x(), p1.x(), c * v_max, c * a_max);
+    y_.generate(p0.y(), v0.y(), p1.y(), s * v_max, s * a_max);
+
+    const auto diff = x_.total_time() - y_.total_time();
+    if (std::abs(diff) < tolerance) break;
+    (diff > 0.0 ? hi : lo) = alpha;
+  }
+}
+
+double bang_bang_2d::total_time() const {
+  return std::max(x_.total_time(), y_.total_time());
+}
+
+Eigen::Vector2d bang_bang_2d::position(double t) const {
+  return {x_.position(t), y_.position(t)};
+}
+
+Eigen::Vector2d bang_bang_2d::velocity(double t) const {
+  return {x_.velocity(t), y_.velocity(t)};
+}
+
+Eigen::Vector2d bang_bang_2d::acceleration(double t) const {
+  return {x_.acceleration(t), y_.acceleration(t)};
+}
+
+} // namespace detail
+} // namespace controller
+} // namespace ai_server
@@ -0,0 +1,95 @@
+#ifndef AI_SERVER_CONTROLLER_DETAIL_BANG_BANG_H
+#define AI_SERVER_CONTROLLER_DETAIL_BANG_BANG_H
+
+#include <array>
+#include <cstddef>
+#include <Eigen/Core>
+
+namespace ai_server {
+namespace controller {
+namespace detail {
+
+/// @class  bang_bang_1d
+/// @brief  速度と加速度の制限のもとで, 目標位置に停止するまでの時間が最短となる 1 次元の軌道
+///
+/// 加速, 等速, 減速の区間からなる台形 (あるいは三角形) の速度プロファイルを求める.
+/// 目標位置を行き過ぎてしまう場合は, 先に停止する区間が加わる. 動的なメモリ確保は行わない.
+class bang_bang_1d {
+public:
+  bang_bang_1d();
+
+  /// @brief  軌道を計算する
+  /// @param  p0 初期位置
+  /// @param  v0 初速度
+  /// @param  p1 目標位置
+  /// @param  v_max 最大速度 (正の値)
+  /// @param  a_max 最大加速度 (正の値)
+  void generate(double p0, double v0, double p1, double v_max, double a_max);
+
+  /// @brief  目標位置に停止するまでの時間
+  double total_time() const;
+
+  /// @brief  時刻 t での位置
+  double position(double t) const;
+  /// @brief  時刻 t での速度
+  double velocity(double t) const;
+  /// @brief  時刻 t での加速度
+  double acceleration(double t) const;
+
+private:
+  /// 加速度が一定の区間
+  struct part {
+    /// 区間の開始時刻と終了時刻
+    double begin;
+    double end;
+    /// 区間の開始時の位置と速度
+    double p;
+    double v;
+    double a;
+  };
+
+  /// 時刻 t を含む区間 (t が軌道の終了後なら nullptr)
+  const part* find(double t) const;
+
+  std::array<part, 4> parts_;
+  std::size_t size_;
+  /// 目標位置
+  double p1_;
+};
+
+/// @class  bang_bang_2d
+/// @brief  x, y の到達時刻が揃うように速度と加速度の制限を配分した 2 次元の軌道
+///
+/// 制限の大きさ (ベクトルのノルム) を角度 alpha で x, y に配分し, 両軸の到達時刻が一致する
+/// alpha を二分法で求める. 動的なメモリ確保は行わない.
+class bang_bang_2d {
+public:
+  /// @brief  軌道を計算する
+  /// @param  p0 初期位置
+  /// @param  v0 初速度
+  /// @param  p1 目標位置
+  /// @param  v_max 最大速度 (正の値)
+  /// @param  a_max 最大加速度 (正の値)
+  void generate(const Eigen::Vector2d& p0, const Eigen::Vector2d& v0, const Eigen::Vector2d& p1,
+                double v_max, double a_max);
+
+  /// @brief  目標位置に停止するまでの時間
+  double total_time() const;
+
+  /// @brief  時刻 t での位置
+  Eigen::Vector2d position(double t) const;
+  /// @brief  時刻 t での速度
+  Eigen::Vector2d velocity(double t) const;
+  /// @brief  時刻 t での加速度
+  Eigen::Vector2d acceleration(double t) const;
+
+private:
+  bang_bang_1d x_;
+  bang_bang_1d y_;
+};
+
+} // namespace detail
+} // namespace controller
+} // namespace ai_server
+
+#endif // AI_SERVER_CONTROLLER_DETAIL_BANG_BANG_H
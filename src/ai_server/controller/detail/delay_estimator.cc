@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+
+#include "delay_estimator.h"
+
+namespace ai_server {
+namespace controller {
+namespace detail {
+
+const double delay_estimator::lag_step_          = 0.005;
+const double delay_estimator::min_variance_      = 50.0 * 50.0;
+const double delay_estimator::min_correlation_   = 0.6;
+const double delay_estimator::plateau_tolerance_ = 1e-3;
+const double delay_estimator::smoothing_         = 0.2;
+const double delay_estimator::drift_threshold_   = 0.01;
+const std::size_t delay_estimator::update_step_  = 15;
+
+delay_estimator::delay_estimator(double initial_delay)
+    : count_(0),
+      last_update_(0),
+      delay_(initial_delay),
+      has_estimate_(false),
+      correlation_(0.0),
+      reported_delay_(initial_delay) {}
+
+void delay_estimator::observe(clock_type::time_point time, double vx, double vy) {
+  samples_[count_ % window_size] = {time, vx, vy};
+  ++count_;
+}
+
+std::optional<double> delay_estimator::update(const model::command_history& history) {
+  // 観測値が揃っていないか, 前回の推定から十分に観測値が増えていない
+  if (count_ < window_size || count_ - last_update_ < update_step_) return std::nullopt;
+  last_update_ = count_;
+
+  // 古い順に並べた観測値
+  const auto at = [this](std::size_t k) -> const sample& {
+    return samples_[(count_ - window_size + k) % window_size];
+  };
+
+  const auto to_duration = [](double t) {
+    return std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(t));
+  };
+
+  // 最も古い観測値から最大の遅延時間だけ遡った時刻以降の指令を取り出す
+  const auto from = at(0).time - to_duration(lag_step_ * (lag_size - 1));
+  std::array<model::command_history::entry, model::command_history::capacity> commands;
+  const auto last = history.copy_since(from, commands.begin());
+  const auto m    = static_cast<std::size_t>(std::distance(commands.begin(), last));
+  if (m == 0) return std::nullopt;
+
+  // 各遅延時間の候補について, 観測値とその時間だけ前の指令の相関係数を求める
+  std::array<double, lag_size> r;
+  for (std::size_t j = 0; j < lag_size; ++j) {
+    const auto lag = to_duration(lag_step_ * j);
+
+    double n = 0;
+    double so[2] = {}, sc[2] = {}, soo = 0, scc = 0, soc = 0;
+    std::size_t idx = 0;
+    for (std::size_t k = 0; k < window_size; ++k) {
+      const auto& s = at(k);
+      const auto t  = s.time - lag;
+      while (idx + 1 < m && commands[idx + 1].time <= t) ++idx;
+      // 時刻 t に有効だった指令が履歴に残っていない
+      if (t < commands[idx].time) continue;
+
+      const auto& c = commands[idx];
+      n += 1;
+      so[0] += s.vx;
+      so[1] += s.vy;
+      sc[0] += c.vx;
+      sc[1] += c.vy;
+      soo += s.vx * s.vx + s.vy * s.vy;
+      scc += c.vx * c.vx + c.vy * c.vy;
+      soc += s.vx * c.vx + s.vy * c.vy;
+    }
+
+    if (n < window_size / 2) {
+      r[j] = -1.0;
+      continue;
+    }
+
+    const auto var_o = soo / n - (so[0] * so[0] + so[1] * so[1]) / (n * n);
+    const auto var_c = scc / n - (sc[0] * sc[0] + sc[1] * sc[1]) / (n * n);
+    const auto cov   = soc / n - (so[0] * sc[0] + so[1] * sc[1]) / (n * n);
+
+    // 指令速度がほとんど変化していなければ遅延時間は決まらない
+    if (j == 0 && var_c < min_variance_) return std::nullopt;
+
+    r[j] = (var_o > 0 && var_c > 0) ? cov / std::sqrt(var_o * var_c) : -1.0;
+  }
+
+  const auto peak =
+      static_cast<std::size_t>(std::distance(r.begin(), std::max_element(r.begin(), r.end())));
+  correlation_ = r[peak];
+  if (correlation_ < min_correlation_) return std::nullopt;
+
+  // 指令は周期的にしか変化しないので, 相関係数が最大値とほぼ等しい候補が連続することがある
+  // その場合はその中央を, そうでなければ隣り合う候補から放物線補間した位置をとる
+  std::size_t lo = peak, hi = peak;
+  while (0 < lo && r[peak] - r[lo - 1] < plateau_tolerance_) --lo;
+  while (hi + 1 < lag_size && r[peak] - r[hi + 1] < plateau_tolerance_) ++hi;
+  double position = 0.5 * (lo + hi);
+  if (lo == hi && 0 < peak && peak + 1 < lag_size) {
+    const auto denom = r[peak - 1] - 2 * r[peak] + r[peak + 1];
+    if (denom < 0) position += std::clamp(0.5 * (r[peak - 1] - r[peak + 1]) / denom, -0.5, 0.5);
+  }
+  const auto measured = lag_step_ * position;
+
+  const auto estimate =
+      has_estimate_ ? (1 - smoothing_) * delay_.load() + smoothing_ * measured : measured;
+  delay_        = estimate;
+  has_estimate_ = true;
+
+  return estimate;
+}
+
+double delay_estimator::delay() const {
+  return delay_;
+}
+
+bool delay_estimator::has_estimate() const {
+  return has_estimate_;
+}
+
+double delay_estimator::correlation() const {
+  return correlation_;
+}
+
+std::optional<std::pair<double, double>> delay_estimator::take_drift() {
+  const auto current = delay_.load();
+  if (std::abs(current - reported_delay_) < drift_threshold_) return std::nullopt;
+
+  const auto prev = reported_delay_;
+  reported_delay_ = current;
+  return std::make_pair(prev, current);
+}
+
+} // namespace detail
+} // namespace controller
+} // namespace ai_server
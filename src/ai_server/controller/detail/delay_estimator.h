@@ -0,0 +1,90 @@
+#ifndef AI_SERVER_CONTROLLER_DETAIL_DELAY_ESTIMATOR_H
+#define AI_SERVER_CONTROLLER_DETAIL_DELAY_ESTIMATOR_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+#include "ai_server/model/command_history.h"
+
+namespace ai_server {
+namespace controller {
+namespace detail {
+
+/// @class  delay_estimator
+/// @brief  指令を送信してからその結果が観測されるまでの遅延時間の推定器
+///
+/// 送信した速度指令と観測した速度の相互相関をスライディングウィンドウ上で計算し,
+/// 相関が最大となるずれを遅延時間とする.
+/// observe() と update() は同じスレッドから呼び出すこと. delay() は任意のスレッドから呼び出せる.
+class delay_estimator {
+public:
+  using clock_type = model::command_history::clock_type;
+
+  /// 相関の計算に使う観測値の数
+  static constexpr std::size_t window_size = 45;
+  /// 探索する遅延時間の候補の数
+  static constexpr std::size_t lag_size = 41;
+
+private:
+  struct sample {
+    clock_type::time_point time;
+    double vx;
+    double vy;
+  };
+
+  static const double lag_step_;          // 遅延時間の候補の間隔 [s]
+  static const double min_variance_;      // 推定に必要な指令速度の分散 [(mm/s)^2]
+  static const double min_correlation_;   // 推定値として採用する相関係数の下限
+  static const double plateau_tolerance_; // 最大値と等しいとみなす相関係数の差
+  static const double smoothing_;         // 推定値の平滑化係数
+  static const double drift_threshold_;   // ドリフトとみなす推定値の変化 [s]
+  static const std::size_t update_step_;  // 推定を行う観測値の間隔
+
+  std::array<sample, window_size> samples_; // 観測値 (リングバッファ)
+  std::size_t count_;                       // これまでの観測値の数
+  std::size_t last_update_;                 // 前回推定を行ったときの観測値の数
+  std::atomic<double> delay_;               // 遅延時間の推定値 [s]
+  std::atomic<bool> has_estimate_;          // 推定値が得られたか
+  double correlation_;                      // 前回の推定での相関係数
+  double reported_delay_;                   // 前回ドリフトを報告したときの推定値 [s]
+
+public:
+  /// @brief  コンストラクタ
+  /// @param  initial_delay 推定値が得られるまでの遅延時間 [s]
+  explicit delay_estimator(double initial_delay);
+
+  /// @brief  観測した速度を追加する
+  /// @param  time 観測した時刻
+  /// @param  vx, vy フィールド基準の速度 [mm/s]
+  void observe(clock_type::time_point time, double vx, double vy);
+
+  /// @brief  遅延時間を推定する
+  ///
+  /// 観測値が一定数追加されるごとに推定を行う. 指令速度の変化が小さい場合や,
+  /// 相関が十分に得られない場合は推定値を更新しない
+  /// @param  history 送信した指令の履歴
+  /// @return 推定値が更新された場合はその値 [s]
+  std::optional<double> update(const model::command_history& history);
+
+  /// @brief  遅延時間の推定値 [s]
+  double delay() const;
+
+  /// @brief  推定値が一度でも得られたか
+  bool has_estimate() const;
+
+  /// @brief  前回の推定での相関係数
+  double correlation() const;
+
+  /// @brief  前回報告したときから推定値が閾値以上変化していれば報告する
+  /// @return (前回報告した値, 現在の値) [s]
+  std::optional<std::pair<double, double>> take_drift();
+};
+
+} // namespace detail
+} // namespace controller
+} // namespace ai_server
+
+#endif // AI_SERVER_CONTROLLER_DETAIL_DELAY_ESTIMATOR_H
@@ -1,8 +1,11 @@
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <iterator>
 #include <Eigen/Geometry>
 
 #include "smith_predictor.h"
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/angle.h"
 #include "ai_server/util/math/to_vector.h"
 
@@ -12,17 +15,45 @@ namespace detail {
 
 // 遅延は 40-60 [ms]
 // 参考: https://ssl.robocup.org/wp-content/uploads/2020/03/2020_ETDP_ZJUNlict.pdf
-const double smith_predictor::delay_ = 0.05;
+smith_predictor::smith_predictor(double cycle) : smith_predictor(cycle, 0.05) {}
 
-smith_predictor::smith_predictor(double cycle)
-    : cycle_(cycle), u_(static_cast<std::size_t>(delay_ / cycle), Eigen::Vector3d::Zero()) {}
+smith_predictor::smith_predictor(double cycle, double delay)
+    : delay_(delay),
+      cycle_(cycle),
+      u_(std::max<std::size_t>(static_cast<std::size_t>(delay / cycle), 1),
+         Eigen::Vector3d::Zero()) {}
+
+double smith_predictor::delay() const {
+  return delay_;
+}
+
+void smith_predictor::set_delay(double delay) {
+  delay_ = delay;
+  // 遅延時間分の制御入力を保持できるように伸縮する
+  const auto size = std::max<std::size_t>(static_cast<std::size_t>(delay / cycle_), 1);
+  while (u_.size() < size) u_.push_front(u_.front());
+  while (u_.size() > size) u_.pop_front();
+}
+
+void smith_predictor::set_command_history(
+    std::shared_ptr<const model::command_history> history) {
+  history_ = std::move(history);
+}
 
 Eigen::Matrix3d smith_predictor::interpolate(const model::robot& robot,
                                              const Eigen::Vector3d& u) {
+  return interpolate(robot, u, util::clock::system_now());
+}
+
+Eigen::Matrix3d smith_predictor::interpolate(
+    const model::robot& robot, const Eigen::Vector3d& u,
+    model::command_history::clock_type::time_point now) {
   // 回転による座標変化を考慮
   const Eigen::Vector3d corrected_u =
       Eigen::AngleAxisd(cycle_ * u.z(), Eigen::Vector3d::UnitZ()) * u;
 
+  if (history_) return interpolate_with_history(robot, corrected_u, now);
+
   const Eigen::Vector3d a = corrected_u - u_.back();
 
   Eigen::Vector3d p =
@@ -38,6 +69,41 @@ Eigen::Matrix3d smith_predictor::interpolate(const model::robot& robot,
 
   return (Eigen::Matrix3d() << p, corrected_u, a).finished();
 }
+
+Eigen::Matrix3d smith_predictor::interpolate_with_history(
+    const model::robot& robot, const Eigen::Vector3d& corrected_u,
+    model::command_history::clock_type::time_point now) {
+  using clock_type = model::command_history::clock_type;
+
+  const auto from =
+      now - std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(delay_));
+
+  std::array<model::command_history::entry, model::command_history::capacity> buf;
+  const auto first = buf.begin();
+  const auto last  = history_->copy_since(from, first);
+
+  // 各指令は次の指令が送信されるまで有効だったとして, 遅延時間内の移動量を積算する
+  Eigen::Vector3d p = util::math::position3d(robot);
+  for (auto it = first; it != last; ++it) {
+    const auto begin = std::max(it->time, from);
+    const auto end   = std::next(it) != last ? std::min(std::next(it)->time, now) : now;
+    if (end <= begin) continue;
+    p += std::chrono::duration<double>(end - begin).count() *
+         Eigen::Vector3d{it->vx, it->vy, it->omega};
+  }
+  // 正規化
+  p.z() = util::math::wrap_to_pi(p.z());
+
+  // 最新の指令の 1 つ前の指令との差分を加速度とする
+  const Eigen::Vector3d prev_u =
+      std::distance(first, last) >= 2
+          ? Eigen::Vector3d{std::prev(last, 2)->vx, std::prev(last, 2)->vy,
+                            std::prev(last, 2)->omega}
+          : Eigen::Vector3d::Zero();
+  const Eigen::Vector3d a = corrected_u - prev_u;
+
+  return (Eigen::Matrix3d() << p, corrected_u, a).finished();
+}
 } // namespace detail
 } // namespace controller
 } // namespace ai_server
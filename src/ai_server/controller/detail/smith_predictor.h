@@ -1,9 +1,12 @@
 #ifndef AI_SERVER_CONTROLLER_DETAIL_SMITH_PREDICTOR_H
 #define AI_SERVER_CONTROLLER_DETAIL_SMITH_PREDICTOR_H
 
+#include <chrono>
 #include <deque>
+#include <memory>
 #include <Eigen/Core>
 
+#include "ai_server/model/command_history.h"
 #include "ai_server/model/robot.h"
 
 namespace ai_server {
@@ -15,21 +18,52 @@ namespace detail {
 class smith_predictor {
 private:
   // 遅延時間 [s]
-  static const double delay_;
+  double delay_;
   // 制御周期
   const double cycle_;
   // 制御入力 (遅延時間分の補完用)
   std::deque<Eigen::Vector3d> u_;
+  // 実際に送信した指令の履歴 (設定されていれば u_ の代わりに使う)
+  std::shared_ptr<const model::command_history> history_;
+
+  // 送信時刻の付いた履歴を使って遅延時間分を補間する
+  Eigen::Matrix3d interpolate_with_history(const model::robot& robot,
+                                           const Eigen::Vector3d& corrected_u,
+                                           model::command_history::clock_type::time_point now);
 
 public:
   /// @brief  コンストラクタ
   /// @param  cycle 制御周期
   smith_predictor(double cycle);
 
+  /// @brief  コンストラクタ
+  /// @param  cycle 制御周期
+  /// @param  delay 遅延時間 [s]
+  smith_predictor(double cycle, double delay);
+
+  /// @brief  遅延時間 [s]
+  double delay() const;
+
+  /// @brief  遅延時間を設定する
+  /// @param  delay 遅延時間 [s]
+  void set_delay(double delay);
+
+  /// @brief  送信した指令の履歴を設定する
+  /// 設定すると, 1 周期ごとに指令が送られたと仮定する代わりに実際の送信時刻を使って補間する
+  /// @param  history 指令の履歴 (nullptr で解除)
+  void set_command_history(std::shared_ptr<const model::command_history> history);
+
   /// @brief  現在状態の推定
   /// @param  robot ロボット
   /// @param  u (前回)制御入力
   Eigen::Matrix3d interpolate(const model::robot& robot, const Eigen::Vector3d& u);
+
+  /// @brief  現在状態の推定
+  /// @param  robot ロボット
+  /// @param  u (前回)制御入力
+  /// @param  now 現在時刻 (履歴を使う場合に補間の終端となる)
+  Eigen::Matrix3d interpolate(const model::robot& robot, const Eigen::Vector3d& u,
+                              model::command_history::clock_type::time_point now);
 };
 
 } // namespace detail
@@ -19,7 +19,11 @@ const double humanoid::omega_max_ = 10.0;
 const double humanoid::alpha_max_ = 0.5 * pi<double>();
 
 humanoid::humanoid(const double cycle)
-    : base(v_max_), cycle_(cycle), velocity_generator_(cycle_), smith_predictor_(cycle_) {
+    : base(v_max_),
+      cycle_(cycle),
+      estimated_robot_(Eigen::Matrix3d::Zero()),
+      velocity_generator_(cycle_),
+      smith_predictor_(cycle_) {
   // 状態フィードバックゲイン
   // (s+k)^2=s^2+2ks+k^2=0
   // |sI-A|=s^2+(2ζω-k2ω^2)s+ω^2-k1ω^2
@@ -42,6 +46,14 @@ void humanoid::set_velocity_limit(const double limit) {
   base::set_velocity_limit(std::min(limit, v_max_));
 }
 
+void humanoid::set_command_history(std::shared_ptr<const model::command_history> history) {
+  smith_predictor_.set_command_history(std::move(history));
+}
+
+void humanoid::set_delay(double delay) {
+  smith_predictor_.set_delay(delay);
+}
+
 base::result_type humanoid::update(const model::robot& robot, const model::field& field,
                                    const model::setpoint::position& position,
                                    const model::setpoint::angle& angle) {
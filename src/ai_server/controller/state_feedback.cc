@@ -19,7 +19,11 @@ const double state_feedback::omega_max_ = 10.0;
 const double state_feedback::alpha_max_ = 2.0 * pi<double>();
 
 state_feedback::state_feedback(const double cycle)
-    : base(v_max_), cycle_(cycle), velocity_generator_(cycle_), smith_predictor_(cycle_) {
+    : base(v_max_),
+      cycle_(cycle),
+      estimated_robot_(Eigen::Matrix3d::Zero()),
+      velocity_generator_(cycle_),
+      smith_predictor_(cycle_) {
   // 状態フィードバックゲイン
   // (s+k)^2=s^2+2ks+k^2=0
   // |sI-A|=s^2+(2ζω-k2ω^2)s+ω^2-k1ω^2
@@ -42,6 +46,14 @@ void state_feedback::set_velocity_limit(const double limit) {
   base::set_velocity_limit(std::min(limit, v_max_));
 }
 
+void state_feedback::set_command_history(std::shared_ptr<const model::command_history> history) {
+  smith_predictor_.set_command_history(std::move(history));
+}
+
+void state_feedback::set_delay(double delay) {
+  smith_predictor_.set_delay(delay);
+}
+
 base::result_type state_feedback::update(const model::robot& robot, const model::field& field,
                                          const model::setpoint::position& position,
                                          const model::setpoint::angle& angle) {
@@ -63,6 +63,10 @@ public:
 
   void set_velocity_limit(double limit) override;
 
+  void set_command_history(std::shared_ptr<const model::command_history> history) override;
+
+  void set_delay(double delay) override;
+
   // 制御入力更新関数
   base::result_type update(const model::robot& robot, const model::field& field,
                            const model::setpoint::position& position,
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cmath>
+#include <boost/math/constants/constants.hpp>
+#include <Eigen/Geometry>
+
+#include "ai_server/util/math/angle.h"
+#include "trajectory.h"
+
+namespace ai_server {
+namespace controller {
+
+using boost::math::constants::pi;
+
+const double trajectory::v_max_     = 3000.0;
+const double trajectory::a_max_     = 5000.0;
+const double trajectory::omega_max_ = 10.0;
+const double trajectory::alpha_max_ = 2.0 * pi<double>();
+const double trajectory::margin_    = 400.0;
+
+trajectory::trajectory(double cycle)
+    : base(v_max_), cycle_(cycle), u_(Eigen::Vector3d::Zero()), smith_predictor_(cycle_) {}
+
+void trajectory::set_velocity_limit(double limit) {
+  base::set_velocity_limit(std::min(limit, v_max_));
+}
+
+void trajectory::set_command_history(std::shared_ptr<const model::command_history> history) {
+  smith_predictor_.set_command_history(std::move(history));
+}
+
+void trajectory::set_delay(double delay) {
+  smith_predictor_.set_delay(delay);
+}
+
+base::result_type trajectory::update(const model::robot& robot, const model::field& field,
+                                     const model::setpoint::position& position,
+                                     const model::setpoint::angle& angle) {
+  const auto state = estimate(robot);
+  const auto p     = clamp_to_field(field, std::get<0>(position), std::get<1>(position));
+  const auto v     = move_to(state, p.x(), p.y());
+  const auto omega = turn_to(state, std::get<0>(angle));
+  return output(state, {v.x(), v.y(), omega});
+}
+
+base::result_type trajectory::update(const model::robot& robot, const model::field& field,
+                                     const model::setpoint::position& position,
+                                     const model::setpoint::velangular& velangular) {
+  const auto state = estimate(robot);
+  const auto p     = clamp_to_field(field, std::get<0>(position), std::get<1>(position));
+  const auto v     = move_to(state, p.x(), p.y());
+  const auto omega = accelerate_to(state, std::get<0>(velangular));
+  return output(state, {v.x(), v.y(), omega});
+}
+
+base::result_type trajectory::update(const model::robot& robot, const model::field& field,
+                                     const model::setpoint::velocity& velocity,
+                                     const model::setpoint::angle& angle) {
+  const auto state  = estimate(robot);
+  const auto target = limit_to_field(state, field, velocity);
+  const auto v      = accelerate_to(state, target.x(), target.y());
+  const auto omega  = turn_to(state, std::get<0>(angle));
+  return output(state, {v.x(), v.y(), omega});
+}
+
+base::result_type trajectory::update(const model::robot& robot, const model::field& field,
+                                     const model::setpoint::velocity& velocity,
+                                     const model::setpoint::velangular& velangular) {
+  const auto state  = estimate(robot);
+  const auto target = limit_to_field(state, field, velocity);
+  const auto v      = accelerate_to(state, target.x(), target.y());
+  const auto omega  = accelerate_to(state, std::get<0>(velangular));
+  return output(state, {v.x(), v.y(), omega});
+}
+
+double trajectory::a_max() const {
+  return stable_flag_ ? 0.5 * a_max_ : a_max_;
+}
+
+Eigen::Matrix3d trajectory::estimate(const model::robot& robot) {
+  // ロボットは指令した速度で動いているとみなし, 遅延時間分だけ進めた状態を現在の状態とする
+  return smith_predictor_.interpolate(robot, u_);
+}
+
+Eigen::Vector2d trajectory::move_to(const Eigen::Matrix3d& state, double x, double y) {
+  const Eigen::Vector2d p = state.col(0).head<2>();
+  const Eigen::Vector2d v = state.col(1).head<2>();
+  const Eigen::Vector2d target{x, y};
+  translation_.generate(p, v, target, std::min(v_max_, velocity_limit_), a_max());
+
+  // 1 周期後の軌道上の速度を指令する
+  // ただし 1 周期以内に到達する場合は, 目標位置で止まるように平均の速度に近づける
+  if (translation_.total_time() < cycle_) {
+    const Eigen::Vector2d average = (target - p) / cycle_;
+    return accelerate_to(state, average.x(), average.y());
+  }
+  return translation_.velocity(cycle_);
+}
+
+double trajectory::turn_to(const Eigen::Matrix3d& state, double theta) {
+  const auto p      = state(2, 0);
+  const auto v      = state(2, 1);
+  const auto target = p + util::math::wrap_to_pi(theta - p);
+  rotation_.generate(p, v, target, omega_max_, alpha_max_);
+
+  if (rotation_.total_time() < cycle_) return accelerate_to(state, (target - p) / cycle_);
+  return rotation_.velocity(cycle_);
+}
+
+Eigen::Vector2d trajectory::clamp_to_field(const model::field& field, double x,
+                                           double y) const {
+  return {std::clamp(x, field.x_min() - margin_, field.x_max() + margin_),
+          std::clamp(y, field.y_min() - margin_, field.y_max() + margin_)};
+}
+
+Eigen::Vector2d trajectory::limit_to_field(const Eigen::Matrix3d& state,
+                                           const model::field& field,
+                                           const model::setpoint::velocity& velocity) const {
+  const auto vx = std::get<0>(velocity);
+  const auto vy = std::get<1>(velocity);
+
+  // 想定加速度で減速して止まれる速度
+  const auto limited_speed = [acc = a_max()](double distance) {
+    return std::sqrt(2.0 * acc * std::max(distance, 0.0));
+  };
+  // 移動可能範囲の端までの距離
+  const Eigen::Vector2d p      = state.col(0).head<2>();
+  const Eigen::Vector2d m      = Eigen::Vector2d::Constant(margin_);
+  const Eigen::Vector2d to_max = Eigen::Vector2d{field.x_max(), field.y_max()} + m - p;
+  const Eigen::Vector2d to_min = Eigen::Vector2d{field.x_min(), field.y_min()} - m - p;
+  const auto x = std::clamp(vx, -limited_speed(-to_min.x()), limited_speed(to_max.x()));
+  const auto y = std::clamp(vy, -limited_speed(-to_min.y()), limited_speed(to_max.y()));
+
+  // 向きを変えないように, x, y のうち強く制限される方の比率で全体を縮める
+  const auto ratio = [](double before, double after) {
+    return before == 0.0 ? 1.0 : after / before;
+  };
+  const auto r = std::min(ratio(vx, x), ratio(vy, y));
+  return {r * vx, r * vy};
+}
+
+Eigen::Vector2d trajectory::accelerate_to(const Eigen::Matrix3d& state, double vx,
+                                          double vy) const {
+  const Eigen::Vector2d v = state.col(1).head<2>();
+
+  Eigen::Vector2d target{vx, vy};
+  const auto v_max = std::min(v_max_, velocity_limit_);
+  if (target.norm() > v_max) target = v_max * target.normalized();
+
+  // 1 周期で変化できる量に制限する
+  Eigen::Vector2d dv = target - v;
+  const auto dv_max  = a_max() * cycle_;
+  if (dv.norm() > dv_max) dv = dv_max * dv.normalized();
+  return v + dv;
+}
+
+double trajectory::accelerate_to(const Eigen::Matrix3d& state, double omega) const {
+  const auto w      = state(2, 1);
+  const auto target = std::clamp(omega, -omega_max_, omega_max_);
+  return std::clamp(target, w - alpha_max_ * cycle_, w + alpha_max_ * cycle_);
+}
+
+base::result_type trajectory::output(const Eigen::Matrix3d& state, const Eigen::Vector3d& u) {
+  // nanが入ったら前回入力を今回値とする
+  if (!std::isnan(u.x()) && !std::isnan(u.y()) && !std::isnan(u.z())) u_ = u;
+
+  // ロボット基準の速度に変換する
+  const Eigen::Vector3d r = Eigen::AngleAxisd(-state(2, 0), Eigen::Vector3d::UnitZ()) * u_;
+  return {r.x(), r.y(), r.z()};
+}
+
+} // namespace controller
+} // namespace ai_server
@@ -0,0 +1,91 @@
+#ifndef AI_SERVER_CONTROLLER_TRAJECTORY_H
+#define AI_SERVER_CONTROLLER_TRAJECTORY_H
+
+#include <memory>
+#include <Eigen/Core>
+
+#include "ai_server/controller/detail/bang_bang.h"
+#include "ai_server/controller/detail/smith_predictor.h"
+#include "base.h"
+
+namespace ai_server {
+namespace controller {
+
+/// @class  trajectory
+/// @brief  目標までの時間最適な軌道を毎周期計画し, それに沿う速度を出力する Controller
+///
+/// 遅延を補償して推定した現在の状態から, 速度と加速度の制限のもとで x, y の到達時刻を揃えた
+/// 軌道 (detail::bang_bang_2d) と回転の軌道 (detail::bang_bang_1d) を求め,
+/// 次の 1 周期の間に軌道上を進む量から指令速度を決める.
+/// state_feedback と同じく, フィールドの外枠から 400 mm 以上は出ないように目標を制限する.
+/// 指令の履歴が設定されていれば, update() の中で動的なメモリ確保は行わない.
+class trajectory : public base {
+private:
+  const double cycle_;            // 制御周期
+  static const double v_max_;     // 最大速度
+  static const double a_max_;     // 最大加速度
+  static const double omega_max_; // 最大角速度
+  static const double alpha_max_; // 最大角加速度
+  static const double margin_;    // フィールドの外枠から出られる距離
+  Eigen::Vector3d u_;             // 前回の指令値 (フィールド基準)
+  detail::smith_predictor smith_predictor_;
+  detail::bang_bang_2d translation_;
+  detail::bang_bang_1d rotation_;
+
+  // 安定制御用flagを考慮した最大加速度
+  double a_max() const;
+
+  // 遅延時間分を補間した現在の状態
+  Eigen::Matrix3d estimate(const model::robot& robot);
+
+  // 目標位置に向かう並進速度
+  Eigen::Vector2d move_to(const Eigen::Matrix3d& state, double x, double y);
+
+  // 目標角度に向かう角速度
+  double turn_to(const Eigen::Matrix3d& state, double theta);
+
+  // 目標位置をフィールドの外枠から margin_ 以内に収める
+  Eigen::Vector2d clamp_to_field(const model::field& field, double x, double y) const;
+
+  // 移動可能範囲の端で止まれるように目標速度を制限する (state_feedback と同じ制限)
+  Eigen::Vector2d limit_to_field(const Eigen::Matrix3d& state, const model::field& field,
+                                 const model::setpoint::velocity& velocity) const;
+
+  // 加速度の制限のもとで目標速度に近づける
+  Eigen::Vector2d accelerate_to(const Eigen::Matrix3d& state, double vx, double vy) const;
+
+  // 角加速度の制限のもとで目標角速度に近づける
+  double accelerate_to(const Eigen::Matrix3d& state, double omega) const;
+
+  // フィールド基準の指令値を記録し, ロボット基準に変換して返す
+  base::result_type output(const Eigen::Matrix3d& state, const Eigen::Vector3d& u);
+
+public:
+  /// @param cycle            制御周期 [s]
+  explicit trajectory(double cycle);
+
+  void set_velocity_limit(double limit) override;
+
+  void set_command_history(std::shared_ptr<const model::command_history> history) override;
+
+  void set_delay(double delay) override;
+
+  base::result_type update(const model::robot& robot, const model::field& field,
+                           const model::setpoint::position& position,
+                           const model::setpoint::angle& angle) override;
+  base::result_type update(const model::robot& robot, const model::field& field,
+                           const model::setpoint::position& position,
+                           const model::setpoint::velangular& velangular) override;
+
+  base::result_type update(const model::robot& robot, const model::field& field,
+                           const model::setpoint::velocity& velocity,
+                           const model::setpoint::angle& angle) override;
+  base::result_type update(const model::robot& robot, const model::field& field,
+                           const model::setpoint::velocity& velocity,
+                           const model::setpoint::velangular& velangular) override;
+};
+
+} // namespace controller
+} // namespace ai_server
+
+#endif // AI_SERVER_CONTROLLER_TRAJECTORY_H
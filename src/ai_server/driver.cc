@@ -1,5 +1,7 @@
 #include <algorithm>
 #include <cmath>
+#include <condition_variable>
+#include <exception>
 #include <stdexcept>
 #include <type_traits>
 #include <variant>
@@ -12,15 +14,47 @@
 #include "ai_server/model/motion/walk_forward.h"
 #include "ai_server/model/motion/walk_left.h"
 #include "ai_server/model/motion/walk_right.h"
+#include "ai_server/util/clock.h"
+#include "ai_server/util/trace.h"
 #include "driver.h"
 
 namespace ai_server {
 
+// 推定値が得られるまでの遅延時間 [s]
+static constexpr double initial_delay = 0.05;
+
+// world の更新を契機に動作するとき, 更新が途絶えてからサイクルを開始するまでの時間 (制御周期の何倍か)
+static constexpr auto fallback_ratio = 1.5;
+
 driver::driver(boost::asio::io_context& io_context, std::chrono::steady_clock::duration cycle,
                const model::updater::world& world, model::team_color color)
-    : timer_(io_context), cycle_(cycle), world_(world), team_color_(color) {
+    : driver(io_context, cycle, world, color, 0) {}
+
+driver::driver(boost::asio::io_context& io_context, std::chrono::steady_clock::duration cycle,
+               const model::updater::world& world, model::team_color color,
+               std::size_t threads)
+    : cycle_(cycle),
+      triggered_(false),
+      pool_(threads > 0 ? std::make_unique<boost::asio::thread_pool>(threads) : nullptr),
+      world_(world),
+      team_color_(color),
+      stats_{} {
   // タイマが開始されたらdriver::main_loop()が呼び出されるように設定
-  timer_.async_wait([this](auto&& error) { main_loop(std::forward<decltype(error)>(error)); });
+  timer_.emplace(io_context);
+  timer_->async_wait([this](auto&& error) { main_loop(std::forward<decltype(error)>(error)); });
+}
+
+driver::driver(std::chrono::steady_clock::duration cycle, const model::updater::world& world,
+               model::team_color color, std::size_t threads)
+    : cycle_(cycle),
+      triggered_(false),
+      pool_(threads > 0 ? std::make_unique<boost::asio::thread_pool>(threads) : nullptr),
+      world_(world),
+      team_color_(color),
+      stats_{} {}
+
+driver::~driver() {
+  if (pool_) pool_->join();
 }
 
 model::team_color driver::team_color() const {
@@ -45,19 +79,30 @@ boost::signals2::connection driver::on_command_updated_extended(
 
 void driver::set_velocity_limit(double limit) {
   std::unique_lock lock(mutex_);
-  for (auto&& meta : robots_metadata_) std::get<1>(meta.second)->set_velocity_limit(limit);
+  for (auto&& [id, meta] : robots_metadata_) {
+    std::unique_lock robot_lock(meta->mutex);
+    meta->controller->set_velocity_limit(limit);
+  }
 }
 
 void driver::set_stable(const bool stable) {
   std::unique_lock lock(mutex_);
-  for (auto&& meta : robots_metadata_) std::get<1>(meta.second)->set_stable(stable);
+  for (auto&& [id, meta] : robots_metadata_) {
+    std::unique_lock robot_lock(meta->mutex);
+    meta->controller->set_stable(stable);
+  }
 }
 
 void driver::register_robot(unsigned int id, controller_type controller, radio_type radio) {
   std::unique_lock lock(mutex_);
-  robots_metadata_.emplace(
-      std::piecewise_construct, std::forward_as_tuple(id),
-      std::forward_as_tuple(model::command{}, std::move(controller), std::move(radio)));
+  auto meta             = std::make_shared<metadata_type>();
+  meta->command_version = 0;
+  meta->controller      = std::move(controller);
+  meta->radio           = std::move(radio);
+  meta->history         = std::make_shared<model::command_history>();
+  meta->estimator       = std::make_unique<controller::detail::delay_estimator>(initial_delay);
+  if (meta->controller) meta->controller->set_command_history(meta->history);
+  robots_metadata_.emplace(id, std::move(meta));
 }
 
 void driver::unregister_robot(unsigned int id) {
@@ -70,51 +115,313 @@ bool driver::registered(unsigned int id) const {
   return robots_metadata_.count(id);
 }
 
+std::shared_ptr<const model::command_history> driver::command_history(unsigned int id) const {
+  std::unique_lock lock(mutex_);
+
+  // ロボットが登録されていなかったらエラー
+  if (auto it = robots_metadata_.find(id); it != robots_metadata_.end()) {
+    return it->second->history;
+  } else {
+    throw not_registered(id);
+  }
+}
+
+std::optional<double> driver::estimated_delay(unsigned int id) const {
+  std::unique_lock lock(mutex_);
+
+  // ロボットが登録されていなかったらエラー
+  if (auto it = robots_metadata_.find(id); it != robots_metadata_.end()) {
+    auto& meta = *it->second;
+    std::unique_lock robot_lock(meta.mutex);
+    if (!meta.estimator->has_estimate()) return std::nullopt;
+    return meta.estimator->delay();
+  } else {
+    throw not_registered(id);
+  }
+}
+
 void driver::update_command(unsigned int id, const model::command& command) {
   std::unique_lock lock(mutex_);
 
   // ロボットが登録されていなかったらエラー
   if (auto it = robots_metadata_.find(id); it != robots_metadata_.end()) {
-    std::get<0>(it->second) = command;
+    it->second->command = command;
+    ++it->second->command_version;
   } else {
-    throw std::runtime_error(
-        boost::str(boost::format("driver: %1% robot id %2% is not registered") %
-                   (static_cast<bool>(team_color_) ? "yellow" : "blue") % id));
+    throw not_registered(id);
+  }
+}
+
+driver::cycle_stats driver::stats() const {
+  std::unique_lock lock(mutex_);
+  return stats_;
+}
+
+void driver::set_trigger_offset(std::optional<std::chrono::steady_clock::duration> offset) {
+  std::unique_lock lock(mutex_);
+  trigger_offset_ = offset;
+}
+
+void driver::notify_world_updated() {
+  if (!timer_) return;
+  // timer_ は main_loop() と同じスレッドから操作する
+  boost::asio::post(timer_->get_executor(), [this] { trigger(); });
+}
+
+void driver::trigger() {
+  std::optional<std::chrono::steady_clock::duration> offset;
+  {
+    std::unique_lock lock(mutex_);
+    offset = trigger_offset_;
   }
+  if (!offset || triggered_) return;
+
+  // 前回のサイクルから間もない通知では開始しない
+  const auto now = std::chrono::steady_clock::now();
+  if (start_time_ && now - *start_time_ < cycle_ / 2) return;
+
+  // 待機中の main_loop() を取り消して開始時刻を早める
+  // 取り消せなかった場合はすでに main_loop() の呼び出しが決まっているので何もしない
+  scheduled_time_ = now + *offset;
+  if (timer_->expires_at(*scheduled_time_) == 0) return;
+  triggered_ = true;
+  timer_->async_wait([this](auto&& error) { main_loop(std::forward<decltype(error)>(error)); });
+}
+
+std::runtime_error driver::not_registered(unsigned int id) const {
+  return std::runtime_error(
+      boost::str(boost::format("driver: %1% robot id %2% is not registered") %
+                 (static_cast<bool>(team_color_) ? "yellow" : "blue") % id));
+}
+
+void driver::step() {
+  if (timer_) throw std::logic_error("driver: step() cannot be used with a timer");
+  run_cycle();
 }
 
 void driver::main_loop(const boost::system::error_code& error) {
   // TODO: エラーが発生したことを上の階層に伝える仕組みを実装する
   if (error) return;
 
+  run_cycle();
+
+  std::optional<std::chrono::steady_clock::duration> trigger_offset;
+  {
+    std::unique_lock lock(mutex_);
+    trigger_offset = trigger_offset_;
+  }
+
+  // 処理の開始時刻からcycle_経過した後に再度main_loop()が呼び出されるように設定
+  // world の更新を契機に動作する場合, 通常はそれより先に trigger() によって早められる
+  const auto interval =
+      trigger_offset ? std::chrono::duration_cast<decltype(cycle_)>(cycle_ * fallback_ratio)
+                     : cycle_;
+  scheduled_time_ = *start_time_ + interval;
+  timer_->expires_at(*scheduled_time_);
+  timer_->async_wait([this](auto&& error) { main_loop(std::forward<decltype(error)>(error)); });
+}
+
+void driver::run_cycle() {
+  AI_SERVER_TRACE_SCOPE("driver::main_loop");
+
   // 処理の開始時刻を記録
   const auto start_time = std::chrono::steady_clock::now();
-
-  std::unique_lock lock(mutex_);
+  const auto lateness =
+      scheduled_time_ ? std::max(start_time - *scheduled_time_, decltype(cycle_)::zero())
+                      : decltype(cycle_)::zero();
+  start_time_ = start_time;
+  triggered_  = false;
 
   // このループでのWorldModelを生成
   const auto world = world_.value();
 
-  // 登録されたロボットの命令をControllerを通してから送信する
-  for (auto&& [id, meta] : robots_metadata_) process(id, meta, world);
+  // world が検出データで更新されてからの経過時間
+  const auto world_age =
+      world.update_time() == std::chrono::system_clock::time_point{}
+          ? decltype(cycle_)::zero()
+          : std::max(std::chrono::duration_cast<decltype(cycle_)>(
+                         util::clock::system_now() - world.update_time()),
+                     decltype(cycle_)::zero());
 
-  // 処理の開始時刻からcycle_経過した後に再度main_loop()が呼び出されるように設定
-  timer_.expires_at(start_time + cycle_);
-  timer_.async_wait([this](auto&& error) { main_loop(std::forward<decltype(error)>(error)); });
+  // 各ロボットの情報のスナップショットをとる
+  // mutex_ はここでしか保持しないので, Controller の計算中も update_command() などは待たされない
+  model::team_color color;
+  {
+    std::unique_lock lock(mutex_);
+    color = team_color_;
+    snapshots_.clear();
+    for (auto&& [id, meta] : robots_metadata_) {
+      snapshots_.push_back({id, meta, meta->command, meta->command_version});
+    }
+  }
+
+  // 登録されたロボットの命令をControllerに通す
+  process_all(world, color);
+
+  // motion の選択などで変化した命令を書き戻す
+  // 計算中に update_command() された場合はそちらを優先する
+  {
+    std::unique_lock lock(mutex_);
+    for (auto&& s : snapshots_) {
+      if (s.metadata->command_version == s.command_version) s.metadata->command = s.command;
+    }
+  }
+
+  const auto compute_end = std::chrono::steady_clock::now();
+
+  // 命令をまとめて送信する
+  send_all(color);
+
+  const auto send_end = std::chrono::steady_clock::now();
+
+  // 処理時間を記録
+  {
+    std::unique_lock lock(mutex_);
+    const auto compute_time = compute_end - start_time;
+    const auto send_time    = send_end - compute_end;
+    ++stats_.cycles;
+    if (lateness + compute_time + send_time > cycle_) ++stats_.overruns;
+    stats_.lateness         = lateness;
+    stats_.compute_time     = compute_time;
+    stats_.send_time        = send_time;
+    stats_.max_lateness     = std::max(stats_.max_lateness, lateness);
+    stats_.max_compute_time = std::max(stats_.max_compute_time, compute_time);
+    stats_.max_send_time    = std::max(stats_.max_send_time, send_time);
+    stats_.world_age        = world_age;
+    stats_.max_world_age    = std::max(stats_.max_world_age, world_age);
+    stats_.total_world_age += world_age;
+  }
+}
+
+void driver::process_all(const model::world& world, model::team_color color) {
+  outputs_.resize(snapshots_.size());
+
+  if (!pool_) {
+    for (std::size_t i = 0; i < snapshots_.size(); ++i) {
+      outputs_[i] = process(snapshots_[i], world, color);
+    }
+    return;
+  }
+
+  // 各ロボットの計算をスレッドプールで並列に行い, 全て終わるまで待つ
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::size_t remaining = snapshots_.size();
+  std::exception_ptr exception;
+
+  for (std::size_t i = 0; i < snapshots_.size(); ++i) {
+    boost::asio::post(*pool_, [&, i] {
+      std::optional<output_type> output;
+      std::exception_ptr e;
+      try {
+        output = process(snapshots_[i], world, color);
+      } catch (...) {
+        e = std::current_exception();
+      }
+
+      std::unique_lock lock(mutex);
+      outputs_[i] = std::move(output);
+      if (e && !exception) exception = e;
+      if (--remaining == 0) cv.notify_one();
+    });
+  }
+
+  std::unique_lock lock(mutex);
+  cv.wait(lock, [&remaining] { return remaining == 0; });
+  if (exception) std::rethrow_exception(exception);
+}
+
+void driver::send_all(model::team_color color) {
+  // 送信と command_updated_ の呼び出しは mutex_ を保持して行う
+  // lock() している間は命令が送信されず, 登録された関数も呼ばれないことを保証する
+  AI_SERVER_TRACE_SCOPE("driver::send_all");
+  std::unique_lock lock(mutex_);
+
+  // 計算中にチームカラーが変更された場合, 計算結果は古い情報に基づいているので送信しない
+  if (color != team_color_) return;
+
+  // 命令は Radio ごとにまとめ, サイクルごとに 1 回だけ送信する
+  for (std::size_t i = 0; i < outputs_.size(); ++i) {
+    if (!outputs_[i]) continue;
+    auto& o = *outputs_[i];
+
+    // 計算中に登録が解除された (あるいは登録し直された) ロボットには送信しない
+    if (const auto it = robots_metadata_.find(o.id);
+        it == robots_metadata_.end() || it->second != snapshots_[i].metadata) {
+      outputs_[i].reset();
+      continue;
+    }
+
+    if (std::find(radios_.cbegin(), radios_.cend(), o.radio) == radios_.cend()) {
+      o.radio->begin_cycle(color);
+      radios_.push_back(o.radio);
+    }
+
+    auto r = std::dynamic_pointer_cast<radio::base::simulator>(o.radio);
+    if (r) {
+      o.radio->stage(color, o.id, o.kick_flag, o.dribble, o.vx, o.vy, o.omega);
+    } else {
+      o.radio->stage(color, o.id, o.motion);
+    }
+  }
+
+  // 命令の送信
+  {
+    AI_SERVER_TRACE_SCOPE("radio::flush");
+    for (const auto& radio : radios_) radio->flush();
+  }
+  radios_.clear();
+
+  const auto now = util::clock::system_now();
+  for (const auto& output : outputs_) {
+    if (!output) continue;
+    const auto& o = *output;
+
+    // 送信した指令を送信時刻とともに記録する
+    o.history->push(now, o.vxf, o.vyf, o.omega);
+
+    // 登録された関数があればそれを呼び出す
+    command_updated_(color, o.id, o.kick_flag, o.dribble, o.vxf, o.vyf, o.omega);
+  }
 }
 
-void driver::process(unsigned int id, metadata_type& metadata, const model::world& world) {
-  auto& [command, controller, radio] = metadata;
+std::optional<driver::output_type> driver::process(snapshot_type& snapshot,
+                                                   const model::world& world,
+                                                   model::team_color color) {
+  AI_SERVER_TRACE_SCOPE("driver::process");
 
-  const auto robots =
-      static_cast<bool>(team_color_) ? world.robots_yellow() : world.robots_blue();
+  const auto id = snapshot.id;
+  auto& command = snapshot.command;
+  auto& meta    = *snapshot.metadata;
 
-  const auto field = world.field();
+  std::unique_lock lock(meta.mutex);
+  auto& controller = meta.controller;
+  auto& estimator  = meta.estimator;
+
+  const auto& robots = static_cast<bool>(color) ? world.robots_yellow() : world.robots_blue();
+
+  const auto& field = world.field();
 
   // ロボットが検出されていないときは何もしない
   if (const auto it = robots.find(id); it != robots.cend()) {
     const auto& robot = it->second;
 
+    // 観測された速度と送信した指令から遅延時間を推定する
+    // 新しい検出データが届いていない周期では, 同じ観測値を重複して追加しない
+    if (const auto t = world.update_time(); t > meta.observed_time) {
+      meta.observed_time = t;
+      estimator->observe(t, robot.vx(), robot.vy());
+      if (const auto delay = estimator->update(*meta.history)) {
+        controller->set_delay(*delay);
+        if (const auto drift = estimator->take_drift()) {
+          logger_.info(boost::str(
+              boost::format("%1% robot id %2%: estimated delay changed %3$.1f ms -> %4$.1f ms") %
+              (static_cast<bool>(color) ? "yellow" : "blue") % id % (drift->first * 1000) %
+              (drift->second * 1000)));
+        }
+      }
+    }
+
     // 指令値を Controller に通して速度を得る
     auto c = [&robot, &field, &c = *controller](auto&&... args) {
       return c.update(robot, field, std::forward<decltype(args)>(args)...);
@@ -162,22 +469,17 @@ void driver::process(unsigned int id, metadata_type& metadata, const model::worl
       omega                         = momega;
     }
 
-    // 命令の送信
-    auto r = std::dynamic_pointer_cast<radio::base::simulator>(radio);
-    if (r) {
-      radio->send(team_color_, id, command.kick_flag(), command.dribble(), vx, vy, omega);
-    } else {
-      radio->send(team_color_, id, command.motion());
-    }
-
-    // 登録された関数があればそれを呼び出す
     // controller はロボット基準の速度を返すのでフィールド基準にもどす
     const auto st  = std::sin(robot.theta());
     const auto ct  = std::cos(robot.theta());
     const auto vxf = ct * vx - st * vy;
     const auto vyf = st * vx + ct * vy;
-    command_updated_(team_color_, id, command.kick_flag(), command.dribble(), vxf, vyf, omega);
+
+    return output_type{id, meta.radio, meta.history, command.kick_flag(), command.dribble(),
+                       vx, vy, omega, vxf, vyf, command.motion()};
   }
+
+  return std::nullopt;
 }
 
 } // namespace ai_server
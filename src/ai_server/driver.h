@@ -2,16 +2,24 @@
 #define AI_SERVER_DRIVER_H
 
 #include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <tuple>
+#include <vector>
 #include <boost/asio.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <boost/signals2.hpp>
 
 #include "ai_server/controller/base.h"
+#include "ai_server/controller/detail/delay_estimator.h"
+#include "ai_server/logger/logger.h"
 #include "ai_server/model/command.h"
+#include "ai_server/model/command_history.h"
 #include "ai_server/model/team_color.h"
 #include "ai_server/model/updater/world.h"
 #include "ai_server/radio/base/base.h"
@@ -23,20 +31,104 @@ class driver {
   using controller_type = std::unique_ptr<controller::base>;
   /// Radioのポインタの型
   using radio_type = std::shared_ptr<radio::base::command>;
+  /// 送信した指令の履歴のポインタの型
+  using history_type = std::shared_ptr<model::command_history>;
+  /// 遅延時間の推定器のポインタの型
+  using estimator_type = std::unique_ptr<controller::detail::delay_estimator>;
+
   /// Driverで行う処理で必要となる各ロボットの情報の型
-  using metadata_type = std::tuple<model::command, controller_type, radio_type>;
+  struct metadata_type {
+    /// controller と estimator を保護する
+    /// Controller の計算は mutex_ を解放してから行うので, ロボットごとに排他制御する
+    std::mutex mutex;
+    /// ロボットへの命令
+    model::command command;
+    /// update_command() されるたびに増える値
+    std::uint64_t command_version;
+    controller_type controller;
+    radio_type radio;
+    history_type history;
+    estimator_type estimator;
+    /// estimator に最後に渡した観測値の時刻
+    std::chrono::system_clock::time_point observed_time;
+  };
+
+  /// main_loop() の開始時にとる各ロボットの情報のスナップショットの型
+  struct snapshot_type {
+    unsigned int id;
+    std::shared_ptr<metadata_type> metadata;
+    model::command command;
+    std::uint64_t command_version;
+  };
+
+  /// Controller を通して得られた, 送信する命令の型
+  struct output_type {
+    unsigned int id;
+    radio_type radio;
+    history_type history;
+    model::command::kick_flag_t kick_flag;
+    int dribble;
+    /// ロボット基準の速度
+    double vx, vy, omega;
+    /// フィールド基準の速度
+    double vxf, vyf;
+    std::shared_ptr<model::motion::base> motion;
+  };
+
   /// Commandが更新された(Controllerを通された)ときに発火するシグナルの型
   using updated_signal_type = boost::signals2::signal<void(
       model::team_color color, unsigned int id, const model::command::kick_flag_t& kick_flag,
       int dribble, double vx, double vy, double omega)>;
 
 public:
+  /// 制御周期ごとの処理時間の統計
+  struct cycle_stats {
+    /// 処理したサイクルの数
+    std::uint64_t cycles;
+    /// 開始の遅れと処理時間の合計が制御周期を超えたサイクルの数
+    std::uint64_t overruns;
+    /// 直近のサイクルの, 予定していた開始時刻からの遅れ
+    std::chrono::steady_clock::duration lateness;
+    /// 直近のサイクルの, Controller の計算にかかった時間
+    std::chrono::steady_clock::duration compute_time;
+    /// 直近のサイクルの, 命令の送信にかかった時間
+    std::chrono::steady_clock::duration send_time;
+    /// これまでの各値の最大値
+    std::chrono::steady_clock::duration max_lateness;
+    std::chrono::steady_clock::duration max_compute_time;
+    std::chrono::steady_clock::duration max_send_time;
+    /// 直近のサイクルで使った world が検出データで更新されてからの経過時間
+    std::chrono::steady_clock::duration world_age;
+    /// world_age の最大値と合計 (平均は total_world_age / cycles で求められる)
+    std::chrono::steady_clock::duration max_world_age;
+    std::chrono::steady_clock::duration total_world_age;
+  };
+
   /// @param cycle            制御周期
   /// @param world            updater::worldの参照
   /// @param color            チームカラー
   driver(boost::asio::io_context& io_context, std::chrono::steady_clock::duration cycle,
          const model::updater::world& world, model::team_color color);
 
+  /// @param cycle            制御周期
+  /// @param world            updater::worldの参照
+  /// @param color            チームカラー
+  /// @param threads          Controller の計算に使うスレッドの数 (0 なら main_loop() のスレッドで行う)
+  driver(boost::asio::io_context& io_context, std::chrono::steady_clock::duration cycle,
+         const model::updater::world& world, model::team_color color, std::size_t threads);
+
+  /// @brief                  タイマを持たず, step() を呼んだときだけサイクルを処理する Driver を作る
+  ///
+  /// シミュレータと同期して動かす (lockstep) ときに使う
+  /// @param cycle            制御周期
+  /// @param world            updater::worldの参照
+  /// @param color            チームカラー
+  /// @param threads          Controller の計算に使うスレッドの数 (0 なら step() のスレッドで行う)
+  driver(std::chrono::steady_clock::duration cycle, const model::updater::world& world,
+         model::team_color color, std::size_t threads = 0);
+
+  ~driver();
+
   /// @brief                  現在設定されているチームカラーを取得する
   model::team_color team_color() const;
 
@@ -58,6 +150,20 @@ public:
   /// @param id               ロボットのID
   bool registered(unsigned int id) const;
 
+  /// @brief                  ロボットに送信した指令の履歴を取得する
+  ///
+  /// 履歴は送信のたびに Driver のスレッドから書き込まれ, 任意のスレッドからロックなしで読み出せる.
+  /// 登録時に Controller にも設定される. 登録を解除した後も返されたポインタは有効だが更新されない.
+  /// @param id               ロボットのID
+  std::shared_ptr<const model::command_history> command_history(unsigned int id) const;
+
+  /// @brief                  指令を送信してから観測されるまでの遅延時間の推定値を取得する
+  ///
+  /// 送信した速度と観測された速度の相互相関から推定し, 更新されるたびに Controller にも設定する.
+  /// @param id               ロボットのID
+  /// @return                 推定値 [s]. まだ推定できていなければ std::nullopt
+  std::optional<double> estimated_delay(unsigned int id) const;
+
   /// @brief                  ロボットへの命令を更新する
   /// @param id               ロボットのID
   /// @param command          ロボットへの命令
@@ -80,7 +186,33 @@ public:
   /// @param stable           true->安定,false->通常
   void set_stable(const bool stable);
 
+  /// @brief                  制御周期ごとの処理時間の統計を取得する
+  cycle_stats stats() const;
+
+  /// @brief                  world の更新を契機にサイクルを開始するよう設定する
+  ///
+  /// 設定すると, notify_world_updated() が呼ばれてから offset 経過した時点でサイクルを開始する.
+  /// ただし前回のサイクルの開始から制御周期の半分が経過していない場合 (複数のカメラから続けて
+  /// 届いた場合など) は無視する. 通知が途絶えても制御周期の 1.5 倍ごとにはサイクルを開始する.
+  /// @param offset           通知からサイクルを開始するまでの時間. std::nullopt なら一定周期で動作する
+  void set_trigger_offset(std::optional<std::chrono::steady_clock::duration> offset);
+
+  /// @brief                  world が更新されたことを通知する
+  ///
+  /// updater::world::on_updated() に登録して使う. 任意のスレッドから呼び出せる
+  void notify_world_updated();
+
+  /// @brief                  1 サイクル分の処理を呼び出したスレッドで直ちに行う
+  ///
+  /// io_context を受け取らないコンストラクタで作った場合にのみ使える
+  void step();
+
   /// @brief                  mutex_ をロックする
+  ///
+  /// ロックしている間は, 命令の送信と on_command_updated() で登録した関数の呼び出しが行われない.
+  /// Controller の計算はロックの外で (スナップショットに対して) 行われるため, ロック中も進むことがある.
+  /// ただしその結果は, 計算中にチームカラーが変更された場合や対象のロボットの登録が解除された場合には
+  /// 送信されずに破棄される.
   /// @param args             unique_lock へ渡す追加の引数
   template <class... Args>
   auto lock(Args&&... args) const {
@@ -91,15 +223,44 @@ private:
   /// @brief                  cycle_毎に呼ばれる制御部のメインループ
   void main_loop(const boost::system::error_code& error);
 
-  /// @brief                  ロボットへの命令をControllerを通してから送信する
-  void process(unsigned int id, metadata_type& metadata, const model::world& world);
+  /// @brief                  1 サイクル分の処理を行う
+  void run_cycle();
+
+  /// @brief                  ロボットへの命令をControllerに通し, 送信する命令を求める
+  /// @return                 ロボットが検出されていないときは std::nullopt
+  std::optional<output_type> process(snapshot_type& snapshot, const model::world& world,
+                                     model::team_color color);
+
+  /// @brief                  notify_world_updated() を受けて次のサイクルの開始時刻を設定する
+  void trigger();
+
+  /// @brief                  snapshots_ の各ロボットについて process() を呼び出す
+  void process_all(const model::world& world, model::team_color color);
+
+  /// @brief                  Controllerを通した命令をまとめて送信する
+  /// @param color            スナップショットをとったときのチームカラー
+  void send_all(model::team_color color);
+
+  /// @brief                  登録されていないロボットのIDを指定されたときのエラー
+  std::runtime_error not_registered(unsigned int id) const;
 
   mutable std::recursive_mutex mutex_;
 
-  /// 制御部の処理を一定の周期で回すためのタイマ
-  boost::asio::steady_timer timer_;
+  /// 制御部の処理を一定の周期で回すためのタイマ (step() で動かす場合は持たない)
+  std::optional<boost::asio::steady_timer> timer_;
   /// 制御周期
   std::chrono::steady_clock::duration cycle_;
+  /// 次のサイクルの開始予定時刻
+  std::optional<std::chrono::steady_clock::time_point> scheduled_time_;
+  /// 前回のサイクルの開始時刻
+  std::optional<std::chrono::steady_clock::time_point> start_time_;
+  /// world の更新からサイクルを開始するまでの時間 (std::nullopt なら一定周期で動作する)
+  std::optional<std::chrono::steady_clock::duration> trigger_offset_;
+  /// trigger() によって次のサイクルの開始時刻が設定されているか
+  bool triggered_;
+
+  /// Controller の計算に使うスレッドプール
+  std::unique_ptr<boost::asio::thread_pool> pool_;
 
   /// updater::worldの参照
   const model::updater::world& world_;
@@ -108,9 +269,20 @@ private:
   model::team_color team_color_;
 
   /// 登録されたロボットの情報
-  std::unordered_map<unsigned int, metadata_type> robots_metadata_;
+  std::unordered_map<unsigned int, std::shared_ptr<metadata_type>> robots_metadata_;
+
+  /// main_loop() で使う作業領域 (サイクルごとに確保し直さないようにメンバとしている)
+  std::vector<snapshot_type> snapshots_;
+  std::vector<std::optional<output_type>> outputs_;
+  /// このサイクルで命令を送る Radio
+  std::vector<radio_type> radios_;
+
+  /// 制御周期ごとの処理時間の統計
+  cycle_stats stats_;
 
   updated_signal_type command_updated_;
+
+  logger::logger_for<driver> logger_;
 };
 
 } // namespace ai_server
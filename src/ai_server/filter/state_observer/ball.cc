@@ -1,6 +1,8 @@
 #include "ball.h"
 #include <cmath>
 
+#include "ai_server/util/trace.h"
+
 namespace ai_server {
 namespace filter {
 namespace state_observer {
@@ -24,6 +26,8 @@ ball::ball(const model::ball& ball, std::chrono::system_clock::time_point time)
 
 std::optional<model::ball> ball::update(std::optional<model::ball> ball,
                                         std::chrono::system_clock::time_point time) {
+  AI_SERVER_TRACE_SCOPE("filter::state_observer::ball::update");
+
   // 対象がロストしたらロストさせる
   // TODO: 任意フレーム補間させる...？
   if (!ball.has_value()) {
@@ -1,7 +1,9 @@
 #include "robot.h"
 #include <cmath>
 
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/angle.h"
+#include "ai_server/util/trace.h"
 
 namespace ai_server {
 namespace filter {
@@ -20,7 +22,25 @@ robot::robot(std::recursive_mutex& mutex, robot::writer_func_type wf,
   x_hat_.fill(decltype(x_hat_)::value_type::Zero());
 }
 
+void robot::observe() {
+  std::unique_lock lock{mutex()};
+
+  if (command_history_) {
+    if (const auto e = command_history_->at(receive_time_)) {
+      observe(e->vx, e->vy);
+      return;
+    }
+  }
+  observe(0.0, 0.0);
+}
+
+void robot::set_command_history(std::shared_ptr<const model::command_history> history) {
+  std::unique_lock lock{mutex()};
+  command_history_ = std::move(history);
+}
+
 void robot::observe(double vx, double vy) {
+  AI_SERVER_TRACE_SCOPE("filter::state_observer::robot::observe");
   std::unique_lock lock{mutex()};
 
   const auto A = (Eigen::Matrix<double, 3, 3>{} << 0, 1, 0, // a11, a12, a13
@@ -41,7 +61,7 @@ void robot::observe(double vx, double vy) {
                      .finished();
 
   // 観測した時間からlost_duration_経過していたらロストさせる
-  if (std::chrono::system_clock::now() - capture_time_ > lost_duration_) {
+  if (util::clock::system_now() - capture_time_ > lost_duration_) {
     capture_time_ = std::chrono::system_clock::time_point::min();
     write(std::nullopt);
     return;
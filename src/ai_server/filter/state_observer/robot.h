@@ -2,9 +2,11 @@
 #define AI_SERVER_FILTER_STATE_OBSERVER_ROBOT_H
 
 #include "ai_server/filter/base.h"
+#include "ai_server/model/command_history.h"
 #include "ai_server/model/robot.h"
 #include <Eigen/Core>
 #include <array>
+#include <memory>
 
 namespace ai_server {
 namespace filter {
@@ -25,6 +27,7 @@ private:
       lost_duration_; // 見えなくなってからロストさせるまでの時間
   std::optional<model::robot> raw_value_; //観測した情報
   model::robot prev_state_;
+  std::shared_ptr<const model::command_history> command_history_; // 送信した指令の履歴
 
 public:
   /// @brief       コンストラクタ
@@ -39,6 +42,16 @@ public:
   /// @return      オブザーバを通したロボットの情報
   void observe(double vx, double vy);
 
+  /// @brief       オブザーバの状態更新
+  ///
+  /// 直近に送信した指令ではなく, 観測した時刻に実際に有効だった指令を制御入力とする.
+  /// 指令の履歴が設定されていない場合や該当する指令がない場合は制御入力を 0 とする.
+  void observe();
+
+  /// @brief         制御入力の取得に使う指令の履歴を設定する
+  /// @param history Driver が書き込む指令の履歴
+  void set_command_history(std::shared_ptr<const model::command_history> history);
+
   void set_raw_value(std::optional<model::robot> value,
                      std::chrono::system_clock::time_point time) override;
 };
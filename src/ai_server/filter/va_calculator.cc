@@ -4,6 +4,7 @@
 
 #include "ai_server/model/robot.h"
 #include "ai_server/util/math/angle.h"
+#include "ai_server/util/trace.h"
 #include "va_calculator.h"
 
 namespace ai_server {
@@ -12,6 +13,8 @@ namespace filter {
 template <>
 std::optional<model::robot> va_calculator<model::robot>::va_calculator::update(
     std::optional<model::robot> value, std::chrono::system_clock::time_point time) {
+  AI_SERVER_TRACE_SCOPE("filter::va_calculator::update");
+
   // 対象がロストしたらロストさせる
   if (!value.has_value()) {
     // 再び見えるようになった時に変な値が計算されないように prev_time_ を初期化する
@@ -3,6 +3,7 @@
 
 #include <boost/math/constants/constants.hpp>
 
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/angle.h"
 #include "ai_server/util/math/to_vector.h"
 
@@ -120,7 +121,7 @@ model::command ball_place::execute() {
 
     // ボールから離れる
     case running_state::leave: {
-      const auto now = std::chrono::steady_clock::now();
+      const auto now = util::clock::steady_now();
       if (wait_flag_) {
         begin_     = now;
         wait_flag_ = false;
@@ -148,7 +149,7 @@ model::command ball_place::execute() {
 
     // 待機
     case running_state::wait: {
-      const auto now = std::chrono::steady_clock::now();
+      const auto now = util::clock::steady_now();
       command.set_velocity(0.0, 0.0, 0.0);
       command.set_dribble(0);
       if (wait_flag_) {
@@ -209,7 +210,7 @@ model::command ball_place::execute() {
         state_ = running_state::place;
       }
       // first_ball_pos_ で判定できない場合のために時間でも判定
-      const auto now = std::chrono::steady_clock::now();
+      const auto now = util::clock::steady_now();
       if ((ball_pos - robot_pos).norm() > 100.0) begin_ = now;
       if (now - begin_ >= 1s) state_ = running_state::place;
 
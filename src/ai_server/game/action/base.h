@@ -9,6 +9,7 @@
 
 namespace ai_server::planner {
 class base;
+class plan_cache;
 }
 
 namespace ai_server {
@@ -46,6 +47,11 @@ protected:
     return *ctx_.nnabla;
   }
 
+  /// @brief                  経路探索の結果を使い回すためのもの (設定されていなければ nullptr)
+  planner::plan_cache* plan_cache() const {
+    return ctx_.plan_cache.get();
+  }
+
 private:
   context& ctx_;
 
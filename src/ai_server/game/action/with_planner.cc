@@ -1,44 +1,86 @@
 #include <Eigen/Core>
 
 #include "ai_server/planner/base.h"
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/to_vector.h"
+#include "ai_server/util/trace.h"
 #include "with_planner.h"
 
 namespace ai_server::game::action {
 
+// 速度指令を位置の目標に直すときに仮定する加速度
+static constexpr double acc = 3000.0;
+
+void with_planner::set_planning_deadline(planner::base::deadline_type deadline) {
+  deadline_ = deadline;
+}
+
 bool with_planner::finished() const {
   return action_->finished();
 }
 
-model::command with_planner::execute() {
-  auto cmd = action_->execute();
+std::optional<planner::service::request> with_planner::prepare() {
+  command_ = action_->execute();
+  start_.reset();
+  target_velocity_.reset();
+  key_.reset();
+  cached_.reset();
 
-  if (auto sp  = cmd.setpoint_pair();
+  Eigen::Vector2d goal;
+  if (auto sp  = command_.setpoint_pair();
       auto pos = std::get_if<model::setpoint::position>(&std::get<0>(sp))) {
     const auto robot = our_robots(world(), team_color()).at(id());
-    const auto start = util::math::position(robot);
-    const auto goal  = Eigen::Vector2d(std::get<0>(*pos), std::get<1>(*pos));
-
-    const auto planner = planner_->planner();
-    const auto new_pos = planner(start, goal, obstacles_);
-    cmd.set_position(std::get<0>(new_pos));
-  } else if (auto sp  = cmd.setpoint_pair();
+    start_           = util::math::position(robot);
+    goal             = Eigen::Vector2d(std::get<0>(*pos), std::get<1>(*pos));
+  } else if (auto sp  = command_.setpoint_pair();
              auto vel = std::get_if<model::setpoint::velocity>(&std::get<0>(sp))) {
-    constexpr double acc  = 3000.0;
-    const auto robot      = our_robots(world(), team_color()).at(id());
-    const auto start      = util::math::position(robot);
-    const auto target_vel = Eigen::Vector2d(std::get<0>(*vel), std::get<1>(*vel));
-    const Eigen::Vector2d goal =
-        (target_vel.squaredNorm() / (2.0 * acc)) * target_vel.normalized() + start;
-
-    const auto planner = planner_->planner();
-    const auto new_pos = planner(start, goal, obstacles_);
-    cmd.set_velocity(std::min(std::sqrt(2.0 * acc * (std::get<0>(new_pos) - start).norm()),
-                              target_vel.norm()) *
-                     (std::get<0>(new_pos) - start).normalized());
+    const auto robot = our_robots(world(), team_color()).at(id());
+    start_           = util::math::position(robot);
+    target_velocity_ = Eigen::Vector2d(std::get<0>(*vel), std::get<1>(*vel));
+    const auto& v    = *target_velocity_;
+    goal             = (v.squaredNorm() / (2.0 * acc)) * v.normalized() + *start_;
+  } else {
+    return std::nullopt;
+  }
+
+  if (auto cache = plan_cache()) {
+    key_    = cache->make_key(*start_, goal, obstacles_, *planner_);
+    cached_ = cache->find(id(), *key_, *start_, obstacles_, util::clock::steady_now());
+    if (cached_) return std::nullopt;
   }
 
+  return planner::service::request{id(), planner_.get(), *start_, goal, &obstacles_, deadline_};
+}
+
+model::command with_planner::complete(const planner::base::result_type& result) {
+  if (!start_) return command_;
+
+  // 使い回した結果は覚え直さない (探索した時刻から有効期間を数える)
+  if (key_ && !cached_) plan_cache()->store(id(), *key_, result, util::clock::steady_now());
+
+  auto cmd           = command_;
+  const auto& start  = *start_;
+  const auto new_pos = std::get<0>(cached_ ? *cached_ : result);
+  if (target_velocity_) {
+    cmd.set_velocity(
+        std::min(std::sqrt(2.0 * acc * (new_pos - start).norm()), target_velocity_->norm()) *
+        (new_pos - start).normalized());
+  } else {
+    cmd.set_position(new_pos);
+  }
   return cmd;
 }
 
+model::command with_planner::execute() {
+  AI_SERVER_TRACE_SCOPE("action::with_planner::execute");
+
+  const auto r = prepare();
+  if (!r) return complete({});
+
+  const auto result =
+      deadline_ ? planner_->anytime_planner()(r->start, r->goal, obstacles_, *deadline_)
+                : planner_->planner()(r->start, r->goal, obstacles_);
+  return complete(result);
+}
+
 } // namespace ai_server::game::action
@@ -2,15 +2,17 @@
 #define AI_SERVER_GAME_ACTION_WITH_PLANNER_H
 
 #include <memory>
+#include <optional>
 #include <type_traits>
 
+#include <Eigen/Core>
+
+#include "ai_server/planner/base.h"
 #include "ai_server/planner/obstacle_list.h"
+#include "ai_server/planner/plan_cache.h"
+#include "ai_server/planner/service.h"
 #include "base.h"
 
-namespace ai_server::planner {
-class base;
-}
-
 namespace ai_server::game::action {
 
 /// action を wrap し、目標値を planner に掛けたものを出力する
@@ -18,6 +20,15 @@ class with_planner : public action::base {
   std::shared_ptr<action::base> action_;
   std::unique_ptr<planner::base> planner_;
   planner::obstacle_list obstacles_;
+  std::optional<planner::base::deadline_type> deadline_;
+
+  // prepare() で作った指令と, complete() で planner の結果を反映するための値
+  model::command command_;
+  std::optional<Eigen::Vector2d> start_;
+  std::optional<Eigen::Vector2d> target_velocity_;
+  // context に plan_cache が設定されているときの, 今回の入力と使い回す結果
+  std::optional<planner::plan_cache::key_type> key_;
+  std::optional<planner::base::result_type> cached_;
 
 public:
   template <class Action,
@@ -30,9 +41,28 @@ public:
                const planner::obstacle_list& obstacles)
       : base{*action}, action_{action}, planner_{std::move(planner)}, obstacles_{obstacles} {}
 
+  /// @brief                  経路探索を打ち切る時刻を設定する
+  ///
+  /// 設定すると planner の anytime_planner() を使い, その時刻までに見つかった経路を使う
+  void set_planning_deadline(planner::base::deadline_type deadline);
+
   bool finished() const override;
 
   model::command execute() override;
+
+  /// @brief                  wrap した action を実行し, 経路探索の要求を作る
+  /// @return                 経路探索が必要なければ std::nullopt
+  ///
+  /// 経路探索を planner::service でまとめて行うときに使う.
+  /// 返した要求は, この action が生存している間有効.
+  /// context に plan_cache が設定されていて前回の結果を使い回せるときも std::nullopt を返す
+  std::optional<planner::service::request> prepare();
+
+  /// @brief                  prepare() で作った要求の結果を反映した指令を返す
+  ///
+  /// prepare() が std::nullopt を返したときは, 使い回す結果があればそれを反映した指令を,
+  /// なければ wrap した action の指令をそのまま返す
+  model::command complete(const planner::base::result_type& result);
 };
 
 } // namespace ai_server::game::action
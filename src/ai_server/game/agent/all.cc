@@ -5,6 +5,7 @@
 #include "ai_server/game/action/with_planner.h"
 #include "ai_server/model/obstacle/field.h"
 #include "ai_server/planner/human_like.h"
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/angle.h"
 #include "ai_server/util/math/to_vector.h"
 
@@ -25,7 +26,7 @@ all::all(context& ctx, const std::vector<unsigned int>& ids, unsigned int keeper
       goal_keep_(make_action<action::goal_keep>(keeper_id)),
       keeper_get_ball_(make_action<action::get_ball>(
           keeper_id, Eigen::Vector2d(world().field().x_max(), 0.0))) {
-  const auto now = std::chrono::steady_clock::now();
+  const auto now = util::clock::steady_now();
   const Eigen::Vector2d ene_goal_pos(world().field().x_max(), 0.0);
   for (auto id : ids_) {
     get_ball_[id]   = make_action<action::get_ball>(id, ene_goal_pos);
@@ -70,8 +71,10 @@ std::vector<std::shared_ptr<action::base>> all::execute() {
           model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
     }
     common_obstacles = ene_robots_obstacles;
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_field(model::obstacle::static_obstacles(
+        world().field(), {model::obstacle::enemy_penalty_area(world().field(), penalty_margin),
+                          model::obstacle::our_penalty_area(world().field(), penalty_margin)}));
+    common_obstacles.share();
   }
 
   ///////////////////////////////////////////
@@ -79,7 +82,7 @@ std::vector<std::shared_ptr<action::base>> all::execute() {
   // filterの補間に任せる?
   // ids_の中で見えていると判定するもの
   std::vector<unsigned int> visible_ids;
-  const auto now = std::chrono::steady_clock::now();
+  const auto now = util::clock::steady_now();
   for (auto id : ids_)
     if (our_robots.count(id)) lost_point_.at(id) = now;
 
@@ -6,6 +6,7 @@
 #include "ai_server/game/action/with_planner.h"
 #include "ai_server/model/obstacle/field.h"
 #include "ai_server/planner/human_like.h"
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/angle.h"
 #include "ai_server/util/math/to_vector.h"
 
@@ -20,7 +21,7 @@ ball_placement::ball_placement(context& ctx, const std::vector<unsigned int>& id
                                const Eigen::Vector2d& target, bool is_active)
     : base(ctx), ids_(ids), lost_count_(3s), abp_target_(target), is_active_(is_active) {
   const auto our_robots = model::our_robots(world(), team_color());
-  const auto now        = std::chrono::steady_clock::now();
+  const auto now        = util::clock::steady_now();
   for (auto id : ids_) {
     abp_[id]       = make_action<action::ball_place>(id, abp_target_);
     receive_[id]   = make_action<action::receive>(id);
@@ -52,7 +53,7 @@ std::vector<std::shared_ptr<action::base>> ball_placement::execute() {
   ///////////////////////////////////////////
   // lost判定 ///////////////////////////////
   std::vector<unsigned int> visible_ids;
-  const auto now = std::chrono::steady_clock::now();
+  const auto now = util::clock::steady_now();
   for (auto id : ids_) {
     if (our_robots.count(id)) {
       robot_pos_[id]  = util::math::position(our_robots.at(id));
@@ -157,8 +158,9 @@ std::vector<std::shared_ptr<action::base>> ball_placement::execute() {
 
     // receiver & waiter ///////////////////////////
     planner::obstacle_list common_obstacles;
-    common_obstacles.add(model::obstacle::enemy_penalty_area(wf, 150.0));
-    common_obstacles.add(model::obstacle::our_penalty_area(wf, 150.0));
+    common_obstacles.set_field(model::obstacle::static_obstacles(
+        wf, {model::obstacle::enemy_penalty_area(wf, 150.0),
+             model::obstacle::our_penalty_area(wf, 150.0)}));
     for (const auto& robot : ene_robots) {
       common_obstacles.add(model::obstacle::point{util::math::position(robot.second), 200.0});
     }
@@ -70,7 +70,10 @@ std::vector<std::shared_ptr<action::base>> defense::execute() {
       common_obstacles.add(
           model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
     }
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_field(model::obstacle::static_obstacles(
+        world().field(),
+        {model::obstacle::enemy_penalty_area(world().field(), penalty_margin)}));
+    common_obstacles.share();
   }
 
   //ここから壁の処理
@@ -36,8 +36,9 @@ std::vector<std::shared_ptr<action::base>> kick_off_waiter::execute() {
   // 障害物設定
   planner::obstacle_list common_obstacles;
   common_obstacles.add(model::obstacle::center_circle(wf, 150.0));
-  common_obstacles.add(model::obstacle::enemy_penalty_area(wf, 150.0));
-  common_obstacles.add(model::obstacle::our_penalty_area(wf, 150.0));
+  common_obstacles.set_field(model::obstacle::static_obstacles(
+      wf, {model::obstacle::enemy_penalty_area(wf, 150.0),
+           model::obstacle::our_penalty_area(wf, 150.0)}));
   common_obstacles.add(model::obstacle::point{ball_pos, 650.0});
   for (const auto& robot : ene_robots) {
     common_obstacles.add(
@@ -100,8 +100,10 @@ std::vector<std::shared_ptr<action::base>> marking::execute() {
       common_obstacles.add(
           model::obstacle::point{util::math::position(robot.second), obs_enemy_rad});
     }
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_field(model::obstacle::static_obstacles(
+        world().field(), {model::obstacle::enemy_penalty_area(world().field(), penalty_margin),
+                          model::obstacle::our_penalty_area(world().field(), penalty_margin)}));
+    common_obstacles.share();
   }
 
   using boost::math::constants::pi;
@@ -4,6 +4,7 @@
 #include "ai_server/game/action/with_planner.h"
 #include "ai_server/model/obstacle/field.h"
 #include "ai_server/planner/human_like.h"
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/to_vector.h"
 
 #include "penalty_kick.h"
@@ -44,7 +45,7 @@ std::vector<std::shared_ptr<action::base>> penalty_kick::execute() {
   const auto ball                        = util::math::position(world().ball());
   const auto field                       = world().field();
   const auto penalty_mark                = field.back_penalty_mark();
-  const auto point                       = std::chrono::steady_clock::now();
+  const auto point                       = util::clock::steady_now();
 
   using boost::math::constants::pi;
 
@@ -60,7 +61,8 @@ std::vector<std::shared_ptr<action::base>> penalty_kick::execute() {
   constexpr double area_margin = 200.0;
   // 障害物設定
   planner::obstacle_list common_obstacles;
-  common_obstacles.add(model::obstacle::our_penalty_area(field, 150.0));
+  common_obstacles.set_field(model::obstacle::static_obstacles(
+      field, {model::obstacle::our_penalty_area(field, 150.0)}));
   for (const auto& robot : enemy_robots) {
     common_obstacles.add(
         model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
@@ -10,6 +10,7 @@
 #include "ai_server/game/action/with_planner.h"
 #include "ai_server/model/obstacle/field.h"
 #include "ai_server/planner/human_like.h"
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/angle.h"
 #include "ai_server/util/math/to_vector.h"
 
@@ -23,11 +24,11 @@ namespace ai_server::game::agent {
 performance::performance(context& ctx, const std::vector<unsigned int>& ids)
     : base(ctx),
       ids_(ids),
-      start_point_(std::chrono::steady_clock::now()),
+      start_point_(util::clock::steady_now()),
       max_rad_(1000.0),
       min_rad_(500.0),
       base_pos_{0.0, 0.0} {
-  const auto now = std::chrono::steady_clock::now();
+  const auto now = util::clock::steady_now();
   for (const auto& id : ids_) {
     lost_point_[id] = now;
   }
@@ -46,7 +47,7 @@ std::vector<std::shared_ptr<action::base>> performance::execute() {
   ///////////////////////////////////////////
   // lost判定 ///////////////////////////////
   std::vector<unsigned int> visible_ids;
-  const auto now = std::chrono::steady_clock::now();
+  const auto now = util::clock::steady_now();
   for (const auto& a : our_robots) {
     if (lost_point_.count(a.first)) lost_point_.at(a.first) = now;
   }
@@ -71,8 +72,10 @@ std::vector<std::shared_ptr<action::base>> performance::execute() {
       common_obstacles.add(
           model::obstacle::point{util::math::position(robot.second), obs_robot_rad});
     }
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_field(model::obstacle::static_obstacles(
+        world().field(), {model::obstacle::enemy_penalty_area(world().field(), penalty_margin),
+                          model::obstacle::our_penalty_area(world().field(), penalty_margin)}));
+    common_obstacles.share();
   }
 
   ///////////////////////////////////////////
@@ -84,7 +87,7 @@ std::vector<std::shared_ptr<action::base>> performance::execute() {
   //基準点へ収縮させる角速度
   constexpr double omega1 = 2.0;
   const double t =
-      std::chrono::duration<double>{std::chrono::steady_clock::now() - start_point_}.count();
+      std::chrono::duration<double>{util::clock::steady_now() - start_point_}.count();
   const double rad = 0.5 * (max_rad_ - min_rad_) * (std::sin(omega1 * t) + 1.0) + min_rad_;
 
   for (std::size_t i = 0; i < visible_ids.size(); ++i) {
@@ -10,6 +10,7 @@
 #include "ai_server/model/command.h"
 #include "ai_server/model/obstacle/field.h"
 #include "ai_server/planner/human_like.h"
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/angle.h"
 #include "ai_server/util/math/to_vector.h"
 
@@ -24,7 +25,7 @@ setplay::setplay(context& ctx, unsigned int kicker_id,
     : base(ctx),
       kicker_id_(kicker_id),
       receiver_ids_(receiver_ids),
-      start_point_(std::chrono::steady_clock::now()) {
+      start_point_(util::clock::steady_now()) {
   kick_                            = make_action<action::kick>(kicker_id_);
   shooter_id_                      = 0;
   shooter_num_                     = 0;
@@ -90,8 +91,10 @@ std::vector<std::shared_ptr<action::base>> setplay::execute() {
       common_obstacles.add(
           model::obstacle::point{util::math::position(robot.second), robot_rad});
     }
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_field(model::obstacle::static_obstacles(
+        world().field(), {model::obstacle::enemy_penalty_area(world().field(), penalty_margin),
+                          model::obstacle::our_penalty_area(world().field(), penalty_margin)}));
+    common_obstacles.share();
   }
   // kicker用障害物設定
   planner::obstacle_list kicker_obstacles = common_obstacles;
@@ -258,7 +261,7 @@ std::vector<std::shared_ptr<action::base>> setplay::execute() {
       }
 
       bool movedflag   = true;
-      const auto point = std::chrono::steady_clock::now();
+      const auto point = util::clock::steady_now();
       // ロボットたちが指定位置に移動したか
       if ((positions_[shooter_num_] - util::math::position(our_robots.at(shooter_id_))).norm() >
               500 &&
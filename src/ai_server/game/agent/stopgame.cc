@@ -92,8 +92,10 @@ std::vector<std::shared_ptr<action::base>> stopgame::execute() {
           model::obstacle::point{util::math::position(ene.second), obs_robot_rad});
     }
     common_obstacles.add(model::obstacle::point{ball_pos, margin});
-    common_obstacles.add(model::obstacle::enemy_penalty_area(world().field(), penalty_margin));
-    common_obstacles.add(model::obstacle::our_penalty_area(world().field(), penalty_margin));
+    common_obstacles.set_field(model::obstacle::static_obstacles(
+        world().field(), {model::obstacle::enemy_penalty_area(world().field(), penalty_margin),
+                          model::obstacle::our_penalty_area(world().field(), penalty_margin)}));
+    common_obstacles.share();
   }
   for (auto id : visible_ids) {
     const Eigen::Vector2d robot_pos = util::math::position(our_robots.at(id));
@@ -17,6 +17,13 @@ public:
   /// @brief       呼び出されたループでの Formation を取得する
   virtual std::shared_ptr<formation::v2::base> execute() = 0;
 
+  /// @brief       id のロボットの経路探索の優先度
+  ///
+  /// 1 周期に経路探索に使える時間はこの値で按分される (game::planning_budget を参照)
+  virtual double planning_priority([[maybe_unused]] unsigned int id) const {
+    return 1.0;
+  }
+
 protected:
   /// @brief       Formation を初期化するためのヘルパ関数
   /// @param args  Formation のコンストラクタに渡す引数
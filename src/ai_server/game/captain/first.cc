@@ -1,3 +1,5 @@
+#include <limits>
+
 #include <fmt/format.h>
 
 #include "ai_server/game/formation/ball_placement.h"
@@ -13,6 +15,8 @@
 #include "ai_server/game/formation/steady.h"
 #include "ai_server/game/formation/stopgame.h"
 #include "ai_server/game/formation/timeout.h"
+#include "ai_server/util/clock.h"
+#include "ai_server/util/math/to_vector.h"
 
 #include "detail/situation_string.h"
 #include "first.h"
@@ -35,7 +39,7 @@ std::shared_ptr<formation::v2::base> first::execute() {
   if (situation_changed) {
     logger_.debug(fmt::format("{} -> {}", situation_to_string(prev_situation),
                               situation_to_string(current_situation)));
-    situation_changed_time_ = std::chrono::steady_clock::now();
+    situation_changed_time_ = util::clock::steady_now();
   }
 
   // 状況に応じたメンバ関数を呼び出して formation を更新する
@@ -46,6 +50,27 @@ std::shared_ptr<formation::v2::base> first::execute() {
   return current_formation_;
 }
 
+double first::planning_priority(unsigned int id) const {
+  // ボールに最も近いロボットに割り当てる優先度 (他のロボットは 1)
+  constexpr double chaser_priority = 3.0;
+
+  const auto robots = model::our_robots(world(), team_color());
+  const auto ball   = util::math::position(world().ball());
+
+  auto chaser   = robots.cend();
+  auto distance = std::numeric_limits<double>::max();
+  for (auto it = robots.cbegin(); it != robots.cend(); ++it) {
+    if (ids_.count(it->first) == 0) continue;
+    const auto d = (util::math::position(it->second) - ball).norm();
+    if (d < distance) {
+      chaser   = it;
+      distance = d;
+    }
+  }
+
+  return chaser != robots.cend() && chaser->first == id ? chaser_priority : 1.0;
+}
+
 void first::halt([[maybe_unused]] situation_type situation,
                  [[maybe_unused]] bool situation_changed) {
   logger_.debug("halt");
@@ -85,7 +110,7 @@ void first::kickoff_attack_start([[maybe_unused]] situation_type situation,
 
 void first::kickoff_attack_start_to_steady(situation_type situation, bool situation_changed) {
   if (auto f = std::dynamic_pointer_cast<formation::kickoff_attack>(current_formation_)) {
-    if (f->finished() || std::chrono::steady_clock::now() - situation_changed_time_ > 8s) {
+    if (f->finished() || util::clock::steady_now() - situation_changed_time_ > 8s) {
       logger_.debug("kickoff_attack_start -> steady");
       steady(situation, situation_changed);
     }
@@ -129,7 +154,7 @@ void first::penalty_attack_start([[maybe_unused]] situation_type situation,
 
 void first::penalty_attack_start_to_steady(situation_type situation, bool situation_changed) {
   if (auto f = std::dynamic_pointer_cast<formation::penalty_attack>(current_formation_)) {
-    if (f->finished() || std::chrono::steady_clock::now() - situation_changed_time_ > 10s) {
+    if (f->finished() || util::clock::steady_now() - situation_changed_time_ > 10s) {
       logger_.debug("penalty_attack_start -> steady");
       steady(situation, situation_changed);
     }
@@ -189,7 +214,7 @@ void first::setplay_attack([[maybe_unused]] situation_type situation,
 
 void first::setplay_attack_to_steady(situation_type situation, bool situation_changed) {
   if (auto f = std::dynamic_pointer_cast<formation::setplay_attack>(current_formation_)) {
-    if (f->finished() || std::chrono::steady_clock::now() - situation_changed_time_ > 15s) {
+    if (f->finished() || util::clock::steady_now() - situation_changed_time_ > 15s) {
       logger_.debug("setplay_attack -> steady");
       steady(situation, situation_changed);
     }
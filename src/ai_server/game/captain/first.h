@@ -22,6 +22,9 @@ public:
 
   std::shared_ptr<formation::v2::base> execute() override;
 
+  /// ボールに最も近いロボット (ボールを追う機体) の経路探索を優先する
+  double planning_priority(unsigned int id) const override;
+
 private:
   // 試合の状況に合わせて呼ばれる関数群
 
@@ -6,6 +6,10 @@
 #include "ai_server/model/team_color.h"
 #include "ai_server/model/world.h"
 
+namespace ai_server::planner {
+class plan_cache;
+} // namespace ai_server::planner
+
 namespace ai_server::game {
 
 class nnabla;
@@ -19,6 +23,12 @@ struct context {
   // また移行段階で nullptr を許容するため std::unique_ptr で扱う
   // この値に対する操作をする場合は "ai_server/game/nnabla.h" も include する
   std::unique_ptr<game::nnabla> nnabla;
+
+  // action::with_planner が経路探索の結果を使い回すためのもの (nullptr なら毎回探索する)
+  // action は周期ごとに作り直されるので, 周期をまたいで残る context に持たせる.
+  // context を破棄する箇所で "ai_server/planner/plan_cache.h" を include しなくてよいように
+  // std::shared_ptr で扱う
+  std::shared_ptr<planner::plan_cache> plan_cache;
 };
 
 } // namespace ai_server::game
@@ -7,6 +7,7 @@
 
 #include "ai_server/util/math/angle.h"
 #include "ai_server/util/math/to_vector.h"
+#include "ai_server/util/trace.h"
 
 #include "mcts.h"
 
@@ -80,6 +81,8 @@ evaluator::evaluator(const game::nnabla& nnabla, unsigned int num) {
 
 void evaluator::execute(const model::field& field, const Eigen::Vector2d& our_goal_pos,
                         const Eigen::Vector2d& ene_goal_pos, node& root_node) {
+  AI_SERVER_TRACE_SCOPE("mcts::evaluator::execute");
+
   // スレッド数分の worker オブジェクトを作る
   std::vector<worker> workers;
   workers.reserve(nnp_ptrs_.size());
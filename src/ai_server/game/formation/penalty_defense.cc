@@ -1,6 +1,7 @@
 #include "ai_server/game/agent/all.h"
 #include "ai_server/game/agent/defense.h"
 #include "ai_server/game/agent/penalty_kick.h"
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/distance.h"
 #include "ai_server/util/math/to_vector.h"
 
@@ -36,7 +37,7 @@ std::vector<std::shared_ptr<action::base>> penalty_defense::execute() {
   visible_ids.erase(std::remove(visible_ids.begin(), visible_ids.end(), keeper_id_),
                     visible_ids.end());
 
-  const auto point = std::chrono::steady_clock::now();
+  const auto point = util::clock::steady_now();
   for (std::size_t i = 0; i < past_ball_.size() - 1; ++i) past_ball_[i] = past_ball_[i + 1];
   past_ball_.back() = util::math::position(world().ball());
 
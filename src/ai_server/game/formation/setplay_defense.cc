@@ -1,6 +1,7 @@
 #include "ai_server/game/agent/all.h"
 #include "ai_server/game/agent/defense.h"
 #include "ai_server/game/agent/stopgame.h"
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/distance.h"
 #include "ai_server/util/math/to_vector.h"
 
@@ -39,9 +40,9 @@ std::vector<std::shared_ptr<action::base>> setplay_defense::execute() {
   if (!kicked_) {
     kicked_ = std::all_of(past_ball_.cbegin(), past_ball_.cend(),
                           [&pb](auto&& a) { return util::math::distance(pb, a) > 200; });
-    if (kicked_) kicked_time_ = std::chrono::steady_clock::now();
+    if (kicked_) kicked_time_ = util::clock::steady_now();
   }
-  if (kicked_ && std::chrono::steady_clock::now() - kicked_time_ > 1s) finished_ = true;
+  if (kicked_ && util::clock::steady_now() - kicked_time_ > 1s) finished_ = true;
 
   auto stop           = make_agent<agent::stopgame>(visible_ids);
   auto defense        = make_agent<agent::defense>(keeper_id_, std::vector<unsigned int>{});
@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <utility>
+
+#include "planning_budget.h"
+
+namespace ai_server::game {
+
+planning_budget::planning_budget(duration budget) : budget_{budget}, end_{}, remaining_{0.0} {}
+
+void planning_budget::set_budget(duration budget) {
+  budget_ = budget;
+}
+
+void planning_budget::start(std::unordered_map<unsigned int, double> priorities) {
+  end_        = clock_type::now() + budget_;
+  priorities_ = std::move(priorities);
+  remaining_  = 0.0;
+  for (auto& [id, p] : priorities_) {
+    p = std::max(p, 0.0);
+    remaining_ += p;
+  }
+}
+
+planning_budget::deadline_type planning_budget::deadline(unsigned int id) {
+  const auto now = clock_type::now();
+  const auto it  = priorities_.find(id);
+  if (it == priorities_.end()) return now;
+
+  const auto p = it->second;
+  priorities_.erase(it);
+  if (p <= 0.0 || remaining_ <= 0.0 || now >= end_) {
+    remaining_ -= p;
+    return now;
+  }
+
+  // 残り時間を, まだ期限を渡していないロボットの優先度で按分する
+  const auto ratio = std::min(p / remaining_, 1.0);
+  const auto share = std::chrono::duration_cast<duration>(
+      std::chrono::duration<double, duration::period>(end_ - now) * ratio);
+  remaining_ -= p;
+  return now + share;
+}
+
+} // namespace ai_server::game
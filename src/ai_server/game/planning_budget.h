@@ -0,0 +1,46 @@
+#ifndef AI_SERVER_GAME_PLANNING_BUDGET_H
+#define AI_SERVER_GAME_PLANNING_BUDGET_H
+
+#include <chrono>
+#include <unordered_map>
+
+namespace ai_server::game {
+
+/// @class  planning_budget
+/// @brief  1 周期に経路探索に使える時間をロボットごとに割り振る
+///
+/// 周期の始めに start() を呼び, 経路探索を行う順に deadline() で期限を受け取る.
+/// 各ロボットには残り時間を優先度で按分した時間を割り当てるので,
+/// 早く終わったロボットの余りは後のロボットが使える
+class planning_budget {
+public:
+  using clock_type    = std::chrono::steady_clock;
+  using duration      = clock_type::duration;
+  using deadline_type = clock_type::time_point;
+
+  /// @param budget       1 周期に経路探索に使える時間
+  explicit planning_budget(duration budget);
+
+  /// @brief              1 周期に経路探索に使える時間を設定する
+  void set_budget(duration budget);
+
+  /// @brief              周期の始めに呼び出す
+  /// @param priorities   この周期に経路探索を行うロボットの ID と優先度 (0 以上)
+  void start(std::unordered_map<unsigned int, double> priorities);
+
+  /// @brief              id のロボットの経路探索の期限を取得する
+  ///
+  /// start() に含まれていないロボットには時間を割り当てない (現在時刻を返す)
+  deadline_type deadline(unsigned int id);
+
+private:
+  duration budget_;
+  deadline_type end_;
+  std::unordered_map<unsigned int, double> priorities_;
+  // まだ期限を渡していないロボットの優先度の合計
+  double remaining_;
+};
+
+} // namespace ai_server::game
+
+#endif // AI_SERVER_GAME_PLANNING_BUDGET_H
@@ -0,0 +1,85 @@
+#include "command_history.h"
+
+namespace ai_server {
+namespace model {
+
+command_history::command_history() : count_(0) {
+  for (auto& s : slots_) {
+    s.seq.store(0, std::memory_order_relaxed);
+    s.time.store(0, std::memory_order_relaxed);
+    s.vx.store(0.0, std::memory_order_relaxed);
+    s.vy.store(0.0, std::memory_order_relaxed);
+    s.omega.store(0.0, std::memory_order_relaxed);
+  }
+}
+
+void command_history::push(clock_type::time_point time, double vx, double vy, double omega) {
+  const auto index = count_.load(std::memory_order_relaxed);
+  auto& s          = slots_[index % capacity];
+
+  s.seq.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  s.time.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+  s.vx.store(vx, std::memory_order_relaxed);
+  s.vy.store(vy, std::memory_order_relaxed);
+  s.omega.store(omega, std::memory_order_relaxed);
+  s.seq.store(2 * index + 2, std::memory_order_release);
+
+  count_.store(index + 1, std::memory_order_release);
+}
+
+std::uint64_t command_history::size() const {
+  return count_.load(std::memory_order_acquire);
+}
+
+std::optional<command_history::entry> command_history::latest() const {
+  const auto n = count_.load(std::memory_order_acquire);
+  if (n == 0) return std::nullopt;
+  return read(n - 1);
+}
+
+std::optional<command_history::entry> command_history::at(clock_type::time_point time) const {
+  const auto n = count_.load(std::memory_order_acquire);
+  for (auto i = n; i > 0 && n - i < capacity; --i) {
+    const auto e = read(i - 1);
+    // 読み出し中に上書きされたらそれより古い要素も残っていない
+    if (!e) break;
+    if (e->time <= time) return e;
+  }
+  return std::nullopt;
+}
+
+std::optional<command_history::entry> command_history::read(std::uint64_t index) const {
+  const auto& s = slots_[index % capacity];
+
+  const auto seq1 = s.seq.load(std::memory_order_acquire);
+  if (seq1 != 2 * index + 2) return std::nullopt;
+
+  const entry e{clock_type::time_point{clock_type::duration{
+                    s.time.load(std::memory_order_relaxed)}},
+                s.vx.load(std::memory_order_relaxed), s.vy.load(std::memory_order_relaxed),
+                s.omega.load(std::memory_order_relaxed)};
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const auto seq2 = s.seq.load(std::memory_order_relaxed);
+  if (seq1 != seq2) return std::nullopt;
+
+  return e;
+}
+
+std::size_t command_history::read_newest_first(clock_type::time_point from,
+                                               std::array<entry, capacity>& buf) const {
+  const auto n = count_.load(std::memory_order_acquire);
+
+  std::size_t size = 0;
+  for (auto i = n; i > 0 && size < capacity; --i) {
+    const auto e = read(i - 1);
+    if (!e) break;
+    buf[size++] = *e;
+    if (e->time <= from) break;
+  }
+  return size;
+}
+
+} // namespace model
+} // namespace ai_server
@@ -0,0 +1,93 @@
+#ifndef AI_SERVER_MODEL_COMMAND_HISTORY_H
+#define AI_SERVER_MODEL_COMMAND_HISTORY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace ai_server {
+namespace model {
+
+/// @class   command_history
+/// @brief   ロボットに送信した速度指令の履歴
+///
+/// Driver が送信時刻とともに書き込み, Controller や Filter が読み出す.
+/// 書き込みは 1 スレッドからのみ行い, 読み出しは任意のスレッドからロックなしで行える.
+/// 各要素は seqlock で保護されており, 読み出し中に上書きされた要素は読み飛ばされる.
+class command_history {
+public:
+  using clock_type = std::chrono::system_clock;
+
+  /// 保持する履歴の数
+  static constexpr std::size_t capacity = 64;
+
+  struct entry {
+    /// 指令を送信した時刻
+    clock_type::time_point time;
+    /// フィールド基準の速度 [mm/s], [rad/s]
+    double vx;
+    double vy;
+    double omega;
+  };
+
+  command_history();
+
+  command_history(const command_history&) = delete;
+  command_history& operator=(const command_history&) = delete;
+
+  /// @brief          送信した指令を追加する (書き込みを行うスレッドは 1 つに限る)
+  /// @param time     指令を送信した時刻
+  void push(clock_type::time_point time, double vx, double vy, double omega);
+
+  /// @brief          これまでに追加された指令の数
+  std::uint64_t size() const;
+
+  /// @brief          最後に送信した指令を取得する
+  std::optional<entry> latest() const;
+
+  /// @brief          時刻 time に有効だった (time 以前で最後に送信された) 指令を取得する
+  std::optional<entry> at(clock_type::time_point time) const;
+
+  /// @brief          時刻 from 以降に有効だった指令を古い順に out へ書き出す
+  ///
+  /// from の時点で有効だった指令 (from 以前で最後に送信された指令) も含まれる.
+  /// @return         書き出した最後の要素の次を指すイテレータ
+  template <class OutputIterator>
+  OutputIterator copy_since(clock_type::time_point from, OutputIterator out) const {
+    std::array<entry, capacity> buf;
+    const auto n = read_newest_first(from, buf);
+    for (auto i = n; i > 0; --i) *out++ = buf[i - 1];
+    return out;
+  }
+
+private:
+  struct slot {
+    /// 書き込み中は 2 * index + 1, 書き込み完了後は 2 * index + 2
+    std::atomic<std::uint64_t> seq;
+    std::atomic<clock_type::rep> time;
+    std::atomic<double> vx;
+    std::atomic<double> vy;
+    std::atomic<double> omega;
+  };
+
+  /// @brief          index 番目の要素の読み出しを試みる
+  /// @return         上書きされていたり書き込み中であったりした場合は std::nullopt
+  std::optional<entry> read(std::uint64_t index) const;
+
+  /// @brief          新しい順に, from の時点で有効だった指令まで buf へ読み出す
+  /// @return         読み出した要素の数
+  std::size_t read_newest_first(clock_type::time_point from,
+                                std::array<entry, capacity>& buf) const;
+
+  std::array<slot, capacity> slots_;
+  /// これまでに追加された指令の数
+  std::atomic<std::uint64_t> count_;
+};
+
+} // namespace model
+} // namespace ai_server
+
+#endif // AI_SERVER_MODEL_COMMAND_HISTORY_H
@@ -1,7 +1,12 @@
 #ifndef AI_SERVER_MODEL_OBSTACLE_FIELD_H
 #define AI_SERVER_MODEL_OBSTACLE_FIELD_H
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "ai_server/model/field.h"
+#include "ai_server/planner/detail/distance_field.h"
 #include "box.h"
 #include "point.h"
 
@@ -39,6 +44,23 @@ static inline obstacle::box enemy_penalty_area(const model::field& field, double
            {field.x_max() + over_length, field.penalty_y_max()}},
           margin};
 }
+
+/// @brief 試合中に動かない障害物を, フィールドの形状が変わるまで使い回す distance_field にまとめる
+/// @param field フィールドの情報
+/// @param obstacles 障害物 (ペナルティエリアなど)
+/// @param resolution 格子の間隔 [mm]
+/// @return planner::obstacle_list::set_field() に渡す distance_field
+static inline std::shared_ptr<const planner::detail::distance_field> static_obstacles(
+    const model::field& field,
+    std::vector<planner::detail::distance_field::obstacle_type> obstacles,
+    double resolution = 20.0) {
+  // 格子を作る範囲をフィールドの外側に広げる量
+  constexpr double padding = 500.0;
+
+  return planner::detail::distance_field::make(
+      std::move(obstacles), {field.x_min() - padding, field.y_min() - padding},
+      {field.x_max() + padding, field.y_max() + padding}, resolution);
+}
 } // namespace ai_server::model::obstacle
 
 #endif
@@ -0,0 +1,17 @@
+#ifndef AI_SERVER_MODEL_OBSTACLE_MOVING_POINT_H
+#define AI_SERVER_MODEL_OBSTACLE_MOVING_POINT_H
+
+#include <Eigen/Core>
+
+namespace ai_server::model::obstacle {
+// 等速で動く点
+struct moving_point {
+  using geometry_type = Eigen::Vector2d;
+
+  geometry_type geometry;   // 現在の位置
+  Eigen::Vector2d velocity; // 速度 [mm/s]
+  double margin;
+};
+} // namespace ai_server::model::obstacle
+
+#endif
@@ -7,6 +7,7 @@
 #include "ai_server/model/world.h"
 #include "ai_server/planner/obstacle_list.h"
 #include "ai_server/util/math/to_vector.h"
+#include "moving_point.h"
 #include "point.h"
 
 namespace ai_server::model::obstacle {
@@ -87,6 +88,38 @@ static inline void add_robot_paths_if(planner::obstacle_list& obstacles,
   }
 }
 
+/// @brief ロボットを動く障害物として障害物リストに追加する
+/// @param   obstacles 追加先
+/// @param   robots    障害物として登録するロボット
+/// @param   radius    障害物の半径
+static inline void add_moving_robots(planner::obstacle_list& obstacles,
+                                     const world::robots_list& robots, double radius) {
+  for (const auto& r : robots) {
+    obstacles.add(obstacle::moving_point{util::math::position(r.second),
+                                         util::math::velocity(r.second), radius});
+  }
+}
+
+/// @brief 条件を満たすロボットを動く障害物として障害物リストに追加する
+/// @param   obstacles 追加先
+/// @param   robots    障害物として登録するロボット
+/// @param   radius    障害物の半径
+/// @param   pred      条件を満たすとき true を返す関数
+template <
+    class Predicate,
+    std::enable_if_t<std::is_invocable_r_v<bool, Predicate, unsigned int, const model::robot&>,
+                     std::nullptr_t> = nullptr>
+static inline void add_moving_robots_if(planner::obstacle_list& obstacles,
+                                        const world::robots_list& robots, double radius,
+                                        Predicate&& pred) {
+  for (const auto& [id, r] : robots) {
+    if (pred(id, r)) {
+      obstacles.add(
+          obstacle::moving_point{util::math::position(r), util::math::velocity(r), radius});
+    }
+  }
+}
+
 } // namespace ai_server::model::obstacle
 
 #endif
@@ -1,4 +1,6 @@
+#include "ai_server/util/clock.h"
 #include "ai_server/util/math/affine.h"
+#include "ai_server/util/trace.h"
 #include "world.h"
 #include "ssl-protos/vision_wrapper.pb.h"
 
@@ -7,6 +9,8 @@ namespace model {
 namespace updater {
 
 void world::update(const ssl_protos::vision::Packet& packet) {
+  AI_SERVER_TRACE_SCOPE("updater::world::update");
+
   if (packet.has_detection()) {
     const auto& detection = packet.detection();
 
@@ -16,16 +20,28 @@ void world::update(const ssl_protos::vision::Packet& packet) {
     ball_.update(detection);
     robots_blue_.update(detection);
     robots_yellow_.update(detection);
+
+    std::lock_guard lock{mutex_};
+    update_time_ = util::clock::system_now();
   }
 
   if (packet.has_geometry()) {
     const auto& geometry = packet.geometry();
     field_.update(geometry);
   }
+
+  if (packet.has_detection()) updated_signal_();
 }
 
 model::world world::value() const {
-  return {field_.value(), ball_.value(), robots_blue_.value(), robots_yellow_.value()};
+  model::world w{field_.value(), ball_.value(), robots_blue_.value(), robots_yellow_.value()};
+  std::lock_guard lock{mutex_};
+  w.set_update_time(update_time_);
+  return w;
+}
+
+boost::signals2::connection world::on_updated(const updated_slot_type& slot) {
+  return updated_signal_.connect(slot);
 }
 
 void world::set_transformation_matrix(const Eigen::Affine3d& matrix) {
@@ -1,8 +1,10 @@
 #ifndef AI_SERVER_MODEL_UPDATER_WORLD_H
 #define AI_SERVER_MODEL_UPDATER_WORLD_H
 
+#include <chrono>
 #include <mutex>
 #include <set>
+#include <boost/signals2.hpp>
 #include <Eigen/Geometry>
 
 #include "ai_server/model/world.h"
@@ -22,6 +24,13 @@ namespace model {
 namespace updater {
 
 class world {
+public:
+  /// 検出データで更新されたときに発火する signal の型
+  using updated_signal_type = boost::signals2::signal<void(void)>;
+  /// updated_signal_type に登録する slot の型
+  using updated_slot_type = typename updated_signal_type::slot_type;
+
+private:
   mutable std::mutex mutex_;
 
   /// フィールドのupdater
@@ -36,6 +45,11 @@ class world {
   /// 無効化されたカメラID
   std::set<unsigned int> disabled_camera_;
 
+  /// 最後に検出データで更新された時刻
+  std::chrono::system_clock::time_point update_time_;
+
+  updated_signal_type updated_signal_;
+
   Eigen::Affine3d matrix_ = Eigen::Affine3d::Identity();
 
 public:
@@ -50,6 +64,12 @@ public:
   /// @brief           値を取得する
   model::world value() const;
 
+  /// @brief           検出データで更新されたときに呼ばれる関数を登録する
+  ///
+  /// 関数は update() を呼び出したスレッドで, 更新された値が value() で取得できるようになってから呼ばれる
+  /// @param slot      更新されたときに呼びたい関数
+  boost::signals2::connection on_updated(const updated_slot_type& slot);
+
   /// @brief           updaterに変換行列を設定する
   /// @param matrix    変換行列
   void set_transformation_matrix(const Eigen::Affine3d& matrix);
@@ -26,5 +26,9 @@ world::robots_list world::robots_yellow() const {
   return robots_yellow_;
 }
 
+std::chrono::system_clock::time_point world::update_time() const {
+  return update_time_;
+}
+
 } // namespace model
 } // namespace ai_server
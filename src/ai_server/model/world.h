@@ -1,6 +1,7 @@
 #ifndef AI_SERVER_MODEL_WORLD_H
 #define AI_SERVER_MODEL_WORLD_H
 
+#include <chrono>
 #include <string>
 #include <unordered_map>
 
@@ -28,6 +29,9 @@ public:
   robots_list robots_blue() const;
   robots_list robots_yellow() const;
 
+  /// @brief  最後に検出データで更新された時刻 (一度も更新されていなければ time_point{})
+  std::chrono::system_clock::time_point update_time() const;
+
   void set_field(const model::field& field) {
     field_ = field;
   }
@@ -44,11 +48,16 @@ public:
     robots_yellow_ = std::move(robots_yellow);
   }
 
+  void set_update_time(std::chrono::system_clock::time_point update_time) {
+    update_time_ = update_time;
+  }
+
 private:
   model::field field_;
   model::ball ball_;
   robots_list robots_blue_;
   robots_list robots_yellow_;
+  std::chrono::system_clock::time_point update_time_;
 };
 
 // @brief \p w から \p color のロボットの情報を取得する
@@ -1,4 +1,6 @@
 #include <limits>
+#include <typeinfo>
+#include <boost/container_hash/hash.hpp>
 #include "base.h"
 
 namespace ai_server::planner {
@@ -23,4 +25,18 @@ void base::set_area(const model::field& field, double padding) {
   min_pos_ = {field.x_min() - padding, field.y_min() - padding};
   max_pos_ = {field.x_max() + padding, field.y_max() + padding};
 }
+
+base::anytime_planner_type base::anytime_planner() {
+  return [p = planner()](const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
+                         const obstacle_list& obs,
+                         deadline_type) { return p(start, goal, obs); };
+}
+
+std::size_t base::settings_hash() const {
+  auto seed = typeid(*this).hash_code();
+  for (const auto v : {min_pos_.x(), min_pos_.y(), max_pos_.x(), max_pos_.y()}) {
+    boost::hash_combine(seed, v);
+  }
+  return seed;
+}
 } // namespace ai_server::planner
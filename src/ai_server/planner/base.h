@@ -1,6 +1,8 @@
 #ifndef AI_SERVER_PLANNER_BASE_H
 #define AI_SERVER_PLANNER_BASE_H
 
+#include <chrono>
+#include <cstddef>
 #include <functional>
 #include <Eigen/Core>
 #include "ai_server/model/field.h"
@@ -13,6 +15,11 @@ public:
   using result_type  = std::pair<Eigen::Vector2d, double>;
   using planner_type = std::function<result_type(const Eigen::Vector2d&, const Eigen::Vector2d&,
                                                  const obstacle_list&)>;
+  // 経路探索を打ち切る時刻 (std::chrono::steady_clock::now() と比較する)
+  using deadline_type = std::chrono::steady_clock::time_point;
+  using anytime_planner_type =
+      std::function<result_type(const Eigen::Vector2d&, const Eigen::Vector2d&,
+                                const obstacle_list&, deadline_type)>;
 
   base();
   virtual ~base();
@@ -33,6 +40,16 @@ public:
   /// @brief 経路探索を行う関数オブジェクトを生成する
   virtual planner_type planner() = 0;
 
+  /// @brief 期限までに見つかった最良の経路を返す関数オブジェクトを生成する
+  ///
+  /// 期限を扱わない planner では planner() の結果をそのまま返す
+  virtual anytime_planner_type anytime_planner();
+
+  /// @brief 探索の結果に影響する型と設定のハッシュ
+  ///
+  /// planner::plan_cache が入力の一部として使う. 設定を持つ planner はそれを加える
+  virtual std::size_t settings_hash() const;
+
 protected:
   // 移動可能領域
   Eigen::Vector2d max_pos_;
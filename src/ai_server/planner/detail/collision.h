@@ -3,6 +3,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <optional>
 #include <variant>
 #include <type_traits>
 #include <boost/geometry/algorithms/distance.hpp>
@@ -10,7 +12,9 @@
 #include <Eigen/Core>
 
 #include "ai_server/model/obstacle/point.h"
+#include "distance_field.h"
 #include "geometry_helper.h"
+#include "obstacle_batch.h"
 #include "obstacle_tree.h"
 
 namespace ai_server::planner::detail {
@@ -49,6 +53,51 @@ inline auto is_collided(const Geometry& g, const tree_type<ObstacleTypes...>& ob
   });
 }
 
+/// @brief 障害物に対する当たり判定を行い，結果を返す
+/// @param g ジオメトリ
+/// @param obstacles 障害物
+/// @return 当たっている障害物が含まれているときtrue.
+template <class Geometry, class Tree>
+inline auto is_collided(const Geometry& g, const layered_tree<Tree>& obstacles) {
+  return (obstacles.field && is_collided(g, *obstacles.field)) ||
+         (obstacles.shared && is_collided(g, *obstacles.shared)) ||
+         is_collided(g, obstacles.local);
+}
+
+/// @brief 障害物に対する当たり判定を行い，結果を返す
+/// @param p 点
+/// @param obstacles 障害物
+/// @return 当たっている障害物が含まれているときtrue.
+inline auto is_collided(const Eigen::Vector2d& p, const obstacle_batch& obstacles) {
+  return obstacles.is_collided(p, p);
+}
+
+/// @brief 障害物に対する当たり判定を行い，結果を返す
+/// @param s 線分
+/// @param obstacles 障害物
+/// @return 当たっている障害物が含まれているときtrue.
+inline auto is_collided(const boost::geometry::model::segment<Eigen::Vector2d>& s,
+                        const obstacle_batch& obstacles) {
+  return obstacles.is_collided(s.first, s.second);
+}
+
+/// @brief 障害物に対する当たり判定を行い，結果を返す
+/// @param p 点
+/// @param obstacles 障害物
+/// @return 当たっている障害物が含まれているときtrue.
+inline auto is_collided(const Eigen::Vector2d& p, const distance_field& obstacles) {
+  return obstacles.is_collided(p, p);
+}
+
+/// @brief 障害物に対する当たり判定を行い，結果を返す
+/// @param s 線分
+/// @param obstacles 障害物
+/// @return 当たっている障害物が含まれているときtrue.
+inline auto is_collided(const boost::geometry::model::segment<Eigen::Vector2d>& s,
+                        const distance_field& obstacles) {
+  return obstacles.is_collided(s.first, s.second);
+}
+
 /// @brief 障害物にぶつかるときの長さを計算する
 /// @param first rayの長さを小さい順に並べたリストの最初の要素
 /// @param last  rayの長さを小さい順に並べたリストの末尾の次の要素
@@ -162,6 +211,71 @@ inline auto find_collided_length(Iterator first, Iterator last, const Eigen::Vec
   return last;
 }
 
+/// @brief 障害物にぶつかるときの長さを計算する
+/// @param first rayの長さを小さい順に並べたリストの最初の要素
+/// @param last  rayの長さを小さい順に並べたリストの末尾の次の要素
+/// @param start 開始地点
+/// @param dir rayを伸ばす方向
+/// @param obstacles 障害物
+/// @return 障害物にぶつかる最小長さの要素
+template <class Iterator, class Tree>
+inline auto find_collided_length(Iterator first, Iterator last, const Eigen::Vector2d& start,
+                                 const Eigen::Vector2d& dir,
+                                 const layered_tree<Tree>& obstacles) {
+  // 動かない障害物と共有する障害物で探索範囲を狭めてから, 残りの障害物を調べる
+  if (obstacles.field) {
+    last = find_collided_length(first, last, start, dir, *obstacles.field);
+  }
+  if (obstacles.shared) {
+    last = find_collided_length(first, last, start, dir, *obstacles.shared);
+  }
+  return find_collided_length(first, last, start, dir, obstacles.local);
+}
+
+/// @brief 障害物にぶつかるときの長さを計算する
+/// @param first rayの長さを小さい順に並べたリストの最初の要素
+/// @param last  rayの長さを小さい順に並べたリストの末尾の次の要素
+/// @param start 開始地点
+/// @param dir rayを伸ばす方向
+/// @param obstacles 障害物
+/// @return 障害物にぶつかる最小長さの要素
+template <class Iterator>
+inline auto find_collided_length(Iterator first, Iterator last, const Eigen::Vector2d& start,
+                                 const Eigen::Vector2d& dir, const obstacle_batch& obstacles) {
+  static_assert(std::is_floating_point_v<typename std::iterator_traits<Iterator>::value_type>);
+
+  // 要素が空のとき
+  if (first == last) return last;
+
+  // 最大まで伸ばしたrayが衝突しないとき
+  if (!obstacles.is_collided(start, start + *std::prev(last, 1) * dir)) return last;
+
+  // 全ての障害物について初めてぶつかる長さを求め, それ以上の値が出てくる場所を探す
+  return std::lower_bound(first, last, obstacles.first_collision(start, dir));
+}
+
+/// @brief 障害物にぶつかるときの長さを計算する
+/// @param first rayの長さを小さい順に並べたリストの最初の要素
+/// @param last  rayの長さを小さい順に並べたリストの末尾の次の要素
+/// @param start 開始地点
+/// @param dir rayを伸ばす方向
+/// @param obstacles 障害物
+/// @return 障害物にぶつかる最小長さの要素
+template <class Iterator>
+inline auto find_collided_length(Iterator first, Iterator last, const Eigen::Vector2d& start,
+                                 const Eigen::Vector2d& dir, const distance_field& obstacles) {
+  static_assert(std::is_floating_point_v<typename std::iterator_traits<Iterator>::value_type>);
+
+  // 要素が空のとき
+  if (first == last) return last;
+
+  // 最大まで伸ばしたrayが衝突しないとき
+  if (!obstacles.is_collided(start, start + *std::prev(last, 1) * dir)) return last;
+
+  // 初めてぶつかる長さ以上の値が出てくる場所を探す
+  return std::lower_bound(first, last, obstacles.first_collision(start, dir));
+}
+
 /// @brief 衝突している障害物を抽出する
 /// @param obstacles 障害物
 /// @param g ジオメトリ
@@ -176,6 +290,64 @@ inline auto extract_collisions(const tree_type<ObstacleTypes...>& obstacles,
                           boost::geometry::index::satisfies(
                               [&g](const auto& a) { return is_collided(g, std::get<1>(a)); }));
 }
+
+/// @brief 障害物までの距離を返す
+/// @param g ジオメトリ
+/// @param o 障害物
+template <class Geometry, class... ObstacleTypes>
+inline double obstacle_distance(const Geometry& g, const std::variant<ObstacleTypes...>& o) {
+  return std::visit(
+      [&g](const auto& arg) { return boost::geometry::distance(g, arg.geometry); }, o);
+}
+
+/// @brief 衝突している障害物のうち最も近いものを探す
+/// @param obstacles 障害物
+/// @param g ジオメトリ
+/// @return 最も近い障害物 (衝突している障害物がなければ std::nullopt)
+template <class Geometry, class... ObstacleTypes>
+inline auto nearest_collision(const tree_type<ObstacleTypes...>& obstacles, const Geometry& g)
+    -> std::optional<typename tree_type<ObstacleTypes...>::value_type> {
+  std::optional<typename tree_type<ObstacleTypes...>::value_type> nearest;
+  auto distance = std::numeric_limits<double>::max();
+  std::for_each(extract_collisions(obstacles, g), obstacles.qend(), [&](const auto& a) {
+    const auto d = obstacle_distance(g, std::get<1>(a));
+    if (d < distance) {
+      nearest  = a;
+      distance = d;
+    }
+  });
+  return nearest;
+}
+
+/// @brief 衝突している障害物のうち最も近いものを探す
+/// @param obstacles 障害物
+/// @param g ジオメトリ
+/// @return 最も近い障害物 (衝突している障害物がなければ std::nullopt)
+template <class Geometry, class Tree>
+inline auto nearest_collision(const layered_tree<Tree>& obstacles, const Geometry& g)
+    -> std::optional<typename Tree::value_type> {
+  auto nearest = nearest_collision(obstacles.local, g);
+  // nearest より近ければ置き換える
+  const auto update = [&g, &nearest](const auto& n) {
+    if (!nearest ||
+        obstacle_distance(g, std::get<1>(n)) <= obstacle_distance(g, std::get<1>(*nearest))) {
+      nearest = n;
+    }
+  };
+
+  if (obstacles.shared) {
+    if (const auto n = nearest_collision(*obstacles.shared, g)) update(*n);
+  }
+  if (obstacles.field) {
+    for (const auto& o : obstacles.field->obstacles()) {
+      if (!is_collided(g, o)) continue;
+      const auto env =
+          std::visit([](const auto& arg) { return to_envelope(arg.geometry, arg.margin); }, o);
+      update(typename Tree::value_type{env, o});
+    }
+  }
+  return nearest;
+}
 } // namespace ai_server::planner::detail
 
 #endif
@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "distance_field.h"
+
+namespace ai_server::planner::detail {
+
+namespace {
+
+// 格子だけで進める回数 (これを超えたら残りは obstacle_batch で調べる)
+constexpr int max_steps = 16;
+
+// 点 p から障害物のマージンの外側までの距離
+double clearance_to(const Eigen::Vector2d& p, const model::obstacle::point& o) {
+  return (p - o.geometry).norm() - o.margin;
+}
+
+double clearance_to(const Eigen::Vector2d& p, const model::obstacle::segment& o) {
+  const Eigen::Vector2d d = o.geometry.second - o.geometry.first;
+  const Eigen::Vector2d w = p - o.geometry.first;
+  const auto dd           = d.squaredNorm();
+  const auto t            = dd > 0.0 ? std::clamp(w.dot(d) / dd, 0.0, 1.0) : 0.0;
+  return (w - t * d).norm() - o.margin;
+}
+
+double clearance_to(const Eigen::Vector2d& p, const model::obstacle::box& o) {
+  const auto& min_c = o.geometry.min_corner();
+  const auto& max_c = o.geometry.max_corner();
+  const auto ex     = std::max({min_c.x() - p.x(), p.x() - max_c.x(), 0.0});
+  const auto ey     = std::max({min_c.y() - p.y(), p.y() - max_c.y(), 0.0});
+  return std::hypot(ex, ey) - o.margin;
+}
+
+// マージンを含めた障害物を包括する長方形
+std::pair<Eigen::Vector2d, Eigen::Vector2d> envelope_of(const model::obstacle::point& o) {
+  const Eigen::Vector2d m{o.margin, o.margin};
+  return {o.geometry - m, o.geometry + m};
+}
+
+std::pair<Eigen::Vector2d, Eigen::Vector2d> envelope_of(const model::obstacle::segment& o) {
+  const Eigen::Vector2d m{o.margin, o.margin};
+  return {o.geometry.first.cwiseMin(o.geometry.second) - m,
+          o.geometry.first.cwiseMax(o.geometry.second) + m};
+}
+
+std::pair<Eigen::Vector2d, Eigen::Vector2d> envelope_of(const model::obstacle::box& o) {
+  const Eigen::Vector2d m{o.margin, o.margin};
+  return {o.geometry.min_corner() - m, o.geometry.max_corner() + m};
+}
+
+// start から dir 方向に伸ばした ray が長方形 e と交わるか
+bool ray_intersects(const Eigen::Vector2d& start, const Eigen::Vector2d& dir,
+                    const std::pair<Eigen::Vector2d, Eigen::Vector2d>& e) {
+  auto t0 = 0.0;
+  auto t1 = std::numeric_limits<double>::infinity();
+  for (int k = 0; k < 2; ++k) {
+    if (dir[k] == 0.0) {
+      if (start[k] < e.first[k] || e.second[k] < start[k]) return false;
+      continue;
+    }
+    const auto a = (e.first[k] - start[k]) / dir[k];
+    const auto b = (e.second[k] - start[k]) / dir[k];
+    t0           = std::max(t0, std::min(a, b));
+    t1           = std::min(t1, std::max(a, b));
+  }
+  return t0 <= t1;
+}
+
+// make() が覚えておく distance_field の数
+constexpr std::size_t cache_size = 4;
+
+// make() の引数を並べたもの
+std::vector<double> make_key(const std::vector<distance_field::obstacle_type>& obstacles,
+                             const Eigen::Vector2d& min_p, const Eigen::Vector2d& max_p,
+                             double resolution) {
+  std::vector<double> key{min_p.x(), min_p.y(), max_p.x(), max_p.y(), resolution};
+  for (const auto& o : obstacles) {
+    key.push_back(static_cast<double>(o.index()));
+    std::visit(
+        [&key](const auto& arg) {
+          using type = std::decay_t<decltype(arg)>;
+          if constexpr (std::is_same_v<type, model::obstacle::point>) {
+            key.insert(key.end(), {arg.geometry.x(), arg.geometry.y()});
+          } else if constexpr (std::is_same_v<type, model::obstacle::segment>) {
+            key.insert(key.end(), {arg.geometry.first.x(), arg.geometry.first.y(),
+                                   arg.geometry.second.x(), arg.geometry.second.y()});
+          } else {
+            key.insert(key.end(),
+                       {arg.geometry.min_corner().x(), arg.geometry.min_corner().y(),
+                        arg.geometry.max_corner().x(), arg.geometry.max_corner().y()});
+          }
+          key.push_back(arg.margin);
+        },
+        o);
+  }
+  return key;
+}
+
+} // namespace
+
+distance_field::distance_field(std::vector<obstacle_type> obstacles,
+                               const Eigen::Vector2d& min_p, const Eigen::Vector2d& max_p,
+                               double resolution)
+    : obstacles_{std::move(obstacles)},
+      exact_{},
+      min_{min_p},
+      resolution_{resolution},
+      // float に丸めた誤差の分も含める
+      slack_{resolution * std::sqrt(0.5) + 0.01},
+      cols_{static_cast<int>(std::floor((max_p.x() - min_p.x()) / resolution)) + 1},
+      rows_{static_cast<int>(std::floor((max_p.y() - min_p.y()) / resolution)) + 1} {
+  for (const auto& o : obstacles_) {
+    // マージンが 0 以下の障害物には当たらない
+    if (std::visit([](const auto& arg) { return arg.margin > 0.0; }, o)) {
+      envelopes_.push_back(std::visit([](const auto& arg) { return envelope_of(arg); }, o));
+    }
+    exact_.add(o);
+  }
+
+  grid_.resize(static_cast<std::size_t>(cols_) * rows_);
+  for (int j = 0; j < rows_; ++j) {
+    for (int i = 0; i < cols_; ++i) {
+      const Eigen::Vector2d p = min_ + Eigen::Vector2d{i * resolution_, j * resolution_};
+      grid_[static_cast<std::size_t>(j) * cols_ + i] = static_cast<float>(clearance(p));
+    }
+  }
+}
+
+std::shared_ptr<const distance_field> distance_field::make(std::vector<obstacle_type> obstacles,
+                                                           const Eigen::Vector2d& min_p,
+                                                           const Eigen::Vector2d& max_p,
+                                                           double resolution) {
+  static std::mutex mutex;
+  // 最近使ったものほど後ろにある
+  static std::vector<std::pair<std::vector<double>, std::shared_ptr<const distance_field>>>
+      cache;
+
+  auto key = make_key(obstacles, min_p, max_p, resolution);
+
+  std::lock_guard<std::mutex> lock{mutex};
+  const auto it = std::find_if(cache.begin(), cache.end(),
+                               [&key](const auto& e) { return e.first == key; });
+  if (it != cache.end()) {
+    std::rotate(it, std::next(it), cache.end());
+    return cache.back().second;
+  }
+
+  auto field =
+      std::make_shared<const distance_field>(std::move(obstacles), min_p, max_p, resolution);
+  if (cache.size() >= cache_size) cache.erase(cache.begin());
+  cache.emplace_back(std::move(key), field);
+  return field;
+}
+
+const std::vector<distance_field::obstacle_type>& distance_field::obstacles() const {
+  return obstacles_;
+}
+
+double distance_field::resolution() const {
+  return resolution_;
+}
+
+double distance_field::lower_bound(const Eigen::Vector2d& p) const {
+  // 最も近い格子点
+  const auto i = std::lround((p.x() - min_.x()) / resolution_);
+  const auto j = std::lround((p.y() - min_.y()) / resolution_);
+  if (i < 0 || cols_ <= i || j < 0 || rows_ <= j) return clearance(p);
+
+  // 距離は 1-Lipschitz なので, 格子点の値との差は格子点までの距離以下
+  return grid_[static_cast<std::size_t>(j) * cols_ + i] - slack_;
+}
+
+bool distance_field::is_collided(const Eigen::Vector2d& a, const Eigen::Vector2d& b) const {
+  // 線分を包括する長方形がどの障害物のものとも重ならなければ当たらない
+  const Eigen::Vector2d lo = a.cwiseMin(b);
+  const Eigen::Vector2d hi = a.cwiseMax(b);
+  if (std::none_of(envelopes_.begin(), envelopes_.end(), [&lo, &hi](const auto& e) {
+        return (lo.array() < e.second.array()).all() && (e.first.array() < hi.array()).all();
+      })) {
+    return false;
+  }
+
+  const Eigen::Vector2d d = b - a;
+  const auto length       = d.norm();
+
+  // 下限の距離だけ進んでも障害物には当たらないので, 線分に沿って進めていく
+  auto t = 0.0;
+  for (int i = 0; i < max_steps; ++i) {
+    const Eigen::Vector2d p = length > 0.0 ? (a + (t / length) * d).eval() : a;
+    const auto l            = lower_bound(p);
+    // 障害物の近くでは残りを正確に調べる
+    if (l < resolution_) return exact_.is_collided(p, b);
+    t += l;
+    if (t >= length) return false;
+  }
+  return exact_.is_collided(a + (t / length) * d, b);
+}
+
+double distance_field::first_collision(const Eigen::Vector2d& start,
+                                       const Eigen::Vector2d& dir) const {
+  const auto n = dir.norm();
+  if (n == 0.0) return exact_.first_collision(start, dir);
+  const Eigen::Vector2d u = dir / n;
+
+  // ray がどの障害物を包括する長方形とも交わらなければ当たらない
+  if (std::none_of(envelopes_.begin(), envelopes_.end(), [&start, &u](const auto& e) {
+        return ray_intersects(start, u, e);
+      })) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  // 障害物の近くまで ray に沿って進めてから, 残りを正確に調べる
+  auto t = 0.0;
+  for (int i = 0; i < max_steps; ++i) {
+    const auto l = lower_bound(start + t * u);
+    // どの障害物もない
+    if (std::isinf(l)) return l;
+    if (l < resolution_) break;
+    t += l;
+  }
+  if (t == 0.0) return exact_.first_collision(start, dir);
+  return t / n + std::max(exact_.first_collision(start + t * u, dir), 0.0);
+}
+
+double distance_field::clearance(const Eigen::Vector2d& p) const {
+  auto result = std::numeric_limits<double>::infinity();
+  for (const auto& o : obstacles_) {
+    // マージンが 0 以下の障害物には当たらない
+    const auto c = std::visit(
+        [&p](const auto& arg) {
+          return arg.margin > 0.0 ? clearance_to(p, arg)
+                                  : std::numeric_limits<double>::infinity();
+        },
+        o);
+    result = std::min(result, c);
+  }
+  return result;
+}
+} // namespace ai_server::planner::detail
@@ -0,0 +1,78 @@
+#ifndef AI_SERVER_PLANNER_DETAIL_DISTANCE_FIELD_H
+#define AI_SERVER_PLANNER_DETAIL_DISTANCE_FIELD_H
+
+#include <memory>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <Eigen/Core>
+
+#include "ai_server/model/obstacle/box.h"
+#include "ai_server/model/obstacle/point.h"
+#include "ai_server/model/obstacle/segment.h"
+#include "obstacle_batch.h"
+
+namespace ai_server::planner::detail {
+
+// 試合中に動かない障害物 (ペナルティエリアなど) までの距離を格子に書き込んでおいたもの
+// 格子の値から距離の下限がすぐに分かるので, 障害物から離れた場所の当たり判定は格子だけで済む.
+// 障害物の近くや格子の外では obstacle_batch で正確に調べるので, 結果は obstacle_batch と同じ
+class distance_field {
+public:
+  using obstacle_type =
+      std::variant<model::obstacle::point, model::obstacle::segment, model::obstacle::box>;
+
+  /// @param obstacles 障害物
+  /// @param min_p 格子を作る範囲の最小座標
+  /// @param max_p 格子を作る範囲の最大座標
+  /// @param resolution 格子の間隔 [mm]
+  distance_field(std::vector<obstacle_type> obstacles, const Eigen::Vector2d& min_p,
+                 const Eigen::Vector2d& max_p, double resolution);
+
+  /// @brief distance_field を作る
+  ///
+  /// 引数が最近作ったものと同じなら, 作り直さずにそれを返す.
+  /// フィールドの形状が変わらない限り, 毎周期呼び出しても格子は作り直さない
+  static std::shared_ptr<const distance_field> make(std::vector<obstacle_type> obstacles,
+                                                    const Eigen::Vector2d& min_p,
+                                                    const Eigen::Vector2d& max_p,
+                                                    double resolution);
+
+  /// @brief 障害物
+  const std::vector<obstacle_type>& obstacles() const;
+
+  /// @brief 格子の間隔 [mm]
+  double resolution() const;
+
+  /// @brief p から最も近い障害物のマージンの外側までの距離の下限 (当たっていれば 0 以下)
+  double lower_bound(const Eigen::Vector2d& p) const;
+
+  /// @brief 線分 a-b が障害物に当たるか (a == b なら点として調べる)
+  bool is_collided(const Eigen::Vector2d& a, const Eigen::Vector2d& b) const;
+
+  /// @brief start から dir 方向に伸ばした ray が初めて障害物に当たる長さを返す
+  ///
+  /// obstacle_batch::first_collision() と同じく, 長さは dir を単位とする.
+  /// start が障害物の中にあれば 0 以下の値を, どの障害物にも当たらなければ無限大を返す
+  double first_collision(const Eigen::Vector2d& start, const Eigen::Vector2d& dir) const;
+
+private:
+  // p から最も近い障害物のマージンの外側までの正確な距離 (当たっていれば 0 以下)
+  double clearance(const Eigen::Vector2d& p) const;
+
+  std::vector<obstacle_type> obstacles_;
+  // マージンを含めた障害物を包括する長方形 (最小座標と最大座標)
+  std::vector<std::pair<Eigen::Vector2d, Eigen::Vector2d>> envelopes_;
+  obstacle_batch exact_;
+  Eigen::Vector2d min_;
+  double resolution_;
+  // 格子点の値と p での値の差の上限 (格子点の間の最大距離の半分)
+  double slack_;
+  int cols_;
+  int rows_;
+  // 格子点での clearance() の値 (行優先)
+  std::vector<float> grid_;
+};
+} // namespace ai_server::planner::detail
+
+#endif
@@ -0,0 +1,460 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "distance_field.h"
+#include "obstacle_batch.h"
+
+namespace ai_server::planner::detail {
+
+namespace {
+
+constexpr double inf = std::numeric_limits<double>::infinity();
+
+// 1 つずつ調べるときの値
+struct scalar_pack {
+  static constexpr std::size_t width = 1;
+  using value                        = double;
+  using mask                         = bool;
+
+  static value load(const std::vector<double>& v, std::size_t i) {
+    return v[i];
+  }
+  static value broadcast(double x) {
+    return x;
+  }
+  static value min(value a, value b) {
+    return a < b ? a : b;
+  }
+  static value max(value a, value b) {
+    return a < b ? b : a;
+  }
+  static value sqrt(value a) {
+    return std::sqrt(a);
+  }
+  static value select(mask m, value a, value b) {
+    return m ? a : b;
+  }
+  static bool any(mask m) {
+    return m;
+  }
+  static double reduce_min(value a) {
+    return a;
+  }
+};
+
+#if defined(__AVX2__)
+// 4 つずつ調べるときの値
+struct avx2_pack {
+  static constexpr std::size_t width = 4;
+  struct value {
+    __m256d v;
+  };
+  struct mask {
+    __m256d v;
+  };
+
+  static value load(const std::vector<double>& v, std::size_t i) {
+    return {_mm256_loadu_pd(v.data() + i)};
+  }
+  static value broadcast(double x) {
+    return {_mm256_set1_pd(x)};
+  }
+  static value min(value a, value b) {
+    return {_mm256_min_pd(a.v, b.v)};
+  }
+  static value max(value a, value b) {
+    return {_mm256_max_pd(a.v, b.v)};
+  }
+  static value sqrt(value a) {
+    return {_mm256_sqrt_pd(a.v)};
+  }
+  static value select(mask m, value a, value b) {
+    return {_mm256_blendv_pd(b.v, a.v, m.v)};
+  }
+  static bool any(mask m) {
+    return _mm256_movemask_pd(m.v) != 0;
+  }
+  static double reduce_min(value a) {
+    const auto m = _mm_min_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+    return _mm_cvtsd_f64(_mm_min_sd(m, _mm_unpackhi_pd(m, m)));
+  }
+};
+
+inline avx2_pack::value operator+(avx2_pack::value a, avx2_pack::value b) {
+  return {_mm256_add_pd(a.v, b.v)};
+}
+inline avx2_pack::value operator-(avx2_pack::value a, avx2_pack::value b) {
+  return {_mm256_sub_pd(a.v, b.v)};
+}
+inline avx2_pack::value operator*(avx2_pack::value a, avx2_pack::value b) {
+  return {_mm256_mul_pd(a.v, b.v)};
+}
+inline avx2_pack::value operator/(avx2_pack::value a, avx2_pack::value b) {
+  return {_mm256_div_pd(a.v, b.v)};
+}
+inline avx2_pack::mask operator<(avx2_pack::value a, avx2_pack::value b) {
+  return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)};
+}
+inline avx2_pack::mask operator<=(avx2_pack::value a, avx2_pack::value b) {
+  return {_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)};
+}
+inline avx2_pack::mask operator==(avx2_pack::value a, avx2_pack::value b) {
+  return {_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)};
+}
+inline avx2_pack::mask operator&(avx2_pack::mask a, avx2_pack::mask b) {
+  return {_mm256_and_pd(a.v, b.v)};
+}
+inline avx2_pack::mask operator|(avx2_pack::mask a, avx2_pack::mask b) {
+  return {_mm256_or_pd(a.v, b.v)};
+}
+#endif
+
+// n 個の障害物を P の幅ずつ f に渡し, 当たるものがあれば true を返す (端数は 1 つずつ調べる)
+template <class P, class F>
+bool any_of(std::size_t n, F&& f) {
+  std::size_t i = 0;
+  for (; i + P::width <= n; i += P::width) {
+    if (P::any(f(P{}, i))) return true;
+  }
+  for (; i < n; ++i) {
+    if (f(scalar_pack{}, i)) return true;
+  }
+  return false;
+}
+
+// n 個の障害物を P の幅ずつ f に渡し, 返された値の最小値を返す (端数は 1 つずつ調べる)
+template <class P, class F>
+double min_of(std::size_t n, F&& f) {
+  auto m        = P::broadcast(inf);
+  std::size_t i = 0;
+  for (; i + P::width <= n; i += P::width) m = P::min(m, f(P{}, i));
+  auto result = P::reduce_min(m);
+  for (; i < n; ++i) result = std::min(result, f(scalar_pack{}, i));
+  return result;
+}
+
+// 調べる線分 a + t * d (0 <= t <= 1)
+struct segment_query {
+  double ax, ay, dx, dy, inv_dd;
+
+  segment_query(const Eigen::Vector2d& a, const Eigen::Vector2d& b)
+      : ax{a.x()},
+        ay{a.y()},
+        dx{b.x() - a.x()},
+        dy{b.y() - a.y()},
+        inv_dd{(b - a).squaredNorm() > 0.0 ? 1.0 / (b - a).squaredNorm() : 0.0} {}
+
+  // 点 (x, y) までの距離の 2 乗
+  template <class P>
+  typename P::value distance2(typename P::value x, typename P::value y) const {
+    const auto wx = x - P::broadcast(ax);
+    const auto wy = y - P::broadcast(ay);
+    const auto t  = P::min(
+        P::max((wx * P::broadcast(dx) + wy * P::broadcast(dy)) * P::broadcast(inv_dd),
+               P::broadcast(0.0)),
+        P::broadcast(1.0));
+    const auto ex = wx - t * P::broadcast(dx);
+    const auto ey = wy - t * P::broadcast(dy);
+    return ex * ex + ey * ey;
+  }
+};
+
+// 調べる ray s + l * u (l は負にもなる)
+struct ray_query {
+  double sx, sy, ux, uy, inv_uu;
+
+  ray_query(const Eigen::Vector2d& s, const Eigen::Vector2d& u)
+      : sx{s.x()}, sy{s.y()}, ux{u.x()}, uy{u.y()}, inv_uu{1.0 / u.squaredNorm()} {}
+
+  // 中心 (cx, cy), 半径の 2 乗が r2 の円に入る l (入らなければ無限大)
+  template <class P>
+  typename P::value enter_circle(typename P::value cx, typename P::value cy,
+                                 typename P::value r2) const {
+    const auto wx    = P::broadcast(sx) - cx;
+    const auto wy    = P::broadcast(sy) - cy;
+    const auto b     = (wx * P::broadcast(ux) + wy * P::broadcast(uy)) * P::broadcast(inv_uu);
+    const auto c     = (wx * wx + wy * wy - r2) * P::broadcast(inv_uu);
+    const auto disc  = b * b - c;
+    const auto root  = P::sqrt(P::max(disc, P::broadcast(0.0)));
+    const auto valid = (P::broadcast(0.0) < disc) & (P::broadcast(0.0) < root - b);
+    return P::select(valid, P::broadcast(0.0) - b - root, P::broadcast(inf));
+  }
+};
+
+// 原点 o, 方向 v の ray が区間 (lo, hi) にある l の範囲
+template <class P>
+std::pair<typename P::value, typename P::value> slab(typename P::value o, typename P::value v,
+                                                     typename P::value lo,
+                                                     typename P::value hi) {
+  // v が 0 なら, ray はずっと区間の中にあるか, ずっと外にある
+  const auto parallel = v == P::broadcast(0.0);
+  const auto inside   = (lo < o) & (o < hi);
+  const auto t1       = (lo - o) / v;
+  const auto t2       = (hi - o) / v;
+  return {P::select(parallel, P::select(inside, P::broadcast(-inf), P::broadcast(inf)),
+                    P::min(t1, t2)),
+          P::select(parallel, P::select(inside, P::broadcast(inf), P::broadcast(-inf)),
+                    P::max(t1, t2))};
+}
+
+// 原点 (ox, oy), 方向 (vx, vy) の ray が長方形 (lo_x, hi_x) x (lo_y, hi_y) に入る l
+// (入らなければ無限大)
+template <class P>
+typename P::value enter_rect(typename P::value ox, typename P::value oy, typename P::value vx,
+                             typename P::value vy, typename P::value lo_x,
+                             typename P::value lo_y, typename P::value hi_x,
+                             typename P::value hi_y) {
+  const auto [x1, x2] = slab<P>(ox, vx, lo_x, hi_x);
+  const auto [y1, y2] = slab<P>(oy, vy, lo_y, hi_y);
+  const auto enter    = P::max(x1, y1);
+  const auto exit     = P::min(x2, y2);
+  const auto valid    = (enter < exit) & (P::broadcast(0.0) < exit);
+  return P::select(valid, enter, P::broadcast(inf));
+}
+
+// 線分が円に当たるか
+template <class P>
+typename P::mask circle_collided(const segment_query& q, typename P::value x,
+                                 typename P::value y, typename P::value r) {
+  return q.distance2<P>(x, y) < r * r;
+}
+
+// 線分がカプセルに当たるか
+// 線分どうしが交差するか, どちらかの端点ともう一方の線分の距離が半径より小さければ当たる
+template <class P>
+typename P::mask capsule_collided(const segment_query& q, typename P::value x,
+                                  typename P::value y, typename P::value ux,
+                                  typename P::value uy, typename P::value length,
+                                  typename P::value r) {
+  const auto zero = P::broadcast(0.0);
+  const auto qx   = x + length * ux;
+  const auto qy   = y + length * uy;
+
+  // 点 (px, py) からカプセルの軸までの距離の 2 乗
+  const auto axis_distance2 = [&](typename P::value px, typename P::value py) {
+    const auto wx = px - x;
+    const auto wy = py - y;
+    const auto t  = P::min(P::max(wx * ux + wy * uy, zero), length);
+    const auto ex = wx - t * ux;
+    const auto ey = wy - t * uy;
+    return ex * ex + ey * ey;
+  };
+  const auto ax = P::broadcast(q.ax);
+  const auto ay = P::broadcast(q.ay);
+  const auto bx = P::broadcast(q.ax + q.dx);
+  const auto by = P::broadcast(q.ay + q.dy);
+  const auto d2 = P::min(P::min(q.distance2<P>(x, y), q.distance2<P>(qx, qy)),
+                         P::min(axis_distance2(ax, ay), axis_distance2(bx, by)));
+
+  const auto dx = P::broadcast(q.dx);
+  const auto dy = P::broadcast(q.dy);
+  const auto o1 = dx * (y - ay) - dy * (x - ax);
+  const auto o2 = dx * (qy - ay) - dy * (qx - ax);
+  const auto o3 = ux * (ay - y) - uy * (ax - x);
+  const auto o4 = ux * (by - y) - uy * (bx - x);
+
+  // 線分どうしが交差する
+  const auto crossed = (o1 * o2 < zero) & (o3 * o4 < zero);
+
+  return (crossed | (d2 < r * r)) & (zero < r);
+}
+
+// 線分が box に当たるか
+// 線分が box と交差するか, 線分の端点と box, box の角と線分の距離がマージンより小さければ当たる
+template <class P>
+typename P::mask box_collided(const segment_query& q, typename P::value min_x,
+                              typename P::value min_y, typename P::value max_x,
+                              typename P::value max_y, typename P::value margin) {
+  const auto zero = P::broadcast(0.0);
+  const auto ax   = P::broadcast(q.ax);
+  const auto ay   = P::broadcast(q.ay);
+
+  const auto [x1, x2] = slab<P>(ax, P::broadcast(q.dx), min_x, max_x);
+  const auto [y1, y2] = slab<P>(ay, P::broadcast(q.dy), min_y, max_y);
+  const auto crossed =
+      P::max(P::max(x1, y1), zero) <= P::min(P::min(x2, y2), P::broadcast(1.0));
+
+  // 点 (px, py) から box までの距離の 2 乗
+  const auto box_distance2 = [&](typename P::value px, typename P::value py) {
+    const auto ex = P::max(P::max(min_x - px, px - max_x), zero);
+    const auto ey = P::max(P::max(min_y - py, py - max_y), zero);
+    return ex * ex + ey * ey;
+  };
+  const auto d2 = P::min(
+      P::min(P::min(box_distance2(ax, ay),
+                    box_distance2(P::broadcast(q.ax + q.dx), P::broadcast(q.ay + q.dy))),
+             P::min(q.distance2<P>(min_x, min_y), q.distance2<P>(max_x, max_y))),
+      P::min(q.distance2<P>(min_x, max_y), q.distance2<P>(max_x, min_y)));
+
+  return (crossed | (d2 < margin * margin)) & (zero < margin);
+}
+
+// ray がカプセルに入る l
+// 両端の円と, 軸に沿った長方形のうち最初に入るもの
+template <class P>
+typename P::value capsule_entry(const ray_query& q, typename P::value x, typename P::value y,
+                                typename P::value ux, typename P::value uy,
+                                typename P::value length, typename P::value r) {
+  const auto r2   = r * r;
+  const auto ends = P::min(q.enter_circle<P>(x, y, r2),
+                           q.enter_circle<P>(x + length * ux, y + length * uy, r2));
+
+  // 軸の方向を u, 法線の方向を v とする座標系で考える
+  const auto zero = P::broadcast(0.0);
+  const auto wx   = P::broadcast(q.sx) - x;
+  const auto wy   = P::broadcast(q.sy) - y;
+  const auto vx   = P::broadcast(q.ux);
+  const auto vy   = P::broadcast(q.uy);
+  const auto body = enter_rect<P>(wx * ux + wy * uy, wy * ux - wx * uy, vx * ux + vy * uy,
+                                  vy * ux - vx * uy, zero, zero - r, length, r);
+  return P::min(ends, body);
+}
+
+// ray がマージンを含めた box に入る l
+// 縦横それぞれにマージン分広げた 2 つの長方形と, 4 つの角の円のうち最初に入るもの
+template <class P>
+typename P::value box_entry(const ray_query& q, typename P::value min_x,
+                            typename P::value min_y, typename P::value max_x,
+                            typename P::value max_y, typename P::value margin) {
+  const auto sx = P::broadcast(q.sx);
+  const auto sy = P::broadcast(q.sy);
+  const auto vx = P::broadcast(q.ux);
+  const auto vy = P::broadcast(q.uy);
+  const auto m2 = margin * margin;
+
+  const auto rects =
+      P::min(enter_rect<P>(sx, sy, vx, vy, min_x - margin, min_y, max_x + margin, max_y),
+             enter_rect<P>(sx, sy, vx, vy, min_x, min_y - margin, max_x, max_y + margin));
+  const auto corners = P::min(
+      P::min(q.enter_circle<P>(min_x, min_y, m2), q.enter_circle<P>(max_x, max_y, m2)),
+      P::min(q.enter_circle<P>(min_x, max_y, m2), q.enter_circle<P>(max_x, min_y, m2)));
+
+  return P::select(P::broadcast(0.0) < margin, P::min(rects, corners), P::broadcast(inf));
+}
+
+} // namespace
+
+void obstacle_batch::add(const model::obstacle::point& o) {
+  circles_.x.push_back(o.geometry.x());
+  circles_.y.push_back(o.geometry.y());
+  circles_.r.push_back(o.margin);
+}
+
+void obstacle_batch::add(const model::obstacle::segment& o) {
+  const Eigen::Vector2d e = o.geometry.second - o.geometry.first;
+  const auto length       = e.norm();
+  const Eigen::Vector2d u = length > 0.0 ? (e / length).eval() : Eigen::Vector2d::Zero();
+  capsules_.x.push_back(o.geometry.first.x());
+  capsules_.y.push_back(o.geometry.first.y());
+  capsules_.ux.push_back(u.x());
+  capsules_.uy.push_back(u.y());
+  capsules_.length.push_back(length);
+  capsules_.r.push_back(o.margin);
+}
+
+void obstacle_batch::add(const model::obstacle::box& o) {
+  boxes_.min_x.push_back(o.geometry.min_corner().x());
+  boxes_.min_y.push_back(o.geometry.min_corner().y());
+  boxes_.max_x.push_back(o.geometry.max_corner().x());
+  boxes_.max_y.push_back(o.geometry.max_corner().y());
+  boxes_.margin.push_back(o.margin);
+}
+
+void obstacle_batch::set_field(std::shared_ptr<const distance_field> field) {
+  field_ = std::move(field);
+}
+
+const std::shared_ptr<const distance_field>& obstacle_batch::field() const {
+  return field_;
+}
+
+void obstacle_batch::set_kernel(kernel k) {
+  kernel_ = k;
+}
+
+std::size_t obstacle_batch::size() const {
+  return circles_.x.size() + capsules_.x.size() + boxes_.min_x.size() +
+         (field_ ? field_->obstacles().size() : 0);
+}
+
+bool obstacle_batch::is_collided(const Eigen::Vector2d& a, const Eigen::Vector2d& b) const {
+  if (field_ && field_->is_collided(a, b)) return true;
+
+  const segment_query q{a, b};
+
+  const auto circle = [&](auto p, std::size_t i) {
+    using P = decltype(p);
+    return circle_collided<P>(q, P::load(circles_.x, i), P::load(circles_.y, i),
+                              P::load(circles_.r, i));
+  };
+  const auto capsule = [&](auto p, std::size_t i) {
+    using P = decltype(p);
+    return capsule_collided<P>(q, P::load(capsules_.x, i), P::load(capsules_.y, i),
+                               P::load(capsules_.ux, i), P::load(capsules_.uy, i),
+                               P::load(capsules_.length, i), P::load(capsules_.r, i));
+  };
+  const auto box = [&](auto p, std::size_t i) {
+    using P = decltype(p);
+    return box_collided<P>(q, P::load(boxes_.min_x, i), P::load(boxes_.min_y, i),
+                           P::load(boxes_.max_x, i), P::load(boxes_.max_y, i),
+                           P::load(boxes_.margin, i));
+  };
+  const auto run = [&](auto p) {
+    using P = decltype(p);
+    return any_of<P>(circles_.x.size(), circle) || any_of<P>(capsules_.x.size(), capsule) ||
+           any_of<P>(boxes_.min_x.size(), box);
+  };
+
+#if defined(__AVX2__)
+  if (kernel_ == kernel::simd) return run(avx2_pack{});
+#endif
+  return run(scalar_pack{});
+}
+
+double obstacle_batch::first_collision(const Eigen::Vector2d& start,
+                                       const Eigen::Vector2d& dir) const {
+  // 伸ばす方向がなければ start だけを調べる
+  if (dir.squaredNorm() == 0.0) return is_collided(start, start) ? 0.0 : inf;
+
+  const ray_query q{start, dir};
+
+  const auto circle = [&](auto p, std::size_t i) {
+    using P = decltype(p);
+    const auto r = P::load(circles_.r, i);
+    return q.enter_circle<P>(P::load(circles_.x, i), P::load(circles_.y, i), r * r);
+  };
+  const auto capsule = [&](auto p, std::size_t i) {
+    using P = decltype(p);
+    return capsule_entry<P>(q, P::load(capsules_.x, i), P::load(capsules_.y, i),
+                            P::load(capsules_.ux, i), P::load(capsules_.uy, i),
+                            P::load(capsules_.length, i), P::load(capsules_.r, i));
+  };
+  const auto box = [&](auto p, std::size_t i) {
+    using P = decltype(p);
+    return box_entry<P>(q, P::load(boxes_.min_x, i), P::load(boxes_.min_y, i),
+                        P::load(boxes_.max_x, i), P::load(boxes_.max_y, i),
+                        P::load(boxes_.margin, i));
+  };
+  const auto run = [&](auto p) {
+    using P = decltype(p);
+    return std::min({min_of<P>(circles_.x.size(), circle),
+                     min_of<P>(capsules_.x.size(), capsule),
+                     min_of<P>(boxes_.min_x.size(), box)});
+  };
+
+  // distance_field の障害物は格子を使って調べる
+  const auto field = field_ ? field_->first_collision(start, dir) : inf;
+
+#if defined(__AVX2__)
+  if (kernel_ == kernel::simd) return std::min(run(avx2_pack{}), field);
+#endif
+  return std::min(run(scalar_pack{}), field);
+}
+
+} // namespace ai_server::planner::detail
@@ -0,0 +1,99 @@
+#ifndef AI_SERVER_PLANNER_DETAIL_OBSTACLE_BATCH_H
+#define AI_SERVER_PLANNER_DETAIL_OBSTACLE_BATCH_H
+
+#include <cstddef>
+#include <memory>
+#include <variant>
+#include <vector>
+#include <Eigen/Core>
+
+#include "ai_server/model/obstacle/box.h"
+#include "ai_server/model/obstacle/point.h"
+#include "ai_server/model/obstacle/segment.h"
+
+namespace ai_server::planner::detail {
+
+class distance_field;
+
+// 障害物を種類ごとに座標の配列 (SoA) で持ち, 1 本の線分と全ての障害物をまとめて調べるもの
+// 点は円, 線分はカプセル, box は角の丸い長方形として扱う
+// 障害物が数十個なら, RTree を辿って 1 つずつ std::visit するより速い
+class obstacle_batch {
+public:
+  // 当たり判定の実装
+  enum class kernel {
+    scalar, // 1 つずつ調べる
+    simd,   // AVX2 で 4 つずつ調べる (AVX2 を有効にしてコンパイルしていなければ scalar と同じ)
+  };
+
+#if defined(__AVX2__)
+  static constexpr bool simd_available = true;
+#else
+  static constexpr bool simd_available = false;
+#endif
+
+  obstacle_batch() = default;
+
+  /// @brief 障害物RTreeの要素 (包括領域と障害物のペア) の範囲から作る
+  template <class InputIterator>
+  obstacle_batch(InputIterator first, InputIterator last) {
+    for (; first != last; ++first) add(std::get<1>(*first));
+  }
+
+  void add(const model::obstacle::point& o);
+  void add(const model::obstacle::segment& o);
+  void add(const model::obstacle::box& o);
+
+  template <class... ObstacleTypes>
+  void add(const std::variant<ObstacleTypes...>& o) {
+    std::visit([this](const auto& arg) { add(arg); }, o);
+  }
+
+  /// @brief 試合中に動かない障害物 (ペナルティエリアなど) を distance_field で設定する
+  ///
+  /// 当たり判定では add() した障害物に加えて distance_field の格子を使って調べる
+  /// @param field 設定する distance_field (nullptr なら使わない)
+  void set_field(std::shared_ptr<const distance_field> field);
+
+  /// @brief 設定した distance_field (設定していなければ nullptr)
+  const std::shared_ptr<const distance_field>& field() const;
+
+  /// @brief 当たり判定の実装を設定する
+  /// @param k 設定値．
+  void set_kernel(kernel k);
+
+  /// @brief 障害物の数 (distance_field の障害物を含む)
+  std::size_t size() const;
+
+  /// @brief 線分 a-b が障害物に当たるか (a == b なら点として調べる)
+  bool is_collided(const Eigen::Vector2d& a, const Eigen::Vector2d& b) const;
+
+  /// @brief start から dir 方向に伸ばした ray が初めて障害物に当たる長さを返す
+  ///
+  /// 長さは dir を単位とする. start が障害物の中にあれば 0 以下の値を,
+  /// どの障害物にも当たらなければ無限大を返す
+  double first_collision(const Eigen::Vector2d& start, const Eigen::Vector2d& dir) const;
+
+private:
+  // 円 (中心と半径)
+  struct circles {
+    std::vector<double> x, y, r;
+  };
+  // カプセル (始点, 始点から終点への単位ベクトル, 長さ, 半径)
+  struct capsules {
+    std::vector<double> x, y, ux, uy, length, r;
+  };
+  // box とマージン
+  struct boxes {
+    std::vector<double> min_x, min_y, max_x, max_y, margin;
+  };
+
+  circles circles_;
+  capsules capsules_;
+  boxes boxes_;
+  std::shared_ptr<const distance_field> field_;
+  kernel kernel_ = kernel::simd;
+};
+} // namespace ai_server::planner::detail
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef AI_SERVER_PLANNER_DETAIL_OBSTACLE_TREE_H
 #define AI_SERVER_PLANNER_DETAIL_OBSTACLE_TREE_H
 
+#include <memory>
 #include <utility>
 #include <variant>
 #include <boost/geometry/index/rtree.hpp>
@@ -9,12 +10,23 @@
 
 namespace ai_server::planner::detail {
 
+class distance_field;
+
 // 障害物RTree
 // 障害物を包括するboxと，障害物のペアを保持
 template <class... ObstacleTypes>
 using tree_type =
     boost::geometry::index::rtree<std::pair<envelope_type, std::variant<ObstacleTypes...>>,
                                   boost::geometry::index::rstar<20>>;
+
+// 複数の planner で共有する障害物RTreeと, planner ごとの障害物RTreeを重ねたもの
+// 全てに含まれる障害物を 1 つの RTree として扱う
+template <class Tree>
+struct layered_tree {
+  std::shared_ptr<const Tree> shared; // nullptr なら local だけ
+  Tree local;
+  std::shared_ptr<const distance_field> field = nullptr; // 試合中に動かない障害物
+};
 } // namespace ai_server::planner::detail
 
 #endif
@@ -0,0 +1,86 @@
+#ifndef AI_SERVER_PLANNER_DETAIL_SPACE_TIME_H
+#define AI_SERVER_PLANNER_DETAIL_SPACE_TIME_H
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include <Eigen/Core>
+
+#include "ai_server/model/obstacle/moving_point.h"
+#include "collision.h"
+
+namespace ai_server::planner::detail {
+
+// ロボットが origin から直線に進んだとき, 各地点に着く時刻での位置で動く障害物を調べるもの
+// 動かない障害物は Static の当たり判定をそのまま使う
+template <class Static>
+struct space_time_obstacles {
+  const Static& statics;                                    // 動かない障害物
+  const std::vector<model::obstacle::moving_point>& moving; // 動く障害物
+  Eigen::Vector2d origin;                                   // ロボットの位置
+  Eigen::Vector2d velocity;                                 // ロボットの速度 [mm/s]
+  double max_velocity;                                      // [mm/s]
+  double max_acceleration;                                  // [mm/s^2]
+  double horizon; // 動く障害物を予測する時間 [s] (それ以降は止まるとみなす)
+
+  /// @brief origin から p まで直線に進んだときに着く時刻 [s]
+  ///
+  /// p の方向の速度成分から最大加速度で加速し, 最大速度に達したらその速度で進むとする
+  double arrival_time(const Eigen::Vector2d& p) const {
+    const Eigen::Vector2d d = p - origin;
+    const auto s            = d.norm();
+    if (s == 0.0) return 0.0;
+
+    const auto v = max_velocity;
+    const auto a = max_acceleration;
+    const auto u = std::clamp(velocity.dot(d) / s, 0.0, v);
+    // 最大速度に達するまでに進む距離
+    const auto s_acc = (v * v - u * u) / (2.0 * a);
+    if (s <= s_acc) return (std::sqrt(u * u + 2.0 * a * s) - u) / a;
+    return (v - u) / a + (s - s_acc) / v;
+  }
+
+  /// @brief p に着いたときに動く障害物に当たっているか
+  bool is_collided_moving(const Eigen::Vector2d& p) const {
+    const auto t = std::min(arrival_time(p), horizon);
+    return std::any_of(moving.begin(), moving.end(), [&p, t](const auto& o) {
+      return (p - (o.geometry + t * o.velocity)).squaredNorm() < o.margin * o.margin;
+    });
+  }
+};
+
+/// @brief 障害物に対する当たり判定を行い，結果を返す
+/// @param p 点
+/// @param obstacles 障害物
+/// @return 当たっている障害物が含まれているときtrue.
+template <class Static>
+inline auto is_collided(const Eigen::Vector2d& p,
+                        const space_time_obstacles<Static>& obstacles) {
+  return is_collided(p, obstacles.statics) || obstacles.is_collided_moving(p);
+}
+
+/// @brief 障害物にぶつかるときの長さを計算する
+/// @param first rayの長さを小さい順に並べたリストの最初の要素
+/// @param last  rayの長さを小さい順に並べたリストの末尾の次の要素
+/// @param start 開始地点 (origin から直線に進んだ先にあること)
+/// @param dir rayを伸ばす方向
+/// @param obstacles 障害物
+/// @return 障害物にぶつかる最小長さの要素
+template <class Iterator, class Static>
+inline auto find_collided_length(Iterator first, Iterator last, const Eigen::Vector2d& start,
+                                 const Eigen::Vector2d& dir,
+                                 const space_time_obstacles<Static>& obstacles) {
+  static_assert(std::is_floating_point_v<typename std::iterator_traits<Iterator>::value_type>);
+
+  // 動かない障害物で探索範囲を狭めてから, 各長さの地点に着く時刻で動く障害物を調べる
+  // 動く障害物は通り過ぎることがあるので, 短い方から順に調べる
+  last = find_collided_length(first, last, start, dir, obstacles.statics);
+  return std::find_if(first, last, [&start, &dir, &obstacles](auto l) {
+    return obstacles.is_collided_moving((start + l * dir).eval());
+  });
+}
+} // namespace ai_server::planner::detail
+
+#endif
@@ -1,66 +1,64 @@
+#include <algorithm>
+#include <boost/container_hash/hash.hpp>
+
 #include "ai_server/util/math/to_vector.h"
 #include "impl/human_like.h"
 #include "human_like.h"
 
 namespace ai_server::planner {
 
+human_like::human_like() : rotations_{impl::make_rotations(direction_count_)} {
+  update_lengths();
+}
+
 void human_like::set_direction_count(int count) {
   direction_count_ = count;
+  rotations_       = impl::make_rotations(direction_count_);
 }
 
 void human_like::set_max_exit_length(double length) {
   max_exit_length_ = length;
+  update_lengths();
 }
 
 void human_like::set_max_length(double length) {
   max_length_ = length;
+  update_lengths();
 }
 
 void human_like::set_min_length(double length) {
   min_length_ = length;
+  update_lengths();
 }
 
 void human_like::set_step_length(double length) {
   step_length_ = length;
+  update_lengths();
 }
 
 base::planner_type human_like::planner() {
   return [this](const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
                 const obstacle_list& obs) {
-    // 障害物
-    const auto obstacles = obs.to_tree();
-    // 移動可能領域
-    impl::box_type area{min_pos_, max_pos_};
-    // スタートからゴールまでのベクトル
-    const Eigen::Vector2d sg = goal - start;
-
-    // 長さを調整
-    const double l_max = std::min(max_length_, sg.norm());
-    const double l_min = std::min(min_length_, l_max);
-
-    // 方向と長さのリスト
-    const auto lengths = impl::make_length_list(l_min, l_max, step_length_);
-    const auto dirs    = impl::make_directions(
-        sg.norm() > 0.0 ? sg.normalized() : Eigen::Vector2d::UnitX(), direction_count_);
-
-    // Human-Likeによる探索結果
-    const auto plan_result = impl::planned_position(start, dirs, lengths, obstacles, area);
+    return plan(start, goal, obs.to_batch(reach(start)));
+  };
+}
 
-    // 最終的な結果
-    Eigen::Vector2d result;
-    if (plan_result.has_value()) {
-      result = plan_result.value();
-    } else {
-      // 脱出
-      const auto exit_lengths = impl::make_length_list(l_min, max_exit_length_, step_length_);
-      const auto exit_p       = impl::exit_position(start, dirs, exit_lengths, obstacles, area);
+std::size_t human_like::settings_hash() const {
+  auto seed = base::settings_hash();
+  boost::hash_combine(seed, direction_count_);
+  for (const auto v : {step_length_, max_length_, min_length_, max_exit_length_}) {
+    boost::hash_combine(seed, v);
+  }
+  return seed;
+}
 
-      result = exit_p.value_or(
-          // 最低でも min_length_ は進ませる
-          impl::default_position(start, sg.normalized(), min_length_, area));
-    }
+void human_like::update_lengths() {
+  lengths_      = impl::make_length_list(min_length_, max_length_, step_length_);
+  exit_lengths_ = impl::make_length_list(min_length_, max_exit_length_, step_length_);
+}
 
-    return std::make_pair(result, (result - start).norm());
-  };
+detail::envelope_type human_like::reach(const Eigen::Vector2d& start) const {
+  const auto r = std::max(max_length_, max_exit_length_);
+  return {start - Eigen::Vector2d{r, r}, start + Eigen::Vector2d{r, r}};
 }
 } // namespace ai_server::planner
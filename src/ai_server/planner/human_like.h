@@ -1,11 +1,18 @@
 #ifndef AI_SERVER_PLANNER_HUMAN_LIKE_H
 #define AI_SERVER_PLANNER_HUMAN_LIKE_H
 
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
 #include "base.h"
+#include "detail/geometry_helper.h"
 
 namespace ai_server::planner {
 class human_like : public base {
 public:
+  human_like();
+
   /// @brief ロボットが進むことのできる方向の数を設定する
   /// @param count            設定値
   void set_direction_count(int count);
@@ -28,7 +35,9 @@ public:
 
   base::planner_type planner() override;
 
-private:
+  std::size_t settings_hash() const override;
+
+protected:
   // rayを伸ばす方向の数
   int direction_count_ = 16;
   // rayを１段階のばすときの長さ
@@ -39,6 +48,27 @@ private:
   double min_length_ = 100.0;
   // 障害物エリアから脱出するときの最大距離
   double max_exit_length_ = 3000.0;
+
+  // 基準方向から rayを伸ばす各方向への回転 (direction_count_ を設定したときに作り直す)
+  std::vector<Eigen::Rotation2D<double>> rotations_;
+  // min_length_ から max_length_ まで step_length_ ずつ伸ばした長さのリスト
+  std::vector<double> lengths_;
+  // min_length_ から max_exit_length_ まで step_length_ ずつ伸ばした長さのリスト
+  std::vector<double> exit_lengths_;
+
+  /// @brief 長さのリストを作り直す
+  void update_lengths();
+
+  /// @brief start から伸ばした rayが届く範囲
+  detail::envelope_type reach(const Eigen::Vector2d& start) const;
+
+  /// @brief Human-Likeアルゴリズムで移動先を求める (定義は impl/human_like.h)
+  /// @param start            初期位置
+  /// @param goal             目標位置
+  /// @param obstacles        障害物 (detail::is_collided と find_collided_length で調べられるもの)
+  template <class Obstacles>
+  result_type plan(const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
+                   const Obstacles& obstacles) const;
 };
 } // namespace ai_server::planner
 
@@ -16,36 +16,60 @@
 #include "ai_server/util/math/to_vector.h"
 #include "ai_server/planner/detail/clipping.h"
 #include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/detail/space_time.h"
+#include "ai_server/planner/human_like.h"
 #include "ai_server/planner/obstacle_list.h"
 
 namespace ai_server::planner::impl {
 using box_type     = boost::geometry::model::box<Eigen::Vector2d>;
 using segment_type = boost::geometry::model::segment<Eigen::Vector2d>;
 
-/// @brief rayを伸ばす方向のリストを作る
-/// @param dir                   基準方向
+/// @brief 基準方向から rayを伸ばす各方向への回転のリストを作る
+///
+/// 基準方向, その両隣, さらにその両隣... の順に並べる
 /// @param dir_count             伸ばす方向の数
 /// @return 作成したリスト
-inline std::vector<Eigen::Vector2d> make_directions(const Eigen::Vector2d& dir, int dir_count) {
+inline std::vector<Eigen::Rotation2D<double>> make_rotations(int dir_count) {
   // rayとrayの間の角度
   const double step = boost::math::constants::two_pi<double>() / dir_count;
 
   const int max     = dir_count / 2 + 1;
   const bool is_odd = dir_count % 2 > 0;
 
-  std::vector<Eigen::Vector2d> result;
+  std::vector<Eigen::Rotation2D<double>> result;
   for (int i = 0; i < max; ++i) {
     Eigen::Rotation2D<double> rot{i * step};
     // +側
-    result.push_back(rot * dir);
+    result.push_back(rot);
     // -側
     if (i > 0 && (is_odd || i + 1 < max)) {
-      result.push_back(rot.inverse() * dir);
+      result.push_back(rot.inverse());
     }
   }
   return result;
 }
 
+/// @brief 基準方向を回転して rayを伸ばす方向のリストを作る
+/// @param dir                   基準方向
+/// @param rotations             make_rotations(...)で作成したリスト
+/// @param result                作成したリストを入れる先
+inline void rotate_directions(const Eigen::Vector2d& dir,
+                              const std::vector<Eigen::Rotation2D<double>>& rotations,
+                              std::vector<Eigen::Vector2d>& result) {
+  result.clear();
+  for (const auto& rot : rotations) result.push_back(rot * dir);
+}
+
+/// @brief rayを伸ばす方向のリストを作る
+/// @param dir                   基準方向
+/// @param dir_count             伸ばす方向の数
+/// @return 作成したリスト
+inline std::vector<Eigen::Vector2d> make_directions(const Eigen::Vector2d& dir, int dir_count) {
+  std::vector<Eigen::Vector2d> result;
+  rotate_directions(dir, make_rotations(dir_count), result);
+  return result;
+}
+
 /// @brief rayを伸ばす長さのリストを作る
 /// @param l_min                 最小長さ
 /// @param l_max                 最大長さ
@@ -60,17 +84,32 @@ inline std::vector<double> make_length_list(double l_min, double l_max, double l
   return result;
 }
 
+/// @brief 作っておいた長さのリストを l_max で打ち切る
+///
+/// make_length_list(l_min, l_max_table, l_step) で作ったリストから, l_max (<= l_max_table)
+/// 未満の要素と l_max を取り出す. make_length_list(std::min(l_min, l_max), l_max, l_step)
+/// と同じになる
+/// @param table                 make_length_list(...)で作成したリスト
+/// @param l_max                 最大長さ
+/// @param result                作成したリストを入れる先
+inline void truncate_lengths(const std::vector<double>& table, double l_max,
+                             std::vector<double>& result) {
+  result.assign(table.begin(), std::lower_bound(table.begin(), table.end(), l_max));
+  result.push_back(l_max);
+}
+
 /// @brief  Human-Likeアルゴリズムが使えないときの経路探索を行い，結果を返す
 /// @param start                 初期位置
 /// @param dirs                  make_directions(...)で作成したリスト
 /// @param lengths               make_length_list(...)で作成したリスト
-/// @param obstacles             障害物リスト
+/// @param obstacles             障害物 (obstacle_list::to_batch() の結果など)
 /// @param area                  移動可能範囲
 /// @return 経路探索の結果
+template <class Obstacles>
 inline std::optional<Eigen::Vector2d> exit_position(const Eigen::Vector2d& start,
                                                     const std::vector<Eigen::Vector2d>& dirs,
                                                     const std::vector<double>& lengths,
-                                                    const obstacle_list::tree_type& obstacles,
+                                                    const Obstacles& obstacles,
                                                     const box_type& area) {
   // 候補がないとき
   if (dirs.empty() || lengths.empty()) return std::nullopt;
@@ -173,13 +212,15 @@ inline Eigen::Vector2d default_position(const Eigen::Vector2d& start,
 /// @param start                 初期位置
 /// @param dirs                  make_directions(...)で作成したリスト
 /// @param lengths               make_length_list(...)で作成したリスト
-/// @param obstacles             障害物リスト
+/// @param obstacles             障害物 (obstacle_list::to_batch() の結果など)
 /// @param area                  移動可能範囲
 /// @return 経路探索の結果
-inline std::optional<Eigen::Vector2d> planned_position(
-    const Eigen::Vector2d& start, const std::vector<Eigen::Vector2d>& dirs,
-    const std::vector<double>& lengths, const obstacle_list::tree_type& obstacles,
-    const box_type& area) {
+template <class Obstacles>
+inline std::optional<Eigen::Vector2d> planned_position(const Eigen::Vector2d& start,
+                                                       const std::vector<Eigen::Vector2d>& dirs,
+                                                       const std::vector<double>& lengths,
+                                                       const Obstacles& obstacles,
+                                                       const box_type& area) {
   if ( // 障害物に当たっている
       detail::is_collided(start, obstacles) ||
       // 候補が無い
@@ -247,4 +288,50 @@ inline std::optional<Eigen::Vector2d> planned_position(
 }
 } // namespace ai_server::planner::impl
 
+namespace ai_server::planner {
+template <class Obstacles>
+base::result_type human_like::plan(const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
+                                   const Obstacles& obstacles) const {
+  // 移動可能領域
+  impl::box_type area{min_pos_, max_pos_};
+  // スタートからゴールまでのベクトル
+  const Eigen::Vector2d sg = goal - start;
+
+  // 長さを調整
+  const double l_max = std::min(max_length_, sg.norm());
+  const double l_min = std::min(min_length_, l_max);
+
+  // 方向と長さのリスト (作っておいたものを回転, 打ち切りして使い, 領域は使い回す)
+  thread_local std::vector<double> lengths;
+  thread_local std::vector<Eigen::Vector2d> dirs;
+  impl::truncate_lengths(lengths_, l_max, lengths);
+  impl::rotate_directions(sg.norm() > 0.0 ? sg.normalized() : Eigen::Vector2d::UnitX(),
+                          rotations_, dirs);
+
+  // Human-Likeによる探索結果
+  const auto plan_result = impl::planned_position(start, dirs, lengths, obstacles, area);
+
+  // 最終的な結果
+  Eigen::Vector2d result;
+  if (plan_result.has_value()) {
+    result = plan_result.value();
+  } else {
+    // 脱出
+    // 最小長さが設定値と違えば作り直す
+    const auto exit_p =
+        l_min == min_length_
+            ? impl::exit_position(start, dirs, exit_lengths_, obstacles, area)
+            : impl::exit_position(start, dirs,
+                                  impl::make_length_list(l_min, max_exit_length_, step_length_),
+                                  obstacles, area);
+
+    result = exit_p.value_or(
+        // 最低でも min_length_ は進ませる
+        impl::default_position(start, sg.normalized(), min_length_, area));
+  }
+
+  return std::make_pair(result, (result - start).norm());
+}
+} // namespace ai_server::planner
+
 #endif
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <random>
@@ -8,27 +9,29 @@
 #include "ai_server/util/math/to_vector.h"
 #include "rrt_star.h"
 
-// RTree用
-namespace boost::geometry::index {
-using node_ptr_t = std::shared_ptr<ai_server::planner::impl::rrt_star::node>;
-
-template <>
-struct indexable<node_ptr_t> {
-  using value_type  = node_ptr_t;
-  using result_type = const Eigen::Vector2d&;
-  result_type operator()(const value_type& v) const {
-    return v->position;
-  }
-};
-} // namespace boost::geometry::index
-
 namespace ai_server::planner::impl {
 
 using double_limits = std::numeric_limits<double>;
 
+// 基準半径
+static const double r_a = 2000 / std::sqrt(std::log10(2.0) / 2.0);
+
+// n 個のノードがあるときの近傍点リストを作る円の半径
+static double neighbor_radius(std::size_t n) {
+  return r_a * std::sqrt(std::log10(n + 1) / (n + 1));
+}
+
+// 探索木を繋ぎ直すときに調べる近傍点の数
+static constexpr unsigned int repair_neighbors = 8;
+
+// 経路の終端を選ぶときに調べる, 目標位置の近傍点の数
+static constexpr unsigned int goal_candidates = 16;
+
 rrt_star::rrt_star()
-    : node_count_(10),
+    : node_count_(20),
       max_branch_length_(300.0),
+      reuse_(false),
+      max_nodes_(200),
       area_({double_limits::lowest(), double_limits::lowest()},
             {double_limits::max(), double_limits::max()}) {
   std::random_device rnd;
@@ -51,14 +54,36 @@ void rrt_star::set_max_branch_length(double length) {
   max_branch_length_ = length;
 }
 
-rrt_star::result_type rrt_star::execute(const Eigen::Vector2d& start_pos,
-                                        const Eigen::Vector2d& goal_pos,
-                                        const obstacle_list& obs) {
+void rrt_star::set_reuse(bool reuse) {
+  reuse_ = reuse;
+}
+
+void rrt_star::set_max_nodes(std::size_t count) {
+  max_nodes_ = count;
+}
+
+void rrt_star::set_seed(std::uint32_t seed) {
+  mt_.seed(seed);
+}
+
+std::size_t rrt_star::tree_size() const {
+  return reuse_ ? nodes_.size() : 0;
+}
+
+rrt_star::result_type rrt_star::execute(
+    const Eigen::Vector2d& start_pos, const Eigen::Vector2d& goal_pos, const obstacle_list& obs,
+    std::optional<std::chrono::steady_clock::time_point> deadline) {
   // 障害物取得
-  const auto obstacles = obs.to_tree();
+  // 障害物が少ないので, RTree より種類ごとの配列でまとめて調べる方が速い
+  const auto obstacles = obs.to_batch();
+
+  // 前回の探索木 (再利用しないときは捨てる)
+  previous_.swap(nodes_);
+  nodes_.clear();
+  if (!reuse_) previous_.clear();
 
   // 障害物の圏内から脱出する必要があるとき
-  if (auto p = exit_position(start_pos, goal_pos, max_branch_length_, obstacles)) {
+  if (auto p = exit_position(start_pos, goal_pos, max_branch_length_, obs, obstacles)) {
     return std::make_pair(*p, (*p - start_pos).norm());
   }
 
@@ -69,108 +94,143 @@ rrt_star::result_type rrt_star::execute(const Eigen::Vector2d& start_pos,
 
   // === rrt star ===
 
-  // 探索木(nodeの集まり)
+  // 探索木(nodeの番号の集まり)
   tree_t tree;
 
   // 初期ノード追加
-  tree.insert(std::make_shared<node>(start_pos, 0.0, nullptr));
-
-  // 基準半径
-  const double r_a = 2000 / std::sqrt(std::log10(2.0) / 2.0);
+  nodes_.reserve(previous_.size() + node_count_ + 1);
+  nodes_.push_back({start_pos, 0.0, no_parent});
+  tree.insert({start_pos, 0});
+
+  // 前回の探索木を繋ぎ直す
+  if (reuse_) repair(goal_pos, obstacles, tree);
+  const auto reused = nodes_.size() - 1;
+
+  // 新しいノードを作るか
+  // 期限は処理時間の制限なので, util::clock ではなく実際の時刻と比べる
+  const auto proceed = [this, &deadline](std::size_t c) {
+    if (!deadline) return c < static_cast<std::size_t>(node_count_);
+    return c == 0 || (c < max_nodes_ && std::chrono::steady_clock::now() < *deadline);
+  };
 
-  for (int c = 0; c < node_count_; ++c) {
+  for (std::size_t c = 0; proceed(c); ++c) {
     // 新しいノード
-    const auto new_node = make_node(goal_pos, max_branch_length_, obstacles, tree);
+    auto new_node   = make_node(goal_pos, max_branch_length_, obstacles, tree);
+    const auto& np  = new_node.position;
+    const auto index = static_cast<std::uint32_t>(nodes_.size());
 
     // 近傍点リストを作る円の半径
-    const double r = r_a * std::sqrt(std::log10(c + 1) / (c + 1));
+    const double r = neighbor_radius(reused + c);
 
     // 先に大まかに絞り込むための範囲
-    const auto around = detail::to_envelope(new_node->position, r);
+    const auto around = detail::to_envelope(np, r);
 
-    // 近傍点リスト
-    std::vector<std::weak_ptr<node>> list;
-    // 半径と障害物でフィルタリング
+    // 近傍点リスト (半径でフィルタリング)
+    neighbors_.clear();
     tree.query(boost::geometry::index::within(around) &&
                    boost::geometry::index::satisfies(
-                       [&obstacles, &np = new_node->position, r](const auto& a) {
-                         return (a->position - np).norm() < r &&
-                                !detail::is_collided(line_t{a->position, np}, obstacles);
-                       }),
-               std::back_inserter(list));
+                       [&np, r](const auto& a) { return (a.first - np).norm() < r; }),
+               std::back_inserter(neighbors_));
 
     // これまでの道と新しいノードからの道を比較してコスト低ならノード再接続
-    if (!list.empty()) {
-      const auto min = *std::min_element(
-          list.begin(), list.end(), [&np = new_node->position](const auto& a, const auto& b) {
-            return a.lock()->cost + (np - a.lock()->position).norm() <
-                   b.lock()->cost + (np - b.lock()->position).norm();
-          });
-
-      //コスト低ならノード再接続
-      const auto min_cost =
-          min.lock()->cost + (new_node->position - min.lock()->position).norm();
-      if (min_cost < new_node->cost) {
-        new_node->parent = min.lock();
-        new_node->cost   = min_cost;
+    // 障害物の判定が重いので, コストの小さい順に調べて最初に障害物がなかったものを使う
+    std::sort(neighbors_.begin(), neighbors_.end(), [this, &np](const auto& a, const auto& b) {
+      return nodes_[a.second].cost + (np - a.first).norm() <
+             nodes_[b.second].cost + (np - b.first).norm();
+    });
+    for (const auto& [p, i] : neighbors_) {
+      const auto cost = nodes_[i].cost + (np - p).norm();
+      if (cost >= new_node.cost) break;
+      if (!detail::is_collided(line_t{p, np}, obstacles)) {
+        new_node.parent = i;
+        new_node.cost   = cost;
+        break;
       }
     }
 
     // treeに追加
-    tree.insert(new_node);
+    nodes_.push_back(new_node);
+    tree.insert({np, index});
 
     // 他のノードから新たなノードに再接続
-    for (auto& a : list) {
-      const double cost = new_node->cost + (new_node->position - a.lock()->position).norm();
-      if (cost < a.lock()->cost) {
-        a.lock()->parent = new_node;
-        a.lock()->cost   = cost;
+    // (コストが下がるものだけ障害物を判定する)
+    for (const auto& [p, i] : neighbors_) {
+      const double cost = new_node.cost + (np - p).norm();
+      if (cost < nodes_[i].cost && !detail::is_collided(line_t{p, np}, obstacles)) {
+        nodes_[i].parent = index;
+        nodes_[i].cost   = cost;
       }
     }
   }
 
-  // 目標位置に最も近いノード
-  const auto nearest_node = tree.qbegin(boost::geometry::index::nearest(goal_pos, 1));
+  // 目標位置の近くのノードのうち, 目標位置まで障害物なしで進めてコストが最小になるもの
+  // (そのようなノードがなければ目標位置に最も近いノード)
+  const auto goal_node = [this, &tree, &goal_pos, &obstacles] {
+    auto it   = tree.qbegin(boost::geometry::index::nearest(goal_pos, goal_candidates));
+    auto best = it->second;
+    auto cost = double_limits::max();
+    for (; it != tree.qend(); ++it) {
+      const auto c = nodes_[it->second].cost + (goal_pos - it->first).norm();
+      if (c < cost && !detail::is_collided(line_t{it->first, goal_pos}, obstacles)) {
+        best = it->second;
+        cost = c;
+      }
+    }
+    return best;
+  }();
+
+  // 今回の経路上の点を次ループで優先して探索する
+  priority_points_ = {};
 
   double trajectory_length;
 
   // 目的地を探す。
-  const auto& p = [this, &nearest_node, &start_pos, &goal_pos, &obstacles,
-                   &trajectory_length]() {
+  const auto p = [this, goal_node, &start_pos, &goal_pos, &obstacles, &trajectory_length]() {
     // 目的地とその一つ手前のノード間の距離を代入
-    trajectory_length = ((*nearest_node)->position - goal_pos).norm();
+    trajectory_length = (nodes_[goal_node].position - goal_pos).norm();
 
     // スムージングした後の値を返す。
-    for (std::weak_ptr<node> n = *nearest_node; n.lock()->parent.lock(); n = n.lock()->parent) {
-      const auto& p = n.lock()->position;
+    // 親子関係は循環しない. repair() は先に繋いだノードだけを親にし, 再接続は親のコストが
+    // 子のコスト以下に保たれたまま, 新しいノードを経由してコストが下がるときだけ行うので,
+    // 新しいノードの祖先がその子になることはない. 辿る回数をノード数までにしているのは念のため
+    auto n = goal_node;
+    for (std::size_t k = 0; k < nodes_.size() && nodes_[n].parent != no_parent; ++k) {
+      const auto& p = nodes_[n].position;
       priority_points_.push(p);
 
       // それぞれのノード間の距離を積分
-      trajectory_length += (p - n.lock()->parent.lock()->position).norm();
+      trajectory_length += (p - nodes_[nodes_[n].parent].position).norm();
 
       // スタート地点とノード間に障害物が無くなったとき
       if (!detail::is_collided(line_t{start_pos, p}, obstacles)) {
         // スタート地点とノード間の距離を加算
         trajectory_length += (p - start_pos).norm();
 
-        return n.lock()->position;
+        return p;
       }
+
+      n = nodes_[n].parent;
     }
     // start_posを指定し続ける
     trajectory_length = 0.0;
     return start_pos;
   }();
 
+  if (!reuse_) nodes_.clear();
+
   return std::make_pair(p, trajectory_length);
 }
 
 std::optional<Eigen::Vector2d> rrt_star::exit_position(
     const Eigen::Vector2d& start, const Eigen::Vector2d& goal, double d,
-    const obstacle_list::tree_type& obstacles) const {
-  const auto collided_itr = detail::extract_collisions(obstacles, start);
+    const obstacle_list& obs, const detail::obstacle_batch& obstacles) const {
+  // 衝突している障害物のうち最も近いもの (衝突していなければ RTree は作らない)
+  const auto collided = detail::is_collided(start, obstacles)
+                            ? detail::nearest_collision(obs.to_tree(), start)
+                            : std::nullopt;
 
   // 衝突する障害物がない
-  if (collided_itr == obstacles.qend()) {
+  if (!collided) {
     // field外のとき
     if (!boost::geometry::within(start, area_)) {
       return Eigen::Vector2d::Zero();
@@ -180,18 +240,7 @@ std::optional<Eigen::Vector2d> rrt_star::exit_position(
     return std::nullopt;
   }
 
-  // 障害物との距離を取得する関数
-  auto obstacle_distance = [&start](auto&& o) {
-    return std::visit(
-        [&start](auto&& arg) { return boost::geometry::distance(start, arg.geometry); }, o);
-  };
-
-  // 最も近い要素を探す
-  const auto nearest = *std::min_element(
-      collided_itr, obstacles.qend(), [&obstacle_distance](const auto& a, const auto& b) {
-        return obstacle_distance(std::get<1>(a)) < obstacle_distance(std::get<1>(b));
-      });
-
+  const auto& nearest  = *collided;
   const auto& obstacle = std::get<1>(nearest);
 
   //線分のとき
@@ -272,10 +321,8 @@ std::optional<Eigen::Vector2d> rrt_star::exit_position(
   return std::nullopt;
 }
 
-std::shared_ptr<rrt_star::node> rrt_star::make_node(const Eigen::Vector2d& goal,
-                                                    double max_branch_length,
-                                                    const obstacle_list::tree_type& obstacles,
-                                                    const tree_t& tree) {
+rrt_star::node rrt_star::make_node(const Eigen::Vector2d& goal, double max_branch_length,
+                                  const detail::obstacle_batch& obstacles, const tree_t& tree) {
   // ランダム点の分布
   constexpr double rand_margin = 1000.0;
   const boost::random::uniform_real_distribution<> rand_x{area_.min_corner().x() - rand_margin,
@@ -314,22 +361,74 @@ std::shared_ptr<rrt_star::node> rrt_star::make_node(const Eigen::Vector2d& goal,
     }();
 
     // 最も近い点
-    const auto nearest_node = tree.qbegin(boost::geometry::index::nearest(sample, 1));
+    const auto [nearest, index] = *tree.qbegin(boost::geometry::index::nearest(sample, 1));
 
     // 同じ点だったら却下
-    if (!boost::geometry::equals(sample, (*nearest_node)->position)) {
+    if (!boost::geometry::equals(sample, nearest)) {
       // 最も近い点から一定距離を置いて点を打ち、コースに障害物がないことを確認
-      const auto new_p = to_new_p((*nearest_node)->position, sample);
+      const auto new_p = to_new_p(nearest, sample);
 
       if (!detail::is_collided(new_p, obstacles) && boost::geometry::within(new_p, area_)) {
-        return std::make_shared<node>(
-            new_p, (*nearest_node)->cost + (new_p - (*nearest_node)->position).norm(),
-            *nearest_node);
+        return {new_p, nodes_[index].cost + (new_p - nearest).norm(), index};
       }
     }
   }
 }
 
-rrt_star::node::node(const Eigen::Vector2d& pos, double c, const std::shared_ptr<node>& ptr)
-    : position(pos), cost(c), parent(ptr) {}
+void rrt_star::repair(const Eigen::Vector2d& goal, const detail::obstacle_batch& obstacles,
+                      tree_t& tree) {
+  // 根と, 移動可能領域の外や障害物に当たるノードは使わない
+  candidates_.clear();
+  for (std::uint32_t i = 0; i < previous_.size(); ++i) {
+    const auto& n = previous_[i];
+    if (n.parent != no_parent && boost::geometry::within(n.position, area_) &&
+        !detail::is_collided(n.position, obstacles)) {
+      candidates_.push_back(i);
+    }
+  }
+
+  // 上限を超えるときは目的地までのコストの見積もりが小さいものを残す
+  if (candidates_.size() > max_nodes_) {
+    std::nth_element(candidates_.begin(), candidates_.begin() + max_nodes_, candidates_.end(),
+                     [this, &goal](auto a, auto b) {
+                       const auto& na = previous_[a];
+                       const auto& nb = previous_[b];
+                       return na.cost + (goal - na.position).norm() <
+                              nb.cost + (goal - nb.position).norm();
+                     });
+    candidates_.resize(max_nodes_);
+  }
+
+  // 前回の根に近いものから繋ぐ (前回の親は子より先に繋がれる)
+  std::sort(candidates_.begin(), candidates_.end(),
+            [this](auto a, auto b) { return previous_[a].cost < previous_[b].cost; });
+
+  for (const auto i : candidates_) {
+    const auto& p  = previous_[i].position;
+    const double r = std::max(neighbor_radius(nodes_.size()), max_branch_length_);
+
+    // 近くのノードのうち, 障害物に当たらずに繋げてコストが最小になるものを親にする
+    neighbors_.clear();
+    tree.query(boost::geometry::index::nearest(p, repair_neighbors),
+               std::back_inserter(neighbors_));
+    std::sort(neighbors_.begin(), neighbors_.end(), [this, &p](const auto& a, const auto& b) {
+      return nodes_[a.second].cost + (p - a.first).norm() <
+             nodes_[b.second].cost + (p - b.first).norm();
+    });
+    auto parent = no_parent;
+    double cost = double_limits::max();
+    for (const auto& [q, j] : neighbors_) {
+      if ((p - q).norm() < r && !detail::is_collided(line_t{q, p}, obstacles)) {
+        parent = j;
+        cost   = nodes_[j].cost + (p - q).norm();
+        break;
+      }
+    }
+    // どこにも繋げないノード (とその先の枝) は捨てる
+    if (parent == no_parent) continue;
+
+    tree.insert({p, static_cast<std::uint32_t>(nodes_.size())});
+    nodes_.push_back({p, cost, parent});
+  }
+}
 } // namespace ai_server::planner::impl
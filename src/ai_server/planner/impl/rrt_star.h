@@ -1,9 +1,14 @@
 #ifndef AI_SERVER_PLANNER_IMPL_RRT_STAR_H
 #define AI_SERVER_PLANNER_IMPL_RRT_STAR_H
 
-#include <memory>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <queue>
+#include <utility>
+#include <vector>
 #include <boost/geometry/algorithms/distance.hpp>
 #include <boost/geometry/geometries/box.hpp>
 #include <boost/geometry/geometries/segment.hpp>
@@ -17,14 +22,15 @@ namespace ai_server::planner::impl {
 class rrt_star {
 public:
   // 節点
+  // 探索木のノードは配列にまとめて持ち, 親は配列の添字で指す
   struct node {
-    Eigen::Vector2d position;   // 座標
-    double cost;                // 親ノードまでに必要なコスト
-    std::weak_ptr<node> parent; // 親ノードを指すポインタ
-
-    node(const Eigen::Vector2d& pos, double c, const std::shared_ptr<node>& ptr);
+    Eigen::Vector2d position; // 座標
+    double cost;              // 親ノードまでに必要なコスト
+    std::uint32_t parent;     // 親ノードの添字 (根なら no_parent)
   };
 
+  static constexpr std::uint32_t no_parent = std::numeric_limits<std::uint32_t>::max();
+
   using result_type = std::pair<Eigen::Vector2d, double>;
 
   rrt_star();
@@ -45,15 +51,38 @@ public:
   /// @param length 設定値．
   void set_max_branch_length(double length);
 
+  /// @brief 前回の探索木を再利用するかを設定する
+  /// @param reuse 設定値．
+  void set_reuse(bool reuse);
+
+  /// @brief 再利用する探索木のノード数の上限を設定する
+  /// @param count 設定値．
+  void set_max_nodes(std::size_t count);
+
+  /// @brief 乱数生成器のシードを設定する
+  /// @param seed 設定値．
+  void set_seed(std::uint32_t seed);
+
+  /// @brief 前回の execute() で作った探索木のノード数
+  std::size_t tree_size() const;
+
+  /// @brief 経路探索を行う
+  ///
+  /// 再利用が有効なら, 前回の探索木のうち障害物に当たらないノードを start_pos を根として
+  /// 繋ぎ直してから探索を続ける.
+  /// deadline を指定すると, ノードを作る回数の代わりにその時刻までノードを作り続ける
+  /// (少なくとも 1 つは作り, 新しく作るのは再利用する探索木のノード数の上限まで)
   result_type execute(const Eigen::Vector2d& start_pos, const Eigen::Vector2d& goal_pos,
-                      const obstacle_list& obs);
+                      const obstacle_list& obs,
+                      std::optional<std::chrono::steady_clock::time_point> deadline = {});
 
 private:
   using point_t = Eigen::Vector2d;
   using box_t   = boost::geometry::model::box<point_t>;
   using line_t  = boost::geometry::model::segment<point_t>;
-  using tree_t =
-      boost::geometry::index::rtree<std::shared_ptr<node>, boost::geometry::index::rstar<20>>;
+  // 座標とノードの添字の組
+  using tree_t = boost::geometry::index::rtree<std::pair<point_t, std::uint32_t>,
+                                               boost::geometry::index::linear<16>>;
 
   // サンプル取得時用の乱数生成器(処理速度が優れているため，boostのものを使用)
   mutable boost::random::mt19937 mt_;
@@ -64,6 +93,22 @@ private:
   // 伸ばす枝の最大距離
   double max_branch_length_;
 
+  // 前回の探索木を再利用するか
+  bool reuse_;
+
+  // 再利用する探索木のノード数の上限
+  std::size_t max_nodes_;
+
+  // 探索木のノード (根を含む). 再利用するときは次の execute() まで残す
+  std::vector<node> nodes_;
+
+  // 前回の探索木のノード
+  std::vector<node> previous_;
+
+  // 作業用の領域 (呼び出しごとに確保し直さないようにメンバとして持つ)
+  std::vector<tree_t::value_type> neighbors_;
+  std::vector<std::uint32_t> candidates_;
+
   // 移動可能領域
   detail::envelope_type area_;
 
@@ -74,19 +119,27 @@ private:
   /// @param  start   初期位置
   /// @param  goal    目標位置
   /// @param  d       初期位置から移動先までの距離
-  //  @param  obstacles 障害物
+  /// @param  obs       障害物
+  /// @param  obstacles 障害物 (obs を種類ごとの配列にまとめたもの)
   std::optional<Eigen::Vector2d> exit_position(const Eigen::Vector2d& start,
                                                const Eigen::Vector2d& goal, double d,
-                                               const obstacle_list::tree_type& obstacles) const;
+                                               const obstacle_list& obs,
+                                               const detail::obstacle_batch& obstacles) const;
 
   /// @brief  あるエリアの範囲内で新規のノードを作成する
   /// @param  goal               最終目的地
   /// @param  max_branch_length  ノード間長さの最大値
   /// @param  obstacles          障害物
   /// @param  tree               探索木
-  std::shared_ptr<node> make_node(const Eigen::Vector2d& goal, double max_branch_length,
-                                  const obstacle_list::tree_type& obstacles,
-                                  const tree_t& tree);
+  node make_node(const Eigen::Vector2d& goal, double max_branch_length,
+                 const detail::obstacle_batch& obstacles, const tree_t& tree);
+
+  /// @brief  前回の探索木 (previous_) のノードを新しい探索木に繋ぎ直す
+  /// @param  goal               最終目的地
+  /// @param  obstacles          障害物
+  /// @param  tree               探索木 (根だけが入っている)
+  void repair(const Eigen::Vector2d& goal, const detail::obstacle_batch& obstacles,
+              tree_t& tree);
 };
 } // namespace ai_server::planner::impl
 
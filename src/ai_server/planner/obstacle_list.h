@@ -1,19 +1,25 @@
 #ifndef AI_SERVER_PLANNER_OBSTACLE_LIST_H
 #define AI_SERVER_PLANNER_OBSTACLE_LIST_H
 
+#include <algorithm>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
 #include <boost/geometry/algorithms/envelope.hpp>
+#include <boost/geometry/algorithms/intersects.hpp>
 #include <boost/geometry/geometries/box.hpp>
 #include <boost/geometry/index/rtree.hpp>
 #include <Eigen/Core>
 
 #include "ai_server/model/obstacle/box.h"
+#include "ai_server/model/obstacle/moving_point.h"
 #include "ai_server/model/obstacle/point.h"
 #include "ai_server/model/obstacle/segment.h"
+#include "detail/distance_field.h"
 #include "detail/geometry_helper.h"
+#include "detail/obstacle_batch.h"
 #include "detail/obstacle_tree.h"
 
 namespace ai_server::planner {
@@ -24,9 +30,20 @@ public:
   using element_type = typename tree_type::value_type;
   // std::variant<ObstacleTypes...>
   using obstacle_type = typename element_type::second_type;
+  // to_tree() が返す RTree (share() でまとめた障害物と, それ以降に追加した障害物)
+  using layered_tree_type = detail::layered_tree<tree_type>;
 
 private:
+  // share() でまとめた障害物. コピーしても木は共有する
+  std::shared_ptr<const tree_type> shared_;
+  // share() でまとめた障害物を種類ごとの配列にしたもの
+  std::shared_ptr<const detail::obstacle_batch> shared_batch_;
+  // share() 以降に追加した障害物
   std::vector<element_type> buffer_;
+  // 動く障害物
+  std::vector<model::obstacle::moving_point> moving_;
+  // 試合中に動かない障害物
+  std::shared_ptr<const detail::distance_field> field_;
 
 public:
   /// @brief リストに障害物を追加する
@@ -39,14 +56,107 @@ public:
     buffer_.emplace_back(std::move(env), std::move(o));
   }
 
-  /// @brief 内部データを取得する
+  /// @brief リストに動く障害物を追加する
+  ///
+  /// 動く障害物は to_tree() や to_batch() には含まれず, 到達する時刻を考える planner
+  /// (planner::space_time) だけが使う
+  /// @param 追加する障害物
+  void add(const model::obstacle::moving_point& o) {
+    moving_.push_back(o);
+  }
+
+  /// @brief 試合中に動かない障害物 (ペナルティエリアなど) を distance_field で設定する
+  ///
+  /// distance_field::make() で作ったものを渡すと, フィールドの形状が変わらない限り
+  /// 格子は作り直されない. to_tree() でも to_batch() でも, 当たり判定には格子を使う
+  /// @param field 設定する distance_field
+  void set_field(std::shared_ptr<const detail::distance_field> field) {
+    field_ = std::move(field);
+  }
+
+  /// @brief これまでに追加した障害物を, コピーで共有する RTree にまとめる
+  ///
+  /// 全てのロボットに共通する障害物を追加した後に呼び出すと, このリストのコピーに
+  /// ロボットごとの障害物を追加しても共通部分はコピーされず, RTree も作り直さない
+  void share() {
+    if (buffer_.empty()) return;
+    if (shared_) {
+      buffer_.insert(buffer_.begin(), shared_->begin(), shared_->end());
+    }
+    shared_ = std::make_shared<const tree_type>(buffer_.begin(), buffer_.end());
+    shared_batch_ =
+        std::make_shared<const detail::obstacle_batch>(buffer_.begin(), buffer_.end());
+    buffer_.clear();
+  }
+
+  /// @brief share() でまとめた障害物の RTree (まとめていなければ nullptr)
+  const std::shared_ptr<const tree_type>& shared_tree() const {
+    return shared_;
+  }
+
+  /// @brief 内部データを取得する (share() でまとめた障害物は含まない)
   const std::vector<element_type>& buffer() const {
     return buffer_;
   }
 
+  /// @brief 試合中に動かない障害物の distance_field (設定していなければ nullptr)
+  const std::shared_ptr<const detail::distance_field>& field() const {
+    return field_;
+  }
+
+  /// @brief 動く障害物を取得する
+  const std::vector<model::obstacle::moving_point>& moving() const {
+    return moving_;
+  }
+
   /// @brief RTreeを構築して返す
-  tree_type to_tree() const {
-    return {buffer_.begin(), buffer_.end()};
+  ///
+  /// share() でまとめた障害物の RTree と distance_field はそのまま使い,
+  /// それ以降に追加した障害物の RTree だけを作る
+  layered_tree_type to_tree() const {
+    return {shared_, tree_type(buffer_.begin(), buffer_.end()), field_};
+  }
+
+  /// @brief 全ての障害物を種類ごとの配列にまとめて返す
+  ///
+  /// 障害物が少ないときは RTree より速く当たり判定ができる.
+  /// share() でまとめた障害物の配列はコピーし, それ以降に追加した障害物だけを加える.
+  /// distance_field はそのまま設定し, その障害物は格子を使って調べる
+  detail::obstacle_batch to_batch() const {
+    auto batch = shared_batch_ ? *shared_batch_ : detail::obstacle_batch{};
+    for (const auto& e : buffer_) batch.add(e.second);
+    batch.set_field(field_);
+    return batch;
+  }
+
+  /// @brief region と重なる障害物だけを種類ごとの配列にまとめて返す
+  ///
+  /// share() でまとめた障害物は RTree を 1 回だけ辿って選ぶ.
+  /// distance_field の障害物が region と重なるときは, distance_field をそのまま設定する.
+  /// 調べる範囲が限られている planner (planner::human_like など) は, RTree を作って
+  /// 当たり判定のたびに辿るより速い
+  /// @param region 調べる範囲
+  detail::obstacle_batch to_batch(const detail::envelope_type& region) const {
+    detail::obstacle_batch batch{};
+    if (shared_) {
+      const auto first = shared_->qbegin(boost::geometry::index::intersects(region));
+      std::for_each(first, shared_->qend(), [&batch](const auto& e) { batch.add(e.second); });
+    }
+    for (const auto& e : buffer_) {
+      if (boost::geometry::intersects(e.first, region)) batch.add(e.second);
+    }
+    // distance_field の障害物が region と重なるときは, 格子を使って調べる
+    if (field_) {
+      const auto envelope = [](const auto& arg) {
+        return detail::to_envelope(arg.geometry, arg.margin);
+      };
+      const auto& fo = field_->obstacles();
+      if (std::any_of(fo.begin(), fo.end(), [&envelope, &region](const auto& o) {
+            return boost::geometry::intersects(std::visit(envelope, o), region);
+          }))
+        batch.set_field(field_);
+    }
+    return batch;
   }
 };
 } // namespace ai_server::planner
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <type_traits>
+#include <variant>
+
+#include <boost/geometry/algorithms/within.hpp>
+#include <boost/geometry/geometries/segment.hpp>
+
+#include "detail/collision.h"
+#include "plan_cache.h"
+
+namespace ai_server::planner {
+
+namespace {
+
+// 64bit の値をよく混ぜる (splitmix64 の finalizer)
+std::uint64_t mix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// 値を順に混ぜ合わせる
+std::uint64_t combine(std::initializer_list<std::int64_t> values) {
+  std::uint64_t h = 0;
+  for (const auto v : values) h = mix(h ^ static_cast<std::uint64_t>(v));
+  return h;
+}
+
+} // namespace
+
+plan_cache::plan_cache(clock_type::duration horizon, double resolution, double margin)
+    : horizon_{horizon}, resolution_{resolution}, margin_{margin} {}
+
+plan_cache::clock_type::duration plan_cache::horizon() const {
+  return horizon_;
+}
+
+double plan_cache::resolution() const {
+  return resolution_;
+}
+
+plan_cache::key_type plan_cache::make_key(const Eigen::Vector2d& start,
+                                          const Eigen::Vector2d& goal,
+                                          const obstacle_list& obstacles,
+                                          const base& planner) const {
+  const auto q = [this](double v) { return std::llround(v / resolution_); };
+
+  // 障害物 1 つ分のハッシュ
+  const auto hash_of = [&q](const auto& obstacle) {
+    return std::visit(
+        [&q, index = static_cast<std::int64_t>(obstacle.index())](const auto& arg) {
+          using type = std::decay_t<decltype(arg)>;
+          if constexpr (std::is_same_v<type, model::obstacle::point>) {
+            return combine({index, q(arg.geometry.x()), q(arg.geometry.y()), q(arg.margin)});
+          } else if constexpr (std::is_same_v<type, model::obstacle::segment>) {
+            const auto& [a, b] = arg.geometry;
+            return combine({index, q(a.x()), q(a.y()), q(b.x()), q(b.y()), q(arg.margin)});
+          } else {
+            const auto& a = arg.geometry.min_corner();
+            const auto& b = arg.geometry.max_corner();
+            return combine({index, q(a.x()), q(a.y()), q(b.x()), q(b.y()), q(arg.margin)});
+          }
+        },
+        obstacle);
+  };
+
+  // 障害物ごとのハッシュの和 (RTree から取り出す順番によらない)
+  std::uint64_t hash = 0;
+
+  const Eigen::Vector2d m{margin_, margin_};
+  const detail::envelope_type region{start.cwiseMin(goal) - m, start.cwiseMax(goal) + m};
+  if (const auto& shared = obstacles.shared_tree()) {
+    const auto first = shared->qbegin(boost::geometry::index::intersects(region));
+    std::for_each(first, shared->qend(), [&](const auto& e) { hash += hash_of(e.second); });
+  }
+  for (const auto& e : obstacles.buffer()) {
+    if (boost::geometry::intersects(e.first, region)) hash += hash_of(e.second);
+  }
+  // 速度は 0.1s に進む距離を量子化する
+  for (const auto& o : obstacles.moving()) {
+    if (boost::geometry::within(o.geometry, region)) {
+      hash += combine({-1, q(o.geometry.x()), q(o.geometry.y()), q(o.velocity.x() * 0.1),
+                       q(o.velocity.y() * 0.1), q(o.margin)});
+    }
+  }
+  // distance_field は範囲によらず全ての障害物の形状を含める
+  // (破棄された distance_field と同じアドレスに別の形状のものが作られることがあるので,
+  //  アドレスは使わない)
+  if (const auto& field = obstacles.field()) {
+    std::uint64_t field_hash = 0;
+    for (const auto& o : field->obstacles()) field_hash += hash_of(o);
+    hash += combine({-2, static_cast<std::int64_t>(field_hash), q(field->resolution())});
+  }
+
+  return {{q(start.x()), q(start.y()), q(goal.x()), q(goal.y())},
+          static_cast<std::size_t>(hash),
+          planner.settings_hash()};
+}
+
+std::optional<base::result_type> plan_cache::find(unsigned int id, const key_type& key,
+                                                  const Eigen::Vector2d& start,
+                                                  const obstacle_list& obstacles,
+                                                  clock_type::time_point now) {
+  std::lock_guard lock{mutex_};
+  auto& e = entries_[id];
+  if (!e.key || !(*e.key == key) || now - e.time > horizon_) {
+    ++e.stats.misses;
+    return std::nullopt;
+  }
+
+  // 前回の目標位置までが現在の障害物に当たらないか調べる
+  const auto& target = e.result.first;
+  const detail::envelope_type region{start.cwiseMin(target), start.cwiseMax(target)};
+  const auto batch = obstacles.to_batch(region);
+  const auto collided =
+      detail::is_collided(start, batch)
+          ? detail::is_collided(target, batch)
+          : detail::is_collided(boost::geometry::model::segment<Eigen::Vector2d>{start, target},
+                                batch);
+  if (collided) {
+    e.key.reset();
+    ++e.stats.misses;
+    ++e.stats.invalidations;
+    return std::nullopt;
+  }
+  ++e.stats.hits;
+  return e.result;
+}
+
+void plan_cache::store(unsigned int id, const key_type& key, const base::result_type& result,
+                       clock_type::time_point now) {
+  std::lock_guard lock{mutex_};
+  auto& e  = entries_[id];
+  e.key    = key;
+  e.result = result;
+  e.time   = now;
+}
+
+void plan_cache::clear() {
+  std::lock_guard lock{mutex_};
+  entries_.clear();
+}
+
+plan_cache::stats_type plan_cache::stats() const {
+  std::lock_guard lock{mutex_};
+  stats_type result{};
+  for (const auto& [id, e] : entries_) {
+    result.hits += e.stats.hits;
+    result.misses += e.stats.misses;
+    result.invalidations += e.stats.invalidations;
+  }
+  return result;
+}
+
+std::unordered_map<unsigned int, plan_cache::stats_type> plan_cache::robot_stats() const {
+  std::lock_guard lock{mutex_};
+  std::unordered_map<unsigned int, stats_type> result{};
+  for (const auto& [id, e] : entries_) result.emplace(id, e.stats);
+  return result;
+}
+
+} // namespace ai_server::planner
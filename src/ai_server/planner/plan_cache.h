@@ -0,0 +1,132 @@
+#ifndef AI_SERVER_PLANNER_PLAN_CACHE_H
+#define AI_SERVER_PLANNER_PLAN_CACHE_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <Eigen/Core>
+
+#include "base.h"
+#include "obstacle_list.h"
+
+namespace ai_server::planner {
+
+/// @class  plan_cache
+/// @brief  ロボットごとに直前の経路探索の結果を覚えておき, 入力がほとんど変わらなければ使い回す
+///
+/// マークや待機で止まっているロボットは, 毎周期ほぼ同じ入力で経路探索を行う.
+/// 開始位置と目標位置を量子化したもの, その周囲の障害物のハッシュ, planner の種類と設定が
+/// 前回と同じなら前回の結果を返す.
+/// 有効期間を過ぎた結果は使わず, 現在の障害物に当たるようになった結果は破棄する.
+/// 各関数は別々のスレッドから呼び出してよい
+class plan_cache {
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  /// 経路探索の入力を量子化したもの
+  struct key_type {
+    // 開始位置と目標位置 (x, y, x, y)
+    std::array<std::int64_t, 4> position;
+    // 周囲の障害物のハッシュ
+    std::size_t obstacles;
+    // planner の種類と設定のハッシュ (base::settings_hash())
+    std::size_t planner;
+
+    bool operator==(const key_type& other) const {
+      return position == other.position && obstacles == other.obstacles &&
+             planner == other.planner;
+    }
+  };
+
+  struct stats_type {
+    /// 結果を使い回した回数
+    std::uint64_t hits;
+    /// 結果を使い回せなかった回数
+    std::uint64_t misses;
+    /// 障害物に当たるようになって破棄した回数 (misses に含む)
+    std::uint64_t invalidations;
+
+    /// @brief              結果を使い回した割合 (一度も探していなければ 0)
+    double hit_rate() const {
+      const auto n = hits + misses;
+      return n > 0 ? static_cast<double>(hits) / n : 0.0;
+    }
+  };
+
+  /// @param horizon        経路探索をしてから結果を使い回せる期間
+  /// @param resolution     位置を量子化する間隔 [mm]
+  /// @param margin         ハッシュに含める障害物の範囲 [mm]
+  ///                       (開始位置と目標位置を包括する長方形をこの分だけ広げた範囲)
+  explicit plan_cache(clock_type::duration horizon, double resolution = 20.0,
+                      double margin = 500.0);
+
+  /// @brief                経路探索をしてから結果を使い回せる期間
+  clock_type::duration horizon() const;
+
+  /// @brief                位置を量子化する間隔 [mm]
+  double resolution() const;
+
+  /// @brief                経路探索の入力を量子化する
+  ///
+  /// distance_field はアドレスではなく障害物の形状をハッシュに含めるので,
+  /// フィールドの形状が変われば前回の結果は使われない
+  /// @param planner        経路探索に使う planner
+  key_type make_key(const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
+                    const obstacle_list& obstacles, const base& planner) const;
+
+  /// @brief                id のロボットの前回の結果を使い回せれば返す
+  ///
+  /// key が前回と同じで, 有効期間内であれば前回の結果を返す.
+  /// ただし start から前回の目標位置までが現在の障害物に当たるなら, 結果を破棄する
+  /// (start が障害物の中にあるときは目標位置だけを調べる)
+  /// @param id             ロボットの ID
+  /// @param key            make_key() で量子化した入力
+  /// @param start          現在の開始位置
+  /// @param obstacles      現在の障害物
+  /// @param now            現在時刻
+  std::optional<base::result_type> find(unsigned int id, const key_type& key,
+                                        const Eigen::Vector2d& start,
+                                        const obstacle_list& obstacles,
+                                        clock_type::time_point now);
+
+  /// @brief                id のロボットの経路探索の結果を覚える
+  /// @param id             ロボットの ID
+  /// @param key            make_key() で量子化した入力
+  /// @param result         経路探索の結果
+  /// @param now            経路探索をした時刻
+  void store(unsigned int id, const key_type& key, const base::result_type& result,
+             clock_type::time_point now);
+
+  /// @brief                全てのロボットの結果と統計を破棄する
+  void clear();
+
+  /// @brief                全てのロボットの統計
+  stats_type stats() const;
+
+  /// @brief                ロボットごとの統計
+  std::unordered_map<unsigned int, stats_type> robot_stats() const;
+
+private:
+  struct entry {
+    std::optional<key_type> key;
+    base::result_type result;
+    clock_type::time_point time;
+    stats_type stats;
+  };
+
+  clock_type::duration horizon_;
+  double resolution_;
+  double margin_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<unsigned int, entry> entries_;
+};
+
+} // namespace ai_server::planner
+
+#endif // AI_SERVER_PLANNER_PLAN_CACHE_H
@@ -1,9 +1,16 @@
+#include <boost/container_hash/hash.hpp>
+
 #include "impl/rrt_star.h"
 #include "rrt_star.h"
 
 namespace ai_server::planner {
 
-rrt_star::rrt_star() : node_count_(10), max_branch_length_(300.0) {}
+rrt_star::rrt_star()
+    : node_count_(20), max_branch_length_(300.0), impl_(std::make_unique<impl::rrt_star>()) {
+  impl_->set_reuse(true);
+}
+
+rrt_star::~rrt_star() = default;
 
 void rrt_star::set_node_count(int count) {
   node_count_ = count;
@@ -13,15 +20,45 @@ void rrt_star::set_max_branch_length(double length) {
   max_branch_length_ = length;
 }
 
+void rrt_star::set_reuse(bool reuse) {
+  impl_->set_reuse(reuse);
+}
+
+void rrt_star::set_max_nodes(std::size_t count) {
+  impl_->set_max_nodes(count);
+}
+
+void rrt_star::set_seed(std::uint32_t seed) {
+  impl_->set_seed(seed);
+}
+
+void rrt_star::configure() {
+  impl_->set_max_pos(max_pos_);
+  impl_->set_min_pos(min_pos_);
+  impl_->set_node_count(node_count_);
+  impl_->set_max_branch_length(max_branch_length_);
+}
+
 base::planner_type rrt_star::planner() {
   return [this](const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
                 const obstacle_list& obs) {
-    impl::rrt_star rrt{};
-    rrt.set_max_pos(max_pos_);
-    rrt.set_min_pos(min_pos_);
-    rrt.set_node_count(node_count_);
-    rrt.set_max_branch_length(max_branch_length_);
-    return rrt.execute(start, goal, obs);
+    configure();
+    return impl_->execute(start, goal, obs);
+  };
+}
+
+base::anytime_planner_type rrt_star::anytime_planner() {
+  return [this](const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
+                const obstacle_list& obs, deadline_type deadline) {
+    configure();
+    return impl_->execute(start, goal, obs, deadline);
   };
 }
+
+std::size_t rrt_star::settings_hash() const {
+  auto seed = base::settings_hash();
+  boost::hash_combine(seed, node_count_);
+  boost::hash_combine(seed, max_branch_length_);
+  return seed;
+}
 } // namespace ai_server::planner
@@ -1,12 +1,23 @@
 #ifndef AI_SERVER_PLANNER_RRT_STAR_H
 #define AI_SERVER_PLANNER_RRT_STAR_H
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
 #include "base.h"
 
 namespace ai_server::planner {
+namespace impl {
+class rrt_star;
+}
+
+/// planner() が返す関数オブジェクトは同じ探索器 (乱数生成器と前回の探索木) を使い続ける.
+/// ロボットごとに 1 つのインスタンスを使い回すこと
 class rrt_star : public base {
 public:
   rrt_star();
+  ~rrt_star();
 
   /// @brief ノードを作る回数を設定する
   /// @param count 設定値．
@@ -16,14 +27,38 @@ public:
   /// @param length 設定値．
   void set_max_branch_length(double length);
 
+  /// @brief 前回の探索木を再利用するかを設定する (デフォルトは true)
+  /// @param reuse 設定値．
+  void set_reuse(bool reuse);
+
+  /// @brief 再利用する探索木のノード数の上限を設定する
+  /// @param count 設定値．
+  void set_max_nodes(std::size_t count);
+
+  /// @brief 乱数生成器のシードを設定する
+  /// @param seed 設定値．
+  void set_seed(std::uint32_t seed);
+
   base::planner_type planner() override;
 
+  /// 期限までノードを作り続ける (ノードを作る回数の設定は使わない).
+  /// 探索木を再利用するなら, 次の呼び出しはその続きから探索する
+  base::anytime_planner_type anytime_planner() override;
+
+  std::size_t settings_hash() const override;
+
 private:
   // 探索を行う回数
   int node_count_;
 
   // 伸ばす枝の最大距離
   double max_branch_length_;
+
+  // 呼び出しをまたいで使う探索器
+  std::unique_ptr<impl::rrt_star> impl_;
+
+  // impl_ に設定を反映する
+  void configure();
 };
 } // namespace ai_server::planner
 
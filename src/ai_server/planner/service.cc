@@ -0,0 +1,77 @@
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include "ai_server/util/trace.h"
+#include "service.h"
+
+namespace ai_server::planner {
+
+namespace {
+
+service::result solve_one(const service::request& r) {
+  AI_SERVER_TRACE_SCOPE("planner::service::solve_one");
+  const auto begin = std::chrono::steady_clock::now();
+  const auto value =
+      r.deadline ? r.planner->anytime_planner()(r.start, r.goal, *r.obstacles, *r.deadline)
+                 : r.planner->planner()(r.start, r.goal, *r.obstacles);
+  return {r.id, value, std::chrono::steady_clock::now() - begin};
+}
+
+} // namespace
+
+service::service(std::size_t threads)
+    : threads_{threads},
+      pool_{threads > 0 ? std::make_unique<boost::asio::thread_pool>(threads) : nullptr} {}
+
+service::~service() {
+  if (pool_) pool_->join();
+}
+
+std::size_t service::threads() const {
+  return threads_;
+}
+
+std::vector<service::result> service::solve(const std::vector<request>& requests) {
+  AI_SERVER_TRACE_SCOPE("planner::service::solve");
+  std::vector<result> results(requests.size());
+  std::vector<std::exception_ptr> exceptions(requests.size());
+
+  const auto f = [&requests, &results, &exceptions](std::size_t i) {
+    try {
+      results[i] = solve_one(requests[i]);
+    } catch (...) {
+      exceptions[i] = std::current_exception();
+    }
+  };
+
+  if (pool_) {
+    // 各ロボットの経路探索をスレッドプールで並列に行い, 全て終わるまで待つ
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t remaining = requests.size();
+
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+      boost::asio::post(*pool_, [&, i] {
+        f(i);
+        std::unique_lock lock(mutex);
+        if (--remaining == 0) cv.notify_one();
+      });
+    }
+
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [&remaining] { return remaining == 0; });
+  } else {
+    for (std::size_t i = 0; i < requests.size(); ++i) f(i);
+  }
+
+  for (const auto& e : exceptions) {
+    if (e) std::rethrow_exception(e);
+  }
+  return results;
+}
+
+} // namespace ai_server::planner
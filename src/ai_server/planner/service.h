@@ -0,0 +1,69 @@
+#ifndef AI_SERVER_PLANNER_SERVICE_H
+#define AI_SERVER_PLANNER_SERVICE_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "base.h"
+#include "obstacle_list.h"
+
+namespace boost::asio {
+class thread_pool;
+} // namespace boost::asio
+
+namespace ai_server::planner {
+
+/// @class  service
+/// @brief  1 周期分の複数ロボットの経路探索をまとめてスレッドプールで解く
+///
+/// 各ロボットの経路探索は互いに独立なので, 結果は実行順によらず要求を渡した順に並ぶ.
+/// planner が乱数のシードを固定していれば, 並列に解いても結果は変わらない
+class service {
+public:
+  /// 1 台分の経路探索の要求
+  /// planner と obstacles は solve() が返るまで有効であること.
+  /// 1 回の solve() で同じ planner を複数の要求に使ってはならない
+  struct request {
+    unsigned int id;
+    base* planner;
+    Eigen::Vector2d start;
+    Eigen::Vector2d goal;
+    const obstacle_list* obstacles;
+    // 指定すると planner の anytime_planner() を使う
+    std::optional<base::deadline_type> deadline;
+  };
+
+  struct result {
+    unsigned int id;
+    base::result_type value;
+    // 経路探索にかかった時間
+    std::chrono::steady_clock::duration time;
+  };
+
+  /// @param threads      経路探索に使うスレッドの数 (0 なら solve() を呼んだスレッドで行う)
+  explicit service(std::size_t threads);
+  ~service();
+
+  /// @brief              経路探索に使うスレッドの数
+  std::size_t threads() const;
+
+  /// @brief              要求をまとめて解き, 全て終わるまで待つ
+  /// @return             requests と同じ順に並んだ結果
+  ///
+  /// いずれかの planner が例外を投げたときは, 全て終わった後に
+  /// 例外を投げた要求のうち最初のものの例外を投げ直す
+  std::vector<result> solve(const std::vector<request>& requests);
+
+private:
+  std::size_t threads_;
+  std::unique_ptr<boost::asio::thread_pool> pool_;
+};
+
+} // namespace ai_server::planner
+
+#endif // AI_SERVER_PLANNER_SERVICE_H
@@ -0,0 +1,44 @@
+#include <cmath>
+#include <boost/container_hash/hash.hpp>
+
+#include "impl/human_like.h"
+#include "space_time.h"
+
+namespace ai_server::planner {
+
+void space_time::set_velocity(const Eigen::Vector2d& velocity) {
+  velocity_ = velocity;
+}
+
+void space_time::set_max_velocity(double velocity) {
+  max_velocity_ = velocity;
+}
+
+void space_time::set_max_acceleration(double acceleration) {
+  max_acceleration_ = acceleration;
+}
+
+void space_time::set_horizon(double horizon) {
+  horizon_ = horizon;
+}
+
+std::size_t space_time::settings_hash() const {
+  auto seed = human_like::settings_hash();
+  boost::hash_combine(seed, std::lround(velocity_.x() / 100.0));
+  boost::hash_combine(seed, std::lround(velocity_.y() / 100.0));
+  for (const auto v : {max_velocity_, max_acceleration_, horizon_}) {
+    boost::hash_combine(seed, v);
+  }
+  return seed;
+}
+
+base::planner_type space_time::planner() {
+  return [this](const Eigen::Vector2d& start, const Eigen::Vector2d& goal,
+                const obstacle_list& obs) {
+    const auto statics = obs.to_batch(reach(start));
+    const detail::space_time_obstacles<detail::obstacle_batch> obstacles{
+        statics, obs.moving(), start, velocity_, max_velocity_, max_acceleration_, horizon_};
+    return plan(start, goal, obstacles);
+  };
+}
+} // namespace ai_server::planner
@@ -0,0 +1,49 @@
+#ifndef AI_SERVER_PLANNER_SPACE_TIME_H
+#define AI_SERVER_PLANNER_SPACE_TIME_H
+
+#include <Eigen/Core>
+
+#include "human_like.h"
+
+namespace ai_server::planner {
+
+/// human_like と同じように ray を伸ばして探索し, 動く障害物 (obstacle_list に追加した
+/// model::obstacle::moving_point) はロボットがその地点に着く時刻での位置で調べる.
+/// 軌跡全体を障害物にするより, すぐに通り過ぎるロボットを避けて遠回りすることが少ない
+class space_time : public human_like {
+public:
+  /// @brief ロボットの現在の速度を設定する
+  /// @param velocity         設定値 [mm/s]
+  void set_velocity(const Eigen::Vector2d& velocity);
+
+  /// @brief ロボットの最大速度を設定する
+  /// @param velocity         設定値 [mm/s]
+  void set_max_velocity(double velocity);
+
+  /// @brief ロボットの最大加速度を設定する
+  /// @param acceleration     設定値 [mm/s^2]
+  void set_max_acceleration(double acceleration);
+
+  /// @brief 動く障害物の位置を予測する時間を設定する (それ以降は止まるとみなす)
+  /// @param horizon          設定値 [s]
+  void set_horizon(double horizon);
+
+  base::planner_type planner() override;
+
+  /// 現在の速度は 100 mm/s 単位に丸めて加える
+  /// (止まっているロボットの速度の揺らぎで plan_cache が使えなくならないようにする)
+  std::size_t settings_hash() const override;
+
+private:
+  // ロボットの現在の速度
+  Eigen::Vector2d velocity_ = Eigen::Vector2d::Zero();
+  // ロボットの最大速度
+  double max_velocity_ = 3000.0;
+  // ロボットの最大加速度
+  double max_acceleration_ = 3000.0;
+  // 動く障害物の位置を予測する時間
+  double horizon_ = 1.5;
+};
+} // namespace ai_server::planner
+
+#endif // AI_SERVER_PLANNER_SPACE_TIME_H
@@ -1,6 +1,9 @@
 #ifndef AI_SERVER_RADIO_BASE_BASE_H
 #define AI_SERVER_RADIO_BASE_BASE_H
 
+#include <memory>
+#include <utility>
+
 #include "ai_server/model/command.h"
 #include "ai_server/model/team_color.h"
 
@@ -25,6 +28,30 @@ public:
 
   virtual void send(model::team_color color, unsigned int id,
                     std::shared_ptr<model::motion::base> motion) = 0;
+
+  /// @brief            1 周期分の命令の送信を開始する
+  ///
+  /// Driver は周期ごとに begin_cycle(), 各ロボットについて stage(), flush() の順に呼び出す.
+  /// 複数の命令をまとめて送信できる Radio はこれらを実装する
+  /// @param color      チームカラー
+  virtual void begin_cycle([[maybe_unused]] model::team_color color) {}
+
+  /// @brief            ロボットへの命令を送信待ちに加える
+  ///
+  /// まとめて送信しない Radio では直ちに send() で送信する
+  virtual void stage(model::team_color color, unsigned int id,
+                     const model::command::kick_flag_t& kick_flag, int dribble, double vx,
+                     double vy, double omega) {
+    send(color, id, kick_flag, dribble, vx, vy, omega);
+  }
+
+  virtual void stage(model::team_color color, unsigned int id,
+                     std::shared_ptr<model::motion::base> motion) {
+    send(color, id, std::move(motion));
+  }
+
+  /// @brief            送信待ちの命令をまとめて送信する
+  virtual void flush() {}
 };
 
 /// シミュレータの制御コマンドの送信
@@ -0,0 +1,95 @@
+#ifndef AI_SERVER_RADIO_CONNECTION_DETAIL_WRITE_QUEUE_H
+#define AI_SERVER_RADIO_CONNECTION_DETAIL_WRITE_QUEUE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include "ai_server/radio/connection/pooled_buffer.h"
+
+namespace ai_server::radio::connection::detail {
+
+/// 送信待ちのメッセージ
+using message = std::variant<std::string, std::vector<std::uint8_t>, pooled_buffer>;
+
+/// @brief                message の内容を指す boost::asio::const_buffer を返す
+inline boost::asio::const_buffer to_buffer(const message& m) {
+  return std::visit([](const auto& b) { return boost::asio::const_buffer{b.data(), b.size()}; },
+                    m);
+}
+
+/// @brief                送信するデータを message に変換する
+///
+/// std::string と std::vector<std::uint8_t> はそのまま移し, それ以外はバイト列を写す.
+template <class Buffer>
+inline message to_message(Buffer buffer) {
+  if constexpr (std::is_same_v<Buffer, std::string> ||
+                std::is_same_v<Buffer, std::vector<std::uint8_t>>) {
+    return message{std::move(buffer)};
+  } else {
+    const auto b = boost::asio::buffer(buffer);
+    const auto p = static_cast<const std::uint8_t*>(b.data());
+    return message{std::vector<std::uint8_t>(p, p + b.size())};
+  }
+}
+
+/// @class  write_queue
+/// @brief  最大で Capacity 個の message を保持する送信待ちの列
+///
+/// 満杯のときに追加すると最も古いものを捨てる. スレッドセーフではないので,
+/// Connection の io_context の中からのみ操作する.
+template <std::size_t Capacity>
+class write_queue {
+public:
+  static constexpr std::size_t capacity = Capacity;
+
+  write_queue() : data_{}, head_{}, size_{} {}
+
+  /// @brief                m を末尾に追加する
+  /// @return               満杯のため最も古いメッセージを捨てたら true
+  bool push(message m) {
+    const auto dropped = size_ == Capacity;
+    if (dropped) pop();
+    data_[(head_ + size_) % Capacity] = std::move(m);
+    ++size_;
+    return dropped;
+  }
+
+  /// @brief                先頭のメッセージを取り出す
+  message take() {
+    auto m = std::move(data_[head_]);
+    pop();
+    return m;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  std::size_t size() const {
+    return size_;
+  }
+
+private:
+  void pop() {
+    // 取り出したあとの領域 (pooled_buffer など) をすぐに解放する
+    data_[head_] = message{};
+    head_        = (head_ + 1) % Capacity;
+    --size_;
+  }
+
+  std::array<message, Capacity> data_;
+  std::size_t head_;
+  std::size_t size_;
+};
+
+} // namespace ai_server::radio::connection::detail
+
+#endif // AI_SERVER_RADIO_CONNECTION_DETAIL_WRITE_QUEUE_H
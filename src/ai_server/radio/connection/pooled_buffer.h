@@ -0,0 +1,119 @@
+#ifndef AI_SERVER_RADIO_CONNECTION_POOLED_BUFFER_H
+#define AI_SERVER_RADIO_CONNECTION_POOLED_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace ai_server::radio::connection {
+
+/// @class  pooled_buffer
+/// @brief  buffer_pool から借りた送信用の領域
+///
+/// 破棄されると領域は buffer_pool に返される. コピーはできない.
+class pooled_buffer {
+public:
+  pooled_buffer() noexcept : data_{}, size_{}, capacity_{}, in_use_{} {}
+
+  pooled_buffer(std::uint8_t* data, std::size_t capacity, std::atomic_bool& in_use) noexcept
+      : data_{data}, size_{}, capacity_{capacity}, in_use_{&in_use} {}
+
+  pooled_buffer(pooled_buffer&& other) noexcept
+      : data_{std::exchange(other.data_, nullptr)},
+        size_{std::exchange(other.size_, 0)},
+        capacity_{std::exchange(other.capacity_, 0)},
+        in_use_{std::exchange(other.in_use_, nullptr)} {}
+
+  pooled_buffer& operator=(pooled_buffer&& other) noexcept {
+    if (this != &other) {
+      release();
+      data_     = std::exchange(other.data_, nullptr);
+      size_     = std::exchange(other.size_, 0);
+      capacity_ = std::exchange(other.capacity_, 0);
+      in_use_   = std::exchange(other.in_use_, nullptr);
+    }
+    return *this;
+  }
+
+  pooled_buffer(const pooled_buffer&) = delete;
+  pooled_buffer& operator=(const pooled_buffer&) = delete;
+
+  ~pooled_buffer() {
+    release();
+  }
+
+  /// @brief  領域を借りているか
+  explicit operator bool() const noexcept {
+    return in_use_ != nullptr;
+  }
+
+  std::uint8_t* data() noexcept {
+    return data_;
+  }
+
+  const std::uint8_t* data() const noexcept {
+    return data_;
+  }
+
+  /// @brief  送信するデータの大きさ
+  std::size_t size() const noexcept {
+    return size_;
+  }
+
+  /// @brief  借りている領域の大きさ
+  std::size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+  /// @brief  送信するデータの大きさを設定する (capacity() を超える場合は capacity() になる)
+  void resize(std::size_t size) noexcept {
+    size_ = size < capacity_ ? size : capacity_;
+  }
+
+private:
+  void release() noexcept {
+    if (in_use_) in_use_->store(false, std::memory_order_release);
+    in_use_ = nullptr;
+  }
+
+  std::uint8_t* data_;
+  std::size_t size_;
+  std::size_t capacity_;
+  std::atomic_bool* in_use_;
+};
+
+/// @class  buffer_pool
+/// @brief  あらかじめ確保した Count 個の Size バイトの領域を貸し出す
+///
+/// acquire() と pooled_buffer の破棄は別々のスレッドから行ってよい.
+/// 動的なメモリ確保は行わない. 貸し出した領域が全て返されるまで破棄してはならない.
+template <std::size_t Size, std::size_t Count>
+class buffer_pool {
+public:
+  buffer_pool() noexcept : data_{}, in_use_{} {}
+
+  buffer_pool(const buffer_pool&) = delete;
+  buffer_pool& operator=(const buffer_pool&) = delete;
+
+  /// @brief  空いている領域を借りる
+  /// @return 空いている領域がなければ空の pooled_buffer
+  pooled_buffer acquire() noexcept {
+    for (std::size_t i = 0; i < Count; ++i) {
+      if (!in_use_[i].load(std::memory_order_relaxed) &&
+          !in_use_[i].exchange(true, std::memory_order_acquire)) {
+        return {data_[i].data(), Size, in_use_[i]};
+      }
+    }
+    return {};
+  }
+
+private:
+  std::array<std::array<std::uint8_t, Size>, Count> data_;
+  std::array<std::atomic_bool, Count> in_use_;
+};
+
+} // namespace ai_server::radio::connection
+
+#endif // AI_SERVER_RADIO_CONNECTION_POOLED_BUFFER_H
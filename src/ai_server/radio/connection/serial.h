@@ -1,16 +1,21 @@
 #ifndef AI_SERVER_RADIO_CONNECTION_SERIAL_H
 #define AI_SERVER_RADIO_CONNECTION_SERIAL_H
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #define BOOST_COROUTINES_NO_DEPRECATION_WARNING
 #include <boost/asio.hpp>
 #include <boost/asio/spawn.hpp>
 
 #include "ai_server/logger/logger.h"
-#include "detail/post_and_return_future.h"
+#include "detail/write_queue.h"
+#include "pooled_buffer.h"
 
 namespace ai_server::radio::connection {
 
@@ -22,79 +27,166 @@ public:
   using stop_bits      = boost::asio::serial_port::stop_bits;
   using character_size = boost::asio::serial_port::character_size;
 
+  /// 送信待ちの列に保持できるメッセージ数
+  static constexpr std::size_t queue_capacity = 64;
+  /// 1 回の書き込みでまとめるメッセージの最大数
+  static constexpr std::size_t max_gather = 16;
+
   template <class... Options>
   serial(boost::asio::io_context& io_context, const std::string& device, const Options&... opts)
       : device_{device},
         total_messages_{},
         messages_per_second_{},
         total_errors_{},
-        last_sent_{},
+        last_sent_{std::chrono::system_clock::time_point{}},
+        total_drops_{},
+        queue_depth_{},
+        closing_{std::make_shared<std::atomic<bool>>(false)},
         io_context_{io_context},
         work_{boost::asio::make_work_guard(io_context_)},
         serial_{io_context_, device_},
-        timer_{io_context_} {
+        timer_{io_context_},
+        wakeup_{io_context_} {
+    writing_.reserve(max_gather);
+    gather_.reserve(max_gather);
+
     (serial_.set_option(opts), ...);
-    boost::asio::spawn(timer_.get_executor(),
-                       [&](auto yield) { count_messages_per_second(yield); });
+    // 破棄された後に再開しても closing_ の値は読めるように, 共有して渡す
+    boost::asio::spawn(timer_.get_executor(), [this, closing = closing_](auto yield) {
+      count_messages_per_second(yield, *closing);
+    });
+    boost::asio::spawn(wakeup_.get_executor(), [this, closing = closing_](auto yield) {
+      write_messages(yield, *closing);
+    });
   }
 
+  ~serial() {
+    // 待機しているコルーチンを起こし, 終了させる
+    *closing_ = true;
+    wakeup_.cancel();
+    timer_.cancel();
+  }
+
+  /// @brief 送信待ちの列に buffer を追加する
+  ///
+  /// 列が満杯のときは最も古いメッセージを捨てる.
   template <class Buffer>
   auto send(Buffer buffer) -> decltype(boost::asio::buffer(buffer), void()) {
-    boost::asio::spawn(io_context_, [this, buffer = std::move(buffer)](auto yield) {
-      boost::system::error_code ec{};
-      serial_.async_write_some(boost::asio::buffer(buffer), yield[ec]);
-      if (ec) {
-        logger_.error("send() failed (" + device_ + "): " + ec.message());
-        total_errors_++;
-      } else {
-        total_messages_++;
-        last_sent_ = std::chrono::system_clock::now();
-      }
-    });
+    enqueue(detail::to_message(std::move(buffer)));
+  }
+
+  /// @brief buffer_pool から借りた領域を送信待ちの列に追加する
+  ///
+  /// 送信が完了するか捨てられるまで buffer は保持され, その後 buffer_pool に返される.
+  void send(pooled_buffer buffer) {
+    enqueue(std::move(buffer));
   }
 
   /// @brief 送信した総メッセージ数を取得する
   std::uint64_t total_messages() const {
-    return detail::post_and_return_future(io_context_, [this] { return total_messages_; })
-        .get();
+    return total_messages_;
   }
 
   /// @brief 1秒間に送信したメッセージ数を取得する
   std::uint64_t messages_per_second() const {
-    return detail::post_and_return_future(io_context_, [this] { return messages_per_second_; })
-        .get();
+    return messages_per_second_;
   }
 
   /// @brief 送信に失敗した数を取得する
   std::uint64_t total_errors() const {
-    return detail::post_and_return_future(io_context_, [this] { return total_errors_; }).get();
+    return total_errors_;
+  }
+
+  /// @brief 送信待ちのメッセージ数を取得する
+  std::size_t queue_depth() const {
+    return queue_depth_;
+  }
+
+  /// @brief 送信待ちの列が満杯のために捨てたメッセージ数を取得する
+  std::uint64_t total_drops() const {
+    return total_drops_;
   }
 
   /// @brief 最後にメッセージを送信した日時を取得する
   std::chrono::system_clock::time_point last_sent() const {
-    return detail::post_and_return_future(io_context_, [this] { return last_sent_; }).get();
+    return last_sent_;
   }
 
 private:
-  void count_messages_per_second(boost::asio::yield_context yield) {
+  void enqueue(detail::message m) {
+    boost::asio::post(io_context_, [this, m = std::move(m)]() mutable {
+      if (queue_.push(std::move(m))) total_drops_++;
+      queue_depth_ = queue_.size();
+      // write_messages() が待機していれば起こす
+      wakeup_.cancel();
+    });
+  }
+
+  /// 送信待ちのメッセージをまとめて書き込み続けるコルーチン
+  /// (async_write で全てのバイトを書き終えてから次の書き込みを始めるので, フレームが混ざらない)
+  /// closing が true になったら, 待機や送信が中断されたときに終了する
+  void write_messages(boost::asio::yield_context yield, const std::atomic<bool>& closing) {
+    boost::system::error_code ec;
+
+    for (;;) {
+      if (queue_.empty()) {
+        // send() で cancel() されるまで待つ
+        wakeup_.expires_at(boost::asio::steady_timer::time_point::max());
+        wakeup_.async_wait(yield[ec]);
+        // 破棄されるときはメンバに触れずに終了する
+        if (ec && closing) break;
+        continue;
+      }
+
+      // 溜まっているメッセージを最大 max_gather 個まとめ, 1 回の書き込み (writev) で送る
+      while (!queue_.empty() && writing_.size() < max_gather) {
+        writing_.push_back(queue_.take());
+      }
+      queue_depth_ = queue_.size();
+      gather_.clear();
+      for (const auto& m : writing_) gather_.push_back(detail::to_buffer(m));
+
+      boost::asio::async_write(serial_, gather_, yield[ec]);
+      if (ec && closing) break;
+
+      // 統計を更新する前に, 送信した領域を返しておく
+      const auto n = writing_.size();
+      writing_.clear();
+      handle_sent(ec, n);
+    }
+  }
+
+  void handle_sent(const boost::system::error_code& ec, std::size_t messages) {
+    if (ec) {
+      logger_.error("send() failed (" + device_ + "): " + ec.message());
+      total_errors_ += messages;
+    } else {
+      total_messages_ += messages;
+      last_sent_ = std::chrono::system_clock::now();
+    }
+  }
+
+  void count_messages_per_second(boost::asio::yield_context yield,
+                                 const std::atomic<bool>& closing) {
     using namespace std::chrono_literals;
 
     boost::system::error_code ec;
 
-    auto prev_total_messages = total_messages_;
+    auto prev_total_messages = total_messages_.load();
 
     timer_.expires_after(1s);
 
     for (;;) {
       // 設定された時刻まで待つ
       timer_.async_wait(yield[ec]);
+      if (ec && closing) break;
       if (ec) {
         logger_.warn("timer is canceled (" + device_ + ")");
         break;
       }
 
       // 1秒間で受信したメッセージ数を求めて更新する
-      const auto tm        = total_messages_;
+      const auto tm        = total_messages_.load();
       messages_per_second_ = tm - prev_total_messages;
       prev_total_messages  = tm;
 
@@ -105,19 +197,35 @@ private:
 
   std::string device_;
 
+  // 統計は write_messages() などが io_context の中で更新し, 他のスレッドからは待たずに読む
   /// 送信した総メッセージ数
-  std::uint64_t total_messages_;
+  std::atomic<std::uint64_t> total_messages_;
   /// 1秒間に送信したメッセージ数
-  std::uint64_t messages_per_second_;
+  std::atomic<std::uint64_t> messages_per_second_;
   /// 送信に失敗した数
-  std::uint64_t total_errors_;
+  std::atomic<std::uint64_t> total_errors_;
   /// 最後にメッセージを送信した日時
-  std::chrono::system_clock::time_point last_sent_;
+  std::atomic<std::chrono::system_clock::time_point> last_sent_;
+  /// 送信待ちの列が満杯のために捨てたメッセージ数
+  std::atomic<std::uint64_t> total_drops_;
+  /// 送信待ちのメッセージ数
+  std::atomic<std::size_t> queue_depth_;
+  /// 破棄が始まったか (コルーチンと共有する)
+  std::shared_ptr<std::atomic<bool>> closing_;
 
   boost::asio::io_context& io_context_;
   boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_;
   boost::asio::serial_port serial_;
   boost::asio::steady_timer timer_;
+  /// 送信待ちのメッセージがあることを write_messages() に知らせるためのタイマ
+  boost::asio::steady_timer wakeup_;
+
+  /// 送信待ちのメッセージ
+  detail::write_queue<queue_capacity> queue_;
+  /// 送信中のメッセージ
+  std::vector<detail::message> writing_;
+  /// writing_ の各メッセージを指すバッファ
+  std::vector<boost::asio::const_buffer> gather_;
 
   logger::logger_for<serial> logger_;
 };
@@ -0,0 +1,38 @@
+#ifndef AI_SERVER_RADIO_DETAIL_FRAME_POOL_H
+#define AI_SERVER_RADIO_DETAIL_FRAME_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ai_server/radio/connection/pooled_buffer.h"
+#include "kiks_frame.h"
+
+namespace ai_server::radio::detail {
+
+/// 1 回に送信できるフレームの最大数 (ID は 4 bit なので 16 台分)
+inline constexpr std::size_t max_frames = 16;
+
+/// フレームの送信に使う領域
+using frame_pool = connection::buffer_pool<kiks_frame_v2_size * max_frames, 32>;
+
+/// @brief                data の内容を pool から借りた領域に写して送信する
+///
+/// 貸し出せる領域がないときや data が領域に収まらないときは, std::vector に写して送信する.
+template <class Connection>
+inline void send_pooled(Connection& connection, frame_pool& pool, const std::uint8_t* data,
+                        std::size_t size) {
+  if (auto buffer = pool.acquire(); buffer && size <= buffer.capacity()) {
+    std::copy(data, data + size, buffer.data());
+    buffer.resize(size);
+    connection.send(std::move(buffer));
+  } else {
+    connection.send(std::vector<std::uint8_t>(data, data + size));
+  }
+}
+
+} // namespace ai_server::radio::detail
+
+#endif // AI_SERVER_RADIO_DETAIL_FRAME_POOL_H
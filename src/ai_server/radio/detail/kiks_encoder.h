@@ -0,0 +1,71 @@
+#ifndef AI_SERVER_RADIO_DETAIL_KIKS_ENCODER_H
+#define AI_SERVER_RADIO_DETAIL_KIKS_ENCODER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "ai_server/model/command.h"
+#include "ai_server/radio/link_monitor.h"
+#include "ai_server/util/clock.h"
+#include "kiks_frame.h"
+
+namespace ai_server::radio {
+
+/// Kiks 形式のフレームの版
+enum class kiks_protocol {
+  /// 通し番号なし
+  v1,
+  /// 終端の前に 1 バイトの通し番号を含む
+  v2,
+};
+
+namespace detail {
+
+/// @class  kiks_encoder
+/// @brief  設定された版に従って Kiks 形式のフレームを作る
+///
+/// v2 ではロボットごとに通し番号を振り, link_monitor が設定されていれば送信を記録する.
+class kiks_encoder {
+public:
+  kiks_encoder() : protocol_{kiks_protocol::v1}, sequences_{} {}
+
+  kiks_protocol protocol() const {
+    return protocol_;
+  }
+
+  void set_protocol(kiks_protocol protocol) {
+    protocol_ = protocol;
+  }
+
+  void set_link_monitor(std::shared_ptr<link_monitor> monitor) {
+    monitor_ = std::move(monitor);
+  }
+
+  /// @brief                1 台分のフレームを data に書き込み, その大きさを返す
+  /// @param data           書き込み先 (kiks_frame_v2_size バイト以上の領域)
+  std::size_t encode(std::uint8_t* data, unsigned int id,
+                     const model::command::kick_flag_t& kick_flag, int dribble, double vx,
+                     double vy, double omega) {
+    encode_kiks_frame(data, id, kick_flag, dribble, vx, vy, omega);
+    if (protocol_ == kiks_protocol::v1) return kiks_frame_size;
+
+    const auto sequence = sequences_[id % sequences_.size()]++;
+    append_kiks_sequence(data, sequence);
+    if (monitor_) monitor_->sent(id, sequence, util::clock::system_now());
+    return kiks_frame_v2_size;
+  }
+
+private:
+  kiks_protocol protocol_;
+  /// ロボットごとの次の通し番号
+  std::array<std::uint8_t, link_monitor::max_robots> sequences_;
+  std::shared_ptr<link_monitor> monitor_;
+};
+
+} // namespace detail
+} // namespace ai_server::radio
+
+#endif // AI_SERVER_RADIO_DETAIL_KIKS_ENCODER_H
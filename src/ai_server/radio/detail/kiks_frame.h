@@ -0,0 +1,112 @@
+#ifndef AI_SERVER_RADIO_DETAIL_KIKS_FRAME_H
+#define AI_SERVER_RADIO_DETAIL_KIKS_FRAME_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+#include <boost/math/constants/constants.hpp>
+
+#include "ai_server/model/command.h"
+#include "ai_server/util/math/angle.h"
+
+namespace ai_server::radio::detail {
+
+/// 1 台分のフレームの大きさ
+inline constexpr std::size_t kiks_frame_size = 11;
+
+/// 通し番号つき (v2) の 1 台分のフレームの大きさ
+inline constexpr std::size_t kiks_frame_v2_size = kiks_frame_size + 1;
+
+/// 1 台分のフレーム
+using kiks_frame = std::array<std::uint8_t, kiks_frame_size>;
+
+/// @brief                量子化した値から 1 台分のフレームを data に書き込む
+/// @param data           書き込み先 (kiks_frame_size バイト以上の領域)
+/// @param id             ロボットの ID
+/// @param kick_type      キックの種類
+/// @param kick_power     キックの強さ
+/// @param dribble        ドリブルの強さ
+/// @param speed          速さ [mm/s]
+/// @param direction      進行方向 (0 から 2pi を 0 から 0xffff に対応させた値)
+/// @param omega          角速度の大きさ [mrad/s]
+/// @param omega_negative 角速度が負か
+constexpr void pack_kiks_frame(std::uint8_t* data, unsigned int id,
+                               model::command::kick_type_t kick_type, std::uint8_t kick_power,
+                               int dribble, std::uint16_t speed, std::uint16_t direction,
+                               std::uint16_t omega, bool omega_negative) noexcept {
+  data[0] = (id + 1) & 0b1111;
+
+  switch (kick_type) {
+    case model::command::kick_type_t::line:
+      data[0] |= 0b00110000;
+      break;
+    case model::command::kick_type_t::chip:
+    case model::command::kick_type_t::backspin:
+      data[0] |= 0b00100000;
+      break;
+    default:
+      data[0] |= 0b00000000;
+  }
+
+  data[0] |= omega_negative ? 0b10000000 : 0b00000000;
+
+  data[1] = (speed & 0xff00) >> 8;
+  data[2] = (speed & 0x00ff);
+
+  data[3] = (direction & 0xff00) >> 8;
+  data[4] = (direction & 0x00ff);
+
+  data[5] = (omega & 0xff00) >> 8;
+  data[6] = (omega & 0x00ff);
+
+  const auto d = dribble + 3;
+  data[7]      = static_cast<std::uint8_t>(d < 0 ? -d : d);
+  data[8]      = kick_power;
+
+  data[9]  = '\r';
+  data[10] = '\n';
+}
+
+/// @brief                量子化した値から 1 台分のフレームを作る
+constexpr kiks_frame make_kiks_frame(unsigned int id, model::command::kick_type_t kick_type,
+                                     std::uint8_t kick_power, int dribble, std::uint16_t speed,
+                                     std::uint16_t direction, std::uint16_t omega,
+                                     bool omega_negative) noexcept {
+  kiks_frame frame{};
+  pack_kiks_frame(frame.data(), id, kick_type, kick_power, dribble, speed, direction, omega,
+                  omega_negative);
+  return frame;
+}
+
+/// @brief                pack_kiks_frame() で書き込んだフレームを通し番号つき (v2) にする
+///
+/// 終端の "\r\n" の前に通し番号を挿入する. data は kiks_frame_v2_size バイト以上の領域.
+constexpr void append_kiks_sequence(std::uint8_t* data, std::uint8_t sequence) noexcept {
+  data[9]  = sequence;
+  data[10] = '\r';
+  data[11] = '\n';
+}
+
+/// @brief                命令を量子化して 1 台分のフレームを data に書き込む
+/// @param data           書き込み先 (kiks_frame_size バイト以上の領域)
+inline void encode_kiks_frame(std::uint8_t* data, unsigned int id,
+                              const model::command::kick_flag_t& kick_flag, int dribble,
+                              double vx, double vy, double omega) noexcept {
+  namespace bmc = boost::math::double_constants;
+
+  const auto speed     = static_cast<std::uint16_t>(std::hypot(vx, vy));
+  const auto dir       = util::math::wrap_to_2pi(std::atan2(vy, vx) + bmc::half_pi);
+  const auto direction = static_cast<std::uint16_t>((dir / bmc::two_pi) * 0xffff);
+  const auto o         = static_cast<std::uint16_t>(std::abs(omega) * 1000);
+  const auto power     = static_cast<std::uint8_t>(std::get<1>(kick_flag));
+
+  pack_kiks_frame(data, id, std::get<0>(kick_flag), power, dribble, speed, direction, o,
+                  !(omega >= 0));
+}
+
+} // namespace ai_server::radio::detail
+
+#endif // AI_SERVER_RADIO_DETAIL_KIKS_FRAME_H
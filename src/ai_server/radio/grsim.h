@@ -1,6 +1,7 @@
 #ifndef AI_SERVER_RADIO_GRSIM_H
 #define AI_SERVER_RADIO_GRSIM_H
 
+#include <array>
 #include <memory>
 
 #include <boost/math/constants/constants.hpp>
@@ -41,6 +42,33 @@ public:
     if (motion) std::cout << id << ": " << motion->motion_id() << std::endl;
   }
 
+  void begin_cycle(model::team_color) override {
+    for (auto& p : staged_) p.mutable_commands()->clear_robot_commands();
+  }
+
+  /// チームごとに 1 つの Packet にまとめ, flush() で送信する
+  void stage(model::team_color color, unsigned int id,
+             const model::command::kick_flag_t& kick_flag, int dribble, double vx, double vy,
+             double omega) override {
+    auto commands = staged_[static_cast<bool>(color)].mutable_commands();
+    commands->set_isteamyellow(color == model::team_color::yellow);
+    commands->set_timestamp(0.0);
+
+    auto gr_cmd = commands->add_robot_commands();
+    convert(id, kick_flag, dribble, vx, vy, omega, *gr_cmd);
+  }
+
+  using base::command::stage;
+
+  void flush() override {
+    for (auto& p : staged_) {
+      if (p.commands().robot_commands_size() == 0) continue;
+      connection_->send(p.SerializeAsString());
+      // 確保した領域を次の周期で再利用するため, Packet ごと破棄せずに要素だけを消す
+      p.mutable_commands()->clear_robot_commands();
+    }
+  }
+
   void set_ball_position(double x, double y) override {
     ssl_protos::grsim::Packet packet{};
 
@@ -100,6 +128,9 @@ protected:
   }
 
   std::unique_ptr<Connection> connection_;
+
+  /// 送信待ちの命令 (青, 黄の順)
+  std::array<ssl_protos::grsim::Packet, 2> staged_;
 };
 
 } // namespace ai_server::radio
@@ -1,23 +1,36 @@
 #ifndef AI_SERVER_RADIO_KIKS_H
 #define AI_SERVER_RADIO_KIKS_H
 
-#include <cmath>
+#include <array>
 #include <cstdint>
 #include <iostream>
 #include <memory>
 #include <vector>
 
-#include <boost/math/constants/constants.hpp>
-
-#include "ai_server/util/math/angle.h"
 #include "base/base.h"
+#include "detail/frame_pool.h"
+#include "detail/kiks_encoder.h"
+#include "detail/kiks_frame.h"
+#include "link_monitor.h"
 
 namespace ai_server::radio {
 
 template <class Connection>
 class kiks : public base::command {
 public:
-  kiks(std::unique_ptr<Connection> connection) : connection_{std::move(connection)} {}
+  kiks(std::unique_ptr<Connection> connection) : connection_{std::move(connection)} {
+    staged_.reserve(detail::kiks_frame_v2_size * detail::max_frames);
+  }
+
+  /// @brief フレームの版を設定する
+  void set_protocol(kiks_protocol protocol) {
+    encoder_.set_protocol(protocol);
+  }
+
+  /// @brief v2 で送信したフレームを記録する link_monitor を設定する
+  void set_link_monitor(std::shared_ptr<link_monitor> monitor) {
+    encoder_.set_link_monitor(std::move(monitor));
+  }
 
   const Connection& connection() const {
     return *connection_;
@@ -26,45 +39,9 @@ public:
   void send([[maybe_unused]] model::team_color color, unsigned int id,
             const model::command::kick_flag_t& kick_flag, int dribble, double vx, double vy,
             double omega) override {
-    std::vector<std::uint8_t> data(11);
-
-    data[0] = (id + 1) & 0b1111;
-
-    switch (std::get<0>(kick_flag)) {
-      case model::command::kick_type_t::line:
-        data[0] |= 0b00110000;
-        break;
-      case model::command::kick_type_t::chip:
-      case model::command::kick_type_t::backspin:
-        data[0] |= 0b00100000;
-        break;
-      default:
-        data[0] |= 0b00000000;
-    }
-
-    data[0] |= omega >= 0 ? 0b00000000 : 0b10000000;
-
-    auto vel = static_cast<std::uint16_t>(std::hypot(vx, vy));
-    data[1]  = (vel & 0xff00) >> 8;
-    data[2]  = (vel & 0x00ff);
-
-    namespace bmc = boost::math::double_constants;
-
-    auto dir = ai_server::util::math::wrap_to_2pi(std::atan2(vy, vx) + bmc::half_pi);
-    data[3]  = (static_cast<std::uint16_t>((dir / bmc::two_pi) * 0xffff) & 0xff00) >> 8;
-    data[4]  = (static_cast<std::uint16_t>((dir / bmc::two_pi) * 0xffff) & 0x00ff);
-
-    auto o  = static_cast<std::uint16_t>(std::abs(omega) * 1000);
-    data[5] = (o & 0xff00) >> 8;
-    data[6] = (o & 0x00ff);
-
-    data[7] = static_cast<std::uint8_t>(std::abs(dribble + 3));
-    data[8] = static_cast<std::uint8_t>(std::get<1>(kick_flag));
-
-    data[9]  = '\r';
-    data[10] = '\n';
-
-    connection_->send(std::move(data));
+    std::array<std::uint8_t, detail::kiks_frame_v2_size> frame;
+    const auto size = encoder_.encode(frame.data(), id, kick_flag, dribble, vx, vy, omega);
+    detail::send_pooled(*connection_, pool_, frame.data(), size);
   }
 
   void send([[maybe_unused]] model::team_color color, unsigned int id,
@@ -72,8 +49,38 @@ public:
     if (motion) std::cout << id << ": " << motion->motion_id() << std::endl;
   }
 
+  void begin_cycle(model::team_color) override {
+    staged_.clear();
+  }
+
+  /// 各ロボットへのフレームを 1 つのバッファに連結し, flush() で 1 回の書き込みで送信する
+  void stage([[maybe_unused]] model::team_color color, unsigned int id,
+             const model::command::kick_flag_t& kick_flag, int dribble, double vx, double vy,
+             double omega) override {
+    const auto n = staged_.size();
+    staged_.resize(n + detail::kiks_frame_v2_size);
+    const auto data = staged_.data() + n;
+    staged_.resize(n + encoder_.encode(data, id, kick_flag, dribble, vx, vy, omega));
+  }
+
+  using base::command::stage;
+
+  void flush() override {
+    if (staged_.empty()) return;
+    detail::send_pooled(*connection_, pool_, staged_.data(), staged_.size());
+    staged_.clear();
+  }
+
 protected:
+  detail::kiks_encoder encoder_;
+
+  /// 送信中のフレームを保持する領域 (connection_ より後に破棄されるよう先に宣言する)
+  detail::frame_pool pool_;
+
   std::unique_ptr<Connection> connection_;
+
+  /// 送信待ちのフレーム
+  std::vector<std::uint8_t> staged_;
 };
 
 } // namespace ai_server::radio
@@ -0,0 +1,66 @@
+#include <algorithm>
+
+#include "link_monitor.h"
+
+namespace ai_server::radio {
+
+link_monitor::link_monitor(duration_type timeout) : timeout_{timeout}, robots_{} {}
+
+void link_monitor::sent(unsigned int id, std::uint8_t sequence, time_point time) {
+  if (id >= max_robots) return;
+
+  std::lock_guard lock{mutex_};
+  auto& r            = robots_[id];
+  r.frames[sequence] = {time, true, false};
+  ++r.sent;
+}
+
+bool link_monitor::acked(unsigned int id, std::uint8_t sequence, time_point time) {
+  if (id >= max_robots) return false;
+
+  std::lock_guard lock{mutex_};
+  auto& r = robots_[id];
+  auto& f = r.frames[sequence];
+  // 送信していない, あるいは既に応答のあったフレームへの応答は無視する
+  if (!f.valid || f.acked || time < f.time) return false;
+
+  f.acked = true;
+  ++r.acked;
+
+  const auto rtt = time - f.time;
+  const auto bin = static_cast<std::size_t>(rtt / histogram_bin_width);
+  ++r.rtt_histogram[std::min(bin, histogram_bins - 1)];
+  r.total_rtt += rtt;
+  r.last_ack = std::max(r.last_ack.value_or(time), time);
+  return true;
+}
+
+bool link_monitor::handle_feedback(const std::vector<std::uint8_t>& packet, time_point time) {
+  if (packet.size() < 2 || packet[0] == 0) return false;
+  return acked(packet[0] - 1u, packet[1], time);
+}
+
+link_monitor::stats link_monitor::robot_stats(unsigned int id, time_point now) const {
+  stats s{};
+  if (id >= max_robots) return s;
+
+  std::lock_guard lock{mutex_};
+  const auto& r   = robots_[id];
+  s.sent          = r.sent;
+  s.acked         = r.acked;
+  s.rtt_histogram = r.rtt_histogram;
+  if (r.acked > 0) s.mean_rtt = r.total_rtt / r.acked;
+  if (r.last_ack) s.last_ack_age = now - *r.last_ack;
+
+  // 応答を待っている最中のフレームは数えない
+  std::size_t expired = 0, lost = 0;
+  for (const auto& f : r.frames) {
+    if (!f.valid || now - f.time < timeout_) continue;
+    ++expired;
+    if (!f.acked) ++lost;
+  }
+  s.loss_rate = expired > 0 ? static_cast<double>(lost) / expired : 0.0;
+  return s;
+}
+
+} // namespace ai_server::radio
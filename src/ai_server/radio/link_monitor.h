@@ -0,0 +1,92 @@
+#ifndef AI_SERVER_RADIO_LINK_MONITOR_H
+#define AI_SERVER_RADIO_LINK_MONITOR_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace ai_server::radio {
+
+/// @class  link_monitor
+/// @brief  通し番号つきで送信したフレームとロボットからの応答を対応づけ, 通信の状態を求める
+///
+/// 送信側 (radio::kiks など) が sent() を, 受信側 (receiver::robot) が handle_feedback() を呼ぶ.
+/// 応答の形式は [ID + 1, 受け取ったフレームの通し番号, ...] とする.
+/// 各関数は別々のスレッドから呼び出してよい.
+class link_monitor {
+public:
+  using clock_type    = std::chrono::system_clock;
+  using time_point    = clock_type::time_point;
+  using duration_type = clock_type::duration;
+
+  /// 扱うロボットの ID の上限
+  static constexpr std::size_t max_robots = 16;
+  /// 往復時間のヒストグラムのビンの数 (最後のビンはそれ以上の全てを含む)
+  static constexpr std::size_t histogram_bins = 32;
+  /// 往復時間のヒストグラムのビンの幅
+  static constexpr std::chrono::milliseconds histogram_bin_width{2};
+
+  /// ロボットごとの通信の状態
+  struct stats {
+    /// 送信したフレーム数
+    std::uint64_t sent;
+    /// 応答のあったフレーム数
+    std::uint64_t acked;
+    /// 往復時間のヒストグラム
+    std::array<std::uint64_t, histogram_bins> rtt_histogram;
+    /// 往復時間の平均 (応答がなければ std::nullopt)
+    std::optional<duration_type> mean_rtt;
+    /// 直近のフレームのうち, timeout を過ぎても応答のないものの割合
+    double loss_rate;
+    /// 最後に応答を受け取ってからの時間 (応答がなければ std::nullopt)
+    std::optional<duration_type> last_ack_age;
+  };
+
+  /// @param timeout          これだけ待っても応答がないフレームを失われたとみなす
+  explicit link_monitor(duration_type timeout = std::chrono::milliseconds{100});
+
+  /// @brief                  フレームを送信したことを記録する
+  void sent(unsigned int id, std::uint8_t sequence, time_point time);
+
+  /// @brief                  フレームへの応答を記録する
+  /// @return                 送信したフレームに対応する最初の応答なら true
+  bool acked(unsigned int id, std::uint8_t sequence, time_point time);
+
+  /// @brief                  ロボットからの応答を解釈して acked() を呼ぶ
+  /// @return                 応答として解釈でき, 送信したフレームに対応していれば true
+  bool handle_feedback(const std::vector<std::uint8_t>& packet, time_point time);
+
+  /// @brief                  ロボットの通信の状態を取得する
+  /// @param now              loss_rate, last_ack_age の基準とする時刻
+  stats robot_stats(unsigned int id, time_point now) const;
+
+private:
+  /// 送信したフレームの記録
+  struct frame {
+    time_point time;
+    bool valid;
+    bool acked;
+  };
+
+  struct robot_state {
+    /// 通し番号で引く直近 256 フレームの記録
+    std::array<frame, 256> frames;
+    std::uint64_t sent;
+    std::uint64_t acked;
+    std::array<std::uint64_t, histogram_bins> rtt_histogram;
+    duration_type total_rtt;
+    std::optional<time_point> last_ack;
+  };
+
+  mutable std::mutex mutex_;
+  duration_type timeout_;
+  std::array<robot_state, max_robots> robots_;
+};
+
+} // namespace ai_server::radio
+
+#endif // AI_SERVER_RADIO_LINK_MONITOR_H
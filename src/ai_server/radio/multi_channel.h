@@ -0,0 +1,294 @@
+#ifndef AI_SERVER_RADIO_MULTI_CHANNEL_H
+#define AI_SERVER_RADIO_MULTI_CHANNEL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "base/base.h"
+#include "detail/frame_pool.h"
+#include "detail/kiks_encoder.h"
+#include "detail/kiks_frame.h"
+#include "link_monitor.h"
+
+namespace ai_server::radio {
+
+/// @class  multi_channel
+/// @brief  複数の Connection (チャネル) にロボットを振り分けて Kiks 形式の命令を送る Radio
+///
+/// ロボットごとに使うチャネルを固定でき, 固定していないロボットは送信量の少ないチャネルに
+/// 自動で割り当てる. v2 では副チャネルを指定したロボットのフレームを 2 つのチャネルに送る.
+/// 同じ通し番号のフレームは同じ内容なので, ロボットは後から届いた方を捨てればよい
+/// (応答が重複しても link_monitor は最初のものだけを数える).
+/// ロボットの ID は link_monitor::max_robots 未満でなければならず, それ以外の ID を渡すと
+/// どの関数も std::out_of_range を投げる.
+template <class Connection>
+class multi_channel : public base::command {
+public:
+  /// チャネルごとの送信の統計
+  struct channel_stats {
+    /// 送信したフレーム数
+    std::uint64_t frames;
+    /// 送信したバイト数
+    std::uint64_t bytes;
+    /// 1 サイクルあたりに送信したバイト数の移動平均
+    double load;
+    /// このチャネルを使うロボットの数 (副チャネルとしての利用を含む)
+    std::size_t robots;
+  };
+
+  explicit multi_channel(std::vector<std::unique_ptr<Connection>> connections)
+      : rebalance_interval_{0}, cycles_{0}, assignments_{} {
+    if (connections.empty()) throw std::invalid_argument{"multi_channel: no connection"};
+    for (auto& c : connections) {
+      channels_.push_back({std::move(c), {}, 0, 0, 0, 0.0});
+      channels_.back().staged.reserve(detail::kiks_frame_v2_size * detail::max_frames);
+    }
+  }
+
+  std::size_t channels() const {
+    return channels_.size();
+  }
+
+  const Connection& connection(std::size_t channel) const {
+    return *channels_.at(channel).connection;
+  }
+
+  /// @brief フレームの版を設定する
+  void set_protocol(kiks_protocol protocol) {
+    std::lock_guard lock{mutex_};
+    encoder_.set_protocol(protocol);
+  }
+
+  /// @brief v2 で送信したフレームを記録する link_monitor を設定する
+  void set_link_monitor(std::shared_ptr<link_monitor> monitor) {
+    std::lock_guard lock{mutex_};
+    encoder_.set_link_monitor(std::move(monitor));
+  }
+
+  /// @brief                rebalance() を自動で呼ぶ間隔を設定する
+  /// @param cycles         begin_cycle() をこの回数呼ぶごとに 1 回 rebalance() する
+  ///                       (0 なら自動では呼ばず, 必要なときに呼び出し側で rebalance() する)
+  void set_rebalance_interval(std::size_t cycles) {
+    std::lock_guard lock{mutex_};
+    rebalance_interval_ = cycles;
+    cycles_             = 0;
+  }
+
+  /// @brief                ロボットが使うチャネルを固定する
+  /// @param primary        命令を送るチャネル
+  /// @param secondary      同じフレームを送るもう 1 つのチャネル (v2 のときのみ使われる)
+  void assign(unsigned int id, std::size_t primary,
+              std::optional<std::size_t> secondary = std::nullopt) {
+    if (primary >= channels_.size() || (secondary && *secondary >= channels_.size())) {
+      throw std::out_of_range{"multi_channel: invalid channel"};
+    }
+    std::lock_guard lock{mutex_};
+    assignment_of(id) = assignment{primary, secondary, true};
+  }
+
+  /// @brief                固定を解除し, 次の送信時に自動で割り当て直す
+  void unassign(unsigned int id) {
+    std::lock_guard lock{mutex_};
+    assignment_of(id).reset();
+  }
+
+  /// @brief                ロボットが現在使っているチャネル (まだ割り当てられていなければ空)
+  std::optional<std::size_t> channel_of(unsigned int id) const {
+    std::lock_guard lock{mutex_};
+    const auto& a = assignments_[checked(id)];
+    return a ? std::optional{a->primary} : std::nullopt;
+  }
+
+  /// @brief                自動で割り当てたロボットを 1 台, 最も負荷の大きいチャネルから
+  ///                       最も負荷の小さいチャネルに移す
+  /// @return               移したら true (負荷の差が 1 台分より小さければ何もしない)
+  bool rebalance() {
+    std::lock_guard lock{mutex_};
+    return rebalance_unlocked();
+  }
+
+  /// @brief                チャネルの送信の統計を取得する
+  channel_stats stats(std::size_t channel) const {
+    std::lock_guard lock{mutex_};
+    const auto& ch = channels_.at(channel);
+
+    std::size_t robots = 0;
+    for (const auto& a : assignments_) {
+      if (a && (a->primary == channel || (redundant(*a) && *a->secondary == channel))) {
+        ++robots;
+      }
+    }
+    return {ch.frames, ch.bytes, ch.load, robots};
+  }
+
+  void send([[maybe_unused]] model::team_color color, unsigned int id,
+            const model::command::kick_flag_t& kick_flag, int dribble, double vx, double vy,
+            double omega) override {
+    std::lock_guard lock{mutex_};
+    checked(id); // 通し番号を進める前に検査する
+    std::array<std::uint8_t, detail::kiks_frame_v2_size> frame;
+    const auto size = encoder_.encode(frame.data(), id, kick_flag, dribble, vx, vy, omega);
+    for_each_channel(id, size, [this, &frame, size](channel& ch) {
+      detail::send_pooled(*ch.connection, pool_, frame.data(), size);
+    });
+  }
+
+  void send([[maybe_unused]] model::team_color color, unsigned int id,
+            std::shared_ptr<model::motion::base> motion) override {
+    if (motion) std::cout << id << ": " << motion->motion_id() << std::endl;
+  }
+
+  void begin_cycle(model::team_color) override {
+    std::lock_guard lock{mutex_};
+    for (auto& ch : channels_) {
+      ch.load        = (1.0 - load_smoothing) * ch.load + load_smoothing * ch.cycle_bytes;
+      ch.cycle_bytes = 0;
+      ch.staged.clear();
+    }
+    if (rebalance_interval_ > 0 && ++cycles_ >= rebalance_interval_) {
+      cycles_ = 0;
+      rebalance_unlocked();
+    }
+  }
+
+  /// 各ロボットへのフレームをチャネルごとに連結し, flush() でチャネルごとに 1 回で送信する
+  void stage([[maybe_unused]] model::team_color color, unsigned int id,
+             const model::command::kick_flag_t& kick_flag, int dribble, double vx, double vy,
+             double omega) override {
+    std::lock_guard lock{mutex_};
+    checked(id); // 通し番号を進める前に検査する
+    std::array<std::uint8_t, detail::kiks_frame_v2_size> frame;
+    const auto size = encoder_.encode(frame.data(), id, kick_flag, dribble, vx, vy, omega);
+    for_each_channel(id, size, [&frame, size](channel& ch) {
+      ch.staged.insert(ch.staged.end(), frame.cbegin(), frame.cbegin() + size);
+    });
+  }
+
+  using base::command::stage;
+
+  void flush() override {
+    std::lock_guard lock{mutex_};
+    for (auto& ch : channels_) {
+      if (ch.staged.empty()) continue;
+      detail::send_pooled(*ch.connection, pool_, ch.staged.data(), ch.staged.size());
+      ch.staged.clear();
+    }
+  }
+
+private:
+  /// load の移動平均の重み
+  static constexpr double load_smoothing = 0.2;
+
+  struct assignment {
+    std::size_t primary;
+    std::optional<std::size_t> secondary;
+    /// assign() で固定されたか
+    bool pinned;
+  };
+
+  struct channel {
+    std::unique_ptr<Connection> connection;
+    /// 送信待ちのフレーム
+    std::vector<std::uint8_t> staged;
+    std::uint64_t frames;
+    std::uint64_t bytes;
+    /// 現在のサイクルで送信したバイト数
+    std::uint64_t cycle_bytes;
+    double load;
+  };
+
+  /// @brief                ID を検査して返す
+  static unsigned int checked(unsigned int id) {
+    if (id >= link_monitor::max_robots) throw std::out_of_range{"multi_channel: invalid id"};
+    return id;
+  }
+
+  std::optional<assignment>& assignment_of(unsigned int id) {
+    return assignments_[checked(id)];
+  }
+
+  /// rebalance() の本体 (mutex_ をロックした状態で呼ぶ)
+  bool rebalance_unlocked() {
+    std::size_t hi = 0, lo = 0;
+    for (std::size_t c = 1; c < channels_.size(); ++c) {
+      if (channels_[c].load > channels_[hi].load) hi = c;
+      if (channels_[c].load < channels_[lo].load) lo = c;
+    }
+
+    // hi を主チャネルとするロボット 1 台あたりの負荷を見積もる
+    std::size_t robots = 0;
+    std::optional<unsigned int> candidate{};
+    for (unsigned int id = 0; id < assignments_.size(); ++id) {
+      const auto& a = assignments_[id];
+      if (!a || a->primary != hi) continue;
+      ++robots;
+      if (!a->pinned) candidate = id;
+    }
+    if (!candidate) return false;
+
+    const auto per_robot = channels_[hi].load / robots;
+    if (channels_[hi].load - channels_[lo].load <= per_robot) return false;
+
+    assignments_[*candidate]->primary = lo;
+    return true;
+  }
+
+  bool redundant(const assignment& a) const {
+    return a.secondary && *a.secondary != a.primary && encoder_.protocol() == kiks_protocol::v2;
+  }
+
+  /// @brief                id のロボットのフレームを送るチャネルそれぞれについて f を呼ぶ
+  ///
+  /// 割り当てられていなければ, このサイクルの送信量を含めて最も負荷の小さいチャネルを割り当てる.
+  template <class F>
+  void for_each_channel(unsigned int id, std::size_t size, F&& f) {
+    auto& a = assignment_of(id);
+    if (!a) {
+      std::size_t best = 0;
+      for (std::size_t c = 1; c < channels_.size(); ++c) {
+        const auto& ch = channels_[c];
+        const auto& b  = channels_[best];
+        if (ch.load + ch.cycle_bytes < b.load + b.cycle_bytes) best = c;
+      }
+      a = assignment{best, std::nullopt, false};
+    }
+
+    const auto use = [this, size, &f](std::size_t c) {
+      auto& ch = channels_[c];
+      f(ch);
+      ++ch.frames;
+      ch.bytes += size;
+      ch.cycle_bytes += size;
+    };
+    use(a->primary);
+    if (redundant(*a)) use(*a->secondary);
+  }
+
+  mutable std::mutex mutex_;
+
+  detail::kiks_encoder encoder_;
+
+  /// rebalance() を自動で呼ぶ間隔 (0 なら呼ばない) と, 前回呼んでからのサイクル数
+  std::size_t rebalance_interval_;
+  std::size_t cycles_;
+
+  /// ロボットごとのチャネルの割り当て
+  std::array<std::optional<assignment>, link_monitor::max_robots> assignments_;
+
+  /// 送信中のフレームを保持する領域 (channels_ より後に破棄されるよう先に宣言する)
+  detail::frame_pool pool_;
+
+  std::vector<channel> channels_;
+};
+
+} // namespace ai_server::radio
+
+#endif // AI_SERVER_RADIO_MULTI_CHANNEL_H
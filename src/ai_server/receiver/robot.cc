@@ -45,11 +45,22 @@ std::chrono::system_clock::time_point robot::last_updated() const {
   return last_updated_;
 }
 
+void robot::set_link_monitor(std::shared_ptr<radio::link_monitor> monitor) {
+  std::unique_lock lock{mutex_};
+  link_monitor_ = std::move(monitor);
+}
+
 void robot::handle_receive(const util::net::multicast::receiver::buffer_t& buffer,
                            std::size_t size, std::uint64_t total_messages,
                            std::chrono::system_clock::time_point time) {
   std::vector<std::uint8_t> packet;
   for (std::size_t i = 0; i < size; ++i) packet.push_back(buffer[i]);
+
+  // 送信したフレームへの応答であれば link_monitor に記録する
+  if (std::shared_lock lock{mutex_}; link_monitor_) {
+    link_monitor_->handle_feedback(packet, time);
+  }
+
   receive_signal_(packet);
 }
 
@@ -3,6 +3,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <shared_mutex>
 
@@ -10,6 +11,7 @@
 #include <boost/signals2.hpp>
 
 #include "ai_server/logger/logger.h"
+#include "ai_server/radio/link_monitor.h"
 #include "ai_server/util/net/multicast/receiver.h"
 
 namespace ai_server {
@@ -47,6 +49,9 @@ public:
   /// @brief 最後にメッセージを受信した日時を取得する
   std::chrono::system_clock::time_point last_updated() const;
 
+  /// @brief 受信したデータを送信したフレームへの応答として照合する link_monitor を設定する
+  void set_link_monitor(std::shared_ptr<radio::link_monitor> monitor);
+
 private:
   /// @brief receiver_ が新しいメッセージを受信したときに呼ばれる関数
   void handle_receive(const util::net::multicast::receiver::buffer_t& buffer,
@@ -68,6 +73,8 @@ private:
   /// 最後にメッセージを受信した日時
   std::chrono::system_clock::time_point last_updated_;
 
+  std::shared_ptr<radio::link_monitor> link_monitor_;
+
   util::net::multicast::receiver receiver_;
 
   receive_signal_type receive_signal_;
@@ -1,3 +1,4 @@
+#include "ai_server/util/trace.h"
 #include "ssl-protos/vision_wrapper.pb.h"
 
 #include "vision.h"
@@ -59,6 +60,8 @@ std::chrono::system_clock::time_point vision::last_updated() const {
 void vision::handle_receive(const util::net::multicast::receiver::buffer_t& buffer,
                             std::size_t size, std::uint64_t total_messages,
                             std::chrono::system_clock::time_point time) {
+  AI_SERVER_TRACE_SCOPE("receiver::vision::handle_receive");
+
   ssl_protos::vision::Packet packet;
 
   // パケットをパース
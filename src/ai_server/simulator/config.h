@@ -0,0 +1,80 @@
+#ifndef AI_SERVER_SIMULATOR_CONFIG_H
+#define AI_SERVER_SIMULATOR_CONFIG_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace ai_server::simulator {
+
+/// シミュレータの設定 (長さの単位は mm)
+struct config {
+  /// フィールドの長さ
+  int field_length = 12000;
+  /// フィールドの幅
+  int field_width = 9000;
+  /// ゴールの幅
+  int goal_width = 1200;
+  /// ゴールの奥行き
+  int goal_depth = 180;
+  /// ペナルティエリアの奥行き
+  int penalty_area_depth = 1200;
+  /// ペナルティエリアの幅
+  int penalty_area_width = 2400;
+  /// センターサークルの半径
+  int center_radius = 500;
+  /// フィールドの外側の余白の幅 (その外側を壁とする)
+  int boundary_width = 300;
+
+  /// x 軸方向に並べるカメラの数
+  unsigned int cameras_x = 2;
+  /// y 軸方向に並べるカメラの数
+  unsigned int cameras_y = 2;
+  /// 隣り合うカメラが重なって映す幅
+  double camera_overlap = 400;
+
+  /// 検出位置に加える誤差の標準偏差
+  double position_noise = 0;
+  /// 検出したロボットの向きに加える誤差の標準偏差 [rad]
+  double angle_noise = 0;
+  /// 乱数のシード
+  std::uint32_t seed = 0;
+
+  /// 撮影から検出データが送られるまでの遅れ
+  std::chrono::nanoseconds latency{0};
+  /// 検出データを作る周期
+  std::chrono::nanoseconds frame_period{16'666'667};
+  /// フィールドの形状を送る間隔 [フレーム] (0 なら送らない)
+  unsigned int geometry_interval = 60;
+  /// 物理演算の刻み幅
+  std::chrono::nanoseconds step{1'000'000};
+
+  /// 開始時に各チームに並べるロボットの数
+  unsigned int robots_per_team = 0;
+  /// ロボットの半径
+  double robot_radius = 90;
+  /// ロボットの高さ (これより高いボールとは衝突しない)
+  double robot_height = 150;
+  /// キッカーの幅
+  double kicker_width = 70;
+  /// ロボットの加速度の上限 [mm/s^2]
+  double robot_acceleration = 4000;
+  /// ロボットの角加速度の上限 [rad/s^2]
+  double robot_angular_acceleration = 40;
+
+  /// ボールの半径
+  double ball_radius = 21.5;
+  /// 転がるボールの減速度 [mm/s^2]
+  double ball_deceleration = 400;
+  /// ボールが地面で跳ねるときの反発係数
+  double ball_restitution = 0.5;
+  /// ボールが壁で跳ね返るときの反発係数
+  double wall_restitution = 0.5;
+  /// ボールがロボットで跳ね返るときの反発係数
+  double robot_restitution = 0.3;
+  /// 重力加速度 [mm/s^2]
+  double gravity = 9810;
+};
+
+} // namespace ai_server::simulator
+
+#endif // AI_SERVER_SIMULATOR_CONFIG_H
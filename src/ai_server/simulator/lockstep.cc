@@ -0,0 +1,38 @@
+#include "lockstep.h"
+
+namespace ai_server::simulator {
+
+lockstep::lockstep(std::shared_ptr<simulator> sim, model::updater::world& world,
+                   duration tick)
+    : simulator_{std::move(sim)},
+      world_{world},
+      tick_{tick},
+      ticks_{0},
+      clock_{simulator_->now()},
+      scoped_{clock_} {}
+
+void lockstep::add_driver(driver& d) {
+  drivers_.push_back(std::ref(d));
+}
+
+void lockstep::on_tick(std::function<void()> f) {
+  on_tick_.push_back(std::move(f));
+}
+
+void lockstep::step() {
+  simulator_->advance(tick_);
+  // 検出データの撮影時刻と util::clock の時刻を揃える
+  clock_.set(simulator_->now());
+
+  for (const auto& p : simulator_->take_vision()) world_.update(p);
+  for (const auto& f : on_tick_) f();
+  for (auto& d : drivers_) d.get().step();
+
+  ++ticks_;
+}
+
+void lockstep::run(std::uint64_t n) {
+  for (std::uint64_t i = 0; i < n; ++i) step();
+}
+
+} // namespace ai_server::simulator
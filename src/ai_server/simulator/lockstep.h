@@ -0,0 +1,75 @@
+#ifndef AI_SERVER_SIMULATOR_LOCKSTEP_H
+#define AI_SERVER_SIMULATOR_LOCKSTEP_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ai_server/driver.h"
+#include "ai_server/model/updater/world.h"
+#include "ai_server/util/clock.h"
+#include "simulator.h"
+
+namespace ai_server::simulator {
+
+/// @class  lockstep
+/// @brief  シミュレータと AI の処理を 1 周期ずつ同じスレッドで進める
+///
+/// step() は時刻を tick だけ進め, 検出データによる world の更新, on_tick() で登録した処理
+/// (Game など), Driver の step() を順に呼び出す. Driver の Radio が simulator::loopback を
+/// 使っていれば, 命令はその場でシミュレータに反映される.
+/// 生存している間は util::clock の時刻をシミュレータの時刻に置き換えるので, 同時に複数作らないこと.
+class lockstep {
+public:
+  using duration = simulator::duration;
+
+  /// @param sim              進めるシミュレータ
+  /// @param world            検出データで更新する updater::world
+  /// @param tick             step() 1 回で進める時間 (Driver の制御周期と揃える)
+  lockstep(std::shared_ptr<simulator> sim, model::updater::world& world, duration tick);
+
+  lockstep(const lockstep&) = delete;
+  lockstep& operator=(const lockstep&) = delete;
+
+  /// @brief                  step() で動かす Driver を追加する
+  ///
+  /// io_context を受け取らないコンストラクタで作った Driver であること
+  void add_driver(driver& d);
+
+  /// @brief                  world の更新と Driver の処理の間に呼ぶ関数を登録する
+  void on_tick(std::function<void()> f);
+
+  /// @brief                  1 周期分の処理を行う
+  void step();
+
+  /// @brief                  step() を n 回行う
+  void run(std::uint64_t n);
+
+  /// @brief                  step() を行った回数
+  std::uint64_t ticks() const {
+    return ticks_;
+  }
+
+  /// @brief                  util::clock に設定している時刻
+  const util::clock::manual& clock() const {
+    return clock_;
+  }
+
+private:
+  std::shared_ptr<simulator> simulator_;
+  model::updater::world& world_;
+  duration tick_;
+  std::uint64_t ticks_;
+
+  util::clock::manual clock_;
+  util::clock::scoped_source scoped_;
+
+  std::vector<std::reference_wrapper<driver>> drivers_;
+  std::vector<std::function<void()>> on_tick_;
+};
+
+} // namespace ai_server::simulator
+
+#endif // AI_SERVER_SIMULATOR_LOCKSTEP_H
@@ -0,0 +1,53 @@
+#ifndef AI_SERVER_SIMULATOR_LOOPBACK_H
+#define AI_SERVER_SIMULATOR_LOOPBACK_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <boost/asio/buffer.hpp>
+
+#include "simulator.h"
+
+namespace ai_server::simulator {
+
+/// @class  loopback
+/// @brief  送信されたデータを同じプロセスの simulator に直接渡す Connection
+///
+/// radio::grsim<loopback> とすれば, UDP を介さずに radio::base::command,
+/// radio::base::simulator として simulator を操作できる.
+class loopback {
+public:
+  explicit loopback(std::shared_ptr<simulator> sim)
+      : simulator_{std::move(sim)}, total_messages_{0}, total_errors_{0} {}
+
+  template <class Buffer>
+  void send(Buffer&& buffer) {
+    const auto b = boost::asio::buffer(buffer);
+    if (simulator_->apply(b.data(), b.size())) {
+      ++total_messages_;
+    } else {
+      ++total_errors_;
+    }
+  }
+
+  /// @brief            反映したパケットの数
+  std::uint64_t total_messages() const {
+    return total_messages_.load();
+  }
+
+  /// @brief            パースできなかったパケットの数
+  std::uint64_t total_errors() const {
+    return total_errors_.load();
+  }
+
+private:
+  std::shared_ptr<simulator> simulator_;
+  std::atomic<std::uint64_t> total_messages_;
+  std::atomic<std::uint64_t> total_errors_;
+};
+
+} // namespace ai_server::simulator
+
+#endif // AI_SERVER_SIMULATOR_LOOPBACK_H
@@ -0,0 +1,80 @@
+#include <limits>
+
+#include "ssl-protos/grsim_packet.pb.h"
+
+#include "simulator.h"
+
+namespace ai_server::simulator {
+
+simulator::simulator(const config& c)
+    : config_{c},
+      world_{c},
+      vision_{c},
+      now_{0},
+      next_frame_{c.frame_period},
+      frames_{0} {}
+
+void simulator::apply(const ssl_protos::grsim::Packet& packet) {
+  std::lock_guard lock{mutex_};
+  world_.apply(packet);
+}
+
+bool simulator::apply(const void* data, std::size_t size) {
+  ssl_protos::grsim::Packet packet{};
+  if (size > static_cast<std::size_t>(std::numeric_limits<int>::max()) ||
+      !packet.ParseFromArray(data, static_cast<int>(size))) {
+    return false;
+  }
+  apply(packet);
+  return true;
+}
+
+void simulator::advance(duration d) {
+  std::lock_guard lock{mutex_};
+
+  const auto dt     = std::chrono::duration<double>{config_.step}.count();
+  const auto target = now_ + d;
+  while (now_ < target) {
+    world_.step(dt);
+    now_ += config_.step;
+
+    if (now_ < next_frame_) continue;
+    next_frame_ += config_.frame_period;
+
+    const auto sent = now_ + config_.latency;
+    if (config_.geometry_interval > 0 && frames_ % config_.geometry_interval == 0) {
+      pending_.push_back({sent, vision_.geometry()});
+    }
+    ++frames_;
+
+    const auto t_capture = std::chrono::duration<double>{now_}.count();
+    const auto t_sent    = std::chrono::duration<double>{sent}.count();
+    for (auto& p : vision_.capture(world_, t_capture, t_sent)) {
+      pending_.push_back({sent, std::move(p)});
+    }
+  }
+}
+
+std::vector<ssl_protos::vision::Packet> simulator::take_vision() {
+  std::lock_guard lock{mutex_};
+
+  // 遅れは一定なので, pending_ は送信する時刻の順に並んでいる
+  std::vector<ssl_protos::vision::Packet> packets{};
+  while (!pending_.empty() && pending_.front().time <= now_) {
+    packets.push_back(std::move(pending_.front().packet));
+    pending_.pop_front();
+  }
+  return packets;
+}
+
+simulator::duration simulator::now() const {
+  std::lock_guard lock{mutex_};
+  return now_;
+}
+
+world simulator::state() const {
+  std::lock_guard lock{mutex_};
+  return world_;
+}
+
+} // namespace ai_server::simulator
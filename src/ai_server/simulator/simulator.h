@@ -0,0 +1,82 @@
+#ifndef AI_SERVER_SIMULATOR_SIMULATOR_H
+#define AI_SERVER_SIMULATOR_SIMULATOR_H
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "ssl-protos/vision_wrapper.pb.h"
+
+#include "config.h"
+#include "vision.h"
+#include "world.h"
+
+// 前方宣言
+namespace ssl_protos {
+namespace grsim {
+class Packet;
+}
+} // namespace ssl_protos
+
+namespace ai_server::simulator {
+
+/// @class  simulator
+/// @brief  grSim の代わりに使う, 画面を持たない決定的なシミュレータ
+///
+/// 時刻は実時間と無関係に advance() で進み, 常に config::step の刻みで物理演算を行う.
+/// config::frame_period ごとに検出データを作り, config::latency だけ遅れて take_vision() で
+/// 取り出せるようになる. 検出データの時刻はシミュレータの開始時を 0 とした時刻 [s] になる.
+/// 各関数は別々のスレッドから呼び出してよい.
+class simulator {
+public:
+  using duration = std::chrono::nanoseconds;
+
+  explicit simulator(const config& c = {});
+
+  /// @brief            grSim 形式の命令や配置の変更を反映する
+  void apply(const ssl_protos::grsim::Packet& packet);
+
+  /// @brief            grSim 形式のシリアライズされたパケットを反映する
+  /// @return           パースできたら true
+  bool apply(const void* data, std::size_t size);
+
+  /// @brief            時刻を d だけ進める (config::step の倍数に切り上げる)
+  void advance(duration d);
+
+  /// @brief            送信する時刻になった検出データを取り出す
+  std::vector<ssl_protos::vision::Packet> take_vision();
+
+  /// @brief            シミュレータの時刻
+  duration now() const;
+
+  /// @brief            現在の状態の複製を取得する
+  world state() const;
+
+  /// @brief            状態を直接操作する
+  template <class F>
+  void modify(F&& f) {
+    std::lock_guard lock{mutex_};
+    f(world_);
+  }
+
+private:
+  /// 送信待ちの検出データ
+  struct pending {
+    duration time;
+    ssl_protos::vision::Packet packet;
+  };
+
+  mutable std::mutex mutex_;
+  config config_;
+  world world_;
+  vision vision_;
+  duration now_;
+  duration next_frame_;
+  unsigned int frames_;
+  std::deque<pending> pending_;
+};
+
+} // namespace ai_server::simulator
+
+#endif // AI_SERVER_SIMULATOR_SIMULATOR_H
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cmath>
+
+#include <boost/math/constants/constants.hpp>
+
+#include "ssl-protos/vision_wrapper.pb.h"
+
+#include "vision.h"
+
+namespace ai_server::simulator {
+
+vision::vision(const config& c) : config_{c}, engine_{c.seed}, normal_{0.0, 1.0} {
+  const auto wall_x = c.field_length / 2.0 + c.boundary_width;
+  const auto wall_y = c.field_width / 2.0 + c.boundary_width;
+  const auto nx     = std::max(c.cameras_x, 1u);
+  const auto ny     = std::max(c.cameras_y, 1u);
+  const auto w      = 2 * wall_x / nx;
+  const auto h      = 2 * wall_y / ny;
+  const auto margin = c.camera_overlap / 2;
+
+  for (unsigned int i = 0; i < nx; ++i) {
+    for (unsigned int j = 0; j < ny; ++j) {
+      areas_.push_back({-wall_x + i * w - (i > 0 ? margin : 0),
+                        -wall_x + (i + 1) * w + (i + 1 < nx ? margin : 0),
+                        -wall_y + j * h - (j > 0 ? margin : 0),
+                        -wall_y + (j + 1) * h + (j + 1 < ny ? margin : 0)});
+    }
+  }
+  frame_numbers_.resize(areas_.size());
+}
+
+std::vector<ssl_protos::vision::Packet> vision::capture(const world& w, double t_capture,
+                                                        double t_sent) {
+  std::vector<ssl_protos::vision::Packet> packets(areas_.size());
+
+  // 結果が映り方に左右されないよう, 誤差は物体ごとに 1 回だけ決めて各カメラで共有する
+  const auto noise = [this](double stddev) {
+    return stddev > 0 ? stddev * normal_(engine_) : 0.0;
+  };
+
+  const auto fill = [](const area& a, auto& o, double x, double y) {
+    const auto cx = (a.x_min + a.x_max) / 2;
+    const auto cy = (a.y_min + a.y_max) / 2;
+    const auto r  = std::hypot(a.x_max - cx, a.y_max - cy);
+    o.set_confidence(static_cast<float>(1.0 - 0.5 * std::hypot(x - cx, y - cy) / r));
+    o.set_x(static_cast<float>(x));
+    o.set_y(static_cast<float>(y));
+    o.set_pixel_x(static_cast<float>(x - a.x_min));
+    o.set_pixel_y(static_cast<float>(y - a.y_min));
+  };
+
+  const auto visible = [](const area& a, double x, double y) {
+    return a.x_min <= x && x < a.x_max && a.y_min <= y && y < a.y_max;
+  };
+
+  for (std::size_t i = 0; i < areas_.size(); ++i) {
+    auto frame = packets[i].mutable_detection();
+    frame->set_frame_number(frame_numbers_[i]++);
+    frame->set_t_capture(t_capture);
+    frame->set_t_sent(t_sent);
+    frame->set_camera_id(static_cast<std::uint32_t>(i));
+  }
+
+  {
+    const auto& b = w.ball();
+    const auto x  = b.x + noise(config_.position_noise);
+    const auto y  = b.y + noise(config_.position_noise);
+    for (std::size_t i = 0; i < areas_.size(); ++i) {
+      if (!visible(areas_[i], x, y)) continue;
+      auto ball = packets[i].mutable_detection()->add_balls();
+      fill(areas_[i], *ball, x, y);
+      ball->set_z(static_cast<float>(b.z));
+    }
+  }
+
+  for (const auto color : {model::team_color::blue, model::team_color::yellow}) {
+    for (unsigned int id = 0; id < world::max_robots; ++id) {
+      const auto& r = w.robot_at(color, id);
+      if (!r.present) continue;
+
+      const auto x     = r.x + noise(config_.position_noise);
+      const auto y     = r.y + noise(config_.position_noise);
+      const auto theta = r.theta + noise(config_.angle_noise);
+      for (std::size_t i = 0; i < areas_.size(); ++i) {
+        if (!visible(areas_[i], x, y)) continue;
+        auto frame = packets[i].mutable_detection();
+        auto robot = color == model::team_color::blue ? frame->add_robots_blue()
+                                                      : frame->add_robots_yellow();
+        fill(areas_[i], *robot, x, y);
+        robot->set_robot_id(id);
+        robot->set_orientation(static_cast<float>(theta));
+      }
+    }
+  }
+
+  return packets;
+}
+
+ssl_protos::vision::Packet vision::geometry() const {
+  ssl_protos::vision::Packet packet{};
+  auto geometry = packet.mutable_geometry();
+
+  auto f = geometry->mutable_field();
+  f->set_field_length(config_.field_length);
+  f->set_field_width(config_.field_width);
+  f->set_goal_width(config_.goal_width);
+  f->set_goal_depth(config_.goal_depth);
+  f->set_boundary_width(config_.boundary_width);
+  f->set_penalty_area_depth(config_.penalty_area_depth);
+  f->set_penalty_area_width(config_.penalty_area_width);
+
+  const auto add_line = [f](const char* name, double x1, double y1, double x2, double y2) {
+    auto l = f->add_field_lines();
+    l->set_name(name);
+    l->mutable_p1()->set_x(static_cast<float>(x1));
+    l->mutable_p1()->set_y(static_cast<float>(y1));
+    l->mutable_p2()->set_x(static_cast<float>(x2));
+    l->mutable_p2()->set_y(static_cast<float>(y2));
+    l->set_thickness(10);
+  };
+  const auto x = -config_.field_length / 2.0;
+  const auto d = config_.penalty_area_depth;
+  const auto h = config_.penalty_area_width / 2.0;
+  add_line("LeftPenaltyStretch", x + d, -h, x + d, h);
+  add_line("LeftFieldLeftPenaltyStretch", x, h, x + d, h);
+
+  auto arc = f->add_field_arcs();
+  arc->set_name("CenterCircle");
+  arc->mutable_center()->set_x(0);
+  arc->mutable_center()->set_y(0);
+  arc->set_radius(static_cast<float>(config_.center_radius));
+  arc->set_a1(0);
+  arc->set_a2(static_cast<float>(2 * boost::math::double_constants::pi));
+  arc->set_thickness(10);
+
+  for (std::size_t i = 0; i < areas_.size(); ++i) {
+    geometry->add_calib()->set_camera_id(static_cast<std::uint32_t>(i));
+  }
+  return packet;
+}
+
+} // namespace ai_server::simulator
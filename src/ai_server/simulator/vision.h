@@ -0,0 +1,65 @@
+#ifndef AI_SERVER_SIMULATOR_VISION_H
+#define AI_SERVER_SIMULATOR_VISION_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "config.h"
+#include "world.h"
+
+// 前方宣言
+namespace ssl_protos {
+namespace vision {
+class Packet;
+}
+} // namespace ssl_protos
+
+namespace ai_server::simulator {
+
+/// @class  vision
+/// @brief  world の状態から SSL-Vision 形式の検出データを作る
+///
+/// 壁の内側を cameras_x * cameras_y の格子に分けて各カメラに割り当て, 隣り合うカメラは
+/// camera_overlap だけ重ねて映す. confidence はカメラの中心から離れるほど小さくなる.
+/// 誤差は seed で初期化した乱数で加えるので, 同じ操作に対して常に同じ検出データを返す.
+class vision {
+public:
+  /// カメラが映す範囲
+  struct area {
+    double x_min;
+    double x_max;
+    double y_min;
+    double y_max;
+  };
+
+  explicit vision(const config& c);
+
+  std::size_t cameras() const {
+    return areas_.size();
+  }
+
+  const area& camera_area(unsigned int camera_id) const {
+    return areas_.at(camera_id);
+  }
+
+  /// @brief                各カメラの検出データを作る
+  /// @param t_capture      撮影した時刻 [s]
+  /// @param t_sent         送信する時刻 [s]
+  std::vector<ssl_protos::vision::Packet> capture(const world& w, double t_capture,
+                                                  double t_sent);
+
+  /// @brief                フィールドの形状を作る
+  ssl_protos::vision::Packet geometry() const;
+
+private:
+  config config_;
+  std::vector<area> areas_;
+  std::vector<std::uint32_t> frame_numbers_;
+  std::mt19937 engine_;
+  std::normal_distribution<double> normal_;
+};
+
+} // namespace ai_server::simulator
+
+#endif // AI_SERVER_SIMULATOR_VISION_H
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cmath>
+
+#include <boost/math/constants/constants.hpp>
+
+#include "ssl-protos/grsim_packet.pb.h"
+
+#include "world.h"
+
+namespace ai_server::simulator {
+
+namespace {
+
+constexpr double pi = boost::math::double_constants::pi;
+
+/// これより遅く地面に落ちたボールは跳ねずに止まる [mm/s]
+constexpr double min_bounce_speed = 100;
+
+/// 角度を (-pi, pi] に正規化する
+double wrap(double theta) {
+  theta = std::fmod(theta + pi, 2 * pi);
+  if (theta < 0) theta += 2 * pi;
+  return theta - pi;
+}
+
+/// (x, y) を (to_x, to_y) へ距離 limit まで近づける
+void approach(double& x, double& y, double to_x, double to_y, double limit) {
+  const auto dx = to_x - x;
+  const auto dy = to_y - y;
+  const auto d  = std::hypot(dx, dy);
+  if (d <= limit) {
+    x = to_x;
+    y = to_y;
+  } else {
+    x += dx * limit / d;
+    y += dy * limit / d;
+  }
+}
+
+} // namespace
+
+world::world(const config& c)
+    : config_{c},
+      wall_x_{c.field_length / 2.0 + c.boundary_width},
+      wall_y_{c.field_width / 2.0 + c.boundary_width},
+      ball_{},
+      robots_{} {
+  // grSim と同じように, 各チームのロボットを自陣に 1 列に並べる
+  const auto n = config_.robots_per_team;
+  for (unsigned int id = 0; id < std::min<std::size_t>(n, max_robots); ++id) {
+    const auto y = (id - (n - 1) / 2.0) * 4 * config_.robot_radius;
+    place_robot(model::team_color::blue, id, -config_.field_length / 4.0, y, 0);
+    place_robot(model::team_color::yellow, id, config_.field_length / 4.0, y, pi);
+  }
+}
+
+void world::step(double dt) {
+  for (auto& team : robots_) {
+    for (auto& r : team) {
+      if (r.present) step_robot(r, dt);
+    }
+  }
+  step_ball(dt);
+}
+
+void world::apply(const ssl_protos::grsim::Packet& packet) {
+  if (packet.has_commands()) {
+    const auto& commands = packet.commands();
+    auto& team           = robots_[commands.isteamyellow()];
+    for (const auto& c : commands.robot_commands()) {
+      if (c.id() >= max_robots || !team[c.id()].present) continue;
+      auto& r         = team[c.id()];
+      r.command_vx    = c.veltangent() * 1000;
+      r.command_vy    = c.velnormal() * 1000;
+      r.command_omega = c.velangular();
+      r.kick_x        = c.kickspeedx() * 1000;
+      r.kick_z        = c.kickspeedz() * 1000;
+      r.spinner       = c.spinner();
+    }
+  }
+
+  if (packet.has_replacement()) {
+    const auto& replacement = packet.replacement();
+    if (replacement.has_ball()) {
+      const auto& b = replacement.ball();
+      place_ball(b.x() * 1000, b.y() * 1000, b.vx() * 1000, b.vy() * 1000);
+    }
+    for (const auto& r : replacement.robots()) {
+      if (r.id() >= max_robots) continue;
+      const auto color =
+          r.yellowteam() ? model::team_color::yellow : model::team_color::blue;
+      if (r.has_turnon() && !r.turnon()) {
+        remove_robot(color, r.id());
+      } else {
+        place_robot(color, r.id(), r.x() * 1000, r.y() * 1000, r.dir() * pi / 180);
+      }
+    }
+  }
+}
+
+void world::place_ball(double x, double y, double vx, double vy) {
+  ball_ = {x, y, 0, vx, vy, 0};
+}
+
+void world::place_robot(model::team_color color, unsigned int id, double x, double y,
+                        double theta) {
+  auto& r   = robots_.at(static_cast<bool>(color)).at(id);
+  r         = {};
+  r.present = true;
+  r.x       = x;
+  r.y       = y;
+  r.theta   = wrap(theta);
+}
+
+void world::remove_robot(model::team_color color, unsigned int id) {
+  robots_.at(static_cast<bool>(color)).at(id) = {};
+}
+
+void world::step_robot(robot& r, double dt) {
+  // 目標速度をフィールド座標系に変換し, 加速度の上限の範囲で近づける
+  const auto c = std::cos(r.theta);
+  const auto s = std::sin(r.theta);
+  approach(r.vx, r.vy, c * r.command_vx - s * r.command_vy, s * r.command_vx + c * r.command_vy,
+           config_.robot_acceleration * dt);
+  const auto domega = r.command_omega - r.omega;
+  const auto alpha  = config_.robot_angular_acceleration * dt;
+  r.omega += std::clamp(domega, -alpha, alpha);
+
+  r.x += r.vx * dt;
+  r.y += r.vy * dt;
+  r.theta = wrap(r.theta + r.omega * dt);
+
+  // 壁より外には出られない
+  const auto lx = wall_x_ - config_.robot_radius;
+  const auto ly = wall_y_ - config_.robot_radius;
+  if (std::abs(r.x) > lx) {
+    r.x  = std::clamp(r.x, -lx, lx);
+    r.vx = 0;
+  }
+  if (std::abs(r.y) > ly) {
+    r.y  = std::clamp(r.y, -ly, ly);
+    r.vy = 0;
+  }
+}
+
+void world::step_ball(double dt) {
+  auto& b = ball_;
+
+  if (b.z > 0 || b.vz > 0) {
+    // 浮いている間は水平方向には減速しない
+    b.vz -= config_.gravity * dt;
+    b.z += b.vz * dt;
+    if (b.z <= 0) {
+      b.z  = 0;
+      b.vz = -b.vz * config_.ball_restitution;
+      if (b.vz < min_bounce_speed) b.vz = 0;
+    }
+  } else {
+    const auto speed = std::hypot(b.vx, b.vy);
+    const auto dv    = config_.ball_deceleration * dt;
+    if (speed <= dv) {
+      b.vx = 0;
+      b.vy = 0;
+    } else {
+      b.vx *= (speed - dv) / speed;
+      b.vy *= (speed - dv) / speed;
+    }
+  }
+
+  b.x += b.vx * dt;
+  b.y += b.vy * dt;
+
+  const auto lx = wall_x_ - config_.ball_radius;
+  const auto ly = wall_y_ - config_.ball_radius;
+  if (std::abs(b.x) > lx) {
+    b.x  = std::clamp(b.x, -lx, lx);
+    b.vx = -b.vx * config_.wall_restitution;
+  }
+  if (std::abs(b.y) > ly) {
+    b.y  = std::clamp(b.y, -ly, ly);
+    b.vy = -b.vy * config_.wall_restitution;
+  }
+
+  for (const auto& team : robots_) {
+    for (const auto& r : team) {
+      if (r.present) collide(r);
+    }
+  }
+}
+
+void world::collide(const robot& r) {
+  auto& b = ball_;
+  if (b.z > config_.robot_height) return;
+
+  const auto dx       = b.x - r.x;
+  const auto dy       = b.y - r.y;
+  const auto d        = std::hypot(dx, dy);
+  const auto distance = config_.robot_radius + config_.ball_radius;
+  if (d >= distance) return;
+
+  // ロボット座標系でのボールの位置
+  const auto c     = std::cos(r.theta);
+  const auto s     = std::sin(r.theta);
+  const auto lx    = c * dx + s * dy;
+  const auto ly    = -s * dx + c * dy;
+  const auto front = lx > 0 && std::abs(ly) < config_.kicker_width / 2;
+
+  if (front && (r.kick_x > 0 || r.kick_z > 0)) {
+    // キッカーの前に置き直し, ロボットの速度に蹴った速度を加える
+    b.x  = r.x + c * distance - s * ly;
+    b.y  = r.y + s * distance + c * ly;
+    b.vx = r.vx + c * r.kick_x;
+    b.vy = r.vy + s * r.kick_x;
+    b.vz = r.kick_z;
+    return;
+  }
+
+  // ロボットの外に押し出し, ロボットに対する相対速度の法線成分を反転させる
+  const auto nx = d > 0 ? dx / d : c;
+  const auto ny = d > 0 ? dy / d : s;
+  b.x           = r.x + nx * distance;
+  b.y           = r.y + ny * distance;
+
+  auto rvx = b.vx - r.vx;
+  auto rvy = b.vy - r.vy;
+  if (front && r.spinner) {
+    // ドリブラーに捕まったボールはロボットと一緒に動く
+    rvx = 0;
+    rvy = 0;
+  } else if (const auto vn = rvx * nx + rvy * ny; vn < 0) {
+    rvx -= (1 + config_.robot_restitution) * vn * nx;
+    rvy -= (1 + config_.robot_restitution) * vn * ny;
+  }
+  b.vx = r.vx + rvx;
+  b.vy = r.vy + rvy;
+}
+
+} // namespace ai_server::simulator
@@ -0,0 +1,103 @@
+#ifndef AI_SERVER_SIMULATOR_WORLD_H
+#define AI_SERVER_SIMULATOR_WORLD_H
+
+#include <array>
+#include <cstddef>
+
+#include "ai_server/model/team_color.h"
+#include "config.h"
+
+// 前方宣言
+namespace ssl_protos {
+namespace grsim {
+class Packet;
+}
+} // namespace ssl_protos
+
+namespace ai_server::simulator {
+
+/// @class  world
+/// @brief  フィールド上のロボットとボールの状態を保持し, 時間を進める
+///
+/// ロボットは命令された速度に加速度の上限つきで追従する. ボールは地面を転がると減速し,
+/// 浮いている間は放物運動をして地面で跳ねる. 壁とロボットにぶつかると跳ね返り,
+/// キックの命令を受けたロボットのキッカーに触れると蹴り出される.
+/// ロボットの質量は十分に大きいとみなし, ロボット同士の衝突は扱わない.
+class world {
+public:
+  /// 各チームのロボットの ID の上限
+  static constexpr std::size_t max_robots = 16;
+
+  struct robot {
+    /// フィールド上に存在するか
+    bool present;
+    double x;
+    double y;
+    double theta;
+    /// フィールド座標系での速度
+    double vx;
+    double vy;
+    double omega;
+
+    /// ロボット座標系での目標速度
+    double command_vx;
+    double command_vy;
+    double command_omega;
+    /// キックの水平方向, 鉛直方向の速さ [mm/s]
+    double kick_x;
+    double kick_z;
+    bool spinner;
+  };
+
+  struct ball {
+    double x;
+    double y;
+    double z;
+    double vx;
+    double vy;
+    double vz;
+  };
+
+  explicit world(const config& c);
+
+  /// @brief            時間を dt [s] だけ進める
+  void step(double dt);
+
+  /// @brief            grSim 形式の命令や配置の変更を反映する
+  ///
+  /// 単位の扱いは radio::grsim に合わせる. 存在しないロボットへの命令は無視する.
+  void apply(const ssl_protos::grsim::Packet& packet);
+
+  void place_ball(double x, double y, double vx = 0, double vy = 0);
+
+  void place_robot(model::team_color color, unsigned int id, double x, double y,
+                   double theta);
+
+  void remove_robot(model::team_color color, unsigned int id);
+
+  const struct ball& ball() const {
+    return ball_;
+  }
+
+  const robot& robot_at(model::team_color color, unsigned int id) const {
+    return robots_.at(static_cast<bool>(color)).at(id);
+  }
+
+private:
+  void step_robot(robot& r, double dt);
+  void step_ball(double dt);
+  void collide(const robot& r);
+
+  config config_;
+  /// 壁の内側の範囲 (原点からの距離)
+  double wall_x_;
+  double wall_y_;
+
+  struct ball ball_;
+  /// 青, 黄の順のロボット
+  std::array<std::array<robot, max_robots>, 2> robots_;
+};
+
+} // namespace ai_server::simulator
+
+#endif // AI_SERVER_SIMULATOR_WORLD_H
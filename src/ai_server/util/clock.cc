@@ -0,0 +1,27 @@
+#include "clock.h"
+
+namespace ai_server::util::clock {
+
+namespace {
+std::atomic<const source*> current{nullptr};
+} // namespace
+
+void set_source(const source* s) {
+  current.store(s, std::memory_order_release);
+}
+
+const source* current_source() {
+  return current.load(std::memory_order_acquire);
+}
+
+std::chrono::system_clock::time_point system_now() {
+  const auto s = current_source();
+  return s ? s->system_now() : std::chrono::system_clock::now();
+}
+
+std::chrono::steady_clock::time_point steady_now() {
+  const auto s = current_source();
+  return s ? s->steady_now() : std::chrono::steady_clock::now();
+}
+
+} // namespace ai_server::util::clock
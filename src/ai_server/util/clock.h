@@ -0,0 +1,98 @@
+#ifndef AI_SERVER_UTIL_CLOCK_H
+#define AI_SERVER_UTIL_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+
+namespace ai_server::util::clock {
+
+/// @class  source
+/// @brief  system_now(), steady_now() が返す時刻の取得元
+///
+/// 何も設定しなければ std::chrono::system_clock, std::chrono::steady_clock の時刻を使う.
+class source {
+public:
+  virtual ~source() = default;
+
+  virtual std::chrono::system_clock::time_point system_now() const = 0;
+  virtual std::chrono::steady_clock::time_point steady_now() const = 0;
+};
+
+/// @class  manual
+/// @brief  advance() を呼んだときだけ進む時刻
+///
+/// lockstep でシミュレータと時刻を揃えるために使う. 各関数は別々のスレッドから呼び出してよい.
+class manual : public source {
+public:
+  using duration = std::chrono::nanoseconds;
+
+  /// @param start      開始時の時刻 (両方の時計の epoch からの経過時間)
+  explicit manual(duration start = duration::zero()) : elapsed_{start.count()} {}
+
+  std::chrono::system_clock::time_point system_now() const override {
+    return std::chrono::system_clock::time_point{
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed())};
+  }
+
+  std::chrono::steady_clock::time_point steady_now() const override {
+    return std::chrono::steady_clock::time_point{
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(elapsed())};
+  }
+
+  /// @brief            epoch からの経過時間
+  duration elapsed() const {
+    return duration{elapsed_.load(std::memory_order_acquire)};
+  }
+
+  /// @brief            時刻を d だけ進める
+  void advance(duration d) {
+    elapsed_.fetch_add(d.count(), std::memory_order_acq_rel);
+  }
+
+  /// @brief            epoch からの経過時間を設定する
+  void set(duration elapsed) {
+    elapsed_.store(elapsed.count(), std::memory_order_release);
+  }
+
+private:
+  std::atomic<duration::rep> elapsed_;
+};
+
+/// @brief              system_now(), steady_now() が使う時刻の取得元を設定する
+/// @param s            取得元 (nullptr なら実際の時計に戻す). 設定している間は破棄しないこと
+void set_source(const source* s);
+
+/// @brief              現在設定されている時刻の取得元 (設定されていなければ nullptr)
+const source* current_source();
+
+/// @brief              現在時刻 (system_clock)
+///
+/// Vision の撮影時刻と比較する値や, 指令の履歴の時刻など, 処理の内容に関わる時刻に使う.
+/// 処理時間の計測には使わない.
+std::chrono::system_clock::time_point system_now();
+
+/// @brief              現在時刻 (steady_clock)
+std::chrono::steady_clock::time_point steady_now();
+
+/// @class  scoped_source
+/// @brief  生存している間だけ時刻の取得元を置き換える
+class scoped_source {
+public:
+  explicit scoped_source(const source& s) : previous_{current_source()} {
+    set_source(&s);
+  }
+
+  ~scoped_source() {
+    set_source(previous_);
+  }
+
+  scoped_source(const scoped_source&) = delete;
+  scoped_source& operator=(const scoped_source&) = delete;
+
+private:
+  const source* previous_;
+};
+
+} // namespace ai_server::util::clock
+
+#endif // AI_SERVER_UTIL_CLOCK_H
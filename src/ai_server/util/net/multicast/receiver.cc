@@ -1,5 +1,6 @@
 #include <chrono>
 #include <functional>
+#include "ai_server/util/clock.h"
 #include "receiver.h"
 
 using namespace std::chrono_literals;
@@ -64,7 +65,7 @@ void receiver::receive_data(boost::asio::yield_context yield,
     if (ec) {
       call_error_callback(ec);
     } else {
-      auto time = std::chrono::system_clock::now();
+      auto time = util::clock::system_now();
       call_receive_callback(data, recieved, ++total_messages_, time);
     }
   }
@@ -3,6 +3,8 @@
 
 #include <string_view>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
 // int pthread_setname_np(pthread_t, const char*) が呼び出せるか確認
 // - macOS でない
@@ -26,6 +28,30 @@ extern "C" {
 #define AI_SERVER_HAS_PTHREAD_SETNAME_NP 0
 #endif
 
+// int pthread_setaffinity_np(pthread_t, size_t, const cpu_set_t*) が呼び出せるか確認
+// - Linux である
+// - 標準ライブラリ内部で GNU C Library 2.4+ を使っている
+//   - 2.3.4 で追加されたが, __GLIBC_PREREQ はパッチ番号を比較できないので 2.4 以降とする
+#if defined(__linux__) && defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 4)
+#define AI_SERVER_HAS_PTHREAD_SETAFFINITY_NP 1
+#else
+#define AI_SERVER_HAS_PTHREAD_SETAFFINITY_NP 0
+#endif
+#else
+#define AI_SERVER_HAS_PTHREAD_SETAFFINITY_NP 0
+#endif
+
+// int pthread_setschedparam(pthread_t, int, const sched_param*) が呼び出せるか確認
+#if __has_include(<pthread.h>) && __has_include(<sched.h>)
+#define AI_SERVER_HAS_PTHREAD_SETSCHEDPARAM 1
+extern "C" {
+#include <sched.h>
+}
+#else
+#define AI_SERVER_HAS_PTHREAD_SETSCHEDPARAM 0
+#endif
+
 namespace ai_server::util {
 
 /// @brief         スレッド名を設定する (可能な場合)
@@ -45,8 +71,54 @@ static inline bool set_thread_name([[maybe_unused]] std::thread& thread,
   return false;
 }
 
+/// @brief         スレッドを実行する CPU を制限する (可能な場合)
+/// @param thread  対象のスレッド
+/// @param cpus    実行してよい CPU の番号 (空なら何もしない)
+/// @return        設定に成功したか
+static inline bool set_thread_affinity([[maybe_unused]] std::thread& thread,
+                                       [[maybe_unused]] const std::vector<unsigned int>& cpus) {
+  if (cpus.empty()) return true;
+
+#if AI_SERVER_HAS_PTHREAD_SETAFFINITY_NP
+  if constexpr (std::is_same_v<std::thread::native_handle_type, ::pthread_t>) {
+    ::cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus) {
+      if (cpu >= CPU_SETSIZE) return false;
+      CPU_SET(cpu, &set);
+    }
+    return ::pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+  }
+#endif
+
+  return false;
+}
+
+/// @brief         スレッドの優先度を設定する (可能な場合)
+///
+/// priority が正なら SCHED_FIFO のリアルタイム優先度として, 0 なら通常のスケジューリングに戻す.
+/// SCHED_FIFO の設定には CAP_SYS_NICE などの権限が必要になる
+/// @param thread  対象のスレッド
+/// @param priority 優先度
+/// @return        設定に成功したか
+static inline bool set_thread_priority([[maybe_unused]] std::thread& thread,
+                                       [[maybe_unused]] int priority) {
+#if AI_SERVER_HAS_PTHREAD_SETSCHEDPARAM
+  if constexpr (std::is_same_v<std::thread::native_handle_type, ::pthread_t>) {
+    ::sched_param param{};
+    param.sched_priority = priority > 0 ? priority : 0;
+    const auto policy    = priority > 0 ? SCHED_FIFO : SCHED_OTHER;
+    return ::pthread_setschedparam(thread.native_handle(), policy, &param) == 0;
+  }
+#endif
+
+  return false;
+}
+
 } // namespace ai_server::util
 
 #undef AI_SERVER_HAS_PTHREAD_SETNAME_NP
+#undef AI_SERVER_HAS_PTHREAD_SETAFFINITY_NP
+#undef AI_SERVER_HAS_PTHREAD_SETSCHEDPARAM
 
 #endif // AI_SERVER_UTIL_THREAD_H
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#if defined(__GLIBC__) && __has_include(<pthread.h>)
+extern "C" {
+#include <pthread.h>
+}
+#endif
+
+#include "trace.h"
+
+namespace ai_server::util::trace {
+
+namespace detail {
+std::atomic<bool> enabled{false};
+} // namespace detail
+
+namespace {
+
+// スレッドごとに保持する区間の数 (2 の冪)
+constexpr std::uint64_t capacity = 1 << 13;
+
+// 1 つの区間
+// 書き出しは記録と並行して行われるので, 各値は atomic に読み書きする (x86 では通常の mov になる)
+struct slot {
+  std::atomic<const char*> name;
+  std::atomic<std::uint64_t> begin;
+  std::atomic<std::uint64_t> end;
+};
+
+// 1 スレッド分の記録
+// 書き込むのは所有するスレッドだけで, head を release で進めて公開する
+struct ring {
+  unsigned int tid;
+  std::string thread_name;
+  std::atomic<std::uint64_t> head{0};
+  // clear() した時点の head (これより前の区間は書き出さない)
+  std::atomic<std::uint64_t> tail{0};
+  std::array<slot, capacity> slots;
+};
+
+// ticks() と steady_clock の対応をとるための基準点
+struct origin_type {
+  std::uint64_t ticks;
+  std::chrono::steady_clock::time_point time;
+};
+
+const origin_type& origin() {
+  static const origin_type o{trace::ticks(), std::chrono::steady_clock::now()};
+  return o;
+}
+
+struct registry_type {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ring>> rings;
+  unsigned int next_tid{1};
+};
+
+registry_type& registry() {
+  static registry_type r{};
+  return r;
+}
+
+std::string current_thread_name(unsigned int tid) {
+#if defined(__GLIBC__) && __has_include(<pthread.h>)
+  std::array<char, 16> buf{};
+  if (::pthread_getname_np(::pthread_self(), buf.data(), buf.size()) == 0 && buf[0] != '\0') {
+    return buf.data();
+  }
+#endif
+  return fmt::format("thread {}", tid);
+}
+
+// 呼び出したスレッドのリングバッファ (なければ作って登録する)
+ring& local_ring() {
+  thread_local const std::shared_ptr<ring> r = [] {
+    origin();
+    auto p = std::make_shared<ring>();
+    auto& g = registry();
+    std::lock_guard lock{g.mutex};
+    p->tid         = g.next_tid++;
+    p->thread_name = current_thread_name(p->tid);
+    g.rings.push_back(p);
+    return p;
+  }();
+  return *r;
+}
+
+// JSON の文字列として書き出す
+void write_string(std::ostream& os, const std::string& s) {
+  os << '"';
+  for (auto c : s) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << fmt::format("\\u{:04x}", static_cast<unsigned int>(c));
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+} // namespace
+
+void set_enabled(bool e) {
+  origin();
+  detail::enabled.store(e, std::memory_order_relaxed);
+}
+
+void record(const char* name, std::uint64_t begin, std::uint64_t end) {
+  auto& r      = local_ring();
+  const auto h = r.head.load(std::memory_order_relaxed);
+  auto& s      = r.slots[h & (capacity - 1)];
+  s.name.store(name, std::memory_order_relaxed);
+  s.begin.store(begin, std::memory_order_relaxed);
+  s.end.store(end, std::memory_order_relaxed);
+  r.head.store(h + 1, std::memory_order_release);
+}
+
+void clear() {
+  auto& g = registry();
+  std::lock_guard lock{g.mutex};
+  for (auto& r : g.rings) r->tail.store(r->head.load(std::memory_order_acquire));
+}
+
+void write_chrome_trace(std::ostream& os) {
+  // ticks() を µs に直す係数を求める
+  // 起動直後は区間が短く誤差が大きいので, 少なくとも 10ms 空ける
+  const auto& o = origin();
+  if (std::chrono::steady_clock::now() - o.time < std::chrono::milliseconds{10}) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
+  const auto now_ticks = trace::ticks();
+  const auto now_time  = std::chrono::steady_clock::now();
+  const auto us_per_tick =
+      std::chrono::duration<double, std::micro>(now_time - o.time).count() /
+      static_cast<double>(std::max<std::uint64_t>(now_ticks - o.ticks, 1));
+  const auto to_us = [&](std::uint64_t t) {
+    return static_cast<double>(static_cast<std::int64_t>(t - o.ticks)) * us_per_tick;
+  };
+
+  std::vector<std::shared_ptr<ring>> rings{};
+  {
+    auto& g = registry();
+    std::lock_guard lock{g.mutex};
+    rings = g.rings;
+  }
+
+  struct event {
+    const char* name;
+    std::uint64_t begin;
+    std::uint64_t end;
+  };
+  std::vector<event> events{};
+
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  const auto separator = [&os, &first] {
+    if (!first) os << ',';
+    first = false;
+  };
+
+  for (const auto& r : rings) {
+    separator();
+    os << fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":)",
+                      r->tid);
+    write_string(os, r->thread_name);
+    os << "}}";
+
+    // 記録中のスレッドに上書きされていない範囲だけを読む
+    const auto h1    = r->head.load(std::memory_order_acquire);
+    const auto tail  = r->tail.load(std::memory_order_relaxed);
+    const auto start = std::max(tail, h1 > capacity ? h1 - capacity : 0);
+    events.clear();
+    for (auto i = start; i < h1; ++i) {
+      const auto& s = r->slots[i & (capacity - 1)];
+      events.push_back({s.name.load(std::memory_order_relaxed),
+                        s.begin.load(std::memory_order_relaxed),
+                        s.end.load(std::memory_order_relaxed)});
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // 読んでいる間に head が h2 まで進んでいたら, h2 - capacity 以前の区間は壊れているかもしれない
+    // (h2 の区間を書き込み中の可能性もあるので, h2 - capacity の区間も除く)
+    const auto h2    = r->head.load(std::memory_order_relaxed);
+    const auto valid = h2 >= capacity ? h2 - capacity + 1 : 0;
+
+    for (auto i = start; i < h1; ++i) {
+      if (i < valid) continue;
+      const auto& e = events[i - start];
+      separator();
+      os << R"({"name":)";
+      write_string(os, e.name);
+      os << fmt::format(R"(,"cat":"ai_server","ph":"X","pid":1,"tid":{},"ts":{:.3f},)", r->tid,
+                        to_us(e.begin))
+         << fmt::format(R"("dur":{:.3f}}})", to_us(e.end) - to_us(e.begin));
+    }
+  }
+
+  os << "]}";
+}
+
+} // namespace ai_server::util::trace
@@ -0,0 +1,93 @@
+#ifndef AI_SERVER_UTIL_TRACE_H
+#define AI_SERVER_UTIL_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace ai_server::util::trace {
+
+/// @brief              計測に使うカウンタの値 (x86 では TSC, それ以外では steady_clock の ns)
+inline std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+namespace detail {
+extern std::atomic<bool> enabled;
+} // namespace detail
+
+/// @brief              記録が有効か
+inline bool enabled() {
+  return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/// @brief              記録を有効/無効にする (デフォルトは無効)
+void set_enabled(bool enabled);
+
+/// @brief              呼び出したスレッドのリングバッファに区間を記録する
+/// @param name         区間の名前. 書き出すまで有効な文字列 (文字列リテラルなど) であること
+/// @param begin        区間の開始時の ticks()
+/// @param end          区間の終了時の ticks()
+///
+/// リングバッファはスレッドごとに最初の呼び出しで確保し, 古いものから上書きする.
+/// 書き込みはロックも動的確保もしない
+void record(const char* name, std::uint64_t begin, std::uint64_t end);
+
+/// @brief              記録した区間を Chrome の trace event 形式の JSON で書き出す
+///
+/// chrome://tracing や Perfetto UI で読み込める. 記録中に呼び出してもよいが,
+/// 書き出している間に上書きされた区間は含まれない
+void write_chrome_trace(std::ostream& os);
+
+/// @brief              これまでに記録した区間を破棄する (以降の write_chrome_trace() に含めない)
+void clear();
+
+/// @class  scope
+/// @brief  生存している間を 1 つの区間として記録する
+///
+/// 記録が無効なときはフラグを 1 回読むだけ
+class scope {
+public:
+  explicit scope(const char* name) : name_{enabled() ? name : nullptr}, begin_{0} {
+    if (name_) begin_ = ticks();
+  }
+
+  ~scope() {
+    if (name_) record(name_, begin_, ticks());
+  }
+
+  scope(const scope&) = delete;
+  scope& operator=(const scope&) = delete;
+
+private:
+  const char* name_;
+  std::uint64_t begin_;
+};
+
+} // namespace ai_server::util::trace
+
+#define AI_SERVER_TRACE_CONCAT_IMPL(a, b) a##b
+#define AI_SERVER_TRACE_CONCAT(a, b) AI_SERVER_TRACE_CONCAT_IMPL(a, b)
+
+/// スコープの終わりまでを name という区間として記録する
+/// AI_SERVER_DISABLE_TRACE を定義してビルドすると何もしない
+#ifdef AI_SERVER_DISABLE_TRACE
+#define AI_SERVER_TRACE_SCOPE(name) static_cast<void>(0)
+#else
+#define AI_SERVER_TRACE_SCOPE(name)    \
+  const ::ai_server::util::trace::scope \
+      AI_SERVER_TRACE_CONCAT(ai_server_trace_scope_, __LINE__) { name }
+#endif
+
+#endif // AI_SERVER_UTIL_TRACE_H
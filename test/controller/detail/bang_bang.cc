@@ -0,0 +1,112 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <cmath>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/controller/detail/bang_bang.h"
+
+namespace detail = ai_server::controller::detail;
+
+BOOST_AUTO_TEST_SUITE(bang_bang)
+
+BOOST_AUTO_TEST_CASE(trapezoid, *boost::unit_test::tolerance(1e-6)) {
+  detail::bang_bang_1d b{};
+  b.generate(0, 0, 10000, 3000, 5000);
+
+  // 0.6s で 900mm 加速し, 等速で進んでから 0.6s で 900mm 減速する
+  BOOST_TEST(b.total_time() == 0.6 + 8200.0 / 3000 + 0.6);
+  BOOST_TEST(b.acceleration(0.1) == 5000);
+  BOOST_TEST(b.velocity(0.3) == 1500);
+  BOOST_TEST(b.position(0.6) == 900);
+  BOOST_TEST(b.velocity(1.0) == 3000);
+  BOOST_TEST(b.acceleration(1.0) == 0);
+  BOOST_TEST(b.acceleration(b.total_time() - 0.1) == -5000);
+  BOOST_TEST(b.position(b.total_time()) == 10000);
+  BOOST_TEST(b.velocity(b.total_time()) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(triangle, *boost::unit_test::tolerance(1e-6)) {
+  detail::bang_bang_1d b{};
+  b.generate(0, 0, -1000, 3000, 5000);
+
+  // 最大速度に達する前に減速を始める
+  const auto v_peak = std::sqrt(5000.0 * 1000);
+  BOOST_TEST(b.total_time() == 2 * v_peak / 5000);
+  BOOST_TEST(b.velocity(b.total_time() / 2) == -v_peak);
+  BOOST_TEST(b.position(b.total_time() / 2) == -500);
+  BOOST_TEST(b.position(b.total_time()) == -1000);
+}
+
+BOOST_AUTO_TEST_CASE(overshoot, *boost::unit_test::tolerance(1e-6)) {
+  // 減速しても行き過ぎる場合は, 停止してから戻る
+  {
+    detail::bang_bang_1d b{};
+    b.generate(0, 3000, 100, 3000, 5000);
+    BOOST_TEST(b.position(0.6) == 900);
+    BOOST_TEST(b.velocity(0.6) == 0);
+    BOOST_TEST(b.total_time() == 0.6 + 2 * std::sqrt(5000.0 * 800) / 5000);
+    BOOST_TEST(b.position(b.total_time()) == 100);
+  }
+
+  // 目標から遠ざかっている場合も同様
+  {
+    detail::bang_bang_1d b{};
+    b.generate(0, -1000, 1000, 3000, 5000);
+    BOOST_TEST(b.position(0.2) == -100);
+    BOOST_TEST(b.total_time() == 0.2 + 2 * std::sqrt(5000.0 * 1100) / 5000);
+    BOOST_TEST(b.position(b.total_time()) == 1000);
+  }
+
+  // 最大速度を超えていれば最大速度まで減速する
+  {
+    detail::bang_bang_1d b{};
+    b.generate(0, 4000, 100000, 3000, 5000);
+    BOOST_TEST(b.acceleration(0.1) == -5000);
+    BOOST_TEST(b.velocity(0.2) == 3000);
+    BOOST_TEST(b.acceleration(0.3) == 0);
+    BOOST_TEST(b.position(b.total_time()) == 100000);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(stay, *boost::unit_test::tolerance(1e-6)) {
+  detail::bang_bang_1d b{};
+  b.generate(100, 0, 100, 3000, 5000);
+
+  BOOST_TEST(b.total_time() == 0);
+  BOOST_TEST(b.position(0) == 100);
+  BOOST_TEST(b.velocity(0) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(synchronized, *boost::unit_test::tolerance(1e-6)) {
+  detail::bang_bang_2d b{};
+  const Eigen::Vector2d p0{0, 0};
+  const Eigen::Vector2d v0{0, 1000};
+  const Eigen::Vector2d p1{3000, -500};
+  b.generate(p0, v0, p1, 3000, 5000);
+
+  BOOST_TEST(b.total_time() > 0);
+  BOOST_TEST(b.position(b.total_time()).x() == p1.x());
+  BOOST_TEST(b.position(b.total_time()).y() == p1.y());
+  BOOST_TEST(b.position(0).x() == p0.x());
+  BOOST_TEST(b.velocity(0).y() == v0.y());
+
+  // 速度と加速度の大きさは制限を超えない
+  bool within_limits = true;
+  for (double t = 0; t < b.total_time(); t += 0.01) {
+    within_limits &= b.velocity(t).norm() <= 3000 + 1e-6;
+    within_limits &= b.acceleration(t).norm() <= 5000 + 1e-6;
+  }
+  BOOST_TEST(within_limits);
+}
+
+BOOST_AUTO_TEST_CASE(one_axis, *boost::unit_test::tolerance(1e-3)) {
+  detail::bang_bang_2d b{};
+  b.generate({0, 0}, {0, 0}, {10000, 0}, 3000, 5000);
+
+  // 片方の軸しか動かない場合は, もう一方の軸に制限が配分されない
+  BOOST_TEST(b.total_time() == 0.6 + 8200.0 / 3000 + 0.6);
+  BOOST_TEST(b.position(b.total_time()).y() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+#include <cmath>
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/controller/detail/delay_estimator.h"
+#include "ai_server/model/command_history.h"
+
+using namespace std::chrono_literals;
+namespace detail = ai_server::controller::detail;
+using history_type = ai_server::model::command_history;
+
+BOOST_AUTO_TEST_SUITE(delay_estimator)
+
+// 周期 cycle で指令を送信し, delay 遅れた指令の値が観測されたとして推定器を回す
+template <class F>
+std::optional<double> run(detail::delay_estimator& e, history_type& h, F&& velocity,
+                          std::chrono::system_clock::duration delay, std::size_t n) {
+  constexpr auto cycle = std::chrono::microseconds{16667};
+  const auto t0        = history_type::clock_type::now();
+
+  std::optional<double> result{};
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto t        = t0 + i * cycle;
+    const auto observed = h.at(t - delay);
+    e.observe(t, observed ? observed->vx : 0.0, observed ? observed->vy : 0.0);
+    if (auto r = e.update(h)) result = r;
+
+    const auto [vx, vy] = velocity(i);
+    h.push(t, vx, vy, 0.0);
+  }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(estimate) {
+  detail::delay_estimator e{0.05};
+  history_type h{};
+
+  BOOST_TEST(!e.has_estimate());
+  BOOST_TEST(e.delay() == 0.05);
+
+  // 速度を変化させ続ける
+  const auto r = run(
+      e, h,
+      [](std::size_t i) {
+        const auto t = i / 60.0;
+        return std::make_pair(1000 * std::sin(7 * t), 800 * std::cos(11 * t));
+      },
+      80ms, 600);
+
+  BOOST_TEST(r.has_value());
+  BOOST_TEST(e.has_estimate());
+  // 指令は 1 周期ごとにしか変化しないので, 推定値の分解能は 1 周期程度になる
+  BOOST_TEST(std::abs(e.delay() - 0.08) < 1.0 / 60);
+  BOOST_TEST(e.correlation() > 0.9);
+
+  // 推定値が初期値から大きく変化したのでドリフトとして報告される
+  const auto d = e.take_drift();
+  BOOST_TEST(d.has_value());
+  BOOST_TEST(d->first == 0.05);
+  BOOST_TEST(d->second == e.delay());
+  // 一度報告したら変化するまで報告されない
+  BOOST_TEST(!e.take_drift().has_value());
+}
+
+BOOST_AUTO_TEST_CASE(no_excitation) {
+  detail::delay_estimator e{0.05};
+  history_type h{};
+
+  // 指令速度が一定なら遅延時間は推定できない
+  const auto r = run(
+      e, h, [](std::size_t) { return std::make_pair(500.0, 0.0); }, 80ms, 600);
+
+  BOOST_TEST(!r.has_value());
+  BOOST_TEST(!e.has_estimate());
+  BOOST_TEST(e.delay() == 0.05);
+  BOOST_TEST(!e.take_drift().has_value());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
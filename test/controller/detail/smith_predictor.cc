@@ -0,0 +1,94 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+#include <memory>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/controller/detail/smith_predictor.h"
+#include "ai_server/model/command_history.h"
+#include "ai_server/model/robot.h"
+
+using namespace std::chrono_literals;
+
+namespace detail = ai_server::controller::detail;
+namespace model  = ai_server::model;
+
+BOOST_AUTO_TEST_SUITE(smith_predictor)
+
+BOOST_AUTO_TEST_CASE(with_history, *boost::unit_test::tolerance(1e-6)) {
+  detail::smith_predictor sp{1.0 / 60, 0.05};
+  auto history = std::make_shared<model::command_history>();
+  sp.set_command_history(history);
+
+  const auto now = model::command_history::clock_type::now();
+
+  // 遅延時間 (50ms) より前から有効な指令と, 30ms 前に送信された指令
+  history->push(now - 100ms, 1000, 0, 0);
+  history->push(now - 30ms, 0, 500, 2);
+
+  const model::robot robot{100, 200, 0};
+  const Eigen::Vector3d u{0, 500, 2};
+  const auto m = sp.interpolate(robot, u, now);
+
+  // [now - 50ms, now - 30ms] は 1 つめ, [now - 30ms, now] は 2 つめの指令で動いたとする
+  BOOST_TEST(m(0, 0) == 100 + 1000 * 0.02);
+  BOOST_TEST(m(1, 0) == 200 + 500 * 0.03);
+  BOOST_TEST(m(2, 0) == 2 * 0.03);
+
+  // 加速度は最新の指令とその 1 つ前の指令との差
+  const Eigen::Vector3d corrected_u = m.col(1);
+  BOOST_TEST(m(0, 2) == corrected_u.x() - 1000);
+  BOOST_TEST(m(1, 2) == corrected_u.y() - 0);
+}
+
+BOOST_AUTO_TEST_CASE(uncovered_window, *boost::unit_test::tolerance(1e-6)) {
+  detail::smith_predictor sp{1.0 / 60, 0.05};
+  auto history = std::make_shared<model::command_history>();
+  sp.set_command_history(history);
+
+  const auto now = model::command_history::clock_type::now();
+
+  // 履歴がなければ補間しない
+  {
+    const auto m = sp.interpolate(model::robot{100, 200, 0}, Eigen::Vector3d::Zero(), now);
+    BOOST_TEST(m(0, 0) == 100);
+    BOOST_TEST(m(1, 0) == 200);
+  }
+
+  // 履歴がない区間は停止していたとみなす
+  history->push(now - 10ms, 1000, 0, 0);
+  {
+    const auto m = sp.interpolate(model::robot{100, 200, 0}, Eigen::Vector3d::Zero(), now);
+    BOOST_TEST(m(0, 0) == 100 + 1000 * 0.01);
+    BOOST_TEST(m(1, 0) == 200);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(set_delay, *boost::unit_test::tolerance(1e-6)) {
+  // 遅延時間が周期の整数倍になるように, 2 進数で正確に表せる値を使う
+  constexpr double cycle = 1.0 / 64;
+  detail::smith_predictor sp{cycle, 4 * cycle};
+  BOOST_TEST(sp.delay() == 4 * cycle);
+
+  // 一定の入力を与え続けると, 遅延時間分だけ進んだ位置が推定される
+  const auto run = [&sp] {
+    const Eigen::Vector3d u{1000, 0, 0};
+    Eigen::Matrix3d m{};
+    for (int i = 0; i < 20; ++i) m = sp.interpolate(model::robot{0, 0, 0}, u);
+    return m(0, 0);
+  };
+  BOOST_TEST(run() == 1000 * 4 * cycle);
+
+  // 遅延時間を伸ばすと保持する入力が増える
+  sp.set_delay(8 * cycle);
+  BOOST_TEST(sp.delay() == 8 * cycle);
+  BOOST_TEST(run() == 1000 * 8 * cycle);
+
+  // 縮めると減る
+  sp.set_delay(2 * cycle);
+  BOOST_TEST(sp.delay() == 2 * cycle);
+  BOOST_TEST(run() == 1000 * 2 * cycle);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,214 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <new>
+#include <boost/math/constants/constants.hpp>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include "ai_server/controller/state_feedback.h"
+#include "ai_server/controller/trajectory.h"
+#include "ai_server/model/command_history.h"
+#include "ai_server/model/field.h"
+#include "ai_server/model/robot.h"
+#include "ai_server/util/math/angle.h"
+
+// update() の中で動的なメモリ確保が行われないことを確かめるために, 確保の回数を数える
+static std::size_t allocation_count = 0;
+
+void* operator new(std::size_t size) {
+  ++allocation_count;
+  if (auto p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace controller = ai_server::controller;
+namespace model      = ai_server::model;
+namespace setpoint   = ai_server::model::setpoint;
+
+using boost::math::double_constants::half_pi;
+
+BOOST_AUTO_TEST_SUITE(trajectory)
+
+// 制御周期
+constexpr double cycle = 1.0 / 60;
+
+// 指令が 3 周期遅れて反映され, 指令した速度で動くロボットを Controller で目標まで動かす
+struct plant {
+  model::robot robot;
+  std::deque<Eigen::Vector3d> commands;
+  // フィールド基準の指令値の最大の変化量 [mm/s]
+  double max_dv;
+  // フィールド基準の指令値の最大の大きさ [mm/s]
+  double max_v;
+
+  plant() : robot{0, 0, 0}, commands(3, Eigen::Vector3d::Zero()), max_dv(0), max_v(0) {}
+
+  // 1 周期進め, 目標に到達していれば true を返す
+  template <class Position, class Angle>
+  bool step(controller::base& c, const Position& position, const Angle& angle) {
+    const auto [vx, vy, omega] = c.update(robot, model::field{}, position, angle);
+
+    // ロボット基準の速度をフィールド基準にもどす
+    const Eigen::Vector3d u =
+        Eigen::AngleAxisd(robot.theta(), Eigen::Vector3d::UnitZ()) * Eigen::Vector3d{vx, vy, omega};
+    max_dv = std::max(max_dv, (u - commands.back()).head<2>().norm());
+    max_v  = std::max(max_v, u.head<2>().norm());
+    commands.push_back(u);
+
+    const auto& v = commands.front();
+    robot.set_x(robot.x() + cycle * v.x());
+    robot.set_y(robot.y() + cycle * v.y());
+    robot.set_theta(ai_server::util::math::wrap_to_pi(robot.theta() + cycle * v.z()));
+    commands.pop_front();
+
+    const auto distance =
+        std::hypot(robot.x() - std::get<0>(position), robot.y() - std::get<1>(position));
+    return distance < 10.0 && commands.back().head<2>().norm() < 50.0;
+  }
+
+  // 目標に到達するまでの時間 [s] (max_time 以内に到達しなければ max_time)
+  template <class Position, class Angle>
+  double run(controller::base& c, const Position& position, const Angle& angle,
+             double max_time) {
+    for (int i = 1; i * cycle < max_time; ++i) {
+      if (step(c, position, angle)) return i * cycle;
+    }
+    return max_time;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(move_to_position) {
+  controller::trajectory c{cycle};
+  plant p{};
+
+  const setpoint::position target{2000, 1000, {}};
+  const setpoint::angle angle{half_pi, {}};
+  const auto t = p.run(c, target, angle, 5.0);
+
+  BOOST_TEST(t < 3.0);
+  BOOST_TEST(std::abs(p.robot.x() - 2000) < 10.0);
+  BOOST_TEST(std::abs(p.robot.y() - 1000) < 10.0);
+  BOOST_TEST(std::abs(p.robot.theta() - half_pi) < 0.05);
+
+  // 速度の制限を守る
+  // (加速度は回転中のロボット基準とフィールド基準の変換の差が乗るので, replay_comparison で確かめる)
+  BOOST_TEST(p.max_v <= 3000 + 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(velocity_limit) {
+  controller::trajectory c{cycle};
+  c.set_velocity_limit(1000);
+  plant p{};
+
+  const setpoint::position target{2000, -1400, {}};
+  p.run(c, target, setpoint::angle{0, {}}, 10.0);
+
+  BOOST_TEST(std::abs(p.robot.x() - 2000) < 10.0);
+  BOOST_TEST(std::abs(p.robot.y() + 1400) < 10.0);
+  // x, y への制限の配分は周期ごとに変わるので, わずかに超えることがある
+  BOOST_TEST(p.max_v <= 1000 * (1 + 1e-4));
+}
+
+BOOST_AUTO_TEST_CASE(velocity_setpoint, *boost::unit_test::tolerance(1e-6)) {
+  controller::trajectory c{cycle};
+  plant p{};
+
+  // 加速度の制限のもとで目標速度に近づく
+  const setpoint::velocity target{1000, 0, {}};
+  const setpoint::velangular omega{0, {}};
+  p.step(c, target, omega);
+  BOOST_TEST(p.commands.back().x() == 5000 * cycle);
+
+  for (int i = 0; i < 60; ++i) p.step(c, target, omega);
+  BOOST_TEST(p.commands.back().x() == 1000);
+  BOOST_TEST(p.commands.back().y() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(field_boundary) {
+  // フィールドの外に向かう指令を与えても, 外枠から 400 mm ほどのところで止まる
+  const model::field field{};
+  const auto check = [&field](const auto& position, const auto& angle) {
+    controller::trajectory c{cycle};
+    plant p{};
+    p.run(c, position, angle, 5.0);
+    BOOST_TEST_MESSAGE("stopped at x = " << p.robot.x() << " (x_max = " << field.x_max()
+                                         << ")");
+    BOOST_TEST(p.robot.x() > field.x_max());
+    // 指令が反映されるまでの遅れの分だけ, わずかに超えることがある
+    BOOST_TEST(p.robot.x() < field.x_max() + 400.0 + 50.0);
+    BOOST_TEST(p.commands.back().head<2>().norm() < 100.0 + 1e-6);
+  };
+  check(setpoint::velocity{3000, 0, {}}, setpoint::velangular{0, {}});
+  check(setpoint::position{field.x_max() + 3000, 0, {}}, setpoint::angle{0, {}});
+}
+
+BOOST_AUTO_TEST_CASE(allocation_free) {
+  controller::trajectory c{cycle};
+  c.set_command_history(std::make_shared<model::command_history>());
+  const model::robot robot{100, 200, 0.5};
+  const model::field field{};
+
+  const auto before = allocation_count;
+  for (int i = 0; i < 100; ++i) {
+    c.update(robot, field, setpoint::position{2000, 1000, {}}, setpoint::angle{1.0, {}});
+    c.update(robot, field, setpoint::velocity{500, 0, {}}, setpoint::velangular{1.0, {}});
+  }
+  BOOST_TEST(allocation_count == before);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark) {
+  controller::trajectory c{cycle};
+  c.set_command_history(std::make_shared<model::command_history>());
+  const model::field field{};
+
+  constexpr int n = 10000;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; ++i) {
+    const model::robot robot{0.1 * i, -0.2 * i, 0.001 * i};
+    c.update(robot, field, setpoint::position{2000, 1000, {}}, setpoint::angle{1.0, {}});
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const auto mean    = std::chrono::duration<double, std::micro>(elapsed).count() / n;
+  // 実行時間は環境に依存するので, 判定はせずに表示だけする
+  BOOST_TEST_MESSAGE("trajectory::update: " << mean << " us");
+}
+
+BOOST_AUTO_TEST_CASE(replay_comparison) {
+  // 同じ目標の列を state_feedback と trajectory に与え, 到達までの時間を比べる
+  const setpoint::position targets[] = {
+      {2000, 1000, {}}, {-1500, 1000, {}}, {-1500, -1400, {}}, {300, 200, {}}};
+  const setpoint::angle angle{0, {}};
+
+  controller::state_feedback sf{cycle};
+  controller::trajectory tr{cycle};
+  plant p_sf{}, p_tr{};
+  double t_sf = 0, t_tr = 0;
+  for (const auto& target : targets) {
+    t_sf += p_sf.run(sf, target, angle, 10.0);
+    t_tr += p_tr.run(tr, target, angle, 10.0);
+  }
+  BOOST_TEST_MESSAGE("state_feedback: " << t_sf << " s, max dv/dt " << p_sf.max_dv / cycle
+                                        << " mm/s^2");
+  BOOST_TEST_MESSAGE("trajectory:     " << t_tr << " s, max dv/dt " << p_tr.max_dv / cycle
+                                        << " mm/s^2");
+
+  // 加速度の制限を守ったうえで, state_feedback より早く全ての目標に到達する
+  BOOST_TEST(t_tr < t_sf);
+  BOOST_TEST(p_tr.max_dv <= 5000 * cycle + 1e-6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
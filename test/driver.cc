@@ -1,8 +1,14 @@
 #define BOOST_TEST_DYN_LINK
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <functional>
 #include <memory>
+#include <random>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 #include <boost/asio.hpp>
 #include <boost/math/constants/constants.hpp>
@@ -10,6 +16,7 @@
 
 #include "ai_server/controller/base.h"
 #include "ai_server/driver.h"
+#include "ai_server/filter/va_calculator.h"
 #include "ai_server/model/team_color.h"
 #include "ai_server/model/updater/world.h"
 #include "ai_server/radio/base/base.h"
@@ -86,6 +93,17 @@ struct mock_controller : public controller::base {
     return stable_flag_;
   }
 
+  void set_command_history(std::shared_ptr<const model::command_history> history) override {
+    history_ = std::move(history);
+  }
+
+  void set_delay(double delay) override {
+    delays_.push_back(delay);
+  }
+
+  std::shared_ptr<const model::command_history> history_;
+  std::vector<double> delays_;
+
   bool executed_ = false;
 
   model::field field_;
@@ -556,4 +574,391 @@ BOOST_AUTO_TEST_CASE(main_loop3, *boost::unit_test::tolerance(0.0000001)) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(command_history) {
+  boost::asio::io_context ctx{};
+  ai_server::model::updater::world wu{};
+  ai_server::driver d{ctx, 100us, wu, model::team_color::blue};
+
+  // 登録されていないロボットの履歴は取得できない
+  BOOST_CHECK_THROW(d.command_history(1), std::runtime_error);
+
+  auto c1_ptr = std::make_unique<mock_controller>();
+  auto& c1    = *c1_ptr;
+  d.register_robot(1, std::move(c1_ptr), std::make_unique<mock_radio>());
+
+  // 登録時に Controller にも同じ履歴が設定される
+  const auto history = d.command_history(1);
+  BOOST_TEST(history == c1.history_);
+  BOOST_TEST(history->size() == 0);
+
+  command_updated_handler handler{};
+  d.on_command_updated(std::ref(handler));
+
+  {
+    ssl_protos::vision::Packet p{};
+    auto md = p.mutable_detection();
+    md->set_camera_id(0);
+
+    auto r = md->add_robots_blue();
+    r->set_robot_id(1);
+    r->set_x(0);
+    r->set_y(0);
+    r->set_orientation(0);
+    r->set_confidence(100);
+
+    wu.update(p);
+  }
+
+  const auto before = std::chrono::system_clock::now();
+  ctx.run_one();
+  const auto after = std::chrono::system_clock::now();
+  {
+    // 送信した指令が送信時刻とともに記録されている
+    BOOST_TEST(history->size() == 1);
+    const auto e = history->latest();
+    BOOST_REQUIRE(e);
+    BOOST_TEST((before <= e->time && e->time <= after));
+
+    BOOST_TEST(handler.commands.size() == 1);
+    const auto& [id, vx, vy, omega, motion] = handler.commands.back();
+    BOOST_TEST(e->vx == vx);
+    BOOST_TEST(e->vy == vy);
+    BOOST_TEST(e->omega == omega);
+  }
+
+  // 登録を解除しても取得済みの履歴は有効
+  d.unregister_robot(1);
+  BOOST_TEST(history->size() == 1);
+  BOOST_CHECK_THROW(d.command_history(1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(parallel) {
+  boost::asio::io_context ctx{};
+  ai_server::model::updater::world wu{};
+  // Controller の計算を 4 スレッドで行う
+  ai_server::driver d{ctx, 100us, wu, model::team_color::blue, 4};
+
+  constexpr unsigned int n = 11;
+  std::vector<mock_controller*> controllers{};
+  auto radio = std::make_shared<mock_radio>();
+  for (unsigned int id = 0; id < n; ++id) {
+    auto c = std::make_unique<mock_controller>();
+    controllers.push_back(c.get());
+    d.register_robot(id, std::move(c), radio);
+  }
+
+  command_updated_handler handler{};
+  d.on_command_updated(std::ref(handler));
+
+  {
+    ssl_protos::vision::Packet p{};
+    auto md = p.mutable_detection();
+    md->set_camera_id(0);
+
+    for (unsigned int id = 0; id < n; ++id) {
+      auto r = md->add_robots_blue();
+      r->set_robot_id(id);
+      r->set_x(0);
+      r->set_y(0);
+      r->set_orientation(0);
+      r->set_confidence(100);
+    }
+
+    wu.update(p);
+  }
+
+  ctx.run_one();
+
+  // 全てのロボットの Controller が呼ばれ, 命令が 1 つずつ送信される
+  for (auto c : controllers) BOOST_TEST(c->executed_);
+  BOOST_TEST(radio->commands_.size() == n);
+  BOOST_TEST(handler.commands.size() == n);
+  for (unsigned int id = 0; id < n; ++id) {
+    const auto count = std::count_if(radio->commands_.cbegin(), radio->commands_.cend(),
+                                     [id](auto&& c) { return std::get<0>(c) == id; });
+    BOOST_TEST(count == 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(batched_send) {
+  boost::asio::io_context ctx{};
+  ai_server::model::updater::world wu{};
+  ai_server::driver d{ctx, 1ms, wu, model::team_color::blue};
+
+  // begin_cycle(), stage(), flush() の呼び出しを記録する Radio
+  struct batching_radio : public mock_radio {
+    std::vector<std::string> calls_;
+
+    void begin_cycle(model::team_color) override {
+      calls_.emplace_back("begin");
+    }
+    void stage(model::team_color color, unsigned int id, const model::command::kick_flag_t& kf,
+               int dribble, double vx, double vy, double omega) override {
+      calls_.emplace_back("stage " + std::to_string(id));
+      send(color, id, kf, dribble, vx, vy, omega);
+    }
+    void stage(model::team_color color, unsigned int id,
+               std::shared_ptr<model::motion::base> motion) override {
+      calls_.emplace_back("stage " + std::to_string(id));
+      send(color, id, std::move(motion));
+    }
+    void flush() override {
+      calls_.emplace_back("flush");
+    }
+  };
+
+  // ID 0, 1, 2 は同じ Radio を, ID 3 は別の Radio を使う
+  auto r1 = std::make_shared<batching_radio>();
+  auto r2 = std::make_shared<batching_radio>();
+  for (unsigned int id = 0; id < 3; ++id) {
+    d.register_robot(id, std::make_unique<mock_controller>(), r1);
+  }
+  d.register_robot(3, std::make_unique<mock_controller>(), r2);
+
+  command_updated_handler handler{};
+  d.on_command_updated(std::ref(handler));
+
+  {
+    ssl_protos::vision::Packet p{};
+    auto md = p.mutable_detection();
+    md->set_camera_id(0);
+
+    for (unsigned int id = 0; id < 4; ++id) {
+      auto r = md->add_robots_blue();
+      r->set_robot_id(id);
+      r->set_x(0);
+      r->set_y(0);
+      r->set_orientation(0);
+      r->set_confidence(100);
+    }
+
+    wu.update(p);
+  }
+
+  ctx.run_one();
+
+  // Radio ごとに, サイクルの始めに 1 回 begin_cycle() を, 最後に 1 回 flush() を呼ぶ
+  // (stage() を呼ぶロボットの順序は決まっていないので並べ替えて比べる)
+  BOOST_REQUIRE(r1->calls_.size() == 5);
+  std::sort(r1->calls_.begin() + 1, r1->calls_.end() - 1);
+  const std::vector<std::string> c1{"begin", "stage 0", "stage 1", "stage 2", "flush"};
+  const std::vector<std::string> c2{"begin", "stage 3", "flush"};
+  BOOST_TEST(r1->calls_ == c1, boost::test_tools::per_element());
+  BOOST_TEST(r2->calls_ == c2, boost::test_tools::per_element());
+  BOOST_TEST(handler.commands.size() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(stats) {
+  boost::asio::io_context ctx{};
+  ai_server::model::updater::world wu{};
+  ai_server::driver d{ctx, 1ms, wu, model::team_color::blue};
+
+  d.register_robot(1, std::make_unique<mock_controller>(), std::make_unique<mock_radio>());
+
+  {
+    const auto s = d.stats();
+    BOOST_TEST(s.cycles == 0);
+    BOOST_TEST(s.overruns == 0);
+  }
+
+  ctx.run_one();
+  {
+    const auto s = d.stats();
+    BOOST_TEST(s.cycles == 1);
+    // 最初のサイクルは開始予定時刻がないので遅れは 0
+    BOOST_TEST(s.lateness.count() == 0);
+    BOOST_TEST(s.compute_time.count() >= 0);
+    BOOST_TEST(s.send_time.count() >= 0);
+  }
+
+  // 次のサイクルの開始を遅らせると遅れとして記録され, 周期を超えれば overrun となる
+  std::this_thread::sleep_for(5ms);
+  ctx.run_one();
+  {
+    const auto s = d.stats();
+    BOOST_TEST(s.cycles == 2);
+    BOOST_TEST(s.overruns == 1);
+    BOOST_TEST((s.lateness >= 4ms));
+    BOOST_TEST((s.max_lateness == s.lateness));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(stale_output) {
+  boost::asio::io_context ctx{};
+  ai_server::model::updater::world wu{};
+  ai_server::driver d{ctx, 100us, wu, model::team_color::blue};
+
+  // Controller の計算中 (mutex_ の外) に呼ばれる処理を差し込めるようにする
+  struct hooked_controller : public mock_controller {
+    std::function<void()> hook;
+
+    controller::base::result_type update(const model::robot& r, const model::field& f,
+                                         const model::setpoint::velocity& v,
+                                         const model::setpoint::velangular& va) override {
+      if (hook) hook();
+      return mock_controller::update(r, f, v, va);
+    }
+  };
+
+  auto c_ptr = std::make_unique<hooked_controller>();
+  auto& c    = *c_ptr;
+  auto radio = std::make_shared<mock_radio>();
+  d.register_robot(1, std::move(c_ptr), radio);
+
+  command_updated_handler handler{};
+  d.on_command_updated(std::ref(handler));
+
+  {
+    ssl_protos::vision::Packet p{};
+    auto md = p.mutable_detection();
+    md->set_camera_id(0);
+
+    auto r = md->add_robots_blue();
+    r->set_robot_id(1);
+    r->set_x(0);
+    r->set_y(0);
+    r->set_orientation(0);
+    r->set_confidence(100);
+
+    wu.update(p);
+  }
+
+  // 計算中にチームカラーが変わったら, 古いチームカラーで計算した命令は送信されない
+  c.hook = [&d] { d.set_team_color(model::team_color::yellow); };
+  ctx.run_one();
+  BOOST_TEST(c.executed_);
+  BOOST_TEST(radio->commands_.empty());
+  BOOST_TEST(handler.commands.empty());
+
+  // 計算中に登録が解除されたロボットには送信されない
+  d.set_team_color(model::team_color::blue);
+  c.executed_ = false;
+  c.hook      = [&d] { d.unregister_robot(1); };
+  ctx.run_one();
+  BOOST_TEST(c.executed_);
+  BOOST_TEST(radio->commands_.empty());
+  BOOST_TEST(handler.commands.empty());
+}
+
+BOOST_AUTO_TEST_CASE(estimated_delay) {
+  boost::asio::io_context ctx{};
+  ai_server::model::updater::world wu{};
+  wu.robots_blue_updater().set_default_filter<ai_server::filter::va_calculator<model::robot>>();
+  ai_server::driver d{ctx, 5ms, wu, model::team_color::blue};
+
+  BOOST_CHECK_THROW(d.estimated_delay(1), std::runtime_error);
+
+  auto c_ptr = std::make_unique<mock_controller>();
+  auto& c    = *c_ptr;
+  d.register_robot(1, std::move(c_ptr), std::make_unique<mock_radio>());
+  const auto history = d.command_history(1);
+
+  // 推定値が得られるまでは値を持たない
+  BOOST_TEST(!d.estimated_delay(1).has_value());
+
+  // 送信した指令が 30ms 遅れて反映されるロボットを, Driver の 2 周期に 1 回観測する
+  constexpr auto delay = 30ms;
+  std::mt19937 rng{0};
+  double x  = 0;
+  auto prev = std::chrono::system_clock::now();
+  for (int i = 0; i < 400; ++i) {
+    if (i % 4 == 0) {
+      // 不規則に前後へ歩かせる
+      model::command command{};
+      command.set_velocity(rng() % 2 ? 1000 : -1000, 0, 0);
+      d.update_command(1, command);
+    }
+    if (i % 2 == 0) {
+      const auto now = std::chrono::system_clock::now();
+      const auto e   = history->at(now - delay);
+      x += (e ? e->vx : 0.0) * std::chrono::duration<double>{now - prev}.count();
+      prev = now;
+
+      ssl_protos::vision::Packet p{};
+      auto md = p.mutable_detection();
+      md->set_camera_id(0);
+      md->set_t_capture(std::chrono::duration<double>{now.time_since_epoch()}.count());
+
+      auto r = md->add_robots_blue();
+      r->set_robot_id(1);
+      r->set_x(x);
+      r->set_y(0);
+      r->set_orientation(0);
+      r->set_confidence(100);
+
+      wu.update(p);
+    }
+    ctx.run_one();
+  }
+
+  // 推定された遅延時間が Controller にも設定される
+  const auto estimated = d.estimated_delay(1);
+  BOOST_REQUIRE(estimated.has_value());
+  BOOST_TEST(std::abs(*estimated - 0.03) < 0.02);
+  BOOST_REQUIRE(!c.delays_.empty());
+  BOOST_TEST(c.delays_.back() == *estimated);
+}
+
+BOOST_AUTO_TEST_CASE(trigger) {
+  boost::asio::io_context ctx{};
+  ai_server::model::updater::world wu{};
+  ai_server::driver d{ctx, 100ms, wu, model::team_color::blue};
+  wu.on_updated([&d] { d.notify_world_updated(); });
+
+  d.register_robot(1, std::make_unique<mock_controller>(), std::make_unique<mock_radio>());
+
+  const auto update = [&wu] {
+    ssl_protos::vision::Packet p{};
+    auto md = p.mutable_detection();
+    md->set_camera_id(0);
+
+    auto r = md->add_robots_blue();
+    r->set_robot_id(1);
+    r->set_x(0);
+    r->set_y(0);
+    r->set_orientation(0);
+    r->set_confidence(100);
+
+    wu.update(p);
+  };
+
+  // 最初のサイクル
+  ctx.run_one();
+  BOOST_TEST(d.stats().cycles == 1);
+
+  // 設定されていなければ, 通知があっても制御周期が経過するまで開始しない
+  std::this_thread::sleep_for(60ms);
+  update();
+  ctx.run_for(5ms);
+  BOOST_TEST(d.stats().cycles == 1);
+  ctx.run_for(50ms);
+  BOOST_TEST(d.stats().cycles == 2);
+
+  d.set_trigger_offset(1ms);
+
+  // 通知から offset 経過した時点で開始する
+  std::this_thread::sleep_for(45ms);
+  update();
+  ctx.run_for(5ms);
+  {
+    const auto s = d.stats();
+    BOOST_TEST(s.cycles == 3);
+    // world が更新されてから offset 以上経過している
+    BOOST_TEST((1ms <= s.world_age && s.world_age < 20ms));
+    BOOST_TEST((s.max_world_age >= s.world_age));
+    BOOST_TEST((s.total_world_age >= s.world_age));
+  }
+
+  // 前回の開始から制御周期の半分が経過していない通知は無視する
+  update();
+  ctx.run_for(5ms);
+  BOOST_TEST(d.stats().cycles == 3);
+
+  // 通知が途絶えても制御周期の 1.5 倍が経過すれば開始する
+  ctx.run_for(100ms);
+  BOOST_TEST(d.stats().cycles == 3);
+  ctx.run_for(80ms);
+  BOOST_TEST(d.stats().cycles == 4);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,10 +1,13 @@
 #define BOOST_TEST_DYN_LINK
 
+#include <array>
+#include <memory>
 #include <vector>
 #include <boost/test/unit_test.hpp>
 #include <Eigen/Core>
 
 #include "ai_server/filter/state_observer/robot.h"
+#include "ai_server/model/command_history.h"
 #include "ai_server/model/robot.h"
 
 using namespace std::chrono_literals;
@@ -87,4 +90,59 @@ BOOST_AUTO_TEST_CASE(move, *boost::unit_test::tolerance(5.0)) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(command_history) {
+  auto t = std::chrono::system_clock::now();
+  model::robot r{};
+  std::array<model::robot, 4> results{};
+
+  std::recursive_mutex mutex{};
+  auto writer = [&results](std::size_t i) {
+    return [&results, i](std::optional<model::robot> v) { results[i] = *v; };
+  };
+  // 履歴から指令を取り出す
+  filter::state_observer::robot obs0{mutex, writer(0), 1s};
+  // 同じ指令を直接与える
+  filter::state_observer::robot obs1{mutex, writer(1), 1s};
+  // 履歴を設定せずに observe() する
+  filter::state_observer::robot obs2{mutex, writer(2), 1s};
+  // 制御入力 0 で observe() する
+  filter::state_observer::robot obs3{mutex, writer(3), 1s};
+
+  auto history = std::make_shared<model::command_history>();
+  obs0.set_command_history(history);
+
+  for (auto i = 0u; i < 100; ++i) {
+    t += 20ms;
+    const double vx = 10.0 * i;
+    const double vy = -5.0 * i;
+
+    // 観測した時刻に有効だった指令と, 観測より後に送信された指令
+    history->push(t - 5ms, vx, vy, 0);
+    history->push(t + 10ms, 9999, 9999, 0);
+
+    r.set_x(r.x() + vx * 0.02);
+    r.set_y(r.y() + vy * 0.02);
+    obs0.set_raw_value(r, t);
+    obs1.set_raw_value(r, t);
+    obs2.set_raw_value(r, t);
+    obs3.set_raw_value(r, t);
+
+    obs0.observe();
+    obs1.observe(vx, vy);
+    obs2.observe();
+    obs3.observe(0, 0);
+  }
+
+  // 観測時刻に有効だった指令が使われる
+  BOOST_TEST(results[0].x() == results[1].x());
+  BOOST_TEST(results[0].y() == results[1].y());
+  BOOST_TEST(results[0].vx() == results[1].vx());
+  BOOST_TEST(results[0].vy() == results[1].vy());
+
+  // 履歴が設定されていなければ制御入力は 0 とする
+  BOOST_TEST(results[2].x() == results[3].x());
+  BOOST_TEST(results[2].vx() == results[3].vx());
+  BOOST_TEST(results[0].vx() != results[2].vx());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 #include <boost/test/unit_test.hpp>
@@ -11,6 +12,7 @@
 #include "ai_server/game/nnabla.h"
 #include "ai_server/planner/base.h"
 #include "ai_server/planner/obstacle_list.h"
+#include "ai_server/planner/plan_cache.h"
 
 namespace action  = ai_server::game::action;
 namespace game    = ai_server::game;
@@ -20,15 +22,29 @@ namespace planner = ai_server::planner;
 struct mock_planner : public planner::base {
   Eigen::Vector2d from;
   Eigen::Vector2d to;
+  int calls = 0;
 
   virtual planner::base::planner_type planner() override {
     return [this](const Eigen::Vector2d& f, const Eigen::Vector2d& t,
                   const planner::obstacle_list&) {
       from = f;
       to   = t;
+      ++calls;
       return planner::base::result_type{f + Eigen::Vector2d(10, 20), 1.23};
     };
   }
+
+  std::optional<planner::base::deadline_type> deadline;
+
+  virtual planner::base::anytime_planner_type anytime_planner() override {
+    return [this](const Eigen::Vector2d& f, const Eigen::Vector2d& t,
+                  const planner::obstacle_list&, planner::base::deadline_type d) {
+      from     = f;
+      to       = t;
+      deadline = d;
+      return planner::base::result_type{f + Eigen::Vector2d(30, 40), 1.23};
+    };
+  }
 };
 
 struct stub_action : public action::base {
@@ -117,4 +133,161 @@ BOOST_AUTO_TEST_CASE(execute) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(planning_deadline) {
+  game::context ctx{};
+  {
+    ctx.team_color = model::team_color::yellow;
+    ctx.world.set_robots_yellow({
+        {123, {100, 200, 300}},
+    });
+  }
+
+  auto a  = std::make_shared<stub_action>(ctx, 123);
+  auto pp = std::make_unique<mock_planner>();
+  auto& p = *pp;
+  auto b  = std::make_shared<action::with_planner>(a, std::move(pp), planner::obstacle_list{});
+
+  // 期限を設定しなければ planner() を使う
+  a->cmd.set_position(4, 5);
+  {
+    const auto cmd = b->execute();
+    auto& pos = std::get<model::setpoint::position>(std::get<0>(cmd.setpoint_pair()));
+    BOOST_TEST(std::get<0>(pos) == 100 + 10);
+    BOOST_TEST(!p.deadline);
+  }
+
+  // 期限を設定すると anytime_planner() にその期限が渡される
+  const auto deadline = planner::base::deadline_type{std::chrono::milliseconds{42}};
+  b->set_planning_deadline(deadline);
+  {
+    const auto cmd = b->execute();
+    auto& pos = std::get<model::setpoint::position>(std::get<0>(cmd.setpoint_pair()));
+    BOOST_TEST(std::get<0>(pos) == 100 + 30);
+    BOOST_TEST(std::get<1>(pos) == 200 + 40);
+    BOOST_TEST(p.to.x() == 4);
+    BOOST_TEST(p.to.y() == 5);
+    BOOST_TEST((p.deadline && *p.deadline == deadline));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(prepare_and_complete) {
+  game::context ctx{};
+  {
+    ctx.team_color = model::team_color::yellow;
+    ctx.world.set_robots_yellow({
+        {123, {100, 200, 300}},
+    });
+  }
+
+  auto a  = std::make_shared<stub_action>(ctx, 123);
+  auto pp = std::make_unique<mock_planner>();
+  auto& p = *pp;
+  auto b  = std::make_shared<action::with_planner>(a, std::move(pp), planner::obstacle_list{});
+
+  // 座標の指令は経路探索の要求になる
+  a->cmd.set_position(4, 5);
+  {
+    const auto r = b->prepare();
+    BOOST_TEST(r.has_value());
+    BOOST_TEST(r->id == 123u);
+    BOOST_TEST(r->planner == &p);
+    BOOST_TEST(r->start.x() == 100);
+    BOOST_TEST(r->start.y() == 200);
+    BOOST_TEST(r->goal.x() == 4);
+    BOOST_TEST(r->goal.y() == 5);
+    BOOST_TEST(!r->deadline);
+
+    // 結果を反映した指令が返る
+    const auto cmd = b->complete({{7, 8}, 1.0});
+    auto& pos      = std::get<model::setpoint::position>(std::get<0>(cmd.setpoint_pair()));
+    BOOST_TEST(std::get<0>(pos) == 7);
+    BOOST_TEST(std::get<1>(pos) == 8);
+  }
+
+  // 速度の指令は止まるまでに進む位置が目標になり, 結果の方向の速度が出力される
+  a->cmd.set_velocity(3000, 0);
+  {
+    const auto r = b->prepare();
+    BOOST_TEST(r.has_value());
+    BOOST_TEST(r->goal.x() == 100 + 1500);
+    BOOST_TEST(r->goal.y() == 200);
+
+    const auto cmd = b->complete({{100, 300}, 1.0});
+    auto& v        = std::get<model::setpoint::velocity>(std::get<0>(cmd.setpoint_pair()));
+    BOOST_TEST(std::get<0>(v) == 0, boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(std::get<1>(v) == std::sqrt(2.0 * 3000.0 * 100.0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(plan_cache) {
+  game::context ctx{};
+  {
+    ctx.team_color = model::team_color::yellow;
+    ctx.world.set_robots_yellow({
+        {123, {100, 200, 300}},
+    });
+    ctx.plan_cache = std::make_shared<planner::plan_cache>(std::chrono::hours{1});
+  }
+
+  auto a = std::make_shared<stub_action>(ctx, 123);
+  a->cmd.set_position(4, 5);
+
+  // with_planner は周期ごとに作り直されるが, context の plan_cache に結果が残る
+  const auto make = [&a] {
+    auto pp = std::make_unique<mock_planner>();
+    auto& p = *pp;
+    return std::make_pair(
+        std::make_shared<action::with_planner>(a, std::move(pp), planner::obstacle_list{}),
+        &p);
+  };
+
+  {
+    auto [b, p]    = make();
+    const auto cmd = b->execute();
+    auto& pos      = std::get<model::setpoint::position>(std::get<0>(cmd.setpoint_pair()));
+    BOOST_TEST(p->calls == 1);
+    BOOST_TEST(std::get<0>(pos) == 100 + 10);
+  }
+
+  // 入力が同じなら planner を呼ばずに前回の結果を使う
+  {
+    auto [b, p]    = make();
+    const auto cmd = b->execute();
+    auto& pos      = std::get<model::setpoint::position>(std::get<0>(cmd.setpoint_pair()));
+    BOOST_TEST(p->calls == 0);
+    BOOST_TEST(std::get<0>(pos) == 100 + 10);
+    BOOST_TEST(std::get<1>(pos) == 200 + 20);
+  }
+
+  // prepare() と complete() で行うときも同じ
+  {
+    auto [b, p] = make();
+    BOOST_TEST(!b->prepare());
+    const auto cmd = b->complete({});
+    auto& pos      = std::get<model::setpoint::position>(std::get<0>(cmd.setpoint_pair()));
+    BOOST_TEST(std::get<0>(pos) == 100 + 10);
+  }
+
+  // 目標が変われば探索し直す
+  a->cmd.set_position(1000, 5);
+  {
+    auto [b, p] = make();
+    const auto r = b->prepare();
+    BOOST_TEST(r.has_value());
+    b->complete({{7, 8}, 1.0});
+
+    // complete() に渡した結果が次から使われる
+    auto [c, q]    = make();
+    const auto cmd = c->execute();
+    auto& pos      = std::get<model::setpoint::position>(std::get<0>(cmd.setpoint_pair()));
+    BOOST_TEST(q->calls == 0);
+    BOOST_TEST(std::get<0>(pos) == 7);
+    BOOST_TEST(std::get<1>(pos) == 8);
+  }
+
+  const auto s = ctx.plan_cache->stats();
+  BOOST_TEST(s.hits == 3u);
+  BOOST_TEST(s.misses == 2u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
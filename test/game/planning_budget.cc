@@ -0,0 +1,61 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/game/planning_budget.h"
+
+namespace game = ai_server::game;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(planning_budget)
+
+BOOST_AUTO_TEST_CASE(share_by_priority) {
+  game::planning_budget b{300ms};
+  b.start({{1, 1.0}, {2, 2.0}, {3, 0.0}});
+
+  // 残り時間を優先度で按分する
+  const auto t1 = std::chrono::steady_clock::now();
+  const auto d1 = b.deadline(1);
+  BOOST_TEST((d1 - t1 > 90ms));
+  BOOST_TEST((d1 - t1 < 110ms));
+
+  // 優先度 0 や start() に含まれていないロボットには時間を割り当てない
+  const auto d3 = b.deadline(3);
+  const auto d4 = b.deadline(4);
+  BOOST_TEST((d3 <= std::chrono::steady_clock::now()));
+  BOOST_TEST((d4 <= std::chrono::steady_clock::now()));
+
+  // 最後のロボットは残り全てを使える
+  const auto d2 = b.deadline(2);
+  BOOST_TEST((d2 - t1 > 290ms));
+  BOOST_TEST((d2 - t1 <= 300ms));
+
+  // 同じロボットに 2 回は割り当てない
+  const auto d5 = b.deadline(2);
+  BOOST_TEST((d5 <= std::chrono::steady_clock::now()));
+}
+
+BOOST_AUTO_TEST_CASE(carry_over) {
+  game::planning_budget b{100ms};
+  b.start({{1, 1.0}, {2, 1.0}});
+
+  // 前のロボットが時間を使い切ると, 後のロボットの時間は減る
+  const auto d1 = b.deadline(1);
+  std::this_thread::sleep_until(d1 + 20ms);
+  const auto t2 = std::chrono::steady_clock::now();
+  const auto d2 = b.deadline(2);
+  BOOST_TEST((d2 - t2 < 35ms));
+
+  // 周期が変われば割り当て直す
+  b.set_budget(50ms);
+  b.start({{1, 1.0}});
+  const auto t3 = std::chrono::steady_clock::now();
+  const auto d3 = b.deadline(1);
+  BOOST_TEST((d3 - t3 > 40ms));
+  BOOST_TEST((d3 - t3 <= 50ms));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
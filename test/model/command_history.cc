@@ -0,0 +1,119 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/model/command_history.h"
+
+using namespace std::chrono_literals;
+using history_type = ai_server::model::command_history;
+
+BOOST_AUTO_TEST_SUITE(command_history)
+
+BOOST_AUTO_TEST_CASE(empty) {
+  history_type h{};
+
+  BOOST_TEST(h.size() == 0);
+  BOOST_TEST(!h.latest().has_value());
+  BOOST_TEST(!h.at(history_type::clock_type::now()).has_value());
+
+  std::vector<history_type::entry> v{};
+  h.copy_since(history_type::clock_type::now(), std::back_inserter(v));
+  BOOST_TEST(v.empty());
+}
+
+BOOST_AUTO_TEST_CASE(push_and_read) {
+  history_type h{};
+  const auto t0 = history_type::clock_type::now();
+
+  h.push(t0, 1, 2, 3);
+  h.push(t0 + 10ms, 4, 5, 6);
+  h.push(t0 + 20ms, 7, 8, 9);
+
+  BOOST_TEST(h.size() == 3);
+
+  {
+    const auto e = h.latest();
+    BOOST_REQUIRE(e);
+    BOOST_TEST((e->time == t0 + 20ms));
+    BOOST_TEST(e->vx == 7);
+    BOOST_TEST(e->vy == 8);
+    BOOST_TEST(e->omega == 9);
+  }
+
+  // 時刻 t に有効だった指令
+  BOOST_TEST(!h.at(t0 - 1ms).has_value());
+  BOOST_TEST(h.at(t0)->vx == 1);
+  BOOST_TEST(h.at(t0 + 15ms)->vx == 4);
+  BOOST_TEST(h.at(t0 + 1s)->vx == 7);
+
+  // from の時点で有効だった指令から古い順に取り出せる
+  {
+    std::vector<history_type::entry> v{};
+    h.copy_since(t0 + 15ms, std::back_inserter(v));
+    BOOST_TEST(v.size() == 2);
+    BOOST_TEST(v.at(0).vx == 4);
+    BOOST_TEST(v.at(1).vx == 7);
+  }
+  {
+    std::vector<history_type::entry> v{};
+    h.copy_since(t0 - 1s, std::back_inserter(v));
+    BOOST_TEST(v.size() == 3);
+    BOOST_TEST(v.at(0).vx == 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(overwrite) {
+  history_type h{};
+  const auto t0 = history_type::clock_type::now();
+
+  // capacity を超えた分は古いものから上書きされる
+  const auto n = history_type::capacity + 10;
+  for (std::size_t i = 0; i < n; ++i) {
+    h.push(t0 + i * 1ms, static_cast<double>(i), 0, 0);
+  }
+
+  BOOST_TEST(h.size() == n);
+  BOOST_TEST(h.latest()->vx == n - 1);
+  BOOST_TEST(!h.at(t0 + 5ms).has_value());
+
+  std::vector<history_type::entry> v{};
+  h.copy_since(t0, std::back_inserter(v));
+  BOOST_TEST(v.size() == history_type::capacity);
+  BOOST_TEST(v.front().vx == 10);
+  BOOST_TEST(v.back().vx == n - 1);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_read) {
+  history_type h{};
+  const auto t0 = history_type::clock_type::now();
+
+  // 書き込み中に読み出しても, 読み出した要素は常に 1 回の push で書き込まれた値になる
+  constexpr std::size_t n = 100000;
+  std::thread writer{[&h, t0] {
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto v = static_cast<double>(i);
+      h.push(t0 + i * 1us, v, 2 * v, 3 * v);
+    }
+  }};
+
+  bool consistent = true;
+  while (h.size() < n) {
+    std::vector<history_type::entry> v{};
+    h.copy_since(t0, std::back_inserter(v));
+    for (std::size_t i = 0; i < v.size(); ++i) {
+      const auto& e = v[i];
+      consistent &= e.vy == 2 * e.vx && e.omega == 3 * e.vx;
+      consistent &= e.time == t0 + static_cast<std::size_t>(e.vx) * 1us;
+      if (i > 0) consistent &= v[i - 1].time < e.time;
+    }
+  }
+  writer.join();
+
+  BOOST_TEST(consistent);
+  BOOST_TEST(h.latest()->vx == n - 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
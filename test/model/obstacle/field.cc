@@ -45,4 +45,25 @@ BOOST_DATA_TEST_CASE(our_penalty, boost::unit_test::data::make({0.0, -500.0, 500
   BOOST_TEST(o.margin == margin);
 }
 
+BOOST_AUTO_TEST_CASE(static_obstacles) {
+  model::field field{};
+  const auto make = [&field] {
+    return obstacle::static_obstacles(field, {obstacle::enemy_penalty_area(field, 150.0),
+                                              obstacle::our_penalty_area(field, 150.0)});
+  };
+  const auto f1 = make();
+  BOOST_TEST(f1->obstacles().size() == 2u);
+
+  // フィールドの形状が変わらなければ作り直さない
+  const auto f2 = make();
+  BOOST_TEST(f1 == f2);
+
+  // フィールドの形状が変われば作り直す
+  field.set_penalty_width(field.penalty_width() + 200);
+  const auto f3 = make();
+  BOOST_TEST(f1 != f3);
+  BOOST_TEST(f3->is_collided({field.back_penalty_x() + 100.0, field.penalty_y_max() + 100.0},
+                             {field.back_penalty_x() + 100.0, field.penalty_y_max() + 100.0}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
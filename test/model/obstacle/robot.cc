@@ -218,4 +218,48 @@ BOOST_DATA_TEST_CASE(add_robots_if_test, boost::unit_test::data::make({0.0, 500.
   }
 }
 
+BOOST_AUTO_TEST_CASE(add_moving_robots_test) {
+  model::world::robots_list robots{
+      {1, {}},
+      {2, {524.23, 324.5, 1.433}},
+      {3, {6.73, 651.43, 0.195}},
+  };
+  for (auto& [id, r] : robots) {
+    r.set_vx(100.0 * id);
+    r.set_vy(-50.0 * id);
+  }
+
+  { // add_moving_robots(...)
+    obstacle_list list;
+    obstacle::add_moving_robots(list, robots, 300.0);
+
+    // 動く障害物は RTree に入れる障害物とは別に持つ
+    BOOST_TEST(list.buffer().empty());
+    const auto& o = list.moving();
+    BOOST_TEST(o.size() == robots.size());
+
+    auto r_itr = robots.begin();
+    auto o_itr = o.begin();
+    for (; r_itr != robots.end() && o_itr != o.end(); ++r_itr, ++o_itr) {
+      BOOST_TEST_CONTEXT("at " << r_itr->first) {
+        BOOST_TEST(o_itr->geometry.x() == r_itr->second.x());
+        BOOST_TEST(o_itr->geometry.y() == r_itr->second.y());
+        BOOST_TEST(o_itr->velocity.x() == r_itr->second.vx());
+        BOOST_TEST(o_itr->velocity.y() == r_itr->second.vy());
+        BOOST_TEST(o_itr->margin == 300.0);
+      }
+    }
+  }
+
+  { // add_moving_robots_if(...)
+    obstacle_list list;
+    const auto pred = [](auto id, [[maybe_unused]] auto&& robot) { return id != 2; };
+    obstacle::add_moving_robots_if(list, robots, 300.0, pred);
+
+    const auto& o = list.moving();
+    BOOST_TEST(o.size() == 2u);
+    for (const auto& m : o) BOOST_TEST(m.velocity.x() != robots.at(2).vx());
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
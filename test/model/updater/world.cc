@@ -1,5 +1,6 @@
 #define BOOST_TEST_DYN_LINK
 
+#include <chrono>
 #include <stdexcept>
 #include <boost/math/constants/constants.hpp>
 #include <boost/test/unit_test.hpp>
@@ -335,4 +336,72 @@ BOOST_AUTO_TEST_CASE(disabling_camera) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(update_time) {
+  ai_server::model::updater::world wu{};
+
+  // 一度も更新されていなければ time_point{}
+  BOOST_TEST((wu.value().update_time() == std::chrono::system_clock::time_point{}));
+
+  // 検出データで更新された時刻が記録される
+  {
+    ssl_protos::vision::Packet p;
+    p.mutable_detection()->set_camera_id(0);
+
+    const auto before = std::chrono::system_clock::now();
+    wu.update(p);
+    const auto after = std::chrono::system_clock::now();
+
+    const auto t = wu.value().update_time();
+    BOOST_TEST((before <= t && t <= after));
+  }
+
+  // 無効化されたカメラや形状データでは更新されない
+  {
+    const auto t = wu.value().update_time();
+
+    wu.disable_camera(1);
+    ssl_protos::vision::Packet p1;
+    p1.mutable_detection()->set_camera_id(1);
+    wu.update(p1);
+
+    ssl_protos::vision::Packet p2;
+    p2.mutable_geometry()->mutable_field()->set_field_length(9000);
+    wu.update(p2);
+
+    BOOST_TEST((wu.value().update_time() == t));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(on_updated) {
+  ai_server::model::updater::world wu{};
+
+  int count = 0;
+  wu.on_updated([&wu, &count] {
+    // 呼び出された時点で更新された値が取得できる
+    BOOST_TEST(wu.value().robots_blue().count(1) == 1);
+    ++count;
+  });
+
+  ssl_protos::vision::Packet p;
+  auto md = p.mutable_detection();
+  md->set_camera_id(0);
+  auto rb1 = md->add_robots_blue();
+  rb1->set_robot_id(1);
+  rb1->set_x(10);
+  rb1->set_y(11);
+  rb1->set_orientation(0);
+  rb1->set_confidence(94.0);
+
+  wu.update(p);
+  BOOST_TEST(count == 1);
+
+  // 無効化されたカメラや形状データだけのパケットでは呼ばれない
+  wu.disable_camera(0);
+  wu.update(p);
+  ssl_protos::vision::Packet p2;
+  p2.mutable_geometry()->mutable_field()->set_field_length(9000);
+  wu.update(p2);
+  BOOST_TEST(count == 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,208 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <variant>
+#include <vector>
+
+#include <boost/geometry/algorithms/distance.hpp>
+#include <boost/geometry/geometries/segment.hpp>
+#include <boost/random.hpp>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/detail/distance_field.h"
+#include "ai_server/planner/human_like.h"
+#include "ai_server/planner/obstacle_list.h"
+
+namespace model   = ai_server::model;
+namespace planner = ai_server::planner;
+namespace detail  = ai_server::planner::detail;
+namespace tt      = boost::test_tools;
+
+using segment_type = boost::geometry::model::segment<Eigen::Vector2d>;
+
+BOOST_AUTO_TEST_SUITE(distance_field)
+
+// ペナルティエリアのような障害物
+const std::vector<detail::distance_field::obstacle_type> statics{
+    model::obstacle::box{{{-100000.0, -1000.0}, {-5000.0, 1000.0}}, 150.0},
+    model::obstacle::box{{{5000.0, -1000.0}, {100000.0, 1000.0}}, 150.0},
+    model::obstacle::point{{0.0, 0.0}, 500.0},
+    model::obstacle::segment{{{-2000.0, 3000.0}, {2000.0, 3000.0}}, 100.0},
+    // マージンが 0 なら当たらない
+    model::obstacle::box{{{-3000.0, -4000.0}, {-2000.0, -3000.0}}, 0.0},
+};
+
+BOOST_AUTO_TEST_CASE(lower_bound) {
+  const detail::distance_field f{statics, {-6500.0, -5000.0}, {6500.0, 5000.0}, 20.0};
+  BOOST_TEST(f.obstacles().size() == statics.size());
+  BOOST_TEST(f.resolution() == 20.0);
+
+  boost::random::mt19937 mt{1};
+  boost::random::uniform_real_distribution<> x{-8000.0, 8000.0};
+  boost::random::uniform_real_distribution<> y{-6000.0, 6000.0};
+  for (int i = 0; i < 2000; ++i) {
+    const Eigen::Vector2d p{x(mt), y(mt)};
+    // マージンの外側までの正確な距離
+    auto c = std::numeric_limits<double>::infinity();
+    for (const auto& o : statics) {
+      std::visit(
+          [&p, &c](const auto& arg) {
+            if (arg.margin > 0.0) {
+              c = std::min(c, boost::geometry::distance(p, arg.geometry) - arg.margin);
+            }
+          },
+          o);
+    }
+
+    // 格子の外では正確な値, 中では最も近い格子点までの距離の 2 倍以内の誤差
+    const auto l = f.lower_bound(p);
+    BOOST_TEST(l <= c + 1e-6);
+    if (std::abs(p.x()) > 6510.0 || std::abs(p.y()) > 5010.0) {
+      BOOST_TEST(l == c, tt::tolerance(1e-9));
+    } else {
+      BOOST_TEST(l >= c - 2.0 * 20.0 * std::sqrt(0.5) - 0.1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(same_as_batch) {
+  const detail::distance_field f{statics, {-6500.0, -5000.0}, {6500.0, 5000.0}, 20.0};
+  detail::obstacle_batch batch{};
+  for (const auto& o : statics) batch.add(o);
+
+  boost::random::mt19937 mt{1};
+  boost::random::uniform_real_distribution<> x{-7000.0, 7000.0};
+  boost::random::uniform_real_distribution<> y{-5500.0, 5500.0};
+  boost::random::uniform_real_distribution<> d{-4000.0, 4000.0};
+
+  std::vector<double> lengths{};
+  for (int i = 1; i <= 100; ++i) lengths.push_back(50.0 * i);
+
+  for (int i = 0; i < 5000; ++i) {
+    const Eigen::Vector2d a{x(mt), y(mt)};
+    Eigen::Vector2d b = a + Eigen::Vector2d{d(mt), d(mt)};
+    // 軸に平行な線分も調べる
+    if (i % 4 == 1) b.y() = a.y();
+    if (i % 4 == 2) b.x() = a.x();
+
+    BOOST_TEST(detail::is_collided(a, f) == detail::is_collided(a, batch));
+    BOOST_TEST(detail::is_collided(segment_type{a, b}, f) ==
+               detail::is_collided(segment_type{a, b}, batch));
+
+    const Eigen::Vector2d dir = (b - a).normalized();
+    const auto first          = lengths.begin();
+    const auto last           = lengths.end();
+    const auto l              = detail::find_collided_length(first, last, a, dir, f);
+    const auto t              = detail::find_collided_length(first, last, a, dir, batch);
+    BOOST_TEST(std::distance(first, l) == std::distance(first, t));
+
+    const auto fc = f.first_collision(a, dir);
+    const auto bc = batch.first_collision(a, dir);
+    if (std::isinf(bc)) {
+      BOOST_TEST(std::isinf(fc));
+    } else if (bc <= 0.0) {
+      BOOST_TEST(fc <= 0.0);
+    } else {
+      BOOST_TEST(fc == bc, tt::tolerance(1e-9));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(make) {
+  const Eigen::Vector2d min_p{-6500.0, -5000.0};
+  const Eigen::Vector2d max_p{6500.0, 5000.0};
+
+  // 同じ引数なら作り直さない
+  const auto f1 = detail::distance_field::make(statics, min_p, max_p, 50.0);
+  const auto f2 = detail::distance_field::make(statics, min_p, max_p, 50.0);
+  BOOST_TEST(f1 == f2);
+
+  // 障害物や格子の間隔が変われば作り直す
+  auto moved = statics;
+  moved.at(2) = model::obstacle::point{{10.0, 0.0}, 500.0};
+  const auto f3 = detail::distance_field::make(moved, min_p, max_p, 50.0);
+  const auto f4 = detail::distance_field::make(statics, min_p, max_p, 100.0);
+  BOOST_TEST(f3 != f1);
+  BOOST_TEST(f4 != f1);
+  BOOST_TEST(f4->resolution() == 100.0);
+
+  // 元に戻れば前に作ったものを使う
+  const auto f5 = detail::distance_field::make(statics, min_p, max_p, 50.0);
+  BOOST_TEST(f5 == f1);
+}
+
+BOOST_AUTO_TEST_CASE(obstacle_list) {
+  boost::random::mt19937 mt{1};
+  boost::random::uniform_real_distribution<> x{-6000.0, 6000.0};
+  boost::random::uniform_real_distribution<> y{-4500.0, 4500.0};
+
+  const auto field = detail::distance_field::make(statics, {-6500.0, -5000.0},
+                                                  {6500.0, 5000.0}, 20.0);
+
+  planner::human_like hl{};
+  hl.set_min_pos({-6000.0, -4500.0});
+  hl.set_max_pos({6000.0, 4500.0});
+
+  for (int i = 0; i < 100; ++i) {
+    // 同じ障害物を distance_field で設定したものと, 1 つずつ追加したもの
+    planner::obstacle_list with_field{};
+    planner::obstacle_list with_boxes{};
+    with_field.set_field(field);
+    for (const auto& o : statics) with_boxes.add(o);
+    for (auto* obs : {&with_field, &with_boxes}) obs->share();
+    for (int j = 0; j < 10; ++j) {
+      const model::obstacle::point o{{x(mt), y(mt)}, 300.0};
+      with_field.add(o);
+      with_boxes.add(o);
+    }
+    BOOST_TEST(with_field.field() == field);
+
+    // 配列にまとめたときも distance_field の格子を使う
+    const auto fb = with_field.to_batch();
+    const auto bb = with_boxes.to_batch();
+    BOOST_TEST(fb.field() == field);
+    BOOST_TEST(fb.size() == bb.size());
+
+    const Eigen::Vector2d start{x(mt), y(mt)}, goal{x(mt), y(mt)};
+    const auto ft = with_field.to_tree();
+    const auto bt = with_boxes.to_tree();
+    BOOST_TEST(detail::is_collided(start, ft) == detail::is_collided(start, bt));
+    BOOST_TEST(detail::is_collided(start, fb) == detail::is_collided(start, bb));
+    BOOST_TEST(detail::is_collided(segment_type{start, goal}, fb) ==
+               detail::is_collided(segment_type{start, goal}, bb));
+
+    const Eigen::Vector2d dir = (goal - start).normalized();
+    const auto fc             = fb.first_collision(start, dir);
+    const auto bc             = bb.first_collision(start, dir);
+    if (std::isinf(bc)) {
+      BOOST_TEST(std::isinf(fc));
+    } else if (bc <= 0.0) {
+      BOOST_TEST(fc <= 0.0);
+    } else {
+      BOOST_TEST(fc == bc, tt::tolerance(1e-9));
+    }
+
+    // 当たっている障害物のうち最も近いもの
+    const auto fn = detail::nearest_collision(ft, start);
+    const auto bn = detail::nearest_collision(bt, start);
+    BOOST_TEST(fn.has_value() == bn.has_value());
+    if (fn && bn) {
+      BOOST_TEST(std::get<1>(*fn).index() == std::get<1>(*bn).index());
+      BOOST_TEST(detail::obstacle_distance(start, std::get<1>(*fn)) ==
+                 detail::obstacle_distance(start, std::get<1>(*bn)));
+    }
+
+    // planner の結果も同じ
+    const auto h1 = hl.planner()(start, goal, with_field).first;
+    const auto h2 = hl.planner()(start, goal, with_boxes).first;
+    BOOST_TEST(h1.x() == h2.x(), tt::tolerance(1e-9));
+    BOOST_TEST(h1.y() == h2.y(), tt::tolerance(1e-9));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
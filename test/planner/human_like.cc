@@ -0,0 +1,96 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <boost/random.hpp>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/planner/human_like.h"
+#include "ai_server/planner/impl/human_like.h"
+#include "ai_server/planner/obstacle_list.h"
+
+namespace model   = ai_server::model;
+namespace planner = ai_server::planner;
+namespace impl    = ai_server::planner::impl;
+namespace tt      = boost::test_tools;
+
+BOOST_AUTO_TEST_SUITE(human_like)
+
+BOOST_AUTO_TEST_CASE(directions) {
+  for (const int count : {1, 2, 7, 8, 16}) {
+    const auto rotations = impl::make_rotations(count);
+    BOOST_TEST(rotations.size() == static_cast<std::size_t>(count));
+
+    // 基準方向, その両隣... の順に並ぶ
+    const Eigen::Vector2d dir = Eigen::Vector2d{3.0, 4.0}.normalized();
+    const auto dirs           = impl::make_directions(dir, count);
+    BOOST_TEST(dirs.size() == rotations.size());
+    BOOST_TEST(dirs.front().x() == dir.x());
+    BOOST_TEST(dirs.front().y() == dir.y());
+    for (std::size_t i = 1; i < dirs.size(); ++i) {
+      BOOST_TEST(dirs[i].norm() == 1.0, tt::tolerance(1e-9));
+      BOOST_TEST(dir.dot(dirs[i]) <= dir.dot(dirs[i - 1]) + 1e-9);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lengths) {
+  const auto table = impl::make_length_list(100.0, 4000.0, 100.0);
+
+  // 作っておいたリストを打ち切ったものと, 作り直したものは同じ
+  std::vector<double> lengths{};
+  for (const double l_max : {0.0, 50.0, 100.0, 150.0, 1234.5, 3900.0, 3950.0, 4000.0}) {
+    impl::truncate_lengths(table, l_max, lengths);
+    const auto expected = impl::make_length_list(std::min(100.0, l_max), l_max, 100.0);
+    BOOST_TEST(lengths == expected, tt::per_element());
+  }
+}
+
+// planner() とは別の障害物で plan() を呼び出せるようにしたもの
+struct exposed : planner::human_like {
+  using human_like::plan;
+};
+
+BOOST_AUTO_TEST_CASE(same_as_tree) {
+  boost::random::mt19937 mt{1};
+  boost::random::uniform_real_distribution<> x{-6000.0, 6000.0};
+  boost::random::uniform_real_distribution<> y{-4500.0, 4500.0};
+  boost::random::uniform_real_distribution<> d{-1000.0, 1000.0};
+
+  exposed hl{};
+  hl.set_min_pos({-6000.0, -4500.0});
+  hl.set_max_pos({6000.0, 4500.0});
+
+  for (int i = 0; i < 400; ++i) {
+    // 設定を変えても作っておいたリストが使われる
+    if (i == 200) {
+      hl.set_direction_count(7);
+      hl.set_max_length(2500.0);
+      hl.set_step_length(50.0);
+    }
+
+    planner::obstacle_list obs{};
+    obs.add(model::obstacle::box{{{-106000.0, -1000.0}, {-4800.0, 1000.0}}, 150.0});
+    for (int j = 0; j < 10; ++j) obs.add(model::obstacle::point{{x(mt), y(mt)}, 300.0});
+    obs.share();
+    for (int j = 0; j < 10; ++j) obs.add(model::obstacle::point{{x(mt), y(mt)}, 300.0});
+    const Eigen::Vector2d p{x(mt), y(mt)};
+    obs.add(model::obstacle::segment{{p, p + Eigen::Vector2d{d(mt), d(mt)}}, 200.0});
+
+    // 障害物の中から始まるもの, ゴールが近いものも含める
+    const Eigen::Vector2d start{x(mt), y(mt)};
+    const Eigen::Vector2d goal = i % 10 == 0 ? (start + Eigen::Vector2d{30.0, 40.0}).eval()
+                                             : Eigen::Vector2d{x(mt), y(mt)};
+
+    const auto a = hl.planner()(start, goal, obs);
+    const auto b = hl.plan(start, goal, obs.to_tree());
+    BOOST_TEST(a.first.x() == b.first.x(), tt::tolerance(1e-9));
+    BOOST_TEST(a.first.y() == b.first.y(), tt::tolerance(1e-9));
+    BOOST_TEST(a.second == b.second, tt::tolerance(1e-9));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+#include <boost/geometry/geometries/segment.hpp>
+#include <boost/random.hpp>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/obstacle_list.h"
+
+namespace model   = ai_server::model;
+namespace planner = ai_server::planner;
+namespace detail  = ai_server::planner::detail;
+namespace tt      = boost::test_tools;
+
+using segment_type = boost::geometry::model::segment<Eigen::Vector2d>;
+
+BOOST_AUTO_TEST_SUITE(obstacle_batch)
+
+BOOST_AUTO_TEST_CASE(each_type) {
+  detail::obstacle_batch batch{};
+  BOOST_TEST(batch.size() == 0u);
+  BOOST_TEST(!batch.is_collided({0.0, 0.0}, {1000.0, 0.0}));
+  BOOST_TEST(std::isinf(batch.first_collision({0.0, 0.0}, {1.0, 0.0})));
+
+  batch.add(model::obstacle::point{{1000.0, 0.0}, 100.0});
+  batch.add(model::obstacle::segment{{{0.0, 1000.0}, {0.0, 2000.0}}, 100.0});
+  batch.add(model::obstacle::box{{{-2000.0, -100.0}, {-1000.0, 100.0}}, 100.0});
+  BOOST_TEST(batch.size() == 3u);
+
+  for (const auto k : {detail::obstacle_batch::kernel::scalar,
+                       detail::obstacle_batch::kernel::simd}) {
+    batch.set_kernel(k);
+
+    // 点
+    BOOST_TEST(batch.is_collided({1050.0, 0.0}, {1050.0, 0.0}));
+    BOOST_TEST(!batch.is_collided({1150.0, 0.0}, {1150.0, 0.0}));
+    BOOST_TEST(batch.is_collided({0.0, 1500.0}, {0.0, 1500.0}));
+    BOOST_TEST(batch.is_collided({-1950.0, 150.0}, {-1950.0, 150.0}));
+    BOOST_TEST(!batch.is_collided({-2090.0, 190.0}, {-2090.0, 190.0}));
+
+    // 線分
+    BOOST_TEST(batch.is_collided({500.0, 50.0}, {1500.0, 50.0}));
+    BOOST_TEST(!batch.is_collided({500.0, 150.0}, {1500.0, 150.0}));
+    BOOST_TEST(batch.is_collided({-500.0, 1500.0}, {500.0, 1500.0}));
+    BOOST_TEST(!batch.is_collided({-500.0, 500.0}, {500.0, 500.0}));
+    BOOST_TEST(batch.is_collided({-1500.0, -500.0}, {-1500.0, 500.0}));
+
+    // ray
+    BOOST_TEST(batch.first_collision({0.0, 0.0}, {1.0, 0.0}) == 900.0, tt::tolerance(1e-9));
+    BOOST_TEST(batch.first_collision({0.0, 0.0}, {-1.0, 0.0}) == 900.0, tt::tolerance(1e-9));
+    BOOST_TEST(batch.first_collision({0.0, 0.0}, {0.0, 1.0}) == 900.0, tt::tolerance(1e-9));
+    BOOST_TEST(batch.first_collision({0.0, 0.0}, {0.0, 2.0}) == 450.0, tt::tolerance(1e-9));
+    BOOST_TEST(std::isinf(batch.first_collision({0.0, 0.0}, {0.0, -1.0})));
+    BOOST_TEST(batch.first_collision({1000.0, 0.0}, {1.0, 0.0}) <= 0.0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(same_as_rtree) {
+  boost::random::mt19937 mt{1};
+  boost::random::uniform_real_distribution<> x{-5000.0, 5000.0};
+  boost::random::uniform_real_distribution<> y{-4000.0, 4000.0};
+  boost::random::uniform_real_distribution<> d{-1000.0, 1000.0};
+  boost::random::uniform_real_distribution<> margin{50.0, 400.0};
+
+  // レーン数の倍数にならない数の障害物
+  planner::obstacle_list obs{};
+  for (int i = 0; i < 23; ++i) {
+    obs.add(model::obstacle::point{{x(mt), y(mt)}, margin(mt)});
+  }
+  for (int i = 0; i < 6; ++i) {
+    const Eigen::Vector2d p{x(mt), y(mt)};
+    obs.add(model::obstacle::segment{{p, p + Eigen::Vector2d{d(mt), d(mt)}}, margin(mt)});
+  }
+  obs.add(model::obstacle::segment{{{0.0, 0.0}, {0.0, 0.0}}, 200.0});
+  for (int i = 0; i < 3; ++i) {
+    const Eigen::Vector2d p{x(mt), y(mt)};
+    const Eigen::Vector2d q = p + Eigen::Vector2d{std::abs(d(mt)), std::abs(d(mt))};
+    obs.add(model::obstacle::box{{p, q}, margin(mt)});
+  }
+  obs.share();
+  obs.add(model::obstacle::point{{x(mt), y(mt)}, margin(mt)});
+
+  const auto tree = obs.to_tree();
+  auto batch      = obs.to_batch();
+  BOOST_TEST(batch.size() == 34u);
+
+  std::vector<double> lengths{};
+  for (int i = 1; i <= 100; ++i) lengths.push_back(50.0 * i);
+
+  for (const auto k : {detail::obstacle_batch::kernel::scalar,
+                       detail::obstacle_batch::kernel::simd}) {
+    batch.set_kernel(k);
+    boost::random::mt19937 q{2};
+
+    for (int i = 0; i < 2000; ++i) {
+      const Eigen::Vector2d a{x(q), y(q)};
+      Eigen::Vector2d b = a + Eigen::Vector2d{d(q), d(q)};
+      // 軸に平行な線分も調べる
+      if (i % 4 == 1) b.y() = a.y();
+      if (i % 4 == 2) b.x() = a.x();
+
+      BOOST_TEST(detail::is_collided(a, batch) == detail::is_collided(a, tree));
+      BOOST_TEST(detail::is_collided(segment_type{a, b}, batch) ==
+                 detail::is_collided(segment_type{a, b}, tree));
+
+      const Eigen::Vector2d dir = (b - a).normalized();
+      const auto first = lengths.begin();
+      const auto last  = lengths.end();
+      const auto l     = detail::find_collided_length(first, last, a, dir, batch);
+      const auto t     = detail::find_collided_length(first, last, a, dir, tree);
+      BOOST_TEST(std::distance(first, l) == std::distance(first, t));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <iterator>
+#include <vector>
+
+#include <boost/geometry/geometries/segment.hpp>
+#include <boost/random.hpp>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/obstacle_list.h"
+
+namespace model   = ai_server::model;
+namespace planner = ai_server::planner;
+namespace detail  = ai_server::planner::detail;
+
+using segment_type = boost::geometry::model::segment<Eigen::Vector2d>;
+
+BOOST_AUTO_TEST_SUITE(obstacle_list)
+
+BOOST_AUTO_TEST_CASE(share) {
+  planner::obstacle_list common{};
+  common.add(model::obstacle::point{{0.0, 0.0}, 100.0});
+  common.add(model::obstacle::point{{1000.0, 0.0}, 100.0});
+  BOOST_TEST(!common.shared_tree());
+
+  // まとめた障害物は buffer() から RTree に移る
+  common.share();
+  BOOST_TEST(common.buffer().empty());
+  BOOST_TEST(common.shared_tree()->size() == 2u);
+
+  // コピーは RTree を共有し, 追加した障害物はコピー元に影響しない
+  auto a = common;
+  a.add(model::obstacle::point{{2000.0, 0.0}, 100.0});
+  BOOST_TEST(a.shared_tree() == common.shared_tree());
+  BOOST_TEST(a.buffer().size() == 1u);
+  BOOST_TEST(common.buffer().empty());
+
+  const auto ta = a.to_tree();
+  BOOST_TEST(ta.shared == common.shared_tree());
+  BOOST_TEST(ta.local.size() == 1u);
+  BOOST_TEST(detail::is_collided(Eigen::Vector2d{0.0, 0.0}, ta));
+  BOOST_TEST(detail::is_collided(Eigen::Vector2d{2000.0, 0.0}, ta));
+  BOOST_TEST(!detail::is_collided(Eigen::Vector2d{2000.0, 0.0}, common.to_tree()));
+
+  // 続けて share() すると, 共有する RTree を作り直してまとめる
+  a.share();
+  BOOST_TEST(a.buffer().empty());
+  BOOST_TEST(a.shared_tree() != common.shared_tree());
+  BOOST_TEST(a.shared_tree()->size() == 3u);
+  BOOST_TEST(common.shared_tree()->size() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(same_as_flat) {
+  boost::random::mt19937 mt{1};
+  boost::random::uniform_real_distribution<> x{-5000.0, 5000.0};
+  boost::random::uniform_real_distribution<> y{-4000.0, 4000.0};
+
+  // 共通の障害物と, ロボットごとの障害物
+  planner::obstacle_list layered{}, flat{};
+  for (int i = 0; i < 20; ++i) {
+    const model::obstacle::point p{{x(mt), y(mt)}, 300.0};
+    layered.add(p);
+    flat.add(p);
+  }
+  const model::obstacle::segment s{{{-1000.0, 2000.0}, {1000.0, 2000.0}}, 100.0};
+  layered.add(s);
+  flat.add(s);
+  layered.share();
+  for (int i = 0; i < 5; ++i) {
+    const model::obstacle::point p{{x(mt), y(mt)}, 300.0};
+    layered.add(p);
+    flat.add(p);
+  }
+
+  const auto lt = layered.to_tree();
+  const auto ft = flat.to_tree();
+  BOOST_TEST(!ft.shared);
+
+  const std::vector<double> lengths{100.0, 200.0, 400.0, 800.0, 1600.0, 3200.0};
+  for (int i = 0; i < 200; ++i) {
+    const Eigen::Vector2d a{x(mt), y(mt)}, b{x(mt), y(mt)};
+
+    // 重ねた RTree でも全ての障害物を 1 つの RTree にしたときと同じ結果になる
+    BOOST_TEST(detail::is_collided(a, lt) == detail::is_collided(a, ft));
+    BOOST_TEST(detail::is_collided(segment_type{a, b}, lt) ==
+               detail::is_collided(segment_type{a, b}, ft));
+
+    const Eigen::Vector2d dir = (b - a).normalized();
+    const auto l = detail::find_collided_length(lengths.begin(), lengths.end(), a, dir, lt);
+    const auto f = detail::find_collided_length(lengths.begin(), lengths.end(), a, dir, ft);
+    BOOST_TEST(std::distance(lengths.begin(), l) == std::distance(lengths.begin(), f));
+
+    const auto nl = detail::nearest_collision(lt, a);
+    const auto nf = detail::nearest_collision(ft, a);
+    BOOST_TEST(nl.has_value() == nf.has_value());
+    if (nl && nf) {
+      BOOST_TEST(detail::obstacle_distance(a, std::get<1>(*nl)) ==
+                 detail::obstacle_distance(a, std::get<1>(*nf)));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(batch_in_region) {
+  boost::random::mt19937 mt{1};
+  boost::random::uniform_real_distribution<> x{-5000.0, 5000.0};
+  boost::random::uniform_real_distribution<> y{-4000.0, 4000.0};
+
+  planner::obstacle_list obs{};
+  for (int i = 0; i < 20; ++i) obs.add(model::obstacle::point{{x(mt), y(mt)}, 200.0});
+  obs.share();
+  for (int i = 0; i < 20; ++i) obs.add(model::obstacle::point{{x(mt), y(mt)}, 200.0});
+  obs.set_field(ai_server::planner::detail::distance_field::make(
+      {model::obstacle::box{{{-106000.0, -1000.0}, {-4800.0, 1000.0}}, 150.0},
+       model::obstacle::box{{{4800.0, -1000.0}, {106000.0, 1000.0}}, 150.0}},
+      {-6000.0, -4500.0}, {6000.0, 4500.0}, 50.0));
+  const auto all = obs.to_batch();
+
+  // distance_field は, その障害物が範囲と重なるときだけ設定する
+  BOOST_TEST(!obs.to_batch({{-1000.0, -1000.0}, {1000.0, 1000.0}}).field());
+  BOOST_TEST((obs.to_batch({{4000.0, -1000.0}, {5000.0, 1000.0}}).field() == obs.field()));
+
+  for (int i = 0; i < 100; ++i) {
+    // 範囲の中の線分は, 全ての障害物を調べたときと同じ結果になる
+    const Eigen::Vector2d c{x(mt), y(mt)};
+    const detail::envelope_type region{c - Eigen::Vector2d{1000.0, 1000.0},
+                                       c + Eigen::Vector2d{1000.0, 1000.0}};
+    const auto batch = obs.to_batch(region);
+    BOOST_TEST(batch.size() <= all.size());
+
+    for (int j = 0; j < 20; ++j) {
+      const Eigen::Vector2d a = c + Eigen::Vector2d{x(mt), y(mt)} / 5.0;
+      const Eigen::Vector2d b = c + Eigen::Vector2d{x(mt), y(mt)} / 5.0;
+      BOOST_TEST(detail::is_collided(segment_type{a, b}, batch) ==
+                 detail::is_collided(segment_type{a, b}, all));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
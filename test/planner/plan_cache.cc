@@ -0,0 +1,187 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/model/field.h"
+#include "ai_server/model/obstacle/field.h"
+#include "ai_server/planner/human_like.h"
+#include "ai_server/planner/obstacle_list.h"
+#include "ai_server/planner/plan_cache.h"
+#include "ai_server/planner/rrt_star.h"
+#include "ai_server/planner/space_time.h"
+
+namespace model   = ai_server::model;
+namespace planner = ai_server::planner;
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(plan_cache)
+
+// 共通の障害物と, 近くにいる敵ロボット
+planner::obstacle_list make_obstacles(const Eigen::Vector2d& enemy) {
+  planner::obstacle_list obs{};
+  obs.add(model::obstacle::point{{-3000.0, 0.0}, 300.0});
+  obs.share();
+  obs.add(model::obstacle::point{enemy, 300.0});
+  return obs;
+}
+
+BOOST_AUTO_TEST_CASE(key) {
+  const planner::plan_cache cache{100ms, 20.0, 500.0};
+  const planner::human_like hl{};
+  BOOST_TEST(cache.resolution() == 20.0);
+  BOOST_TEST((cache.horizon() == 100ms));
+
+  const Eigen::Vector2d start{0.0, 0.0}, goal{1000.0, 0.0};
+  const auto obs = make_obstacles({500.0, 600.0});
+  const auto k   = cache.make_key(start, goal, obs, hl);
+
+  // 量子化の間隔より小さな違いは同じ入力とみなす
+  const auto noisy = make_obstacles({503.0, 598.0});
+  BOOST_TEST((cache.make_key({3.0, -2.0}, {1004.0, 1.0}, noisy, hl) == k));
+
+  // 開始位置, 目標位置, 近くの障害物が動けば違う入力になる
+  BOOST_TEST(!(cache.make_key({50.0, 0.0}, goal, obs, hl) == k));
+  BOOST_TEST(!(cache.make_key(start, {1000.0, 50.0}, obs, hl) == k));
+  BOOST_TEST(!(cache.make_key(start, goal, make_obstacles({600.0, 600.0}), hl) == k));
+
+  // 範囲の外の障害物は含めない
+  const auto far = cache.make_key(start, goal, make_obstacles({500.0, 3000.0}), hl);
+  BOOST_TEST((cache.make_key(start, goal, make_obstacles({600.0, 3000.0}), hl) == far));
+
+  // 障害物を追加した順番によらない
+  planner::obstacle_list a{}, b{};
+  a.add(model::obstacle::point{{100.0, 100.0}, 300.0});
+  a.add(model::obstacle::point{{200.0, -100.0}, 300.0});
+  b.add(model::obstacle::point{{200.0, -100.0}, 300.0});
+  b.add(model::obstacle::point{{100.0, 100.0}, 300.0});
+  BOOST_TEST((cache.make_key(start, goal, a, hl) == cache.make_key(start, goal, b, hl)));
+
+  // 動く障害物は速度も含める
+  planner::obstacle_list m1{}, m2{};
+  m1.add(model::obstacle::moving_point{{500.0, 200.0}, {0.0, 0.0}, 300.0});
+  m2.add(model::obstacle::moving_point{{500.0, 200.0}, {0.0, 1000.0}, 300.0});
+  BOOST_TEST(!(cache.make_key(start, goal, m1, hl) == cache.make_key(start, goal, m2, hl)));
+
+  // distance_field は同じものなら同じ入力になる
+  const model::field field{};
+  const auto penalty = model::obstacle::enemy_penalty_area(field, 150.0);
+  planner::obstacle_list f1{}, f2{};
+  f1.set_field(model::obstacle::static_obstacles(field, {penalty}, 100.0));
+  f2.set_field(model::obstacle::static_obstacles(field, {penalty}, 100.0));
+  BOOST_TEST((cache.make_key(start, goal, f1, hl) == cache.make_key(start, goal, f2, hl)));
+
+  // distance_field のアドレスではなく形状で区別する
+  // (前のものを破棄してから作ると, 同じアドレスが使われることがある)
+  const auto kf = cache.make_key(start, goal, f1, hl);
+  f1.set_field(nullptr);
+  f2.set_field(nullptr);
+  const auto wide = model::obstacle::enemy_penalty_area(field, 300.0);
+  f1.set_field(model::obstacle::static_obstacles(field, {wide}, 100.0));
+  BOOST_TEST(!(cache.make_key(start, goal, f1, hl) == kf));
+  BOOST_TEST(!(cache.make_key(start, goal, f2, hl) == kf));
+
+  // planner の種類や設定が違えば違う入力になる
+  planner::human_like hl32{};
+  hl32.set_direction_count(32);
+  planner::space_time st{};
+  planner::rrt_star rrt{};
+  BOOST_TEST(!(cache.make_key(start, goal, obs, hl32) == k));
+  BOOST_TEST(!(cache.make_key(start, goal, obs, st) == k));
+  BOOST_TEST(!(cache.make_key(start, goal, obs, rrt) == k));
+  BOOST_TEST((cache.make_key(start, goal, obs, planner::human_like{}) == k));
+
+  // space_time の現在の速度は 100 mm/s 単位で区別する
+  const auto ks = cache.make_key(start, goal, obs, st);
+  st.set_velocity({20.0, -30.0});
+  BOOST_TEST((cache.make_key(start, goal, obs, st) == ks));
+  st.set_velocity({500.0, 0.0});
+  BOOST_TEST(!(cache.make_key(start, goal, obs, st) == ks));
+}
+
+BOOST_AUTO_TEST_CASE(find_and_store) {
+  planner::plan_cache cache{100ms};
+  const planner::human_like hl{};
+  const planner::plan_cache::clock_type::time_point t0{1s};
+
+  const Eigen::Vector2d start{0.0, 0.0}, goal{1000.0, 0.0};
+  const auto obs = make_obstacles({500.0, 600.0});
+  const auto k   = cache.make_key(start, goal, obs, hl);
+
+  // 覚えていなければ使えない
+  BOOST_TEST(!cache.find(1, k, start, obs, t0));
+
+  const planner::base::result_type result{{1000.0, 0.0}, 1.0};
+  cache.store(1, k, result, t0);
+
+  // 同じ入力なら有効期間の間は使える
+  for (const auto t : {t0, t0 + 50ms, t0 + 100ms}) {
+    const auto r = cache.find(1, k, start, obs, t);
+    BOOST_TEST(r.has_value());
+    BOOST_TEST(r->first.x() == 1000.0);
+    BOOST_TEST(r->second == 1.0);
+  }
+  BOOST_TEST(!cache.find(1, k, start, obs, t0 + 101ms));
+
+  // ロボットごとに覚える
+  BOOST_TEST(!cache.find(2, k, start, obs, t0));
+
+  // 入力が変われば使えない
+  cache.store(1, k, result, t0);
+  const auto moved = cache.make_key({100.0, 0.0}, goal, obs, hl);
+  BOOST_TEST(!cache.find(1, moved, {100.0, 0.0}, obs, t0));
+
+  // planner の設定が変われば使えない
+  BOOST_TEST(cache.find(1, k, start, obs, t0).has_value());
+  planner::human_like other{};
+  other.set_max_length(2000.0);
+  BOOST_TEST(!cache.find(1, cache.make_key(start, goal, obs, other), start, obs, t0));
+
+  const auto s = cache.stats();
+  BOOST_TEST(s.hits == 4u);
+  BOOST_TEST(s.misses == 5u);
+  BOOST_TEST(s.invalidations == 0u);
+  BOOST_TEST(s.hit_rate() == 4.0 / 9.0);
+
+  const auto rs = cache.robot_stats();
+  BOOST_TEST(rs.at(1).hits == 4u);
+  BOOST_TEST(rs.at(2).misses == 1u);
+
+  cache.clear();
+  BOOST_TEST(cache.stats().hits == 0u);
+  BOOST_TEST(cache.stats().hit_rate() == 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(invalidate_on_collision) {
+  // 範囲を狭くして, ハッシュに含まれない障害物を置けるようにする
+  planner::plan_cache cache{1s, 20.0, 0.0};
+  const planner::human_like hl{};
+  const planner::plan_cache::clock_type::time_point t0{1s};
+
+  const Eigen::Vector2d start{0.0, 0.0}, goal{0.0, 100.0};
+  planner::obstacle_list empty{};
+  const auto k = cache.make_key(start, goal, empty, hl);
+  cache.store(1, k, {{2000.0, 0.0}, 1.0}, t0);
+
+  // 前回の目標位置までの間に障害物があれば破棄する
+  planner::obstacle_list obs{};
+  obs.add(model::obstacle::point{{1000.0, 0.0}, 300.0});
+  BOOST_TEST((cache.make_key(start, goal, obs, hl) == k));
+  BOOST_TEST(!cache.find(1, k, start, obs, t0));
+  BOOST_TEST(cache.stats().invalidations == 1u);
+
+  // 破棄した後は障害物がなくなっても使えない
+  BOOST_TEST(!cache.find(1, k, start, empty, t0));
+
+  // 開始位置が障害物の中にあるときは, 目標位置だけを調べる
+  planner::obstacle_list inside{};
+  inside.add(model::obstacle::point{{0.0, 0.0}, 300.0});
+  const auto ki = cache.make_key(start, goal, inside, hl);
+  cache.store(1, ki, {{0.0, 1000.0}, 1.0}, t0);
+  BOOST_TEST(cache.find(1, ki, start, inside, t0).has_value());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
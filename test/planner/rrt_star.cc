@@ -0,0 +1,157 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+
+#include <Eigen/Core>
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/planner/detail/collision.h"
+#include "ai_server/planner/impl/rrt_star.h"
+#include "ai_server/planner/obstacle_list.h"
+#include "ai_server/planner/rrt_star.h"
+
+namespace model   = ai_server::model;
+namespace planner = ai_server::planner;
+
+namespace {
+
+// start と goal の間の, 上側に隙間のある壁
+planner::obstacle_list make_wall() {
+  planner::obstacle_list obs{};
+  for (int i = -5; i <= 5; ++i) {
+    obs.add(model::obstacle::point{{0.0, -1000.0 + 400.0 * i}, 250.0});
+  }
+  return obs;
+}
+
+planner::impl::rrt_star make_impl(bool reuse) {
+  planner::impl::rrt_star rrt{};
+  rrt.set_max_pos({6000.0, 4500.0});
+  rrt.set_min_pos({-6000.0, -4500.0});
+  rrt.set_node_count(50);
+  rrt.set_max_nodes(200);
+  rrt.set_reuse(reuse);
+  rrt.set_seed(1);
+  return rrt;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(rrt_star)
+
+BOOST_AUTO_TEST_CASE(tree_reuse) {
+  const auto obs = make_wall();
+  const Eigen::Vector2d start{-3000.0, 0.0}, goal{3000.0, 0.0};
+
+  // 再利用しなければ毎回作り直す
+  auto a = make_impl(false);
+  a.execute(start, goal, obs);
+  BOOST_TEST(a.tree_size() == 0u);
+
+  // 再利用すると上限まで増えていく
+  auto b = make_impl(true);
+  b.execute(start, goal, obs);
+  BOOST_TEST(b.tree_size() == 51u);
+  for (int i = 0; i < 10; ++i) b.execute(start, goal, obs);
+  BOOST_TEST(b.tree_size() > 150u);
+  BOOST_TEST(b.tree_size() <= 251u);
+
+  // 目的地の近くでは探索しないので木を捨てる
+  b.execute(goal, goal, obs);
+  BOOST_TEST(b.tree_size() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(repair) {
+  const Eigen::Vector2d start{-3000.0, 0.0}, goal{3000.0, 0.0};
+
+  auto rrt = make_impl(true);
+  for (int i = 0; i < 10; ++i) rrt.execute(start, goal, planner::obstacle_list{});
+  const auto before = rrt.tree_size();
+
+  // 新しく現れた障害物に当たるノードは捨てられる
+  planner::obstacle_list obs{};
+  obs.add(model::obstacle::point{{0.0, 0.0}, 1500.0});
+  const auto [p, _] = rrt.execute(start, goal, obs);
+  BOOST_TEST(rrt.tree_size() < before + 50);
+  BOOST_TEST(!planner::detail::is_collided(p, obs.to_tree()));
+}
+
+BOOST_AUTO_TEST_CASE(reach_goal) {
+  const auto obs = make_wall();
+  const Eigen::Vector2d goal{3000.0, 0.0};
+
+  // 壁を避けて目的地まで進める
+  planner::rrt_star rrt{};
+  rrt.set_max_pos({6000.0, 4500.0});
+  rrt.set_min_pos({-6000.0, -4500.0});
+  rrt.set_node_count(50);
+  rrt.set_seed(1);
+  const auto plan = rrt.planner();
+
+  Eigen::Vector2d pos{-3000.0, 0.0};
+  int cycles = 0;
+  for (; cycles < 400 && (goal - pos).norm() > 50.0; ++cycles) {
+    const Eigen::Vector2d d = std::get<0>(plan(pos, goal, obs)) - pos;
+    if (d.norm() > 0.0) pos += std::min(50.0, d.norm()) * d.normalized();
+    BOOST_TEST(!planner::detail::is_collided(pos, obs.to_tree()));
+  }
+  BOOST_TEST(cycles < 400);
+}
+
+BOOST_AUTO_TEST_CASE(deadline) {
+  const auto obs = make_wall();
+  const Eigen::Vector2d start{-3000.0, 0.0}, goal{3000.0, 0.0};
+
+  // 期限を過ぎていてもノードを 1 つは作る
+  {
+    auto rrt = make_impl(true);
+    rrt.execute(start, goal, obs, std::chrono::steady_clock::now());
+    BOOST_TEST(rrt.tree_size() == 2u);
+  }
+
+  // 次の呼び出しは前回の探索木の続きから探索し, 期限までの時間があればその分ノードが増える
+  // (ノード数の上限で止まるように期限を十分先にして, 実行環境の速さによらない結果にする)
+  {
+    const auto far = [] { return std::chrono::steady_clock::now() + std::chrono::seconds{10}; };
+    auto with_budget    = make_impl(true);
+    auto without_budget = make_impl(true);
+    for (auto* rrt : {&with_budget, &without_budget}) {
+      rrt->set_max_nodes(200);
+      rrt->execute(start, goal, obs, far());
+      BOOST_TEST(rrt->tree_size() == 201u);
+    }
+
+    // 期限を過ぎていれば新しいノードは 1 つだけだが, 前回の探索木は引き継ぐ
+    without_budget.execute(start, goal, obs, std::chrono::steady_clock::now());
+    BOOST_TEST(without_budget.tree_size() > 100u);
+
+    // 繋ぎ直しの結果は同じなので, 期限までの時間で作った分だけ探索木が大きくなる
+    with_budget.execute(start, goal, obs, far());
+    BOOST_TEST(with_budget.tree_size() > 201u);
+    BOOST_TEST(with_budget.tree_size() == without_budget.tree_size() + 199u);
+  }
+
+  // 新しく作るノードは再利用する探索木のノード数の上限まで
+  {
+    auto rrt = make_impl(true);
+    rrt.set_max_nodes(30);
+    rrt.execute(start, goal, obs, std::chrono::steady_clock::now() + std::chrono::seconds{10});
+    BOOST_TEST(rrt.tree_size() == 31u);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(deterministic) {
+  const auto obs = make_wall();
+  const Eigen::Vector2d start{-3000.0, 0.0}, goal{3000.0, 0.0};
+
+  auto a = make_impl(true);
+  auto b = make_impl(true);
+  for (int i = 0; i < 5; ++i) {
+    const auto ra = a.execute(start, goal, obs);
+    const auto rb = b.execute(start, goal, obs);
+    BOOST_TEST(std::get<0>(ra) == std::get<0>(rb));
+    BOOST_TEST(std::get<1>(ra) == std::get<1>(rb));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/planner/obstacle_list.h"
+#include "ai_server/planner/rrt_star.h"
+#include "ai_server/planner/service.h"
+
+namespace model   = ai_server::model;
+namespace planner = ai_server::planner;
+
+namespace {
+
+struct throwing_planner : public planner::base {
+  planner::base::planner_type planner() override {
+    return [](const Eigen::Vector2d&, const Eigen::Vector2d&,
+              const planner::obstacle_list&) -> planner::base::result_type {
+      throw std::runtime_error{"failed"};
+    };
+  }
+};
+
+// ロボットごとの planner と障害物
+struct robots {
+  std::vector<std::unique_ptr<planner::rrt_star>> planners;
+  std::vector<planner::obstacle_list> obstacles;
+
+  explicit robots(unsigned int n) {
+    for (unsigned int i = 0; i < n; ++i) {
+      auto p = std::make_unique<planner::rrt_star>();
+      p->set_max_pos({6000.0, 4500.0});
+      p->set_min_pos({-6000.0, -4500.0});
+      p->set_node_count(50);
+      p->set_seed(i);
+      planners.push_back(std::move(p));
+
+      planner::obstacle_list obs{};
+      for (int j = -3; j <= 3; ++j) {
+        obs.add(model::obstacle::point{{0.0, 100.0 * i + 400.0 * j}, 250.0});
+      }
+      obstacles.push_back(std::move(obs));
+    }
+  }
+
+  std::vector<planner::service::request> requests() {
+    std::vector<planner::service::request> r{};
+    for (unsigned int i = 0; i < planners.size(); ++i) {
+      r.push_back({i + 10,
+                   planners[i].get(),
+                   {-3000.0, 200.0 * i},
+                   {3000.0, -200.0 * i},
+                   &obstacles[i],
+                   std::nullopt});
+    }
+    return r;
+  }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(service)
+
+BOOST_AUTO_TEST_CASE(parallel_matches_serial) {
+  robots a{11}, b{11};
+  planner::service serial{0}, parallel{4};
+  BOOST_TEST(serial.threads() == 0u);
+  BOOST_TEST(parallel.threads() == 4u);
+
+  // 何周期か続けても, 並列に解いた結果は順に解いた結果と一致する
+  for (int c = 0; c < 5; ++c) {
+    const auto rs = serial.solve(a.requests());
+    const auto rp = parallel.solve(b.requests());
+    BOOST_TEST(rs.size() == 11u);
+    BOOST_TEST(rp.size() == 11u);
+    for (std::size_t i = 0; i < rs.size(); ++i) {
+      // 結果は要求を渡した順に並ぶ
+      BOOST_TEST(rs[i].id == i + 10);
+      BOOST_TEST(rp[i].id == i + 10);
+      BOOST_TEST(std::get<0>(rs[i].value) == std::get<0>(rp[i].value));
+      BOOST_TEST(std::get<1>(rs[i].value) == std::get<1>(rp[i].value));
+      BOOST_TEST(rp[i].time.count() > 0);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(exception) {
+  robots a{3};
+  throwing_planner t{};
+  auto requests       = a.requests();
+  requests[1].planner = &t;
+
+  // 他の要求を解き終えてから例外を投げ直す
+  planner::service s{2};
+  BOOST_CHECK_THROW(s.solve(requests), std::runtime_error);
+
+  // 空の要求
+  BOOST_TEST(s.solve({}).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,103 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <initializer_list>
+#include <vector>
+
+#include <boost/random.hpp>
+#include <boost/test/unit_test.hpp>
+#include <Eigen/Core>
+
+#include "ai_server/planner/detail/space_time.h"
+#include "ai_server/planner/human_like.h"
+#include "ai_server/planner/obstacle_list.h"
+#include "ai_server/planner/space_time.h"
+
+namespace model   = ai_server::model;
+namespace planner = ai_server::planner;
+namespace detail  = ai_server::planner::detail;
+namespace tt      = boost::test_tools;
+
+BOOST_AUTO_TEST_SUITE(space_time)
+
+BOOST_AUTO_TEST_CASE(arrival_time) {
+  const detail::obstacle_batch statics{};
+  const std::vector<model::obstacle::moving_point> moving{};
+  detail::space_time_obstacles<detail::obstacle_batch> o{
+      statics, moving, {0.0, 0.0}, {0.0, 0.0}, 3000.0, 3000.0, 1.5};
+
+  // 止まっているとき: 1500mm で最大速度に達する
+  BOOST_TEST(o.arrival_time({0.0, 0.0}) == 0.0);
+  BOOST_TEST(o.arrival_time({1500.0, 0.0}) == 1.0, tt::tolerance(1e-9));
+  BOOST_TEST(o.arrival_time({0.0, -3000.0}) == 1.5, tt::tolerance(1e-9));
+
+  // 進む方向の速度成分だけを使う
+  o.velocity = {3000.0, 0.0};
+  BOOST_TEST(o.arrival_time({1500.0, 0.0}) == 0.5, tt::tolerance(1e-9));
+  BOOST_TEST(o.arrival_time({0.0, 1500.0}) == 1.0, tt::tolerance(1e-9));
+  BOOST_TEST(o.arrival_time({-1500.0, 0.0}) == 1.0, tt::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(moving_obstacles) {
+  const Eigen::Vector2d start{0.0, 0.0};
+  const Eigen::Vector2d goal{3000.0, 0.0};
+
+  planner::space_time st{};
+  st.set_max_velocity(3000.0);
+  st.set_max_acceleration(3000.0);
+
+  {
+    // 経路上にいるが, 着く前に離れていく
+    planner::obstacle_list obs{};
+    obs.add(model::obstacle::moving_point{{1500.0, 0.0}, {0.0, 3000.0}, 300.0});
+    const auto target = st.planner()(start, goal, obs).first;
+    BOOST_TEST(target.x() == goal.x());
+    BOOST_TEST(target.y() == goal.y());
+
+    // 同じ位置に止まっている障害物は避ける
+    planner::obstacle_list still{};
+    still.add(model::obstacle::point{{1500.0, 0.0}, 300.0});
+    const auto t = st.planner()(start, goal, still).first;
+    BOOST_TEST(!(t.x() == goal.x() && t.y() == goal.y()));
+  }
+
+  {
+    // 今は経路上にいないが, 着く頃に経路上に来る (止まった状態から 1500mm 進むのに 1s)
+    planner::obstacle_list obs{};
+    obs.add(model::obstacle::moving_point{{1500.0, -2000.0}, {0.0, 2000.0}, 300.0});
+    const auto target = st.planner()(start, goal, obs).first;
+    BOOST_TEST(!(target.x() == goal.x() && target.y() == goal.y()));
+
+    // 既に速く動いていれば, 障害物が来る前に通り過ぎる
+    st.set_velocity({3000.0, 0.0});
+    const auto t = st.planner()(start, goal, obs).first;
+    BOOST_TEST(t.x() == goal.x());
+    BOOST_TEST(t.y() == goal.y());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(same_as_human_like) {
+  boost::random::mt19937 mt{1};
+  boost::random::uniform_real_distribution<> x{-5000.0, 5000.0};
+  boost::random::uniform_real_distribution<> y{-4000.0, 4000.0};
+
+  planner::human_like hl{};
+  planner::space_time st{};
+  for (planner::base* p : std::initializer_list<planner::base*>{&hl, &st}) {
+    p->set_min_pos({-6000.0, -4500.0});
+    p->set_max_pos({6000.0, 4500.0});
+  }
+
+  // 動く障害物がなければ human_like と同じ
+  for (int i = 0; i < 100; ++i) {
+    planner::obstacle_list obs{};
+    for (int j = 0; j < 20; ++j) obs.add(model::obstacle::point{{x(mt), y(mt)}, 300.0});
+    const Eigen::Vector2d start{x(mt), y(mt)}, goal{x(mt), y(mt)};
+
+    const auto h = hl.planner()(start, goal, obs).first;
+    const auto s = st.planner()(start, goal, obs).first;
+    BOOST_TEST(h.x() == s.x(), tt::tolerance(1e-9));
+    BOOST_TEST(h.y() == s.y(), tt::tolerance(1e-9));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
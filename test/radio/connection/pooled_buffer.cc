@@ -0,0 +1,69 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/radio/connection/pooled_buffer.h"
+
+namespace connection = ai_server::radio::connection;
+
+BOOST_AUTO_TEST_SUITE(pooled_buffer)
+
+BOOST_AUTO_TEST_CASE(acquire_and_release) {
+  connection::buffer_pool<8, 2> pool{};
+
+  auto b1 = pool.acquire();
+  auto b2 = pool.acquire();
+  BOOST_TEST(static_cast<bool>(b1));
+  BOOST_TEST(static_cast<bool>(b2));
+  BOOST_TEST(b1.data() != b2.data());
+  BOOST_TEST(b1.capacity() == 8);
+  BOOST_TEST(b1.size() == 0);
+
+  // 全て貸し出されていれば空の pooled_buffer が返る
+  {
+    const auto b3 = pool.acquire();
+    BOOST_TEST(!b3);
+    BOOST_TEST(b3.capacity() == 0);
+  }
+
+  // 大きさは capacity() を超えない
+  b1.resize(5);
+  BOOST_TEST(b1.size() == 5);
+  b1.resize(100);
+  BOOST_TEST(b1.size() == 8);
+
+  // ムーブしても領域は返されない
+  const auto p = b1.data();
+  auto b4      = std::move(b1);
+  BOOST_TEST(!b1);
+  BOOST_TEST(b4.data() == p);
+  BOOST_TEST(!pool.acquire());
+
+  // 破棄すると領域が返される
+  b4 = connection::pooled_buffer{};
+  auto b5 = pool.acquire();
+  BOOST_TEST(static_cast<bool>(b5));
+  BOOST_TEST(b5.data() == p);
+}
+
+BOOST_AUTO_TEST_CASE(release_from_other_thread) {
+  connection::buffer_pool<4, 4> pool{};
+
+  // 別のスレッドで破棄された領域を再び借りられる
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<connection::pooled_buffer> buffers{};
+    for (int j = 0; j < 4; ++j) buffers.push_back(pool.acquire());
+    for (const auto& b : buffers) BOOST_TEST(static_cast<bool>(b));
+    BOOST_TEST(!pool.acquire());
+
+    std::thread th{[buffers = std::move(buffers)]() mutable { buffers.clear(); }};
+    th.join();
+  }
+  BOOST_TEST(static_cast<bool>(pool.acquire()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,10 +2,14 @@
 
 #include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
 #include <memory>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 #include <stdexcept>
 
 #include <boost/asio.hpp>
@@ -55,6 +59,12 @@ public:
   }
 };
 
+// 受信した時点では送信完了の処理が終わっていないことがあるので, 送信数が n になるまで少し待つ
+template <class Connection>
+static void wait_for_messages(const Connection& c, std::uint64_t n) {
+  for (int i = 0; i < 100 && c.total_messages() < n; ++i) std::this_thread::sleep_for(1ms);
+}
+
 BOOST_AUTO_TEST_SUITE(serial)
 
 BOOST_AUTO_TEST_CASE(send, *boost::unit_test::timeout(30)) {
@@ -83,6 +93,7 @@ BOOST_AUTO_TEST_CASE(send, *boost::unit_test::timeout(30)) {
     BOOST_TEST((std::string{buf.cbegin(), buf.cbegin() + len}) == "Hello"s);
 
     // 値が更新されているか
+    wait_for_messages(tx, 1);
     BOOST_TEST(tx.total_messages() == 1);
     BOOST_TEST(tx.total_errors() == 0);
     BOOST_TEST((std::chrono::system_clock::now() - tx.last_sent() < 1s));
@@ -100,6 +111,7 @@ BOOST_AUTO_TEST_CASE(send, *boost::unit_test::timeout(30)) {
                boost::test_tools::per_element());
 
     // 値が更新されているか
+    wait_for_messages(tx, 2);
     BOOST_TEST(tx.total_messages() == 2);
     BOOST_TEST(tx.total_errors() == 0);
     BOOST_TEST((std::chrono::system_clock::now() - tx.last_sent() < 1s));
@@ -111,4 +123,77 @@ BOOST_AUTO_TEST_CASE(send, *boost::unit_test::timeout(30)) {
   BOOST_TEST(tx.messages_per_second() == 2);
 }
 
+BOOST_AUTO_TEST_CASE(coalesce_and_drop, *boost::unit_test::timeout(30)) {
+  auto [master, slave] = pty::openpty();
+
+  boost::asio::io_context ctx1{};
+  radio::connection::serial tx{ctx1, slave.name()};
+  auto th = run_io_context_in_new_thread(ctx1);
+
+  BOOST_TEST(tx.queue_depth() == 0);
+  BOOST_TEST(tx.total_drops() == 0);
+
+  // 読み出さずに大量のフレームを送り, 書き込みを詰まらせる
+  constexpr int n = 5000;
+  for (int i = 0; i < n; ++i) {
+    std::vector<std::uint8_t> frame(11, static_cast<std::uint8_t>(i & 0xff));
+    frame[0] = static_cast<std::uint8_t>(i >> 8);
+    frame[9]  = '\r';
+    frame[10] = '\n';
+    tx.send(std::move(frame));
+  }
+
+  // 列の長さは制限され, 古いものから捨てられる
+  // (send() は io_context に処理を post するだけで, 統計は待たずに読むので,
+  //  捨てたフレームが数えられるまで待つ)
+  for (int i = 0; i < 1000 && tx.total_drops() == 0; ++i) std::this_thread::sleep_for(1ms);
+  BOOST_TEST(tx.total_drops() > 0);
+  BOOST_TEST(tx.queue_depth() <= radio::connection::serial::queue_capacity);
+
+  // 全て読み出す (最後に送ったフレームが届くまで読む)
+  boost::asio::io_context ctx2{};
+  boost::asio::posix::stream_descriptor rx{ctx2, master.fd()};
+  std::vector<std::uint8_t> received{};
+  std::array<std::uint8_t, 4096> buf{};
+  const auto last_byte = static_cast<std::uint8_t>((n - 1) & 0xff);
+  while (received.size() < 11 || received[received.size() - 11] != ((n - 1) >> 8) ||
+         received[received.size() - 10] != last_byte) {
+    const auto len = rx.read_some(boost::asio::buffer(buf));
+    received.insert(received.end(), buf.cbegin(), buf.cbegin() + len);
+  }
+
+  // フレームは途中で混ざったり切れたりせず, 送った順に届く
+  BOOST_TEST(received.size() % 11 == 0);
+  int prev = -1;
+  for (std::size_t i = 0; i < received.size(); i += 11) {
+    const auto id = (received[i] << 8) | received[i + 1];
+    BOOST_TEST(received[i + 9] == '\r');
+    BOOST_TEST(received[i + 10] == '\n');
+    BOOST_TEST(id > prev);
+    prev = id;
+  }
+
+  // 送ったフレームは送信されたか捨てられたかのどちらか
+  wait_for_messages(tx, n - tx.total_drops());
+  BOOST_TEST(tx.total_messages() + tx.total_drops() == n);
+  BOOST_TEST(tx.total_messages() == received.size() / 11);
+  BOOST_TEST(tx.queue_depth() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(destroy_while_running, *boost::unit_test::timeout(30)) {
+  auto [master, slave] = pty::openpty();
+
+  boost::asio::io_context ctx{};
+  auto tx = std::make_unique<radio::connection::serial>(ctx, slave.name());
+  // 仕事がなくなると run() は返る
+  auto f = std::async(std::launch::async, [&ctx] { return ctx.run(); });
+
+  tx->send("Hello\r\n"s);
+  wait_for_messages(*tx, 1);
+
+  // 破棄するとコルーチンが終了し, io_context の仕事がなくなる
+  tx.reset();
+  BOOST_TEST((f.wait_for(5s) == std::future_status::ready));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,7 +1,11 @@
 #define BOOST_TEST_DYN_LINK
 
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
 #include <string>
 #include <thread>
 
@@ -17,6 +21,12 @@ namespace radio = ai_server::radio;
 using namespace std::string_literals;
 using namespace std::chrono_literals;
 
+// 受信した時点では送信完了の処理が終わっていないことがあるので, 送信数が n になるまで少し待つ
+template <class Connection>
+static void wait_for_messages(const Connection& c, std::uint64_t n) {
+  for (int i = 0; i < 100 && c.total_messages() < n; ++i) std::this_thread::sleep_for(1ms);
+}
+
 BOOST_AUTO_TEST_SUITE(udp)
 
 BOOST_AUTO_TEST_CASE(send, *boost::unit_test::timeout(30)) {
@@ -47,6 +57,7 @@ BOOST_AUTO_TEST_CASE(send, *boost::unit_test::timeout(30)) {
     BOOST_TEST((std::string{buf.cbegin(), buf.cbegin() + len}) == "Hello"s);
 
     // 値が更新されているか
+    wait_for_messages(tx, 1);
     BOOST_TEST(tx.total_messages() == 1);
     BOOST_TEST(tx.total_errors() == 0);
     BOOST_TEST((std::chrono::system_clock::now() - tx.last_sent() < 1s));
@@ -65,6 +76,7 @@ BOOST_AUTO_TEST_CASE(send, *boost::unit_test::timeout(30)) {
                boost::test_tools::per_element());
 
     // 値が更新されているか
+    wait_for_messages(tx, 2);
     BOOST_TEST(tx.total_messages() == 2);
     BOOST_TEST(tx.total_errors() == 0);
     BOOST_TEST((std::chrono::system_clock::now() - tx.last_sent() < 1s));
@@ -76,4 +88,82 @@ BOOST_AUTO_TEST_CASE(send, *boost::unit_test::timeout(30)) {
   BOOST_TEST(tx.messages_per_second() == 2);
 }
 
+BOOST_AUTO_TEST_CASE(send_pooled_buffer, *boost::unit_test::timeout(30)) {
+  boost::asio::io_context ctx1{};
+
+  constexpr unsigned short port = 31338;
+
+  radio::connection::udp tx{ctx1, {boost::asio::ip::udp::v4(), port}};
+  auto th = run_io_context_in_new_thread(ctx1);
+
+  boost::asio::io_context ctx2{};
+  boost::asio::ip::udp::socket rx{ctx2, {boost::asio::ip::udp::v4(), port}};
+
+  std::array<char, 4096> buf{};
+
+  // 領域は 1 つしかない
+  radio::connection::buffer_pool<16, 1> pool{};
+
+  {
+    auto b = pool.acquire();
+    BOOST_TEST(static_cast<bool>(b));
+    const auto s = "Hello"s;
+    std::copy(s.cbegin(), s.cend(), b.data());
+    b.resize(s.size());
+
+    tx.send(std::move(b));
+
+    boost::asio::ip::udp::endpoint e{};
+    auto len = rx.receive_from(boost::asio::buffer(buf), e);
+
+    // send したものと同じか
+    BOOST_TEST((std::string{buf.cbegin(), buf.cbegin() + len}) == "Hello"s);
+
+    wait_for_messages(tx, 1);
+    BOOST_TEST(tx.total_messages() == 1);
+    BOOST_TEST(tx.total_errors() == 0);
+  }
+
+  // 送信が終わると領域は返される
+  BOOST_TEST(static_cast<bool>(pool.acquire()));
+}
+
+BOOST_AUTO_TEST_CASE(stats_from_handler, *boost::unit_test::timeout(30)) {
+  boost::asio::io_context ctx{};
+  radio::connection::udp tx{ctx, {boost::asio::ip::udp::v4(), 31339}};
+  auto th = run_io_context_in_new_thread(ctx);
+
+  tx.send("Hello"s);
+  wait_for_messages(tx, 1);
+
+  // io_context の中から呼び出しても待たずに値が返る
+  std::promise<std::uint64_t> p{};
+  auto f = p.get_future();
+  boost::asio::post(ctx, [&tx, &p] {
+    tx.messages_per_second();
+    tx.total_errors();
+    tx.queue_depth();
+    tx.total_drops();
+    tx.last_sent();
+    p.set_value(tx.total_messages());
+  });
+  BOOST_TEST((f.wait_for(5s) == std::future_status::ready));
+  BOOST_TEST(f.get() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(destroy_while_running, *boost::unit_test::timeout(30)) {
+  boost::asio::io_context ctx{};
+  auto tx = std::make_unique<radio::connection::udp>(
+      ctx, boost::asio::ip::udp::endpoint{boost::asio::ip::udp::v4(), 31340});
+  // 仕事がなくなると run() は返る
+  auto f = std::async(std::launch::async, [&ctx] { return ctx.run(); });
+
+  tx->send("Hello"s);
+  wait_for_messages(*tx, 1);
+
+  // 破棄するとコルーチンが終了し, io_context の仕事がなくなる
+  tx.reset();
+  BOOST_TEST((f.wait_for(5s) == std::future_status::ready));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,39 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/radio/detail/kiks_frame.h"
+
+namespace model  = ai_server::model;
+namespace detail = ai_server::radio::detail;
+
+BOOST_AUTO_TEST_SUITE(kiks_frame)
+
+// フレームの組み立てはコンパイル時に確かめられる
+constexpr auto f1 = detail::make_kiks_frame(1, model::command::kick_type_t::line, 3, 2, 0x1234,
+                                            0x5678, 1000, true);
+static_assert(f1[0] == 0b10110010);
+static_assert(f1[1] == 0x12 && f1[2] == 0x34);
+static_assert(f1[3] == 0x56 && f1[4] == 0x78);
+static_assert(f1[5] == (1000 >> 8) && f1[6] == (1000 & 0xff));
+static_assert(f1[7] == 2 + 3 && f1[8] == 3);
+static_assert(f1[9] == '\r' && f1[10] == '\n');
+
+constexpr auto f2 =
+    detail::make_kiks_frame(15, model::command::kick_type_t::chip, 0, -5, 0, 0, 0, false);
+static_assert(f2[0] == 0b00100000);
+static_assert(f2[7] == 2);
+
+BOOST_AUTO_TEST_CASE(encode) {
+  detail::kiks_frame f{};
+  detail::encode_kiks_frame(f.data(), 1, {model::command::kick_type_t::backspin, 4}, 2, 0, 1000,
+                            -1);
+
+  // 量子化した値を pack_kiks_frame() に渡したものと一致する
+  // (+y 方向は 0 から 2pi のうち pi に対応する)
+  const auto expected = detail::make_kiks_frame(1, model::command::kick_type_t::backspin, 4, 2,
+                                                1000, 0xffff / 2, 1000, true);
+  BOOST_TEST(f == expected, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
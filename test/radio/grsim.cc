@@ -1,5 +1,7 @@
 #define BOOST_TEST_DYN_LINK
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -18,8 +20,10 @@ BOOST_AUTO_TEST_SUITE(grsim)
 
 struct mock_connection {
   std::optional<std::string> last_value;
+  std::size_t count = 0;
   void send(std::string value) {
     last_value = std::move(value);
+    ++count;
   }
 };
 
@@ -123,6 +127,91 @@ BOOST_AUTO_TEST_CASE(send_command) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(stage_command) {
+  auto c   = std::make_unique<mock_connection>();
+  auto& rc = *c;
+  radio::grsim g{std::move(c)};
+
+  // 命令は flush() まで送信されない
+  g.begin_cycle(model::team_color::yellow);
+  for (unsigned int id = 0; id < 3; ++id) {
+    g.stage(model::team_color::yellow, id, {model::command::kick_type_t::none, 0}, 0, 100.0 * id,
+            0, 0);
+  }
+  BOOST_TEST(rc.count == 0);
+
+  // 全てのロボットへの命令が 1 つの Packet にまとめて送信される
+  g.flush();
+  {
+    BOOST_TEST(rc.count == 1);
+
+    ssl_protos::grsim::Packet p{};
+    BOOST_TEST(p.ParseFromString(rc.last_value.value()));
+
+    const auto& pc = p.commands();
+    BOOST_TEST(pc.isteamyellow());
+
+    const auto& pcc = pc.robot_commands();
+    BOOST_TEST(pcc.size() == 3);
+    for (int i = 0; i < 3; ++i) BOOST_TEST(pcc[i].id() == i);
+  }
+
+  // 送信済みの命令は次のサイクルに持ち越されない
+  g.begin_cycle(model::team_color::blue);
+  g.stage(model::team_color::blue, 4, {model::command::kick_type_t::none, 0}, 0, 0, 0, 0);
+  g.flush();
+  {
+    BOOST_TEST(rc.count == 2);
+
+    ssl_protos::grsim::Packet p{};
+    BOOST_TEST(p.ParseFromString(rc.last_value.value()));
+    BOOST_TEST(!p.commands().isteamyellow());
+    BOOST_TEST(p.commands().robot_commands_size() == 1);
+    BOOST_TEST(p.commands().robot_commands(0).id() == 4);
+  }
+
+  // 命令がなければ何も送信しない
+  g.begin_cycle(model::team_color::blue);
+  g.flush();
+  BOOST_TEST(rc.count == 2);
+}
+
+BOOST_AUTO_TEST_CASE(stage_benchmark) {
+  using namespace std::chrono;
+  constexpr unsigned int robots = 11;
+  constexpr int cycles          = 2000;
+  const model::command::kick_flag_t kick{model::command::kick_type_t::none, 0};
+
+  radio::grsim g{std::make_unique<mock_connection>()};
+
+  // 1 台ずつ送信する場合
+  const auto t0 = steady_clock::now();
+  for (int i = 0; i < cycles; ++i) {
+    for (unsigned int id = 0; id < robots; ++id) {
+      g.send(model::team_color::blue, id, kick, 0, 1000, 500, 1);
+    }
+  }
+
+  // 1 サイクル分をまとめて送信する場合
+  const auto t1 = steady_clock::now();
+  for (int i = 0; i < cycles; ++i) {
+    g.begin_cycle(model::team_color::blue);
+    for (unsigned int id = 0; id < robots; ++id) {
+      g.stage(model::team_color::blue, id, kick, 0, 1000, 500, 1);
+    }
+    g.flush();
+  }
+  const auto t2 = steady_clock::now();
+
+  const auto per_robot = duration<double, std::micro>(t1 - t0).count() / cycles;
+  const auto batched   = duration<double, std::micro>(t2 - t1).count() / cycles;
+  BOOST_TEST_MESSAGE("send per robot: " << per_robot << " us/cycle");
+  BOOST_TEST_MESSAGE("staged:         " << batched << " us/cycle");
+
+  BOOST_TEST(batched < per_robot);
+  BOOST_TEST(g.connection().count == robots * cycles + cycles);
+}
+
 BOOST_AUTO_TEST_CASE(replacement_ball) {
   auto c   = std::make_unique<mock_connection>();
   auto& rc = *c;
@@ -1,12 +1,40 @@
 #define BOOST_TEST_DYN_LINK
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
+#include <new>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
 #include "ai_server/radio/kiks.h"
+#include "ai_server/radio/link_monitor.h"
+
+// 送信の際に動的なメモリ確保が行われないことを確かめるために, 確保の回数を数える
+static std::size_t allocation_count = 0;
+
+void* operator new(std::size_t size) {
+  ++allocation_count;
+  if (auto p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc{};
+}
+
+// operator new を置き換えているので, malloc した領域を free するのは正しい
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+#pragma GCC diagnostic pop
 
 namespace model = ai_server::model;
 namespace radio = ai_server::radio;
@@ -18,6 +46,9 @@ struct mock_connection {
   void send(std::vector<std::uint8_t> value) {
     last_value = std::move(value);
   }
+  void send(radio::connection::pooled_buffer value) {
+    last_value.emplace(value.data(), value.data() + value.size());
+  }
 };
 
 BOOST_AUTO_TEST_CASE(send_command) {
@@ -89,4 +120,112 @@ BOOST_AUTO_TEST_CASE(send_command) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(stage_command) {
+  auto c   = std::make_unique<mock_connection>();
+  auto& rc = *c;
+  radio::kiks k{std::move(c)};
+
+  const model::command::kick_flag_t kick{model::command::kick_type_t::line, 3};
+
+  // 1 台ずつ送信したときのフレーム
+  std::vector<std::uint8_t> expected{};
+  for (unsigned int id = 0; id < 3; ++id) {
+    k.send(model::team_color::yellow, id, kick, 2, 100.0 * id, 0, 0.5);
+    const auto& v = rc.last_value.value();
+    expected.insert(expected.end(), v.cbegin(), v.cend());
+  }
+  rc.last_value.reset();
+
+  // 命令は flush() まで送信されない
+  k.begin_cycle(model::team_color::yellow);
+  for (unsigned int id = 0; id < 3; ++id) {
+    k.stage(model::team_color::yellow, id, kick, 2, 100.0 * id, 0, 0.5);
+  }
+  BOOST_TEST(!rc.last_value.has_value());
+
+  // 各ロボットへのフレームを連結したものが 1 回で送信される
+  k.flush();
+  BOOST_TEST(rc.last_value.has_value());
+  BOOST_TEST(rc.last_value->size() == 33);
+  BOOST_TEST(*rc.last_value == expected, boost::test_tools::per_element());
+
+  // 命令がなければ何も送信しない
+  rc.last_value.reset();
+  k.begin_cycle(model::team_color::yellow);
+  k.flush();
+  BOOST_TEST(!rc.last_value.has_value());
+}
+
+BOOST_AUTO_TEST_CASE(protocol_v2) {
+  auto c   = std::make_unique<mock_connection>();
+  auto& rc = *c;
+  radio::kiks k{std::move(c)};
+
+  auto monitor = std::make_shared<radio::link_monitor>();
+  k.set_protocol(radio::kiks_protocol::v2);
+  k.set_link_monitor(monitor);
+
+  const model::command::kick_flag_t kick{model::command::kick_type_t::line, 3};
+
+  // 終端の前にロボットごとの通し番号が入る
+  for (int i = 0; i < 3; ++i) {
+    k.send(model::team_color::yellow, 2, kick, 2, 0, 0, 0);
+    const auto& v = rc.last_value.value();
+    BOOST_TEST(v.size() == 12);
+    BOOST_TEST(v[0] == 0b00110011);
+    BOOST_TEST(v[9] == i);
+    BOOST_TEST(v[10] == '\r');
+    BOOST_TEST(v[11] == '\n');
+  }
+
+  k.begin_cycle(model::team_color::yellow);
+  k.stage(model::team_color::yellow, 2, kick, 2, 0, 0, 0);
+  k.stage(model::team_color::yellow, 5, kick, 2, 0, 0, 0);
+  k.flush();
+  {
+    const auto& v = rc.last_value.value();
+    BOOST_TEST(v.size() == 24);
+    BOOST_TEST(v[9] == 3);
+    BOOST_TEST(v[12 + 9] == 0);
+  }
+
+  // 送信したフレームは link_monitor に記録され, 応答と照合できる
+  const auto now = radio::link_monitor::clock_type::now();
+  BOOST_TEST(monitor->robot_stats(2, now).sent == 4);
+  BOOST_TEST(monitor->robot_stats(5, now).sent == 1);
+  BOOST_TEST(monitor->handle_feedback({3, 1}, now + std::chrono::seconds{1}));
+  BOOST_TEST(monitor->robot_stats(2, now).acked == 1);
+}
+
+BOOST_AUTO_TEST_CASE(allocation_free) {
+  // 受け取った領域をすぐに返す Connection
+  struct counting_connection {
+    std::size_t pooled   = 0;
+    std::size_t fallback = 0;
+    void send(std::vector<std::uint8_t>) {
+      ++fallback;
+    }
+    void send(radio::connection::pooled_buffer) {
+      ++pooled;
+    }
+  };
+
+  radio::kiks k{std::make_unique<counting_connection>()};
+  const model::command::kick_flag_t kick{model::command::kick_type_t::line, 3};
+
+  const auto before = allocation_count;
+  for (int i = 0; i < 100; ++i) {
+    k.send(model::team_color::yellow, 1, kick, 2, 1000, 500, 1);
+
+    k.begin_cycle(model::team_color::yellow);
+    for (unsigned int id = 0; id < 11; ++id) {
+      k.stage(model::team_color::yellow, id, kick, 2, 1000, 500, 1);
+    }
+    k.flush();
+  }
+  BOOST_TEST(allocation_count == before);
+  BOOST_TEST(k.connection().pooled == 200);
+  BOOST_TEST(k.connection().fallback == 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/radio/link_monitor.h"
+
+namespace radio = ai_server::radio;
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(link_monitor)
+
+BOOST_AUTO_TEST_CASE(round_trip) {
+  radio::link_monitor m{100ms};
+  const auto t0 = radio::link_monitor::time_point{} + 1s;
+
+  // 応答がなければ往復時間は分からない
+  {
+    const auto s = m.robot_stats(1, t0);
+    BOOST_TEST(s.sent == 0);
+    BOOST_TEST(s.acked == 0);
+    BOOST_TEST(!s.mean_rtt.has_value());
+    BOOST_TEST(!s.last_ack_age.has_value());
+    BOOST_TEST(s.loss_rate == 0.0);
+  }
+
+  m.sent(1, 10, t0);
+  m.sent(1, 11, t0 + 5ms);
+  BOOST_TEST(m.acked(1, 10, t0 + 3ms));
+  BOOST_TEST(m.acked(1, 11, t0 + 12ms));
+
+  // 同じフレームへの応答, 送信していないフレームへの応答は無視する
+  BOOST_TEST(!m.acked(1, 10, t0 + 20ms));
+  BOOST_TEST(!m.acked(1, 12, t0 + 20ms));
+  BOOST_TEST(!m.acked(2, 10, t0 + 20ms));
+  BOOST_TEST(!m.acked(100, 10, t0 + 20ms));
+
+  const auto s = m.robot_stats(1, t0 + 50ms);
+  BOOST_TEST(s.sent == 2);
+  BOOST_TEST(s.acked == 2);
+  BOOST_TEST((s.mean_rtt == 5ms));
+  BOOST_TEST((s.last_ack_age == 38ms));
+  // 3ms は 2 番目, 7ms は 4 番目のビン
+  BOOST_TEST(s.rtt_histogram[1] == 1);
+  BOOST_TEST(s.rtt_histogram[3] == 1);
+
+  // 他のロボットには影響しない
+  BOOST_TEST(m.robot_stats(2, t0 + 50ms).sent == 0);
+}
+
+BOOST_AUTO_TEST_CASE(loss_rate) {
+  radio::link_monitor m{100ms};
+  const auto t0 = radio::link_monitor::time_point{} + 1s;
+
+  // 10 フレームのうち 3 フレームには応答がない
+  for (std::uint8_t i = 0; i < 10; ++i) {
+    m.sent(3, i, t0 + i * 1ms);
+    if (i % 3 != 0 || i == 9) m.acked(3, i, t0 + i * 1ms + 2ms);
+  }
+
+  // 応答を待っている間は失われたとみなさない
+  BOOST_TEST(m.robot_stats(3, t0 + 50ms).loss_rate == 0.0);
+  BOOST_TEST(m.robot_stats(3, t0 + 200ms).loss_rate == 0.3, boost::test_tools::tolerance(1e-9));
+
+  // 遅れて届いた応答も往復時間に数える (最後のビンに入る)
+  BOOST_TEST(m.acked(3, 0, t0 + 150ms));
+  const auto s = m.robot_stats(3, t0 + 200ms);
+  BOOST_TEST(s.loss_rate == 0.2, boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(s.rtt_histogram.back() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(feedback) {
+  radio::link_monitor m{};
+  const auto t0 = radio::link_monitor::time_point{} + 1s;
+
+  m.sent(4, 200, t0);
+
+  // [ID + 1, 通し番号] の形式の応答を解釈する
+  BOOST_TEST(!m.handle_feedback({}, t0 + 1ms));
+  BOOST_TEST(!m.handle_feedback({0, 200}, t0 + 1ms));
+  BOOST_TEST(!m.handle_feedback({5}, t0 + 1ms));
+  BOOST_TEST(m.handle_feedback({5, 200, 0xff}, t0 + 4ms));
+  BOOST_TEST((m.robot_stats(4, t0 + 4ms).mean_rtt == 4ms));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,185 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/radio/link_monitor.h"
+#include "ai_server/radio/multi_channel.h"
+
+namespace model = ai_server::model;
+namespace radio = ai_server::radio;
+
+BOOST_AUTO_TEST_SUITE(multi_channel)
+
+struct mock_connection {
+  std::vector<std::vector<std::uint8_t>> values;
+  void send(std::vector<std::uint8_t> value) {
+    values.push_back(std::move(value));
+  }
+  void send(radio::connection::pooled_buffer value) {
+    values.emplace_back(value.data(), value.data() + value.size());
+  }
+};
+
+using radio_type = radio::multi_channel<mock_connection>;
+
+// 3 チャネルの Radio を作る
+static radio_type make_radio() {
+  std::vector<std::unique_ptr<mock_connection>> connections{};
+  for (int i = 0; i < 3; ++i) connections.push_back(std::make_unique<mock_connection>());
+  return radio_type{std::move(connections)};
+}
+
+static const model::command::kick_flag_t kick{model::command::kick_type_t::none, 0};
+
+BOOST_AUTO_TEST_CASE(construct) {
+  BOOST_CHECK_THROW(radio_type{{}}, std::invalid_argument);
+
+  auto r = make_radio();
+  BOOST_TEST(r.channels() == 3);
+  BOOST_CHECK_THROW(r.assign(0, 3), std::out_of_range);
+  BOOST_CHECK_THROW(r.assign(0, 0, 3), std::out_of_range);
+
+  // 範囲外の ID はどの関数でも扱わない
+  BOOST_CHECK_THROW(r.assign(16, 0), std::out_of_range);
+  BOOST_CHECK_THROW(r.unassign(16), std::out_of_range);
+  BOOST_CHECK_THROW(r.channel_of(16), std::out_of_range);
+  BOOST_CHECK_THROW(r.send(model::team_color::blue, 16, kick, 0, 0, 0, 0), std::out_of_range);
+  BOOST_CHECK_THROW(r.stage(model::team_color::blue, 16, kick, 0, 0, 0, 0), std::out_of_range);
+  BOOST_TEST(!r.channel_of(0).has_value());
+  for (std::size_t c = 0; c < 3; ++c) BOOST_TEST(r.stats(c).frames == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(assignment) {
+  auto r = make_radio();
+  r.assign(0, 2);
+  r.assign(1, 2);
+
+  r.begin_cycle(model::team_color::blue);
+  for (unsigned int id = 0; id < 5; ++id) {
+    r.stage(model::team_color::blue, id, kick, 0, 0, 0, 0);
+  }
+  r.flush();
+
+  // 固定したロボットは指定したチャネルに, それ以外は送信量の少ないチャネルに振り分けられる
+  BOOST_TEST(*r.channel_of(0) == 2);
+  BOOST_TEST(*r.channel_of(1) == 2);
+  BOOST_TEST(*r.channel_of(2) == 0);
+  BOOST_TEST(*r.channel_of(3) == 1);
+  BOOST_TEST(*r.channel_of(4) == 0);
+  BOOST_TEST(!r.channel_of(5).has_value());
+
+  // チャネルごとに 1 回ずつ, 割り当てられたロボットのフレームを連結して送る
+  for (std::size_t c = 0; c < 3; ++c) {
+    const auto& v = r.connection(c).values;
+    BOOST_TEST(v.size() == 1);
+    BOOST_TEST(v[0].size() == r.stats(c).frames * 11);
+  }
+  BOOST_TEST(r.stats(0).frames == 2);
+  BOOST_TEST(r.stats(1).frames == 1);
+  BOOST_TEST(r.stats(2).frames == 2);
+  BOOST_TEST(r.stats(2).robots == 2);
+  // ID 2 のフレームの先頭
+  BOOST_TEST(r.connection(0).values[0][0] == 3);
+
+  // 固定を解除すると次の送信で割り当て直される
+  r.unassign(0);
+  BOOST_TEST(!r.channel_of(0).has_value());
+  r.send(model::team_color::blue, 0, kick, 0, 0, 0, 0);
+  BOOST_TEST(r.channel_of(0).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(redundant) {
+  auto r = make_radio();
+  auto monitor = std::make_shared<radio::link_monitor>();
+  r.set_link_monitor(monitor);
+  r.assign(0, 0, 1);
+
+  // v1 では副チャネルには送らない (重複を取り除く手段がないため)
+  r.send(model::team_color::blue, 0, kick, 0, 0, 0, 0);
+  BOOST_TEST(r.connection(0).values.size() == 1);
+  BOOST_TEST(r.connection(1).values.empty());
+  BOOST_TEST(r.stats(1).robots == 0);
+
+  // v2 では同じ通し番号のフレームを 2 つのチャネルに送る
+  r.set_protocol(radio::kiks_protocol::v2);
+  r.send(model::team_color::blue, 0, kick, 0, 0, 0, 0);
+  BOOST_TEST(r.connection(0).values.size() == 2);
+  BOOST_TEST(r.connection(1).values.size() == 1);
+  BOOST_TEST(r.connection(0).values[1] == r.connection(1).values[0],
+             boost::test_tools::per_element());
+  BOOST_TEST(r.stats(1).robots == 1);
+
+  // 両方のチャネルから応答が届いても 1 回だけ数える
+  const auto now = radio::link_monitor::clock_type::now();
+  BOOST_TEST(monitor->handle_feedback({1, 0}, now));
+  BOOST_TEST(!monitor->handle_feedback({1, 0}, now));
+  BOOST_TEST(monitor->robot_stats(0, now).sent == 1);
+  BOOST_TEST(monitor->robot_stats(0, now).acked == 1);
+}
+
+BOOST_AUTO_TEST_CASE(rebalance) {
+  auto r = make_radio();
+
+  // n サイクル分, ID 0 から robots - 1 のロボットへ命令を送る
+  const auto run = [&r](unsigned int robots, int n) {
+    for (int i = 0; i < n; ++i) {
+      r.begin_cycle(model::team_color::blue);
+      for (unsigned int id = 0; id < robots; ++id) {
+        r.stage(model::team_color::blue, id, kick, 0, 0, 0, 0);
+      }
+      r.flush();
+    }
+  };
+
+  // 自動で割り当てると ID 0, 1, 2 はチャネル 0, 1, 2 に分かれる
+  run(3, 1);
+  for (unsigned int id = 0; id < 3; ++id) BOOST_TEST(*r.channel_of(id) == id);
+
+  // チャネル 0 に 3 台を固定して偏らせる
+  for (unsigned int id = 3; id < 6; ++id) r.assign(id, 0);
+  run(6, 50);
+  BOOST_TEST(r.stats(0).load > 3 * r.stats(1).load);
+
+  // 負荷の統計をもとに, 自動で割り当てたロボットを負荷の小さいチャネルへ移す
+  BOOST_TEST(r.rebalance());
+  BOOST_TEST(*r.channel_of(0) != 0);
+  for (unsigned int id = 3; id < 6; ++id) BOOST_TEST(*r.channel_of(id) == 0);
+
+  // チャネル 0 に残るのは固定したロボットだけなので, それ以上は移さない
+  run(6, 50);
+  BOOST_TEST(!r.rebalance());
+  BOOST_TEST(r.stats(0).robots == 3);
+  BOOST_TEST(r.stats(1).robots + r.stats(2).robots == 3);
+}
+
+BOOST_AUTO_TEST_CASE(rebalance_interval) {
+  auto r = make_radio();
+  r.set_rebalance_interval(10);
+
+  const auto run = [&r](int n) {
+    for (int i = 0; i < n; ++i) {
+      r.begin_cycle(model::team_color::blue);
+      for (unsigned int id = 0; id < 6; ++id) {
+        r.stage(model::team_color::blue, id, kick, 0, 0, 0, 0);
+      }
+      r.flush();
+    }
+  };
+
+  // 最初のサイクルで ID 0 はチャネル 0 に割り当てられ, ID 3 から 5 もチャネル 0 に固定する
+  for (unsigned int id = 3; id < 6; ++id) r.assign(id, 0);
+  run(9);
+  BOOST_TEST(*r.channel_of(0) == 0);
+
+  // begin_cycle() を 10 回呼んだところで自動的に割り当て直される
+  run(1);
+  BOOST_TEST(*r.channel_of(0) != 0);
+  for (unsigned int id = 3; id < 6; ++id) BOOST_TEST(*r.channel_of(id) == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
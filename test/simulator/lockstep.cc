@@ -0,0 +1,91 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/controller/state_feedback.h"
+#include "ai_server/driver.h"
+#include "ai_server/model/updater/world.h"
+#include "ai_server/radio/grsim.h"
+#include "ai_server/simulator/lockstep.h"
+#include "ai_server/simulator/loopback.h"
+#include "ai_server/util/clock.h"
+
+namespace controller = ai_server::controller;
+namespace model      = ai_server::model;
+namespace radio      = ai_server::radio;
+namespace simulator  = ai_server::simulator;
+namespace clock_     = ai_server::util::clock;
+
+using namespace std::chrono_literals;
+
+static constexpr auto cycle = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>{1.0 / 60});
+
+// ロボットを目標位置に移動させ, n 周期後のロボットの位置を返す
+static simulator::world move_robot(std::uint64_t n) {
+  simulator::config c{};
+  c.position_noise = 1;
+  c.latency        = 20ms;
+  c.frame_period   = cycle;
+  c.seed           = 7;
+  auto sim         = std::make_shared<simulator::simulator>(c);
+  auto r = std::make_shared<radio::grsim<simulator::loopback>>(
+      std::make_unique<simulator::loopback>(sim));
+  r->set_robot_position(model::team_color::blue, 3, -1000, 0, 0);
+
+  model::updater::world updater{};
+  ai_server::driver d{cycle, updater, model::team_color::blue};
+  d.register_robot(3, std::make_unique<controller::state_feedback>(1.0 / 60), r);
+
+  simulator::lockstep l{sim, updater, cycle};
+  l.add_driver(d);
+
+  // Game の代わりに命令を更新する
+  l.on_tick([&d] {
+    model::command command{};
+    command.set_position(-500, 0, 0);
+    d.update_command(3, command);
+  });
+
+  l.run(n);
+  BOOST_TEST(l.ticks() == n);
+  BOOST_TEST((l.clock().elapsed() == sim->now()));
+  // lockstep の間は util::clock もシミュレータの時刻を返す
+  BOOST_TEST((clock_::system_now().time_since_epoch() == sim->now()));
+  BOOST_TEST(d.stats().cycles == n);
+  return sim->state();
+}
+
+BOOST_AUTO_TEST_SUITE(lockstep)
+
+BOOST_AUTO_TEST_CASE(closed_loop) {
+  // 実時間で 7s 分 (Driver は motion の速度で動かすので 100mm/s 程度で進む)
+  const auto w1 = move_robot(420);
+  const auto& r1 = w1.robot_at(model::team_color::blue, 3);
+  BOOST_TEST(std::hypot(r1.x + 500, r1.y) < 50.0);
+
+  // lockstep が破棄されたら実際の時計に戻る
+  BOOST_TEST(clock_::current_source() == nullptr);
+
+  // 同じ設定なら同じ結果になる
+  const auto w2 = move_robot(420);
+  const auto& r2 = w2.robot_at(model::team_color::blue, 3);
+  BOOST_TEST(r1.x == r2.x);
+  BOOST_TEST(r1.y == r2.y);
+  BOOST_TEST(r1.theta == r2.theta);
+}
+
+BOOST_AUTO_TEST_CASE(step_with_timer) {
+  boost::asio::io_context io{};
+  model::updater::world updater{};
+  ai_server::driver d{io, cycle, updater, model::team_color::blue};
+  BOOST_CHECK_THROW(d.step(), std::logic_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/model/updater/world.h"
+#include "ai_server/radio/grsim.h"
+#include "ai_server/simulator/loopback.h"
+#include "ai_server/simulator/simulator.h"
+
+namespace model     = ai_server::model;
+namespace radio     = ai_server::radio;
+namespace simulator = ai_server::simulator;
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(simulator_core)
+
+BOOST_AUTO_TEST_CASE(camera_layout) {
+  simulator::config c{};
+  c.cameras_x      = 2;
+  c.cameras_y      = 2;
+  c.camera_overlap = 400;
+  simulator::vision v{c};
+  BOOST_TEST(v.cameras() == 4u);
+
+  // 原点付近は全てのカメラに映る
+  simulator::world w{c};
+  w.place_ball(100, -100);
+  w.place_robot(model::team_color::blue, 2, 3000, 3000, 0);
+  const auto packets = v.capture(w, 1.0, 1.5);
+  BOOST_TEST(packets.size() == 4u);
+
+  std::size_t balls = 0, robots = 0;
+  for (std::size_t i = 0; i < packets.size(); ++i) {
+    const auto& f = packets[i].detection();
+    BOOST_TEST(f.camera_id() == i);
+    BOOST_TEST(f.t_capture() == 1.0);
+    BOOST_TEST(f.t_sent() == 1.5);
+    balls += f.balls_size();
+    robots += f.robots_blue_size();
+    for (const auto& r : f.robots_blue()) {
+      BOOST_TEST(r.robot_id() == 2u);
+      BOOST_TEST(r.x() == 3000.0f);
+    }
+  }
+  BOOST_TEST(balls == 4u);
+  // (3000, 3000) は 1 台のカメラにしか映らない
+  BOOST_TEST(robots == 1u);
+
+  const auto g = v.geometry();
+  BOOST_TEST(g.geometry().field().field_length() == c.field_length);
+  BOOST_TEST(g.geometry().calib_size() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(latency) {
+  simulator::config c{};
+  c.cameras_x         = 1;
+  c.cameras_y         = 1;
+  c.frame_period      = 10ms;
+  c.latency           = 25ms;
+  c.geometry_interval = 0;
+  simulator::simulator sim{c};
+
+  sim.advance(30ms);
+  BOOST_TEST((sim.now() == 30ms));
+  // 10ms に撮影したものは 35ms まで送られない
+  BOOST_TEST(sim.take_vision().empty());
+
+  sim.advance(5ms);
+  auto packets = sim.take_vision();
+  BOOST_TEST(packets.size() == 1u);
+  BOOST_TEST(packets[0].detection().t_capture() == 0.010, boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(packets[0].detection().t_sent() == 0.035, boost::test_tools::tolerance(1e-9));
+
+  sim.advance(20ms);
+  packets = sim.take_vision();
+  BOOST_TEST(packets.size() == 2u);
+  BOOST_TEST(packets[0].detection().frame_number() == 1u);
+  BOOST_TEST(packets[1].detection().frame_number() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(deterministic) {
+  simulator::config c{};
+  c.position_noise  = 10;
+  c.angle_noise     = 0.01;
+  c.robots_per_team = 4;
+  c.seed            = 42;
+
+  const auto run = [&c] {
+    simulator::simulator sim{c};
+    sim.modify([](auto& w) { w.place_ball(0, 0, 2000, 500); });
+    std::vector<std::string> out{};
+    for (int i = 0; i < 30; ++i) {
+      sim.advance(16ms);
+      for (const auto& p : sim.take_vision()) out.push_back(p.SerializeAsString());
+    }
+    return out;
+  };
+
+  const auto a = run();
+  const auto b = run();
+  BOOST_TEST(a.size() > 0u);
+  BOOST_TEST(a == b);
+
+  // シードを変えると誤差が変わる
+  c.seed       = 43;
+  const auto d = run();
+  BOOST_TEST(a.size() == d.size());
+  BOOST_TEST(a != d);
+}
+
+BOOST_AUTO_TEST_CASE(loopback) {
+  auto sim = std::make_shared<simulator::simulator>();
+  radio::grsim<simulator::loopback> r{std::make_unique<simulator::loopback>(sim)};
+
+  r.set_robot_position(model::team_color::yellow, 5, 1000, -500, 0);
+  r.set_ball_position(200, 300);
+  r.send(model::team_color::yellow, 5, {model::command::kick_type_t::none, 0}, 0, 1000, 0, 0);
+  BOOST_TEST(r.connection().total_messages() == 3u);
+  BOOST_TEST(r.connection().total_errors() == 0u);
+
+  sim->advance(1s);
+  const auto w = sim->state();
+  BOOST_TEST(w.ball().x == 200.0, boost::test_tools::tolerance(1e-6));
+  BOOST_TEST(w.ball().y == 300.0, boost::test_tools::tolerance(1e-6));
+  const auto& robot = w.robot_at(model::team_color::yellow, 5);
+  BOOST_TEST(robot.present);
+  BOOST_TEST(robot.x > 1500.0);
+  BOOST_TEST(robot.y == -500.0, boost::test_tools::tolerance(1e-6));
+
+  // パースできないデータは数えるだけ
+  simulator::loopback l{sim};
+  l.send(std::string{"\xff\xff"});
+  BOOST_TEST(l.total_errors() == 1u);
+}
+
+// 検出データで WorldModel を更新し, radio::grsim を通して命令を送る閉ループ
+BOOST_AUTO_TEST_CASE(closed_loop) {
+  simulator::config c{};
+  c.position_noise = 2;
+  c.latency        = 30ms;
+  auto sim         = std::make_shared<simulator::simulator>(c);
+  radio::grsim<simulator::loopback> r{std::make_unique<simulator::loopback>(sim)};
+  model::updater::world updater{};
+
+  r.set_robot_position(model::team_color::blue, 0, -2000, -1000, 0.5);
+  const double target_x = 1500, target_y = 800;
+
+  // 実時間で 10s 分を待たずに進める
+  for (int i = 0; i < 600; ++i) {
+    sim->advance(c.frame_period);
+    for (const auto& p : sim->take_vision()) updater.update(p);
+
+    const auto robots = updater.value().robots_blue();
+    const auto it     = robots.find(0);
+    if (it == robots.end()) continue;
+    const auto& robot = it->second;
+
+    // フィールド座標系での速度をロボット座標系に直して送る
+    const auto vx    = std::clamp(2.0 * (target_x - robot.x()), -1500.0, 1500.0);
+    const auto vy    = std::clamp(2.0 * (target_y - robot.y()), -1500.0, 1500.0);
+    const auto theta = robot.theta();
+    r.send(model::team_color::blue, 0, {model::command::kick_type_t::none, 0}, 0,
+           std::cos(theta) * vx + std::sin(theta) * vy,
+           -std::sin(theta) * vx + std::cos(theta) * vy, -theta);
+  }
+
+  const auto w      = sim->state();
+  const auto& robot = w.robot_at(model::team_color::blue, 0);
+  BOOST_TEST(std::hypot(robot.x - target_x, robot.y - target_y) < 30.0);
+  BOOST_TEST(std::abs(robot.theta) < 0.05);
+  BOOST_TEST(updater.value().field().length() == c.field_length);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,226 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <cmath>
+
+#include <boost/math/constants/constants.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "ssl-protos/grsim_packet.pb.h"
+
+#include "ai_server/model/team_color.h"
+#include "ai_server/simulator/world.h"
+
+namespace model     = ai_server::model;
+namespace simulator = ai_server::simulator;
+
+constexpr double pi = boost::math::double_constants::pi;
+
+// world を dt = 1ms で duration [s] だけ進める
+static void run(simulator::world& w, double duration) {
+  const auto n = static_cast<int>(std::round(duration / 0.001));
+  for (int i = 0; i < n; ++i) w.step(0.001);
+}
+
+BOOST_AUTO_TEST_SUITE(simulator_world)
+
+BOOST_AUTO_TEST_CASE(initial_robots) {
+  simulator::config c{};
+  c.robots_per_team = 3;
+  simulator::world w{c};
+
+  for (unsigned int id = 0; id < simulator::world::max_robots; ++id) {
+    const auto& b = w.robot_at(model::team_color::blue, id);
+    const auto& y = w.robot_at(model::team_color::yellow, id);
+    BOOST_TEST(b.present == (id < 3));
+    BOOST_TEST(y.present == (id < 3));
+    if (id < 3) {
+      BOOST_TEST(b.x < 0);
+      BOOST_TEST(y.x > 0);
+      BOOST_TEST(b.y == y.y);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(robot_motion, *boost::unit_test::tolerance(1e-6)) {
+  simulator::config c{};
+  c.robot_acceleration = 2000;
+  simulator::world w{c};
+  w.place_robot(model::team_color::blue, 1, 0, 0, pi / 2);
+
+  ssl_protos::grsim::Packet p{};
+  auto commands = p.mutable_commands();
+  commands->set_timestamp(0);
+  commands->set_isteamyellow(false);
+  auto cmd = commands->add_robot_commands();
+  cmd->set_id(1);
+  cmd->set_kickspeedx(0);
+  cmd->set_kickspeedz(0);
+  cmd->set_veltangent(1.0);
+  cmd->set_velnormal(0);
+  cmd->set_velangular(0);
+  cmd->set_spinner(false);
+  cmd->set_wheelsspeed(false);
+  w.apply(p);
+
+  // 加速度の上限があるので, 0.25s 後は目標速度の半分
+  run(w, 0.25);
+  {
+    const auto& r = w.robot_at(model::team_color::blue, 1);
+    BOOST_TEST(std::hypot(r.vx, r.vy) == 500.0);
+  }
+
+  // 0.5s で目標速度に達し, ロボットの前方 (フィールドの +y 方向) に進む
+  run(w, 0.75);
+  {
+    const auto& r = w.robot_at(model::team_color::blue, 1);
+    BOOST_TEST(r.vx == 0.0);
+    BOOST_TEST(r.vy == 1000.0);
+    BOOST_TEST(r.x == 0.0);
+    BOOST_TEST(r.y == 750.0, boost::test_tools::tolerance(1.0));
+  }
+
+  // 存在しないロボットへの命令は無視する
+  cmd->set_id(2);
+  w.apply(p);
+  BOOST_TEST(!w.robot_at(model::team_color::blue, 2).present);
+}
+
+BOOST_AUTO_TEST_CASE(ball_rolling) {
+  simulator::config c{};
+  c.ball_deceleration = 500;
+  simulator::world w{c};
+  w.place_ball(0, 0, 1000, 0);
+
+  // v^2 / 2a = 1000mm 進んで 2s で止まる
+  run(w, 1.0);
+  BOOST_TEST(w.ball().vx == 500.0, boost::test_tools::tolerance(1e-6));
+  run(w, 1.5);
+  BOOST_TEST(w.ball().vx == 0.0);
+  BOOST_TEST(w.ball().x == 1000.0, boost::test_tools::tolerance(1e-3));
+}
+
+BOOST_AUTO_TEST_CASE(ball_wall) {
+  simulator::config c{};
+  c.ball_deceleration = 0;
+  c.wall_restitution  = 0.5;
+  simulator::world w{c};
+
+  const auto wall = c.field_length / 2.0 + c.boundary_width;
+  w.place_ball(wall - 100, 0, 2000, 0);
+  run(w, 0.2);
+  BOOST_TEST(w.ball().vx == -1000.0, boost::test_tools::tolerance(1e-6));
+  BOOST_TEST(w.ball().x < wall);
+}
+
+BOOST_AUTO_TEST_CASE(kick) {
+  simulator::config c{};
+  c.ball_deceleration = 0;
+  simulator::world w{c};
+  w.place_robot(model::team_color::yellow, 0, 0, 0, 0);
+  w.place_ball(c.robot_radius + c.ball_radius + 10, 0);
+
+  ssl_protos::grsim::Packet p{};
+  auto commands = p.mutable_commands();
+  commands->set_timestamp(0);
+  commands->set_isteamyellow(true);
+  auto cmd = commands->add_robot_commands();
+  cmd->set_id(0);
+  cmd->set_kickspeedx(3.0);
+  cmd->set_kickspeedz(0);
+  cmd->set_veltangent(0.5);
+  cmd->set_velnormal(0);
+  cmd->set_velangular(0);
+  cmd->set_spinner(false);
+  cmd->set_wheelsspeed(false);
+  w.apply(p);
+
+  run(w, 0.2);
+  const auto& b = w.ball();
+  BOOST_TEST(b.vx > 3000.0);
+  BOOST_TEST(b.vy == 0.0);
+  BOOST_TEST(b.z == 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(chip) {
+  simulator::config c{};
+  c.ball_restitution = 0.5;
+  simulator::world w{c};
+  w.place_robot(model::team_color::blue, 0, 0, 0, 0);
+  w.place_ball(c.robot_radius + c.ball_radius - 1, 0);
+
+  ssl_protos::grsim::Packet p{};
+  auto commands = p.mutable_commands();
+  commands->set_timestamp(0);
+  commands->set_isteamyellow(false);
+  auto cmd = commands->add_robot_commands();
+  cmd->set_id(0);
+  cmd->set_kickspeedx(2.0);
+  cmd->set_kickspeedz(2.0);
+  cmd->set_veltangent(0);
+  cmd->set_velnormal(0);
+  cmd->set_velangular(0);
+  cmd->set_spinner(false);
+  cmd->set_wheelsspeed(false);
+  w.apply(p);
+
+  // 浮いている間は減速せず, 最高点は v^2 / 2g
+  double max_z = 0;
+  for (int i = 0; i < 300; ++i) {
+    w.step(0.001);
+    max_z = std::max(max_z, w.ball().z);
+  }
+  BOOST_TEST(max_z == 2000.0 * 2000.0 / (2 * c.gravity), boost::test_tools::tolerance(0.02));
+  BOOST_TEST(w.ball().vx == 2000.0);
+
+  // 跳ねるたびに低くなり, やがて転がり始める
+  run(w, 3.0);
+  BOOST_TEST(w.ball().z == 0.0);
+  BOOST_TEST(w.ball().vz == 0.0);
+  BOOST_TEST(w.ball().vx < 2000.0);
+}
+
+BOOST_AUTO_TEST_CASE(robot_blocks_ball) {
+  simulator::config c{};
+  c.ball_deceleration = 0;
+  simulator::world w{c};
+  // ボールに背を向けたロボット
+  w.place_robot(model::team_color::blue, 0, 0, 0, pi);
+  w.place_ball(1000, 0, -1000, 0);
+
+  run(w, 1.5);
+  BOOST_TEST(w.ball().vx > 0.0);
+  BOOST_TEST(w.ball().x >= c.robot_radius + c.ball_radius);
+}
+
+BOOST_AUTO_TEST_CASE(replacement, *boost::unit_test::tolerance(1e-6)) {
+  simulator::world w{simulator::config{}};
+
+  ssl_protos::grsim::Packet p{};
+  auto b = p.mutable_replacement()->mutable_ball();
+  b->set_x(1.0);
+  b->set_y(-2.0);
+  b->set_vx(0);
+  b->set_vy(0);
+  auto r = p.mutable_replacement()->add_robots();
+  r->set_id(3);
+  r->set_x(0.5);
+  r->set_y(0.25);
+  r->set_dir(90);
+  r->set_yellowteam(true);
+  w.apply(p);
+
+  BOOST_TEST(w.ball().x == 1000.0);
+  BOOST_TEST(w.ball().y == -2000.0);
+  const auto& robot = w.robot_at(model::team_color::yellow, 3);
+  BOOST_TEST(robot.present);
+  BOOST_TEST(robot.x == 500.0);
+  BOOST_TEST(robot.y == 250.0);
+  BOOST_TEST(robot.theta == pi / 2);
+
+  r->set_turnon(false);
+  p.mutable_replacement()->clear_ball();
+  w.apply(p);
+  BOOST_TEST(!w.robot_at(model::team_color::yellow, 3).present);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,53 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <chrono>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/util/clock.h"
+
+namespace clock_ = ai_server::util::clock;
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(clock_source)
+
+BOOST_AUTO_TEST_CASE(manual) {
+  clock_::manual c{1s};
+  BOOST_TEST((c.elapsed() == 1s));
+  BOOST_TEST((c.system_now() == std::chrono::system_clock::time_point{} + 1s));
+  BOOST_TEST((c.steady_now() == std::chrono::steady_clock::time_point{} + 1s));
+
+  c.advance(250ms);
+  BOOST_TEST((c.system_now() == std::chrono::system_clock::time_point{} + 1250ms));
+
+  c.set(10s);
+  BOOST_TEST((c.steady_now() == std::chrono::steady_clock::time_point{} + 10s));
+}
+
+BOOST_AUTO_TEST_CASE(scoped) {
+  // 何も設定していなければ実際の時計を使う
+  BOOST_TEST(clock_::current_source() == nullptr);
+  const auto before = std::chrono::system_clock::now();
+  BOOST_TEST((clock_::system_now() >= before));
+
+  clock_::manual a{5s};
+  {
+    clock_::scoped_source s1{a};
+    BOOST_TEST(clock_::current_source() == &a);
+    BOOST_TEST((clock_::system_now() == std::chrono::system_clock::time_point{} + 5s));
+
+    clock_::manual b{7s};
+    {
+      clock_::scoped_source s2{b};
+      BOOST_TEST((clock_::steady_now() == std::chrono::steady_clock::time_point{} + 7s));
+    }
+
+    // 内側の設定が外れると外側の設定に戻る
+    a.advance(1s);
+    BOOST_TEST((clock_::steady_now() == std::chrono::steady_clock::time_point{} + 6s));
+  }
+  BOOST_TEST(clock_::current_source() == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,42 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/util/thread.h"
+
+using namespace ai_server;
+
+BOOST_AUTO_TEST_SUITE(thread_utils)
+
+BOOST_AUTO_TEST_CASE(affinity_and_priority) {
+  std::mutex mutex{};
+  std::condition_variable cv{};
+  bool done = false;
+  std::thread t{[&] {
+    std::unique_lock lock{mutex};
+    cv.wait(lock, [&] { return done; });
+  }};
+
+  // 空なら何もせずに成功する
+  BOOST_TEST(util::set_thread_affinity(t, {}));
+#if defined(__linux__) && defined(__GLIBC__)
+  BOOST_TEST(util::set_thread_affinity(t, {0}));
+  // 存在しない CPU は設定できない
+  BOOST_TEST(!util::set_thread_affinity(t, {CPU_SETSIZE}));
+  // 通常のスケジューリングには権限なしで戻せる
+  BOOST_TEST(util::set_thread_priority(t, 0));
+#endif
+
+  {
+    std::lock_guard lock{mutex};
+    done = true;
+  }
+  cv.notify_all();
+  t.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,107 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "ai_server/util/trace.h"
+
+using namespace ai_server;
+
+namespace {
+
+// 書き出した JSON に含まれる名前が name の区間の数
+std::size_t count_events(const std::string& json, const std::string& name) {
+  std::istringstream is{json};
+  boost::property_tree::ptree pt{};
+  boost::property_tree::read_json(is, pt);
+  std::size_t n = 0;
+  for (const auto& [_, e] : pt.get_child("traceEvents")) {
+    if (e.get<std::string>("ph") == "X" && e.get<std::string>("name") == name) ++n;
+  }
+  return n;
+}
+
+std::string export_trace() {
+  std::ostringstream os{};
+  util::trace::write_chrome_trace(os);
+  return os.str();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(trace)
+
+BOOST_AUTO_TEST_CASE(scope) {
+  util::trace::clear();
+
+  // 無効なときは記録されない
+  util::trace::set_enabled(false);
+  { AI_SERVER_TRACE_SCOPE("disabled"); }
+  BOOST_TEST(count_events(export_trace(), "disabled") == 0u);
+
+  util::trace::set_enabled(true);
+  { AI_SERVER_TRACE_SCOPE("main \"zone\""); }
+  std::thread t{[] {
+    for (int i = 0; i < 10; ++i) {
+      AI_SERVER_TRACE_SCOPE("worker");
+    }
+  }};
+  t.join();
+  util::trace::set_enabled(false);
+
+  const auto json = export_trace();
+  BOOST_TEST(count_events(json, "main \"zone\"") == 1u);
+  BOOST_TEST(count_events(json, "worker") == 10u);
+
+  // clear() 以前の区間は含まれない
+  util::trace::clear();
+  BOOST_TEST(count_events(export_trace(), "worker") == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(overwrite) {
+  util::trace::clear();
+  util::trace::set_enabled(true);
+
+  // リングバッファの大きさを超えたら古いものから上書きされる
+  std::thread t{[] {
+    for (int i = 0; i < 100000; ++i) {
+      AI_SERVER_TRACE_SCOPE("many");
+    }
+  }};
+  t.join();
+  util::trace::set_enabled(false);
+
+  const auto n = count_events(export_trace(), "many");
+  BOOST_TEST(n > 0u);
+  BOOST_TEST(n < 100000u);
+}
+
+BOOST_AUTO_TEST_CASE(timestamps) {
+  util::trace::clear();
+  util::trace::set_enabled(true);
+  {
+    AI_SERVER_TRACE_SCOPE("sleep");
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+  }
+  util::trace::set_enabled(false);
+
+  std::istringstream is{export_trace()};
+  boost::property_tree::ptree pt{};
+  boost::property_tree::read_json(is, pt);
+  std::size_t found = 0;
+  for (const auto& [_, e] : pt.get_child("traceEvents")) {
+    if (e.get<std::string>("ph") != "X") continue;
+    ++found;
+    // dur は µs
+    BOOST_TEST(e.get<double>("dur") >= 19000.0);
+    BOOST_TEST(e.get<double>("dur") < 200000.0);
+  }
+  BOOST_TEST(found == 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()